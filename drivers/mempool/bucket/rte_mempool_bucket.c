@@ -0,0 +1,631 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/queue.h>
+
+#include <rte_errno.h>
+#include <rte_atomic.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_ring.h>
+#include <rte_mempool.h>
+
+/*
+ * Bucket mempool handler.
+ *
+ * The objects are grouped in buckets: physically contiguous memory areas
+ * of RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB kilobytes, aligned on their (power
+ * of 2) size and starting with a bucket header. The header of an object is
+ * thus found by masking the object address.
+ *
+ * A bucket is given to an lcore as a whole: bulk dequeues are satisfied
+ * with complete buckets whenever possible, so that the dequeued objects are
+ * neighbours in memory. The lcore owning a bucket counts the objects freed
+ * back into it; once all of them are back, the bucket is full and can be
+ * handed out again. Objects freed by another lcore are first put in the
+ * adoption ring of the owner, which processes them on its next dequeue.
+ *
+ * Dequeues of less than a bucket are served from a shared ring of "orphan"
+ * objects. When it is empty, a bucket is broken: some of its objects are
+ * returned, and the other ones are moved to the orphan ring.
+ *
+ * A bucket must fit in one memory chunk, so every chunk given to the pool
+ * has to be contiguous over at least one aligned bucket. Unless the pool is
+ * created with MEMPOOL_F_NO_PHYS_CONTIG, pages smaller than a bucket do not
+ * guarantee it: rte_mempool_populate_default() on such pages is rejected,
+ * and rte_mempool_populate_anon() or rte_mempool_populate_virt() fail with
+ * -EINVAL as soon as a chunk cannot hold any bucket.
+ */
+
+struct bucket_header {
+	unsigned int lcore_id;    /**< Owner of the bucket. */
+	unsigned int obj_cnt;     /**< Number of objects in the bucket. */
+	rte_atomic32_t fill_cnt;  /**< Number of objects back in the bucket. */
+};
+
+struct bucket_stack {
+	unsigned int top;         /**< Number of buckets in the stack. */
+	unsigned int limit;       /**< Capacity of the stack. */
+	void *objects[];          /**< Bucket headers. */
+};
+
+struct bucket_data {
+	unsigned int header_size;     /**< Bucket and object header size. */
+	unsigned int total_elt_size;  /**< Size of an object with metadata. */
+	unsigned int obj_per_bucket;  /**< Number of objects in a bucket. */
+	unsigned int bucket_stack_thresh; /**< Max buckets kept per lcore. */
+	unsigned int bucket_mem_size; /**< Size of a bucket. */
+	uintptr_t bucket_page_mask;   /**< Mask to get a bucket header. */
+	/** Full buckets available to all lcores. */
+	struct rte_ring *shared_bucket_ring;
+	/** Full buckets owned by each lcore. */
+	struct bucket_stack *buckets[RTE_MAX_LCORE];
+	/**
+	 * Multi-producer single-consumer rings holding the objects freed
+	 * by an lcore that does not own their bucket.
+	 */
+	struct rte_ring *adoption_buffer_rings[RTE_MAX_LCORE];
+	/** Free objects not accounted in their bucket. */
+	struct rte_ring *shared_orphan_ring;
+	struct rte_mempool *pool;     /**< Mempool using this data. */
+};
+
+static struct bucket_stack *
+bucket_stack_create(const struct rte_mempool *mp, unsigned int n_elts)
+{
+	struct bucket_stack *stack;
+
+	stack = rte_zmalloc_socket("bucket_stack",
+				   sizeof(struct bucket_stack) +
+				   n_elts * sizeof(void *),
+				   RTE_CACHE_LINE_SIZE,
+				   mp->socket_id);
+	if (stack == NULL)
+		return NULL;
+	stack->limit = n_elts;
+	stack->top = 0;
+
+	return stack;
+}
+
+static void
+bucket_stack_push(struct bucket_stack *stack, void *obj)
+{
+	RTE_ASSERT(stack->top < stack->limit);
+	stack->objects[stack->top++] = obj;
+}
+
+static void *
+bucket_stack_pop(struct bucket_stack *stack)
+{
+	RTE_ASSERT(stack->top > 0);
+	return stack->objects[--stack->top];
+}
+
+static inline struct bucket_header *
+bucket_get_header(const struct bucket_data *bd, void *obj)
+{
+	return (struct bucket_header *)((uintptr_t)obj & bd->bucket_page_mask);
+}
+
+static inline void *
+bucket_first_obj(const struct bucket_data *bd, struct bucket_header *hdr)
+{
+	return (char *)hdr + bd->header_size;
+}
+
+/* give an object back to its bucket */
+static void
+bucket_enqueue_single(struct bucket_data *bd, void *obj)
+{
+	struct bucket_header *hdr = bucket_get_header(bd, obj);
+	unsigned int lcore_id = rte_lcore_id();
+	int32_t fill_cnt;
+	int rc __rte_unused;
+
+	if (unlikely(hdr->obj_cnt != bd->obj_per_bucket)) {
+		/* the objects of incomplete buckets are always orphans */
+		rc = rte_ring_enqueue(bd->shared_orphan_ring, obj);
+		/* the ring is big enough to store all objects */
+		RTE_ASSERT(rc == 0);
+	} else if (hdr->lcore_id == LCORE_ID_ANY) {
+		/* bucket owned by no lcore, the counter is shared */
+		fill_cnt = rte_atomic32_add_return(&hdr->fill_cnt, 1);
+		if (fill_cnt == (int32_t)bd->obj_per_bucket) {
+			rte_atomic32_set(&hdr->fill_cnt, 0);
+			rc = rte_ring_enqueue(bd->shared_bucket_ring, hdr);
+			RTE_ASSERT(rc == 0);
+		}
+	} else if (hdr->lcore_id == lcore_id) {
+		/* only the owner updates the counter, no atomic needed */
+		fill_cnt = rte_atomic32_read(&hdr->fill_cnt) + 1;
+		if (fill_cnt == (int32_t)bd->obj_per_bucket) {
+			rte_atomic32_set(&hdr->fill_cnt, 0);
+			bucket_stack_push(bd->buckets[lcore_id], hdr);
+		} else {
+			rte_atomic32_set(&hdr->fill_cnt, fill_cnt);
+		}
+	} else {
+		rc = rte_ring_enqueue(bd->adoption_buffer_rings[hdr->lcore_id],
+				      obj);
+		RTE_ASSERT(rc == 0);
+	}
+}
+
+/* process the objects freed by other lcores in our buckets */
+static void
+bucket_adopt_orphans(struct bucket_data *bd)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_ring *adopt_ring;
+	void *orphan;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	adopt_ring = bd->adoption_buffer_rings[lcore_id];
+	while (rte_ring_sc_dequeue(adopt_ring, &orphan) == 0)
+		bucket_enqueue_single(bd, orphan);
+}
+
+/*
+ * Take n full buckets, from the local stack first, and store their headers
+ * in hdr_table. Either all the buckets are taken, or none.
+ */
+static int
+bucket_get_buckets(struct bucket_data *bd, void **hdr_table, unsigned int n)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct bucket_stack *stack = NULL;
+	unsigned int n_local = 0;
+	unsigned int i;
+
+	if (lcore_id < RTE_MAX_LCORE) {
+		stack = bd->buckets[lcore_id];
+		n_local = RTE_MIN(n, stack->top);
+		for (i = 0; i < n_local; i++)
+			hdr_table[i] = bucket_stack_pop(stack);
+	}
+
+	if (n_local == n)
+		return 0;
+
+	if (rte_ring_dequeue_bulk(bd->shared_bucket_ring, &hdr_table[n_local],
+				  n - n_local, NULL) == 0) {
+		/* give the local buckets back */
+		while (n_local > 0)
+			bucket_stack_push(stack, hdr_table[--n_local]);
+		return -ENOBUFS;
+	}
+
+	for (i = n_local; i < n; i++) {
+		struct bucket_header *hdr = hdr_table[i];
+
+		hdr->lcore_id = lcore_id;
+	}
+
+	return 0;
+}
+
+static int
+bucket_dequeue_orphans(struct bucket_data *bd, void **obj_table,
+		       unsigned int n_orphans)
+{
+	struct bucket_header *hdr;
+	char *objptr;
+	unsigned int i;
+	void *first;
+
+	if (rte_ring_dequeue_bulk(bd->shared_orphan_ring, obj_table,
+				  n_orphans, NULL) != 0)
+		return 0;
+
+	/* not enough orphans, break a bucket */
+	if (bucket_get_buckets(bd, &first, 1) != 0)
+		return -ENOBUFS;
+
+	hdr = first;
+	objptr = bucket_first_obj(bd, hdr);
+	for (i = 0; i < bd->obj_per_bucket; i++) {
+		if (i < n_orphans) {
+			obj_table[i] = objptr;
+		} else if (rte_ring_enqueue(bd->shared_orphan_ring,
+					    objptr) != 0) {
+			/* the ring is big enough to store all objects */
+			RTE_ASSERT(0);
+		}
+		objptr += bd->total_elt_size;
+	}
+
+	return 0;
+}
+
+static int
+bucket_dequeue_buckets(struct bucket_data *bd, void **obj_table,
+		       unsigned int n_buckets)
+{
+	unsigned int i, j;
+	char *objptr;
+
+	/* the bucket headers are stored at the start of obj_table */
+	if (bucket_get_buckets(bd, obj_table, n_buckets) != 0)
+		return -ENOBUFS;
+
+	/* expand the last bucket first, so no header is overwritten */
+	for (i = n_buckets; i-- > 0; ) {
+		objptr = bucket_first_obj(bd, obj_table[i]);
+		for (j = 0; j < bd->obj_per_bucket; j++) {
+			obj_table[i * bd->obj_per_bucket + j] = objptr;
+			objptr += bd->total_elt_size;
+		}
+	}
+
+	return 0;
+}
+
+static int
+bucket_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	       unsigned int n)
+{
+	struct bucket_data *bd = mp->pool_data;
+	unsigned int lcore_id = rte_lcore_id();
+	struct bucket_stack *stack;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		bucket_enqueue_single(bd, obj_table[i]);
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return 0;
+
+	/* share the buckets above the threshold with the other lcores */
+	stack = bd->buckets[lcore_id];
+	if (stack->top > bd->bucket_stack_thresh) {
+		rte_ring_enqueue_bulk(bd->shared_bucket_ring,
+				      &stack->objects[bd->bucket_stack_thresh],
+				      stack->top - bd->bucket_stack_thresh,
+				      NULL);
+		stack->top = bd->bucket_stack_thresh;
+	}
+
+	return 0;
+}
+
+static int
+bucket_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct bucket_data *bd = mp->pool_data;
+	unsigned int n_buckets = n / bd->obj_per_bucket;
+	unsigned int n_orphans = n - n_buckets * bd->obj_per_bucket;
+	void **orphan_table = obj_table + n_buckets * bd->obj_per_bucket;
+	int rc = 0;
+
+	bucket_adopt_orphans(bd);
+
+	if (unlikely(n_orphans > 0)) {
+		rc = bucket_dequeue_orphans(bd, orphan_table, n_orphans);
+		if (rc != 0)
+			return rc;
+	}
+
+	if (likely(n_buckets > 0)) {
+		rc = bucket_dequeue_buckets(bd, obj_table, n_buckets);
+		if (unlikely(rc != 0) && n_orphans > 0)
+			rte_ring_enqueue_bulk(bd->shared_orphan_ring,
+					      orphan_table, n_orphans, NULL);
+	}
+
+	return rc;
+}
+
+static int
+bucket_dequeue_contig_blocks(struct rte_mempool *mp, void **first_obj_table,
+			     unsigned int n)
+{
+	struct bucket_data *bd = mp->pool_data;
+	unsigned int i;
+
+	bucket_adopt_orphans(bd);
+
+	if (bucket_get_buckets(bd, first_obj_table, n) != 0)
+		return -ENOBUFS;
+
+	for (i = 0; i < n; i++)
+		first_obj_table[i] = bucket_first_obj(bd, first_obj_table[i]);
+
+	return 0;
+}
+
+static unsigned int
+bucket_get_count(const struct rte_mempool *mp)
+{
+	const struct bucket_data *bd = mp->pool_data;
+	const struct rte_mempool_memhdr *memhdr;
+	size_t bucket_page_sz = ~bd->bucket_page_mask + 1;
+	size_t bucket_header_sz = bd->header_size - mp->header_size;
+	unsigned int count;
+	unsigned int i;
+
+	count = bd->obj_per_bucket * rte_ring_count(bd->shared_bucket_ring) +
+		rte_ring_count(bd->shared_orphan_ring);
+
+	RTE_LCORE_FOREACH(i) {
+		count += bd->obj_per_bucket * bd->buckets[i]->top +
+			rte_ring_count(bd->adoption_buffer_rings[i]);
+	}
+
+	/* add the objects back in the buckets which are not full yet */
+	STAILQ_FOREACH(memhdr, &mp->mem_list, next) {
+		char *end = (char *)memhdr->addr + memhdr->len;
+		char *iter;
+
+		for (iter = RTE_PTR_ALIGN_CEIL(memhdr->addr, bucket_page_sz);
+		     iter + bucket_header_sz < end; iter += bucket_page_sz) {
+			struct bucket_header *hdr = (struct bucket_header *)iter;
+
+			count += rte_atomic32_read(&hdr->fill_cnt);
+		}
+	}
+
+	return count;
+}
+
+static void
+bucket_free_data(struct bucket_data *bd)
+{
+	unsigned int i;
+
+	if (bd == NULL)
+		return;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		rte_free(bd->buckets[i]);
+		rte_ring_free(bd->adoption_buffer_rings[i]);
+	}
+	rte_ring_free(bd->shared_orphan_ring);
+	rte_ring_free(bd->shared_bucket_ring);
+	rte_free(bd);
+}
+
+static struct rte_ring *
+bucket_ring_create(const struct rte_mempool *mp, const char *suffix,
+		   unsigned int count, unsigned int flags)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	int ret;
+
+	ret = snprintf(rg_name, sizeof(rg_name), RTE_MEMPOOL_MZ_FORMAT ".%s",
+		       mp->name, suffix);
+	if (ret < 0 || ret >= (int)sizeof(rg_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	return rte_ring_create(rg_name, rte_align32pow2(count + 1),
+			       mp->socket_id, flags);
+}
+
+static int
+bucket_alloc(struct rte_mempool *mp)
+{
+	unsigned int bucket_header_size;
+	unsigned int n_buckets;
+	struct bucket_data *bd;
+	char suffix[8];
+	unsigned int i;
+
+	bd = rte_zmalloc_socket("bucket_pool", sizeof(*bd),
+				RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (bd == NULL)
+		return -ENOMEM;
+
+	bd->pool = mp;
+	bucket_header_size = RTE_CACHE_LINE_ROUNDUP(
+		sizeof(struct bucket_header));
+	bd->header_size = mp->header_size + bucket_header_size;
+	bd->total_elt_size = mp->header_size + mp->elt_size +
+		mp->trailer_size;
+	bd->bucket_mem_size = RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024;
+	bd->obj_per_bucket = (bd->bucket_mem_size - bucket_header_size) /
+		bd->total_elt_size;
+	if (bd->obj_per_bucket == 0) {
+		RTE_LOG(ERR, MEMPOOL, "Objects are too big for %u kB buckets\n",
+			RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB);
+		rte_free(bd);
+		return -EINVAL;
+	}
+	bd->bucket_page_mask = ~(rte_align64pow2(bd->bucket_mem_size) - 1);
+
+	/* only complete buckets are stored in the stacks and bucket ring */
+	n_buckets = mp->size / bd->obj_per_bucket;
+	/* keep at most a fair share of the buckets on each lcore */
+	bd->bucket_stack_thresh = RTE_MAX(n_buckets / rte_lcore_count(), 1U);
+
+	/*
+	 * The rings are always multi-producer: even with a single producer
+	 * and a single consumer thread, both may enqueue orphan objects.
+	 */
+	RTE_LCORE_FOREACH(i) {
+		bd->buckets[i] = bucket_stack_create(mp, n_buckets);
+		if (bd->buckets[i] == NULL) {
+			rte_errno = ENOMEM;
+			goto error;
+		}
+
+		snprintf(suffix, sizeof(suffix), "a%u", i);
+		bd->adoption_buffer_rings[i] = bucket_ring_create(mp, suffix,
+			mp->size, RING_F_SC_DEQ);
+		if (bd->adoption_buffer_rings[i] == NULL)
+			goto error;
+	}
+
+	bd->shared_orphan_ring = bucket_ring_create(mp, "0", mp->size, 0);
+	if (bd->shared_orphan_ring == NULL)
+		goto error;
+
+	bd->shared_bucket_ring = bucket_ring_create(mp, "1", n_buckets, 0);
+	if (bd->shared_bucket_ring == NULL)
+		goto error;
+
+	mp->pool_data = bd;
+
+	return 0;
+
+error:
+	RTE_LOG(ERR, MEMPOOL, "Cannot allocate bucket mempool data: %s\n",
+		rte_strerror(rte_errno));
+	bucket_free_data(bd);
+	return -rte_errno;
+}
+
+static void
+bucket_free(struct rte_mempool *mp)
+{
+	bucket_free_data(mp->pool_data);
+}
+
+static ssize_t
+bucket_calc_mem_size(const struct rte_mempool *mp, uint32_t obj_num,
+		     uint32_t pg_shift, size_t *align)
+{
+	const struct bucket_data *bd = mp->pool_data;
+	size_t bucket_page_sz;
+	size_t n_buckets;
+
+	if (bd == NULL)
+		return -EINVAL;
+
+	bucket_page_sz = ~bd->bucket_page_mask + 1;
+
+	/* a bucket cannot be physically contiguous across smaller pages */
+	if (pg_shift != 0 && ((size_t)1 << pg_shift) < bucket_page_sz &&
+	    !(mp->flags & MEMPOOL_F_NO_PHYS_CONTIG)) {
+		RTE_LOG(ERR, MEMPOOL,
+			"%s: %zu kB buckets do not fit in %zu kB pages\n",
+			mp->name, bucket_page_sz >> 10,
+			((size_t)1 << pg_shift) >> 10);
+		return -EINVAL;
+	}
+	n_buckets = (obj_num + bd->obj_per_bucket - 1) / bd->obj_per_bucket;
+
+	/* the buckets are aligned on their size */
+	*align = RTE_MAX(*align, bucket_page_sz);
+
+	return n_buckets * bucket_page_sz;
+}
+
+static int
+bucket_populate(struct rte_mempool *mp, unsigned int max_objs,
+		char *vaddr, phys_addr_t paddr, size_t len,
+		rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct bucket_data *bd = mp->pool_data;
+	size_t bucket_page_sz = ~bd->bucket_page_mask + 1;
+	size_t bucket_header_sz = bd->header_size - mp->header_size;
+	char *end = vaddr + len;
+	unsigned int n_objs = 0;
+	char *iter;
+	int rc;
+
+	/*
+	 * Initialize the headers of all the buckets in the chunk, even the
+	 * unused ones, so that bucket_get_count() can browse them.
+	 */
+	for (iter = RTE_PTR_ALIGN_CEIL(vaddr, bucket_page_sz);
+	     iter + bucket_header_sz < end; iter += bucket_page_sz) {
+		struct bucket_header *hdr = (struct bucket_header *)iter;
+		size_t chunk_len;
+		phys_addr_t chunk_paddr;
+
+		chunk_len = RTE_MIN((size_t)(end - iter),
+				    (size_t)bd->bucket_mem_size) -
+			bucket_header_sz;
+		chunk_paddr = (paddr == RTE_BAD_PHYS_ADDR) ? RTE_BAD_PHYS_ADDR :
+			paddr + (iter - vaddr) + bucket_header_sz;
+
+		hdr->lcore_id = LCORE_ID_ANY;
+		rte_atomic32_init(&hdr->fill_cnt);
+		/* the objects are enqueued as soon as they are populated */
+		hdr->obj_cnt = RTE_MIN(max_objs - n_objs,
+				       RTE_MIN(bd->obj_per_bucket,
+					       (unsigned int)(chunk_len /
+						       bd->total_elt_size)));
+		if (hdr->obj_cnt == 0)
+			continue;
+
+		rc = rte_mempool_op_populate_default(mp, hdr->obj_cnt,
+						     iter + bucket_header_sz,
+						     chunk_paddr, chunk_len,
+						     obj_cb, obj_cb_arg);
+		if (rc < 0)
+			return rc;
+		RTE_ASSERT((unsigned int)rc == hdr->obj_cnt);
+		n_objs += rc;
+	}
+
+	if (n_objs == 0 && max_objs != 0) {
+		RTE_LOG(ERR, MEMPOOL,
+			"%s: chunk of %zu bytes at %p cannot hold a %zu kB bucket aligned on its size\n",
+			mp->name, len, vaddr, bucket_page_sz >> 10);
+		return -EINVAL;
+	}
+
+	return n_objs;
+}
+
+static int
+bucket_get_info(const struct rte_mempool *mp, struct rte_mempool_info *info)
+{
+	const struct bucket_data *bd = mp->pool_data;
+
+	info->contig_block_size = bd->obj_per_bucket;
+	return 0;
+}
+
+static struct rte_mempool_ops ops_bucket = {
+	.name = "bucket",
+	.alloc = bucket_alloc,
+	.free = bucket_free,
+	.enqueue = bucket_enqueue,
+	.dequeue = bucket_dequeue,
+	.get_count = bucket_get_count,
+	.calc_mem_size = bucket_calc_mem_size,
+	.populate = bucket_populate,
+	.get_info = bucket_get_info,
+	.dequeue_contig_blocks = bucket_dequeue_contig_blocks,
+};
+
+MEMPOOL_REGISTER_OPS(ops_bucket);
@@ -0,0 +1,256 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Lock-free LIFO mempool handler.
+ *
+ * Objects are stored in two singly-linked lists of preallocated elements:
+ * the "used" list holds the elements carrying the objects available in the
+ * pool, and the "free" list holds the unused elements. Each list head is a
+ * (pointer, modification counter) pair updated with a 128-bit compare and
+ * swap, the counter protecting the lists against the ABA problem. The
+ * length of each list is maintained separately, and is decremented before
+ * popping elements, so that a pop never tries to take more elements than
+ * the list contains.
+ */
+
+#include <stdio.h>
+#include <rte_mempool.h>
+#include <rte_malloc.h>
+#include <rte_atomic.h>
+#include <rte_cpuflags.h>
+#include <rte_prefetch.h>
+
+struct lf_stack_elem {
+	void *data;			/**< object pointer */
+	struct lf_stack_elem *next;	/**< next element in the list */
+};
+
+union lf_stack_head {
+	rte_int128_t i128;		/**< to update the head atomically */
+	struct {
+		struct lf_stack_elem *top;	/**< first element */
+		uint64_t cnt;		/**< modification counter */
+	};
+};
+
+struct lf_stack_list {
+	union lf_stack_head head;	/**< list head */
+	rte_atomic64_t len;		/**< number of elements in the list */
+};
+
+struct rte_mempool_lf_stack {
+	/* the lists are accessed by different lcores, avoid false sharing */
+	struct lf_stack_list used __rte_cache_aligned;
+	struct lf_stack_list free __rte_cache_aligned;
+	struct lf_stack_elem elems[] __rte_cache_aligned;
+};
+
+/* push a chain of num elements, from first to last, on a list */
+static __rte_always_inline void
+lf_stack_push(struct lf_stack_list *list, struct lf_stack_elem *first,
+		struct lf_stack_elem *last, unsigned int num)
+{
+	union lf_stack_head old_head, new_head;
+
+	old_head = list->head;
+
+	do {
+		new_head.top = first;
+		new_head.cnt = old_head.cnt + 1;
+		last->next = old_head.top;
+
+		/* on failure, old_head is updated with the current head */
+	} while (rte_atomic128_cmp_exchange(&list->head.i128, &old_head.i128,
+			&new_head.i128) == 0);
+
+	rte_atomic64_add(&list->len, num);
+}
+
+/*
+ * pop a chain of num elements from a list, copying their objects to
+ * obj_table if not NULL. Return the first element and the last one in
+ * *last, or NULL if the list does not contain enough elements.
+ */
+static __rte_always_inline struct lf_stack_elem *
+lf_stack_pop(struct lf_stack_list *list, unsigned int num,
+		void **obj_table, struct lf_stack_elem **last)
+{
+	union lf_stack_head old_head, new_head;
+	struct lf_stack_elem *tmp;
+	int64_t len;
+	unsigned int i;
+
+	/* reserve num elements, so that they are in the list */
+	do {
+		len = rte_atomic64_read(&list->len);
+		if (unlikely(len < (int64_t)num))
+			return NULL;
+	} while (rte_atomic64_cmpset((volatile uint64_t *)&list->len.cnt,
+			len, len - num) == 0);
+
+	old_head = list->head;
+
+	for (;;) {
+		/* walk the list to find the new head. The elements may be
+		 * popped and pushed by other lcores in the meantime, the
+		 * compare and swap below fails in that case */
+		tmp = old_head.top;
+		for (i = 0; i < num && tmp != NULL; i++) {
+			rte_prefetch0(tmp->next);
+			if (obj_table != NULL)
+				obj_table[i] = tmp->data;
+			*last = tmp;
+			tmp = tmp->next;
+		}
+
+		/* the list was modified while walking it, start again */
+		if (unlikely(i != num)) {
+			old_head = list->head;
+			continue;
+		}
+
+		new_head.top = tmp;
+		new_head.cnt = old_head.cnt + 1;
+
+		if (rte_atomic128_cmp_exchange(&list->head.i128,
+				&old_head.i128, &new_head.i128) != 0)
+			break;
+	}
+
+	return old_head.top;
+}
+
+static int
+lf_stack_alloc(struct rte_mempool *mp)
+{
+	struct rte_mempool_lf_stack *s;
+	unsigned int n = mp->size;
+	unsigned int i;
+	size_t size;
+
+	if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_CMPXCHG16B)) {
+		RTE_LOG(ERR, MEMPOOL,
+			"lf_stack requires 128-bit compare and swap\n");
+		return -ENOTSUP;
+	}
+
+	size = sizeof(*s) + n * sizeof(struct lf_stack_elem);
+
+	/* Allocate our local memory structure */
+	s = rte_zmalloc_socket("mempool-lf-stack",
+			size,
+			RTE_CACHE_LINE_SIZE,
+			mp->socket_id);
+	if (s == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate lf_stack!\n");
+		return -ENOMEM;
+	}
+
+	/* all the elements are initially in the free list */
+	for (i = 0; i < n; i++)
+		s->elems[i].next = (i + 1 < n) ? &s->elems[i + 1] : NULL;
+	s->free.head.top = (n != 0) ? &s->elems[0] : NULL;
+	rte_atomic64_set(&s->free.len, n);
+
+	mp->pool_data = s;
+
+	return 0;
+}
+
+static int
+lf_stack_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+	struct lf_stack_elem *first, *last = NULL, *tmp;
+	unsigned int i;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* Is there sufficient space in the stack ? */
+	first = lf_stack_pop(&s->free, n, NULL, &last);
+	if (unlikely(first == NULL))
+		return -ENOBUFS;
+
+	/* store the objects so that the last one is on top of the stack */
+	for (tmp = first, i = 0; i < n; i++, tmp = tmp->next)
+		tmp->data = obj_table[n - i - 1];
+
+	lf_stack_push(&s->used, first, last, n);
+	return 0;
+}
+
+static int
+lf_stack_dequeue(struct rte_mempool *mp, void **obj_table,
+		unsigned int n)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+	struct lf_stack_elem *first, *last = NULL;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	first = lf_stack_pop(&s->used, n, obj_table, &last);
+	if (unlikely(first == NULL))
+		return -ENOENT;
+
+	lf_stack_push(&s->free, first, last, n);
+	return 0;
+}
+
+static unsigned
+lf_stack_get_count(const struct rte_mempool *mp)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+
+	return (unsigned int)rte_atomic64_read(&s->used.len);
+}
+
+static void
+lf_stack_free(struct rte_mempool *mp)
+{
+	rte_free((void *)(mp->pool_data));
+}
+
+static struct rte_mempool_ops ops_lf_stack = {
+	.name = "lf_stack",
+	.alloc = lf_stack_alloc,
+	.free = lf_stack_free,
+	.enqueue = lf_stack_enqueue,
+	.dequeue = lf_stack_dequeue,
+	.get_count = lf_stack_get_count
+};
+
+MEMPOOL_REGISTER_OPS(ops_lf_stack);
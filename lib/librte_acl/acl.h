@@ -185,6 +185,20 @@ struct rte_acl_bld_trie {
 	struct rte_acl_node *trie;
 };
 
+struct acl_update;
+struct acl_update_rt;
+
+/* quiescent state counter of a reader, 0 while it is offline. */
+struct acl_reader {
+	volatile uint64_t cnt;
+} __rte_cache_aligned;
+
+/* readers of a context, holding back the free of replaced tries. */
+struct acl_readers {
+	volatile uint64_t token;  /* incremented on each update. */
+	struct acl_reader reader[RTE_ACL_MAX_READERS];
+};
+
 struct rte_acl_ctx {
 	char                name[RTE_ACL_NAMESIZE];
 	/** Name of the ACL context. */
@@ -195,6 +209,8 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	struct acl_readers *readers;
+	/* readers of the updated tries, kept across builds. */
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
@@ -206,6 +222,9 @@ struct rte_acl_ctx {
 	void               *mem;
 	size_t              mem_sz;
 	struct rte_acl_config config; /* copy of build config. */
+	struct acl_update  *upd;  /* incremental update state. */
+	struct acl_update_rt *volatile upd_rt;
+	/* tries used by classify once the context has been updated. */
 };
 
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
@@ -215,6 +234,16 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+/*
+ * Incremental updates, see acl_upd.c.
+ */
+void acl_update_free(struct rte_acl_ctx *ctx);
+
+int
+acl_update_classify(const struct acl_update_rt *rt, rte_acl_classify_t fn,
+	const uint8_t **data, uint32_t *results, uint32_t num,
+	uint32_t categories);
+
 /*
  * Different implementations of ACL classify.
  */
@@ -230,6 +259,10 @@ int
 rte_acl_classify_avx2(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
 
+int
+rte_acl_classify_avx512(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
 int
 rte_acl_classify_neon(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
@@ -31,6 +31,7 @@
  *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <pthread.h>
 #include <rte_acl.h>
 #include "tb_mem.h"
 #include "acl.h"
@@ -114,6 +115,34 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* threads rebuilding the split rule sets, NULL if not started. */
+	struct acl_build_workers  *workers;
+};
+
+/*
+ * Rebuild of the rule set of one trie, that can run on a worker thread.
+ * Each job has its own build context, so it doesn't share any memory
+ * with the other tries.
+ */
+struct acl_build_job {
+	struct acl_build_context   bcx;
+	struct rte_acl_build_rule *rules;
+	uint32_t                   n;
+	int32_t                    rc;
+};
+
+/* Worker threads, with the queue of the jobs to run. */
+struct acl_build_workers {
+	pthread_mutex_t      lock;
+	pthread_cond_t       cond;
+	uint32_t             num_threads;
+	uint32_t             head;
+	uint32_t             tail;
+	uint32_t             stop;
+	pthread_t            threads[RTE_ACL_MAX_TRIES];
+	struct acl_build_job *queue[RTE_ACL_MAX_TRIES];
+	struct acl_build_job *jobs[RTE_ACL_MAX_TRIES];
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -795,12 +824,14 @@ acl_merge_trie(struct acl_build_context *context,
 
 /*
  * Reset current runtime fields before next build:
+ *  - drop incremental updates.
  *  - free allocated RT memory.
  *  - reset all RT related fields to zero.
  */
 static void
 acl_build_reset(struct rte_acl_ctx *ctx)
 {
+	acl_update_free(ctx);
 	rte_free(ctx->mem);
 	memset(&ctx->num_categories, 0,
 		sizeof(*ctx) - offsetof(struct rte_acl_ctx, num_categories));
@@ -1300,10 +1331,227 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+/*
+ * Run one rebuild job, in its own build context.
+ */
+static void
+acl_build_job_run(struct acl_build_job *job)
+{
+	int32_t rc;
+	struct rte_acl_build_rule *last;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+
+	/* rebuild runs out of memory. */
+	if (rc != 0) {
+		job->rc = rc;
+		return;
+	}
+
+	rule_sets[job->n] = job->rules;
+	last = build_one_trie(&job->bcx, rule_sets, job->n, INT32_MAX);
+	if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL)
+		job->rc = -ENOMEM;
+	else
+		job->rc = 0;
+}
+
+/*
+ * Get next job from the queue.
+ * If wait is set, block until either a job is queued or workers are stopped.
+ */
+static struct acl_build_job *
+acl_build_job_get(struct acl_build_workers *wrk, int wait)
+{
+	struct acl_build_job *job;
+
+	pthread_mutex_lock(&wrk->lock);
+	while (wait != 0 && wrk->head == wrk->tail && wrk->stop == 0)
+		pthread_cond_wait(&wrk->cond, &wrk->lock);
+
+	job = NULL;
+	if (wrk->head != wrk->tail)
+		job = wrk->queue[wrk->head++];
+	pthread_mutex_unlock(&wrk->lock);
+
+	return job;
+}
+
+static void *
+acl_build_worker(void *arg)
+{
+	struct acl_build_job *job;
+	struct acl_build_workers *wrk;
+
+	wrk = arg;
+	while ((job = acl_build_job_get(wrk, 1)) != NULL)
+		acl_build_job_run(job);
+
+	return NULL;
+}
+
+/*
+ * Start the worker threads: as the calling thread keeps building tries,
+ * (num_threads - 1) of them at most are started.
+ */
+static void
+acl_build_workers_start(struct acl_build_context *context)
+{
+	uint32_t i, n;
+	struct acl_build_workers *wrk;
+
+	wrk = tb_alloc(&context->pool, sizeof(*wrk));
+	pthread_mutex_init(&wrk->lock, NULL);
+	pthread_cond_init(&wrk->cond, NULL);
+
+	n = RTE_MIN(context->cfg.num_threads, (uint32_t)RTE_ACL_MAX_TRIES) - 1;
+	for (i = 0; i != n; i++) {
+		if (pthread_create(wrk->threads + i, NULL, acl_build_worker,
+				wrk) != 0) {
+			RTE_LOG(WARNING, ACL,
+				"ACL context: %s, could only start %u of %u "
+				"build threads\n",
+				context->acx->name, i, n);
+			break;
+		}
+	}
+
+	wrk->num_threads = i;
+	context->workers = wrk;
+}
+
+/*
+ * Wait for all the jobs to complete, running the queued ones in the calling
+ * thread too, then copy their results into the build context.
+ * Tries are always put at the index of their rule set, so the output
+ * doesn't depend on the number of threads or on the order jobs complete in.
+ */
+static int
+acl_build_workers_stop(struct acl_build_context *context)
+{
+	int32_t rc;
+	uint32_t i, n;
+	struct acl_build_job *job;
+	struct acl_build_workers *wrk;
+
+	wrk = context->workers;
+	if (wrk == NULL)
+		return 0;
+
+	pthread_mutex_lock(&wrk->lock);
+	wrk->stop = 1;
+	pthread_cond_broadcast(&wrk->cond);
+	pthread_mutex_unlock(&wrk->lock);
+
+	while ((job = acl_build_job_get(wrk, 0)) != NULL)
+		acl_build_job_run(job);
+
+	for (i = 0; i != wrk->num_threads; i++)
+		pthread_join(wrk->threads[i], NULL);
+
+	pthread_cond_destroy(&wrk->cond);
+	pthread_mutex_destroy(&wrk->lock);
+
+	rc = 0;
+	for (n = 0; n != RTE_DIM(wrk->jobs); n++) {
+
+		job = wrk->jobs[n];
+		if (job == NULL)
+			continue;
+
+		if (job->rc != 0) {
+			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
+			rc = (rc == 0) ? job->rc : rc;
+			continue;
+		}
+
+		context->tries[n] = job->bcx.tries[n];
+		context->bld_tries[n] = job->bcx.bld_tries[n];
+		memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->num_nodes += job->bcx.num_nodes;
+	}
+
+	return rc;
+}
+
+/*
+ * Free memory used by the tries the worker threads built.
+ */
+static void
+acl_build_workers_free(struct acl_build_context *context)
+{
+	uint32_t n;
+	struct acl_build_workers *wrk;
+
+	wrk = context->workers;
+	if (wrk == NULL)
+		return;
+
+	for (n = 0; n != RTE_DIM(wrk->jobs); n++) {
+		if (wrk->jobs[n] != NULL)
+			tb_free_pool(&wrk->jobs[n]->bcx.pool);
+	}
+	context->workers = NULL;
+}
+
+/*
+ * Rebuild the trie for the reduced rule-set.
+ * With more than one build thread, the rebuild is queued for the worker
+ * threads, while the calling thread goes on with the remaining rules.
+ */
+static int
+acl_rebuild_trie(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES], uint32_t n)
+{
+	struct rte_acl_build_rule *last;
+	struct acl_build_job *job;
+	struct acl_build_workers *wrk;
+
+	if (context->cfg.num_threads <= 1) {
+		last = build_one_trie(context, rule_sets, n, INT32_MAX);
+		if (context->bld_tries[n].trie == NULL || last != NULL) {
+			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
+			return -ENOMEM;
+		}
+		return 0;
+	}
+
+	if (context->workers == NULL)
+		acl_build_workers_start(context);
+	wrk = context->workers;
+
+	job = tb_alloc(&context->pool, sizeof(*job));
+	job->bcx.acx = context->acx;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->bcx.cfg.num_categories = context->cfg.num_categories;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = INT32_MAX;
+	job->rules = rule_sets[n];
+	job->n = n;
+
+	/* trie will be filled in when the job completes. */
+	context->tries[n].type = RTE_ACL_UNUSED_TRIE;
+	context->bld_tries[n].trie = NULL;
+	context->tries[n].count = 0;
+
+	pthread_mutex_lock(&wrk->lock);
+	wrk->jobs[n] = job;
+	wrk->queue[wrk->tail++] = job;
+	pthread_cond_signal(&wrk->cond);
+	pthread_mutex_unlock(&wrk->lock);
+
+	return 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
+	int32_t rc;
 	uint32_t n, num_tries;
 	struct rte_acl_config *config;
 	struct rte_acl_build_rule *last;
@@ -1363,12 +1611,9 @@ acl_build_tries(struct acl_build_context *context,
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
 		 */
-		last = build_one_trie(context, rule_sets, n, INT32_MAX);
-		if (context->bld_tries[n].trie == NULL || last != NULL) {
-			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
-			return -ENOMEM;
-		}
-
+		rc = acl_rebuild_trie(context, rule_sets, n);
+		if (rc != 0)
+			return rc;
 	}
 
 	context->num_tries = num_tries;
@@ -1466,7 +1711,7 @@ static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	const struct rte_acl_config *cfg, uint32_t node_max)
 {
-	int32_t rc;
+	int32_t rc, rcw;
 
 	/* setup build context. */
 	memset(bcx, 0, sizeof(*bcx));
@@ -1482,6 +1727,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 
 	/* build phase runs out of memory. */
 	if (rc != 0) {
+		acl_build_workers_stop(bcx);
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
@@ -1499,6 +1745,10 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	} else {
 		/* build internal trie representation. */
 		rc = acl_build_tries(bcx, bcx->build_rules);
+
+		/* collect tries built by worker threads. */
+		rcw = acl_build_workers_stop(bcx);
+		rc = (rc == 0) ? rcw : rc;
 	}
 	return rc;
 }
@@ -1591,6 +1841,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
+		acl_build_workers_free(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
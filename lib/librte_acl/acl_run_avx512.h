@@ -0,0 +1,344 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "acl_run_avx2.h"
+
+static const rte_zmm_t zmm_match_mask = {
+	.u32 = {
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH, RTE_ACL_NODE_MATCH,
+	},
+};
+
+static const rte_zmm_t zmm_index_mask = {
+	.u32 = {
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX, RTE_ACL_NODE_INDEX,
+	},
+};
+
+static const rte_zmm_t zmm_shuffle_input = {
+	.u32 = {
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+	},
+};
+
+static const rte_zmm_t zmm_ones_16 = {
+	.u16 = {
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	},
+};
+
+static const rte_zmm_t zmm_range_base = {
+	.u32 = {
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+	},
+};
+
+/* Indexes of low and high 32 bits of 16 transitions in 2 ZMM registers. */
+static const rte_zmm_t zmm_pmidx_lo = {
+	.u32 = {
+		0, 2, 4, 6, 8, 10, 12, 14,
+		16, 18, 20, 22, 24, 26, 28, 30,
+	},
+};
+
+static const rte_zmm_t zmm_pmidx_hi = {
+	.u32 = {
+		1, 3, 5, 7, 9, 11, 13, 15,
+		17, 19, 21, 23, 25, 27, 29, 31,
+	},
+};
+
+/*
+ * Calculate the address of the next transition for 16 flows,
+ * same as ACL_TR_CALC_ADDR(), but with AVX512 mask registers
+ * used instead of the blend and sign instructions.
+ */
+static __rte_always_inline zmm_t
+calc_addr16(zmm_t next_input, zmm_t tr_lo, zmm_t tr_hi)
+{
+	__mmask16 dfa_msk;
+	__mmask64 qrange_msk;
+	zmm_t addr, in, node_type, r, t, dfa_ofs, quad_ofs;
+
+	in = _mm512_shuffle_epi8(next_input, zmm_shuffle_input.z);
+
+	/* Calc node type and node addr */
+	node_type = _mm512_andnot_si512(zmm_index_mask.z, tr_lo);
+	addr = _mm512_and_si512(zmm_index_mask.z, tr_lo);
+
+	/* mask for DFA type(0) nodes */
+	dfa_msk = _mm512_testn_epi32_mask(node_type, node_type);
+
+	/* DFA calculations. */
+	r = _mm512_srli_epi32(in, 30);
+	r = _mm512_add_epi8(r, zmm_range_base.z);
+	t = _mm512_srli_epi32(in, 24);
+	r = _mm512_shuffle_epi8(tr_hi, r);
+
+	dfa_ofs = _mm512_sub_epi32(t, r);
+
+	/* QUAD/SINGLE calculations: count boundaries less than input. */
+	qrange_msk = _mm512_cmpgt_epi8_mask(in, tr_hi);
+	t = _mm512_maskz_mov_epi8(qrange_msk, _mm512_set1_epi8(1));
+	t = _mm512_maddubs_epi16(t, t);
+	quad_ofs = _mm512_madd_epi16(t, zmm_ones_16.z);
+
+	/* blend DFA and QUAD/SINGLE. */
+	t = _mm512_mask_mov_epi32(quad_ofs, dfa_msk, dfa_ofs);
+
+	/* calculate address for next transitions. */
+	return _mm512_add_epi32(addr, t);
+}
+
+/*
+ * Split 16 transitions from 2 ZMM registers:
+ * low 32 bits of each transition into tr_lo and high 32 bits into tr_hi.
+ */
+#define	ACL_TR_HILO_AVX512(t0, t1, tr_lo, tr_hi)	do { \
+	tr_lo = _mm512_permutex2var_epi32(t0, zmm_pmidx_lo.z, t1); \
+	tr_hi = _mm512_permutex2var_epi32(t0, zmm_pmidx_hi.z, t1); \
+} while (0)
+
+/*
+ * Process 16 transitions in parallel.
+ * tr_lo contains low 32 bits for 16 transitions.
+ * tr_hi contains high 32 bits for 16 transitions.
+ * next_input contains up to 4 input bytes for 16 flows.
+ * Only transitions for the active flows are gathered:
+ * idle ones keep pointing to the idle node.
+ */
+static __rte_always_inline zmm_t
+transition16(zmm_t next_input, const uint64_t *trans, __mmask16 active,
+	zmm_t *tr_lo, zmm_t *tr_hi)
+{
+	const int32_t *tr;
+	zmm_t addr;
+
+	tr = (const int32_t *)(uintptr_t)trans;
+
+	/* Calculate the address (array index) for all 16 transitions. */
+	addr = calc_addr16(next_input, *tr_lo, *tr_hi);
+
+	/* load lower 32 bits of 16 transitions at once. */
+	*tr_lo = _mm512_mask_i32gather_epi32(*tr_lo, active, addr, tr,
+		sizeof(trans[0]));
+
+	next_input = _mm512_srli_epi32(next_input, CHAR_BIT);
+
+	/* load high 32 bits of 16 transitions at once. */
+	*tr_hi = _mm512_mask_i32gather_epi32(*tr_hi, active, addr, (tr + 1),
+		sizeof(trans[0]));
+
+	return next_input;
+}
+
+/*
+ * Check for matches in 16 flows, and replace each completed trie traversal
+ * with the next one. Flows that run out of tries are removed from
+ * the active mask.
+ */
+static inline void
+acl_match_check_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	zmm_t *tr_lo, zmm_t *tr_hi, __mmask16 *active)
+{
+	uint32_t i;
+	uint64_t tr;
+	__mmask16 msk;
+	rte_zmm_t lo, hi;
+
+	/* test for match node */
+	msk = _mm512_test_epi32_mask(*tr_lo, zmm_match_mask.z);
+	if (msk == 0)
+		return;
+
+	lo.z = *tr_lo;
+	hi.z = *tr_hi;
+
+	do {
+		i = rte_bsf32(msk);
+		msk &= msk - 1;
+
+		tr = (uint64_t)hi.u32[i] << 32 | lo.u32[i];
+		do {
+			tr = acl_match_check(tr, slot + i, ctx, parms, flows,
+				resolve_priority_sse);
+		} while (tr & RTE_ACL_NODE_MATCH);
+
+		lo.u32[i] = (uint32_t)tr;
+		hi.u32[i] = tr >> 32;
+
+		if (parms[slot + i].data == (const uint8_t *)idle)
+			*active &= ~(1 << i);
+	} while (msk != 0);
+
+	*tr_lo = lo.z;
+	*tr_hi = hi.z;
+}
+
+/*
+ * Gather 4 bytes of input data for 16 flows.
+ */
+static __rte_always_inline zmm_t
+acl_next_input_avx512x16(struct parms *parms)
+{
+	xmm_t in[4];
+	ymm_t t0, t1;
+
+	in[0] = _mm_cvtsi32_si128(GET_NEXT_4BYTES(parms, 0));
+	in[1] = _mm_cvtsi32_si128(GET_NEXT_4BYTES(parms, 4));
+	in[2] = _mm_cvtsi32_si128(GET_NEXT_4BYTES(parms, 8));
+	in[3] = _mm_cvtsi32_si128(GET_NEXT_4BYTES(parms, 12));
+
+	in[0] = _mm_insert_epi32(in[0], GET_NEXT_4BYTES(parms, 1), 1);
+	in[1] = _mm_insert_epi32(in[1], GET_NEXT_4BYTES(parms, 5), 1);
+	in[2] = _mm_insert_epi32(in[2], GET_NEXT_4BYTES(parms, 9), 1);
+	in[3] = _mm_insert_epi32(in[3], GET_NEXT_4BYTES(parms, 13), 1);
+
+	in[0] = _mm_insert_epi32(in[0], GET_NEXT_4BYTES(parms, 2), 2);
+	in[1] = _mm_insert_epi32(in[1], GET_NEXT_4BYTES(parms, 6), 2);
+	in[2] = _mm_insert_epi32(in[2], GET_NEXT_4BYTES(parms, 10), 2);
+	in[3] = _mm_insert_epi32(in[3], GET_NEXT_4BYTES(parms, 14), 2);
+
+	in[0] = _mm_insert_epi32(in[0], GET_NEXT_4BYTES(parms, 3), 3);
+	in[1] = _mm_insert_epi32(in[1], GET_NEXT_4BYTES(parms, 7), 3);
+	in[2] = _mm_insert_epi32(in[2], GET_NEXT_4BYTES(parms, 11), 3);
+	in[3] = _mm_insert_epi32(in[3], GET_NEXT_4BYTES(parms, 15), 3);
+
+	t0 = _mm256_inserti128_si256(_mm256_castsi128_si256(in[0]), in[1], 1);
+	t1 = _mm256_inserti128_si256(_mm256_castsi128_si256(in[2]), in[3], 1);
+
+	return _mm512_inserti64x4(_mm512_castsi256_si512(t0), t1, 1);
+}
+
+/*
+ * Execute trie traversal for up to 32 flows in parallel,
+ * 16 flows per ZMM register.
+ */
+static inline int
+search_avx512x32(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	uint64_t index_array[MAX_SEARCHES_AVX32];
+	struct completion cmplt[MAX_SEARCHES_AVX32];
+	struct parms parms[MAX_SEARCHES_AVX32];
+	zmm_t input[2], tr_lo[2], tr_hi[2];
+	zmm_t t0, t1;
+	__mmask16 active[2];
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	active[0] = 0;
+	active[1] = 0;
+	for (n = 0; n < RTE_DIM(cmplt); n++) {
+		cmplt[n].count = 0;
+		index_array[n] = acl_start_next_trie(&flows, parms, n, ctx);
+		if (parms[n].data != (const uint8_t *)idle)
+			active[n / MAX_SEARCHES_AVX16] |=
+				1 << (n % MAX_SEARCHES_AVX16);
+	}
+
+	t0 = _mm512_loadu_si512(index_array);
+	t1 = _mm512_loadu_si512(index_array + 8);
+	ACL_TR_HILO_AVX512(t0, t1, tr_lo[0], tr_hi[0]);
+
+	t0 = _mm512_loadu_si512(index_array + 16);
+	t1 = _mm512_loadu_si512(index_array + 24);
+	ACL_TR_HILO_AVX512(t0, t1, tr_lo[1], tr_hi[1]);
+
+	 /* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, &flows, 0,
+		&tr_lo[0], &tr_hi[0], &active[0]);
+	acl_match_check_avx512x16(ctx, parms, &flows, MAX_SEARCHES_AVX16,
+		&tr_lo[1], &tr_hi[1], &active[1]);
+
+	while (flows.started > 0) {
+
+		/* Gather 4 bytes of input data for all 32 flows. */
+		input[0] = acl_next_input_avx512x16(parms);
+		input[1] = acl_next_input_avx512x16(parms +
+			MAX_SEARCHES_AVX16);
+
+		input[0] = transition16(input[0], flows.trans, active[0],
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans, active[1],
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans, active[0],
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans, active[1],
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans, active[0],
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans, active[1],
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans, active[0],
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans, active[1],
+			&tr_lo[1], &tr_hi[1]);
+
+		 /* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0,
+			&tr_lo[0], &tr_hi[0], &active[0]);
+		acl_match_check_avx512x16(ctx, parms, &flows,
+			MAX_SEARCHES_AVX16, &tr_lo[1], &tr_hi[1], &active[1]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,881 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rte_acl.h>
+#include <rte_atomic.h>
+#include "acl.h"
+
+/*
+ * Incremental updates.
+ *
+ * The trie built by rte_acl_build() (or by the last compaction) is kept
+ * as the main trie, and the rules added or deleted since then are the
+ * dirty rules. Next to it a small delta trie is built from:
+ *  - one marker per dirty rule, with the lowest priority and all the
+ *    categories, so that any input within a dirty rule matches in delta;
+ *  - the intersections of every live rule with every dirty rule it
+ *    overlaps, with the priority order of the live rules.
+ * An input matching no dirty rule gets no result from the delta trie, and
+ * the same results from the main trie as from a full rebuild. An input
+ * matching a dirty rule gets at least one result from the delta trie (as
+ * a rule has priority 0 in the categories it is not in, the marker may
+ * be hidden in those). It can only match live rules overlapping the dirty
+ * rule, so the delta trie has all of them and its results are the ones
+ * of a full rebuild.
+ * Each update builds a new delta trie and publishes it with the main
+ * one through a single pointer, so classify keeps running meanwhile.
+ * The tries it replaces are queued with the current token, and freed by
+ * a later update once every registered reader reported a quiescent
+ * state past that token.
+ */
+
+/* delta trie userdata of the markers, live rules start after it. */
+#define ACL_UPD_MARKER		1
+#define ACL_UPD_USERDATA_BASE	2
+
+/* number of inputs classified at once over the delta trie. */
+#define ACL_UPD_BURST		64
+
+struct acl_update_rt {
+	const struct rte_acl_ctx *main;  /* trie of the compacted rules. */
+	struct rte_acl_ctx *delta;       /* trie of the dirty rules. */
+	uint32_t *userdata;              /* userdata of the delta live rules. */
+	uint32_t num_categories;         /* categories of the tries. */
+	uint32_t categories;             /* categories to classify delta. */
+};
+
+/* tries replaced by an update, waiting for the readers. */
+struct acl_update_retired {
+	struct acl_update_retired *next;
+	struct acl_update_rt *rt;
+	struct rte_acl_ctx *main;        /* replaced by a compaction. */
+	uint64_t token;                  /* token the readers have to reach. */
+};
+
+struct acl_update {
+	struct rte_acl_ctx *main;        /* NULL if there are no rules. */
+	struct acl_update_retired *retired_head;  /* oldest one first. */
+	struct acl_update_retired *retired_tail;
+	uint32_t num_dirty;
+	uint32_t max_dirty;
+	uint8_t *dirty;                  /* rules added or deleted since. */
+	uint32_t num_pairs;
+	uint32_t max_pairs;
+	int32_t pairs_stale;             /* pairs to compute again. */
+	uint8_t *pairs;
+	/*
+	 * live rules restricted to the dirty ones, each one followed by the
+	 * live rule itself.
+	 */
+};
+
+#define	ACL_UPD_PAIR(ctx, n)	\
+	((ctx)->upd->pairs + (size_t)(n) * 2 * (ctx)->rule_sz)
+
+/*
+ * Allocates a context which is not registered in the ACL list, to hold
+ * the rules and the run-time structures of one trie.
+ */
+static struct rte_acl_ctx *
+acl_update_ctx_alloc(const struct rte_acl_ctx *ctx, const char *sfx,
+	uint32_t max_rules)
+{
+	struct rte_acl_ctx *nc;
+
+	nc = rte_zmalloc_socket(ctx->name,
+		sizeof(*nc) + (size_t)max_rules * ctx->rule_sz,
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (nc == NULL)
+		return NULL;
+
+	nc->rules = nc + 1;
+	nc->max_rules = max_rules;
+	nc->rule_sz = ctx->rule_sz;
+	nc->socket_id = ctx->socket_id;
+	nc->alg = ctx->alg;
+	snprintf(nc->name, sizeof(nc->name), "%s%s", ctx->name, sfx);
+	return nc;
+}
+
+static void
+acl_update_ctx_free(struct rte_acl_ctx *ctx, struct rte_acl_ctx *nc)
+{
+	if (nc == NULL)
+		return;
+
+	/* the first main trie is the one of the context itself. */
+	if (nc == ctx) {
+		rte_free(ctx->mem);
+		ctx->mem = NULL;
+		ctx->trans_table = NULL;
+		return;
+	}
+
+	rte_free(nc->mem);
+	rte_free(nc);
+}
+
+static void
+acl_update_rt_free(struct rte_acl_ctx *ctx, struct acl_update_rt *rt)
+{
+	if (rt == NULL)
+		return;
+
+	acl_update_ctx_free(ctx, rt->delta);
+	rte_free(rt->userdata);
+	rte_free(rt);
+}
+
+/*
+ * Frees the tries no registered reader can still be walking, i.e. those
+ * replaced before every online reader last reported a quiescent state.
+ * Without online reader, all of them are freed.
+ */
+static void
+acl_update_reclaim(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd = ctx->upd;
+	struct acl_update_retired *ret;
+	uint64_t min_cnt = UINT64_MAX, cnt;
+	uint32_t i;
+
+	if (upd->retired_head == NULL)
+		return;
+
+	for (i = 0; i != RTE_DIM(ctx->readers->reader); i++) {
+		cnt = ctx->readers->reader[i].cnt;
+		if (cnt != 0 && cnt < min_cnt)
+			min_cnt = cnt;
+	}
+
+	while (upd->retired_head != NULL) {
+		ret = upd->retired_head;
+		if (ret->token > min_cnt)
+			break;
+
+		upd->retired_head = ret->next;
+		acl_update_rt_free(ctx, ret->rt);
+		acl_update_ctx_free(ctx, ret->main);
+		rte_free(ret);
+	}
+	if (upd->retired_head == NULL)
+		upd->retired_tail = NULL;
+}
+
+/*
+ * Publishes a new run-time, and queues the one it replaces. The queued
+ * tries are only reclaimed before that, so without registered readers
+ * the tries replaced now are kept until the next update, and a classify
+ * call that loaded them is safe as long as it returns before the next
+ * update starts.
+ * Returns -ENOMEM, publishing nothing, if the queue entry can't be
+ * allocated.
+ */
+static int
+acl_update_publish(struct rte_acl_ctx *ctx, struct acl_update_rt *rt,
+	struct rte_acl_ctx *old_main)
+{
+	struct acl_update *upd = ctx->upd;
+	struct acl_update_retired *ret;
+
+	ret = rte_zmalloc_socket(ctx->name, sizeof(*ret), 0, ctx->socket_id);
+	if (ret == NULL)
+		return -ENOMEM;
+
+	acl_update_reclaim(ctx);
+
+	ret->rt = ctx->upd_rt;
+	ret->main = old_main;
+
+	rte_smp_wmb();
+	ctx->upd_rt = rt;
+
+	/*
+	 * Readers may still be walking the replaced tries, keep them until
+	 * all of them report a quiescent state after this point.
+	 */
+	rte_smp_wmb();
+	ret->token = ++ctx->readers->token;
+	if (upd->retired_tail != NULL)
+		upd->retired_tail->next = ret;
+	else
+		upd->retired_head = ret;
+	upd->retired_tail = ret;
+	return 0;
+}
+
+void
+acl_update_free(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd = ctx->upd;
+	struct acl_update_retired *ret;
+
+	if (upd == NULL)
+		return;
+
+	while (upd->retired_head != NULL) {
+		ret = upd->retired_head;
+		upd->retired_head = ret->next;
+		acl_update_rt_free(ctx, ret->rt);
+		acl_update_ctx_free(ctx, ret->main);
+		rte_free(ret);
+	}
+	acl_update_rt_free(ctx, ctx->upd_rt);
+	if (upd->main != ctx)
+		acl_update_ctx_free(ctx, upd->main);
+
+	rte_free(upd->pairs);
+	rte_free(upd->dirty);
+	rte_free(upd);
+	ctx->upd = NULL;
+	ctx->upd_rt = NULL;
+}
+
+static int
+acl_update_init(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd;
+	struct acl_update_rt *rt;
+
+	if (ctx->upd != NULL)
+		return 0;
+
+	/* updates apply on top of a built context. */
+	if (ctx->trans_table == NULL)
+		return -EINVAL;
+
+	upd = rte_zmalloc_socket(ctx->name, sizeof(*upd), 0, ctx->socket_id);
+	rt = rte_zmalloc_socket(ctx->name, sizeof(*rt), 0, ctx->socket_id);
+	if (upd != NULL)
+		upd->dirty = rte_malloc_socket(ctx->name,
+			(size_t)ctx->max_rules * ctx->rule_sz, 0,
+			ctx->socket_id);
+	if (upd == NULL || rt == NULL || upd->dirty == NULL) {
+		if (upd != NULL)
+			rte_free(upd->dirty);
+		rte_free(upd);
+		rte_free(rt);
+		return -ENOMEM;
+	}
+
+	upd->main = ctx;
+	upd->max_dirty = ctx->max_rules;
+	rt->main = ctx;
+
+	ctx->upd = upd;
+	ctx->upd_rt = rt;
+	return 0;
+}
+
+static uint64_t
+acl_field_get(const union rte_acl_field_types *v, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+static void
+acl_field_set(union rte_acl_field_types *v, uint32_t size, uint64_t val)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		v->u8 = val;
+		break;
+	case sizeof(uint16_t):
+		v->u16 = val;
+		break;
+	case sizeof(uint32_t):
+		v->u32 = val;
+		break;
+	default:
+		v->u64 = val;
+	}
+}
+
+/*
+ * Restricts field f to the values it shares with field d.
+ * Returns zero if they have no value in common.
+ */
+static int
+acl_field_intersect(const struct rte_acl_field_def *def,
+	struct rte_acl_field *f, const struct rte_acl_field *d)
+{
+	uint64_t v1, v2, m1, m2, msk;
+
+	v1 = acl_field_get(&f->value, def->size);
+	v2 = acl_field_get(&d->value, def->size);
+
+	switch (def->type) {
+	case RTE_ACL_FIELD_TYPE_MASK:
+		/* prefixes overlap if the shortest one covers the other. */
+		m1 = f->mask_range.u32;
+		m2 = d->mask_range.u32;
+		msk = RTE_ACL_MASKLEN_TO_BITMASK(RTE_MIN(m1, m2), def->size);
+		if (((v1 ^ v2) & msk) != 0)
+			return 0;
+		if (m2 > m1)
+			*f = *d;
+		break;
+
+	case RTE_ACL_FIELD_TYPE_RANGE:
+		m1 = acl_field_get(&f->mask_range, def->size);
+		m2 = acl_field_get(&d->mask_range, def->size);
+		v1 = RTE_MAX(v1, v2);
+		m1 = RTE_MIN(m1, m2);
+		if (v1 > m1)
+			return 0;
+		acl_field_set(&f->value, def->size, v1);
+		acl_field_set(&f->mask_range, def->size, m1);
+		break;
+
+	default:
+		m1 = acl_field_get(&f->mask_range, def->size);
+		m2 = acl_field_get(&d->mask_range, def->size);
+		if (((v1 ^ v2) & m1 & m2) != 0)
+			return 0;
+		acl_field_set(&f->value, def->size, (v1 & m1) | (v2 & m2));
+		acl_field_set(&f->mask_range, def->size, m1 | m2);
+	}
+
+	return 1;
+}
+
+/*
+ * Copies rule r restricted to dirty rule d into nr.
+ * Returns zero if they do not overlap.
+ */
+static int
+acl_rule_intersect(const struct rte_acl_config *cfg,
+	struct rte_acl_rule *nr, const struct rte_acl_rule *r,
+	const struct rte_acl_rule *d, uint32_t rule_sz)
+{
+	uint32_t i, n;
+
+	memcpy(nr, r, rule_sz);
+	for (i = 0; i != cfg->num_fields; i++) {
+		n = cfg->defs[i].field_index;
+		if (acl_field_intersect(cfg->defs + i, nr->field + n,
+				d->field + n) == 0)
+			return 0;
+	}
+	return 1;
+}
+
+static int
+acl_priority_cmp(const void *a, const void *b)
+{
+	int32_t pa = *(const int32_t *)a;
+	int32_t pb = *(const int32_t *)b;
+
+	return (pa > pb) - (pa < pb);
+}
+
+/*
+ * Appends the pairs of the dirty rules d and the live rules l which
+ * overlap.
+ */
+static int
+acl_update_pairs_add(struct rte_acl_ctx *ctx, const uint8_t *d,
+	uint32_t num_d, const uint8_t *l, uint32_t num_l)
+{
+	struct acl_update *upd = ctx->upd;
+	struct rte_acl_rule *nr;
+	uint8_t *pairs;
+	uint32_t i, j, n;
+
+	for (i = 0; i != num_d; i++) {
+		for (j = 0; j != num_l; j++) {
+			if (upd->num_pairs == upd->max_pairs) {
+				n = RTE_MAX(2 * upd->max_pairs, 64U);
+				pairs = rte_realloc(upd->pairs,
+					(size_t)n * 2 * ctx->rule_sz, 0);
+				if (pairs == NULL)
+					return -ENOMEM;
+				upd->pairs = pairs;
+				upd->max_pairs = n;
+			}
+
+			nr = (struct rte_acl_rule *)
+				ACL_UPD_PAIR(ctx, upd->num_pairs);
+			if (acl_rule_intersect(&ctx->config, nr,
+					(const struct rte_acl_rule *)
+					(l + j * ctx->rule_sz),
+					(const struct rte_acl_rule *)
+					(d + i * ctx->rule_sz),
+					ctx->rule_sz) == 0)
+				continue;
+
+			memcpy((uint8_t *)nr + ctx->rule_sz,
+				l + j * ctx->rule_sz, ctx->rule_sz);
+			upd->num_pairs++;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Removes the pairs of the deleted live rules.
+ */
+static void
+acl_update_pairs_del(struct rte_acl_ctx *ctx, const uint8_t *rules,
+	uint32_t num)
+{
+	struct acl_update *upd = ctx->upd;
+	const uint8_t *r;
+	uint32_t i, j;
+
+	for (i = 0; i != upd->num_pairs; ) {
+		r = ACL_UPD_PAIR(ctx, i) + ctx->rule_sz;
+		for (j = 0; j != num &&
+				memcmp(r, rules + j * ctx->rule_sz,
+				ctx->rule_sz) != 0; j++)
+			;
+		if (j == num) {
+			i++;
+			continue;
+		}
+		upd->num_pairs--;
+		memcpy(ACL_UPD_PAIR(ctx, i), ACL_UPD_PAIR(ctx, upd->num_pairs),
+			2 * ctx->rule_sz);
+	}
+}
+
+/*
+ * Computes all the pairs again, after an update failed halfway.
+ */
+static int
+acl_update_pairs_reset(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd = ctx->upd;
+	int32_t rc;
+
+	upd->num_pairs = 0;
+	rc = acl_update_pairs_add(ctx, upd->dirty, upd->num_dirty,
+		ctx->rules, ctx->num_rules);
+	upd->pairs_stale = (rc != 0);
+	return rc;
+}
+
+/*
+ * Builds the delta trie of the current dirty rules, and publishes it.
+ */
+static int
+acl_update_delta(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd = ctx->upd;
+	struct acl_update_rt *rt;
+	struct rte_acl_ctx *delta;
+	struct rte_acl_rule *nr;
+	int32_t *prio, *p;
+	uint32_t i, num, num_prio;
+	int32_t rc;
+
+	if (upd->pairs_stale) {
+		rc = acl_update_pairs_reset(ctx);
+		if (rc != 0)
+			return rc;
+	}
+
+	num = upd->num_pairs;
+	rt = rte_zmalloc_socket(ctx->name, sizeof(*rt), 0, ctx->socket_id);
+	delta = NULL;
+	if (upd->num_dirty != 0)
+		delta = acl_update_ctx_alloc(ctx, "_delta",
+			upd->num_dirty + num);
+	prio = rte_malloc(NULL, (num + 1) * sizeof(prio[0]), 0);
+	if (rt != NULL)
+		rt->userdata = rte_malloc_socket(ctx->name,
+			(num + 1) * sizeof(rt->userdata[0]), 0,
+			ctx->socket_id);
+	if (rt == NULL || (delta == NULL && upd->num_dirty != 0) ||
+			prio == NULL || rt->userdata == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	if (delta != NULL) {
+		/* markers of the dirty rules. */
+		for (i = 0; i != upd->num_dirty; i++) {
+			nr = (struct rte_acl_rule *)((uintptr_t)delta->rules +
+				i * ctx->rule_sz);
+			memcpy(nr, upd->dirty + i * ctx->rule_sz,
+				ctx->rule_sz);
+			nr->data.category_mask = RTE_LEN2MASK(
+				ctx->config.num_categories, uint32_t);
+			nr->data.priority = RTE_ACL_MIN_PRIORITY;
+			nr->data.userdata = ACL_UPD_MARKER;
+		}
+
+		/* live rules restricted to the dirty ones. */
+		for (i = 0; i != num; i++) {
+			nr = (struct rte_acl_rule *)((uintptr_t)delta->rules +
+				(upd->num_dirty + i) * ctx->rule_sz);
+			memcpy(nr, ACL_UPD_PAIR(ctx, i), ctx->rule_sz);
+			rt->userdata[i] = nr->data.userdata;
+			nr->data.userdata = ACL_UPD_USERDATA_BASE + i;
+			prio[i] = nr->data.priority;
+		}
+
+		/*
+		 * Rank the priorities from 1, so that every live rule wins
+		 * over the markers while keeping their order.
+		 */
+		qsort(prio, num, sizeof(prio[0]), acl_priority_cmp);
+		for (i = 0, num_prio = 0; i != num; i++)
+			if (num_prio == 0 || prio[num_prio - 1] != prio[i])
+				prio[num_prio++] = prio[i];
+
+		for (i = 0; i != num; i++) {
+			nr = (struct rte_acl_rule *)((uintptr_t)delta->rules +
+				(upd->num_dirty + i) * ctx->rule_sz);
+			p = bsearch(&nr->data.priority, prio, num_prio,
+				sizeof(prio[0]), acl_priority_cmp);
+			nr->data.priority = p - prio + 1;
+		}
+
+		delta->num_rules = upd->num_dirty + num;
+		rc = rte_acl_build(delta, &ctx->config);
+		if (rc != 0)
+			goto err;
+	}
+
+	rt->main = upd->main;
+	rt->delta = delta;
+	rt->num_categories = ctx->config.num_categories;
+	rt->categories = (rt->num_categories == 1) ? 1 :
+		RTE_ALIGN_CEIL(rt->num_categories, RTE_ACL_RESULTS_MULTIPLIER);
+	rc = acl_update_publish(ctx, rt, NULL);
+	if (rc != 0)
+		goto err;
+
+	rte_free(prio);
+	return 0;
+
+err:
+	rte_free(prio);
+	acl_update_ctx_free(ctx, delta);
+	if (rt != NULL)
+		rte_free(rt->userdata);
+	rte_free(rt);
+	return rc;
+}
+
+/*
+ * Add rules to a built context, see rte_acl.h.
+ */
+int
+rte_acl_update_add(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	struct acl_update *upd;
+	const uint8_t *added;
+	uint32_t num_dirty;
+	int32_t rc;
+
+	if (ctx == NULL || rules == NULL)
+		return -EINVAL;
+
+	rc = acl_update_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	upd = ctx->upd;
+	if (num > upd->max_dirty - upd->num_dirty)
+		return -ENOSPC;
+
+	/* checks and appends the rules to the live ones. */
+	rc = rte_acl_add_rules(ctx, rules, num);
+	if (rc != 0)
+		return rc;
+
+	added = (const uint8_t *)ctx->rules + (ctx->num_rules - num) *
+		ctx->rule_sz;
+	num_dirty = upd->num_dirty;
+	memcpy(upd->dirty + num_dirty * ctx->rule_sz, rules,
+		num * ctx->rule_sz);
+	upd->num_dirty += num;
+
+	/* new rules within the dirty ones, all the rules within new ones. */
+	rc = acl_update_pairs_add(ctx, upd->dirty, num_dirty, added, num);
+	if (rc == 0)
+		rc = acl_update_pairs_add(ctx,
+			upd->dirty + num_dirty * ctx->rule_sz, num,
+			ctx->rules, ctx->num_rules);
+	if (rc == 0)
+		rc = acl_update_delta(ctx);
+
+	if (rc != 0) {
+		upd->num_dirty -= num;
+		ctx->num_rules -= num;
+		acl_update_pairs_reset(ctx);
+	}
+	return rc;
+}
+
+static int32_t
+acl_rule_find(const struct rte_acl_ctx *ctx, const void *rule)
+{
+	uint32_t i;
+
+	for (i = 0; i != ctx->num_rules; i++)
+		if (memcmp((const uint8_t *)ctx->rules + i * ctx->rule_sz,
+				rule, ctx->rule_sz) == 0)
+			return i;
+	return -ENOENT;
+}
+
+/*
+ * Delete rules from a built context, see rte_acl.h.
+ */
+int
+rte_acl_update_del(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	struct acl_update *upd;
+	uint8_t *live, *dirty;
+	int32_t rc, n;
+	uint32_t i, num_del;
+
+	if (ctx == NULL || rules == NULL)
+		return -EINVAL;
+
+	rc = acl_update_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	upd = ctx->upd;
+	if (num > upd->max_dirty - upd->num_dirty)
+		return -ENOSPC;
+
+	for (i = 0; i != num; i++)
+		if (acl_rule_find(ctx, (const uint8_t *)rules +
+				i * ctx->rule_sz) < 0)
+			return -ENOENT;
+
+	/* move the last live rule in place of each deleted one. */
+	live = ctx->rules;
+	dirty = upd->dirty + upd->num_dirty * ctx->rule_sz;
+	num_del = 0;
+	for (i = 0; i != num; i++) {
+		n = acl_rule_find(ctx, (const uint8_t *)rules +
+			i * ctx->rule_sz);
+		/* same rule given twice. */
+		if (n < 0)
+			continue;
+		memcpy(dirty + num_del++ * ctx->rule_sz,
+			live + n * ctx->rule_sz, ctx->rule_sz);
+		ctx->num_rules--;
+		memmove(live + n * ctx->rule_sz,
+			live + ctx->num_rules * ctx->rule_sz, ctx->rule_sz);
+	}
+	upd->num_dirty += num_del;
+
+	/* forget the deleted rules, all the rules within deleted ones. */
+	acl_update_pairs_del(ctx, dirty, num_del);
+	rc = acl_update_pairs_add(ctx, dirty, num_del, ctx->rules,
+		ctx->num_rules);
+	if (rc == 0)
+		rc = acl_update_delta(ctx);
+
+	if (rc != 0) {
+		/* put the deleted rules back. */
+		upd->num_dirty -= num_del;
+		memcpy(live + ctx->num_rules * ctx->rule_sz, dirty,
+			num_del * ctx->rule_sz);
+		ctx->num_rules += num_del;
+		acl_update_pairs_reset(ctx);
+	}
+	return rc;
+}
+
+/*
+ * Rebuild the main trie from the live rules, see rte_acl.h.
+ */
+int
+rte_acl_update_compact(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd;
+	struct acl_update_rt *rt;
+	struct rte_acl_ctx *nmain;
+	int32_t rc;
+
+	if (ctx == NULL)
+		return -EINVAL;
+
+	upd = ctx->upd;
+	if (upd == NULL || upd->num_dirty == 0)
+		return 0;
+
+	rt = rte_zmalloc_socket(ctx->name, sizeof(*rt), 0, ctx->socket_id);
+	if (rt == NULL)
+		return -ENOMEM;
+
+	/* no rule left: every input misses. */
+	nmain = NULL;
+	if (ctx->num_rules != 0) {
+		nmain = acl_update_ctx_alloc(ctx, "_main", ctx->num_rules);
+		if (nmain == NULL) {
+			rte_free(rt);
+			return -ENOMEM;
+		}
+		memcpy(nmain->rules, ctx->rules,
+			(size_t)ctx->num_rules * ctx->rule_sz);
+		nmain->num_rules = ctx->num_rules;
+
+		rc = rte_acl_build(nmain, &ctx->config);
+		if (rc != 0) {
+			acl_update_ctx_free(ctx, nmain);
+			rte_free(rt);
+			return rc;
+		}
+	}
+
+	rt->main = nmain;
+	rc = acl_update_publish(ctx, rt, upd->main);
+	if (rc != 0) {
+		acl_update_ctx_free(ctx, nmain);
+		rte_free(rt);
+		return rc;
+	}
+	upd->main = nmain;
+	upd->num_dirty = 0;
+	upd->num_pairs = 0;
+	upd->pairs_stale = 0;
+	return 0;
+}
+
+/*
+ * Registers a reader holding back the free of the replaced tries.
+ */
+int
+rte_acl_reader_register(struct rte_acl_ctx *ctx, unsigned int reader_id)
+{
+	if (ctx == NULL || ctx->readers == NULL ||
+			reader_id >= RTE_ACL_MAX_READERS)
+		return -EINVAL;
+
+	/* the reader holds no reference yet, so it starts quiescent. */
+	ctx->readers->reader[reader_id].cnt = ctx->readers->token;
+	rte_smp_mb();
+
+	return 0;
+}
+
+/*
+ * Unregisters a reader, it no longer holds back the free of the tries.
+ */
+int
+rte_acl_reader_unregister(struct rte_acl_ctx *ctx, unsigned int reader_id)
+{
+	if (ctx == NULL || ctx->readers == NULL ||
+			reader_id >= RTE_ACL_MAX_READERS)
+		return -EINVAL;
+
+	rte_smp_mb();
+	ctx->readers->reader[reader_id].cnt = 0;
+
+	return 0;
+}
+
+/*
+ * Reports a quiescent state for a reader.
+ */
+void
+rte_acl_quiescent(struct rte_acl_ctx *ctx, unsigned int reader_id)
+{
+	uint64_t token;
+
+	/* classify calls issued so far must be complete before reporting. */
+	rte_smp_mb();
+	token = ctx->readers->token;
+	/* later classify calls must see the tries as of this token. */
+	rte_smp_rmb();
+	ctx->readers->reader[reader_id].cnt = token;
+}
+
+int
+acl_update_classify(const struct acl_update_rt *rt, rte_acl_classify_t fn,
+	const uint8_t **data, uint32_t *results, uint32_t num,
+	uint32_t categories)
+{
+	uint32_t dres[ACL_UPD_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t dcat, i, j, k, n;
+	uint32_t *r;
+	const uint32_t *d;
+	int32_t rc;
+
+	if (rt->main != NULL)
+		rc = fn(rt->main, data, results, num, categories);
+	else {
+		memset(results, 0, num * categories * sizeof(results[0]));
+		rc = 0;
+	}
+
+	if (rc != 0 || rt->delta == NULL)
+		return rc;
+
+	/* results of all the categories are needed to spot the markers. */
+	dcat = RTE_MAX(categories, rt->categories);
+
+	for (i = 0; i != num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_UPD_BURST);
+		rc = fn(rt->delta, data + i, dres, n, dcat);
+		if (rc != 0)
+			return rc;
+
+		/* inputs matching a marker take the delta results. */
+		for (j = 0; j != n; j++) {
+			d = dres + j * dcat;
+			for (k = 0; k != rt->num_categories && d[k] == 0; k++)
+				;
+			if (k == rt->num_categories)
+				continue;
+			r = results + (i + j) * categories;
+			for (k = 0; k != categories; k++)
+				r[k] = (d[k] < ACL_UPD_USERDATA_BASE) ? 0 :
+					rt->userdata[d[k] -
+					ACL_UPD_USERDATA_BASE];
+		}
+	}
+
+	return 0;
+}
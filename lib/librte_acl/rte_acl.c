@@ -55,6 +55,20 @@ rte_acl_classify_avx2(__rte_unused const struct rte_acl_ctx *ctx,
 	return -ENOTSUP;
 }
 
+/*
+ * If the compiler doesn't support AVX512 instructions,
+ * then the dummy one would be used instead for AVX512 classify method.
+ */
+int __attribute__ ((weak))
+rte_acl_classify_avx512(__rte_unused const struct rte_acl_ctx *ctx,
+	__rte_unused const uint8_t **data,
+	__rte_unused uint32_t *results,
+	__rte_unused uint32_t num,
+	__rte_unused uint32_t categories)
+{
+	return -ENOTSUP;
+}
+
 int __attribute__ ((weak))
 rte_acl_classify_sse(__rte_unused const struct rte_acl_ctx *ctx,
 	__rte_unused const uint8_t **data,
@@ -92,6 +106,7 @@ static const rte_acl_classify_t classify_fns[] = {
 	[RTE_ACL_CLASSIFY_AVX2] = rte_acl_classify_avx2,
 	[RTE_ACL_CLASSIFY_NEON] = rte_acl_classify_neon,
 	[RTE_ACL_CLASSIFY_ALTIVEC] = rte_acl_classify_altivec,
+	[RTE_ACL_CLASSIFY_AVX512] = rte_acl_classify_avx512,
 };
 
 /* by default, use always available scalar code path. */
@@ -116,9 +131,10 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 
 /*
  * Select highest available classify method as default one.
- * Note that CLASSIFY_AVX2 should be set as a default only
+ * Note that CLASSIFY_AVX2 (CLASSIFY_AVX512) should be set as a default only
  * if both conditions are met:
- * at build time compiler supports AVX2 and target cpu supports AVX2.
+ * at build time compiler supports AVX2 (AVX512F and AVX512BW)
+ * and target cpu supports them.
  */
 static void __attribute__((constructor))
 rte_acl_init(void)
@@ -142,6 +158,12 @@ rte_acl_init(void)
 #endif
 		alg = RTE_ACL_CLASSIFY_SSE;
 
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		alg = RTE_ACL_CLASSIFY_AVX512;
+#endif
+
 #endif
 	rte_acl_set_default_classify(alg);
 }
@@ -151,10 +173,18 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories,
 	enum rte_acl_classify_alg alg)
 {
+	const struct acl_update_rt *rt;
+
 	if (categories != 1 &&
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	/* the context has been updated incrementally. */
+	rt = ctx->upd_rt;
+	if (unlikely(rt != NULL))
+		return acl_update_classify(rt, classify_fns[alg],
+			data, results, num, categories);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -217,6 +247,8 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 
+	acl_update_free(ctx);
+	rte_free(ctx->readers);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -273,6 +305,21 @@ rte_acl_create(const struct rte_acl_param *param)
 			rte_free(te);
 			goto exit;
 		}
+
+		/* tokens start at 1, so that 0 marks an offline reader. */
+		ctx->readers = rte_zmalloc_socket(name, sizeof(*ctx->readers),
+			RTE_CACHE_LINE_SIZE, param->socket_id);
+		if (ctx->readers == NULL) {
+			RTE_LOG(ERR, ACL,
+				"allocation of readers on socket %d for %s "
+				"failed\n", param->socket_id, name);
+			rte_free(ctx);
+			rte_free(te);
+			ctx = NULL;
+			goto exit;
+		}
+		ctx->readers->token = 1;
+
 		/* init new allocated context. */
 		ctx->rules = ctx + 1;
 		ctx->max_rules = param->max_rule_num;
@@ -53,6 +53,9 @@ extern "C" {
 #define RTE_ACL_MAX_LEVELS 64
 #define RTE_ACL_MAX_FIELDS 64
 
+/** Max number of readers tracked by incremental updates. */
+#define RTE_ACL_MAX_READERS RTE_MAX_LCORE
+
 union rte_acl_field_types {
 	uint8_t  u8;
 	uint16_t u16;
@@ -96,6 +99,9 @@ struct rte_acl_config {
 	/**< array of field definitions. */
 	size_t max_size;
 	/**< max memory limit for internal run-time structures. */
+	uint32_t num_threads;
+	/**< max number of threads to build the tries with, including the
+	 * calling one. 0 or 1 builds them in the calling thread only. */
 };
 
 /**
@@ -235,6 +241,8 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 /**
  * Analyze set of rules and build required internal run-time structures.
  * This function is not multi-thread safe.
+ * When cfg->num_threads is more than one, the tries are built on up to
+ * that many threads, and the result is the same as with one thread.
  *
  * @param ctx
  *   ACL context to build.
@@ -260,6 +268,119 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 void
 rte_acl_reset(struct rte_acl_ctx *ctx);
 
+/**
+ * Add rules to a built ACL context without rebuilding it.
+ * The rules are looked up from a small delta trie next to the built one,
+ * which is rebuilt on each update. Classify calls on other lcores keep
+ * running during the update. The structures replaced by an update are
+ * freed by a later one, once every reader registered with
+ * rte_acl_reader_register() has called rte_acl_quiescent() since. Without
+ * registered readers, they are freed by the next update, so no classify
+ * call may then overlap with two consecutive updates.
+ * This function is not multi-thread safe with other updates of the
+ * same context.
+ *
+ * @param ctx
+ *   ACL context, built with rte_acl_build().
+ * @param rules
+ *   Array of rules to add to the ACL context.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the ACL context for these rules.
+ *   - -ENOSPC if too many rules changed since the last compaction.
+ *   - -EINVAL if the parameters are invalid or the context is not built.
+ *   - Negative error code if building the delta trie failed.
+ *   - Zero if operation completed successfully.
+ */
+int
+rte_acl_update_add(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num);
+
+/**
+ * Delete rules from a built ACL context without rebuilding it.
+ * Same conditions as rte_acl_update_add() apply.
+ *
+ * @param ctx
+ *   ACL context, built with rte_acl_build().
+ * @param rules
+ *   Array of rules to delete, each one must be identical to a rule of
+ *   the context.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOENT if one of the rules is not in the context, nothing is
+ *     deleted then.
+ *   - -ENOSPC if too many rules changed since the last compaction.
+ *   - -EINVAL if the parameters are invalid or the context is not built.
+ *   - Negative error code if building the delta trie failed.
+ *   - Zero if operation completed successfully.
+ */
+int
+rte_acl_update_del(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num);
+
+/**
+ * Rebuild the ACL context from its current rules and drop the delta trie
+ * of the updates. It takes as long as rte_acl_build(), but classify calls
+ * keep running meanwhile, so it can be done from a control thread
+ * whenever updates become frequent or the delta trie grows.
+ * Same conditions as rte_acl_update_add() apply.
+ *
+ * @param ctx
+ *   ACL context to compact.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+int
+rte_acl_update_compact(struct rte_acl_ctx *ctx);
+
+/**
+ * Register a reader of an ACL context which is updated incrementally.
+ * Until it is unregistered, the structures replaced by rte_acl_update_add(),
+ * rte_acl_update_del() or rte_acl_update_compact() are not freed before the
+ * reader calls rte_acl_quiescent().
+ *
+ * @param ctx
+ *   ACL context.
+ * @param reader_id
+ *   Reader index, lower than RTE_ACL_MAX_READERS (e.g. the lcore id).
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+int
+rte_acl_reader_register(struct rte_acl_ctx *ctx, unsigned int reader_id);
+
+/**
+ * Unregister a reader, which must not classify with the ACL context
+ * afterwards.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param reader_id
+ *   Reader index passed to rte_acl_reader_register().
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+int
+rte_acl_reader_unregister(struct rte_acl_ctx *ctx, unsigned int reader_id);
+
+/**
+ * Report that a registered reader holds no reference to the ACL context,
+ * i.e. that all its earlier classify calls have returned. It is typically
+ * called once per burst by each forwarding lcore.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param reader_id
+ *   Reader index passed to rte_acl_reader_register().
+ */
+void
+rte_acl_quiescent(struct rte_acl_ctx *ctx, unsigned int reader_id);
+
 /**
  *  Available implementations of ACL classify.
  */
@@ -270,6 +391,7 @@ enum rte_acl_classify_alg {
 	RTE_ACL_CLASSIFY_AVX2 = 3,    /**< requires AVX2 support. */
 	RTE_ACL_CLASSIFY_NEON = 4,    /**< requires NEON support. */
 	RTE_ACL_CLASSIFY_ALTIVEC = 5,    /**< requires ALTIVEC support. */
+	RTE_ACL_CLASSIFY_AVX512 = 6,  /**< requires AVX512F and AVX512BW. */
 	RTE_ACL_CLASSIFY_NUM          /* should always be the last one. */
 };
 
@@ -47,6 +47,8 @@
 #include <rte_branch_prediction.h>
 #include <rte_memcpy.h>
 #include <rte_ring.h>
+#include <rte_spinlock.h>
+#include <rte_atomic.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
 
@@ -250,6 +252,18 @@ struct efd_online_chunk {
 	/**< Array of all the groups in the chunk. */
 } __attribute__((__packed__));
 
+/**
+ * Per-chunk writer lock and version counter, used when the table
+ * was created with RTE_EFD_EXTRA_FLAGS_MULTI_WRITER.
+ * The version is odd while a writer is modifying the online chunk.
+ * One cache line per chunk, so that writers on different chunks and the
+ * readers polling their versions do not share lines.
+ */
+struct efd_chunk_sync {
+	rte_spinlock_t lock;
+	volatile uint32_t version;
+} __rte_cache_aligned;
+
 /**
  * EFD table structure
  */
@@ -261,7 +275,7 @@ struct rte_efd_table {
 	uint32_t max_num_rules;
 	/**< Static maximum number of entries the table was constructed to hold. */
 
-	uint32_t num_rules;
+	rte_atomic32_t num_rules;
 	/**< Number of entries currently in the table . */
 
 	uint32_t num_chunks;
@@ -273,6 +287,12 @@ struct rte_efd_table {
 	enum efd_lookup_internal_function lookup_fn;
 	/**< Indicates which lookup function to use. */
 
+	uint8_t extra_flag;
+	/**< RTE_EFD_EXTRA_FLAGS_* the table was created with. */
+
+	struct efd_chunk_sync *chunk_sync;
+	/**< Dynamic array of size num_chunks, NULL for single writer tables. */
+
 	struct efd_online_chunk *chunks[RTE_MAX_NUMA_NODES];
 	/**< Dynamic array of size num_chunks of chunk records. */
 
@@ -520,6 +540,15 @@ efd_search_hash(struct rte_efd_table * const table,
 struct rte_efd_table *
 rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 		uint8_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket)
+{
+	return rte_efd_create_with_flags(name, max_num_rules, key_len,
+			online_cpu_socket_bitmask, offline_cpu_socket, 0);
+}
+
+struct rte_efd_table *
+rte_efd_create_with_flags(const char *name, uint32_t max_num_rules,
+		uint32_t key_len, uint8_t online_cpu_socket_bitmask,
+		uint8_t offline_cpu_socket, uint8_t extra_flag)
 {
 	struct rte_efd_table *table = NULL;
 	uint8_t *key_array = NULL;
@@ -601,7 +630,7 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 			"on socket %u\n", offline_cpu_socket);
 
 	table->max_num_rules = num_chunks * EFD_TARGET_CHUNK_MAX_NUM_RULES;
-	table->num_rules = 0;
+	rte_atomic32_init(&table->num_rules);
 	table->num_chunks = num_chunks;
 	table->num_chunks_shift = num_chunks_shift;
 	table->key_len = key_len;
@@ -699,6 +728,22 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 			(float) offline_table_size / (1024.0F * 1024.0F),
 			offline_cpu_socket);
 
+	table->extra_flag = extra_flag;
+	if (extra_flag & RTE_EFD_EXTRA_FLAGS_MULTI_WRITER) {
+		table->chunk_sync = (struct efd_chunk_sync *)
+				rte_zmalloc_socket(NULL,
+				num_chunks * sizeof(struct efd_chunk_sync),
+				RTE_CACHE_LINE_SIZE,
+				offline_cpu_socket);
+		if (table->chunk_sync == NULL) {
+			RTE_LOG(ERR, EFD, "Allocating EFD chunk locks on "
+					"socket %u failed\n", offline_cpu_socket);
+			goto error_unlock_exit;
+		}
+		for (i = 0; i < num_chunks; i++)
+			rte_spinlock_init(&table->chunk_sync[i].lock);
+	}
+
 	te->data = (void *) table;
 	TAILQ_INSERT_TAIL(efd_list, te, next);
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
@@ -764,6 +809,7 @@ rte_efd_free(struct rte_efd_table *table)
 		rte_free(table->chunks[socket_id]);
 
 	rte_ring_free(table->free_slots);
+	rte_free(table->chunk_sync);
 	rte_free(table->offline_chunks);
 	rte_free(table->keys);
 	rte_free(table);
@@ -815,6 +861,16 @@ efd_apply_update(struct rte_efd_table * const table, const unsigned int socket_i
 	choice_chunk = (choice_chunk & (~(0x03 << offset)))
 			| ((new_bin_choice & 0x03) << offset);
 
+	/*
+	 * With several writers, make the chunk version odd while the
+	 * group entry and bin choice are rewritten, so lock-free
+	 * readers can detect a torn read and retry.
+	 */
+	if (table->chunk_sync != NULL) {
+		table->chunk_sync[chunk_id].version++;
+		rte_smp_wmb();
+	}
+
 	/* Update the online table with the new data across all sockets */
 	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
 		if (table->chunks[i] != NULL) {
@@ -825,6 +881,33 @@ efd_apply_update(struct rte_efd_table * const table, const unsigned int socket_i
 					choice_chunk;
 		}
 	}
+
+	if (table->chunk_sync != NULL) {
+		rte_smp_wmb();
+		table->chunk_sync[chunk_id].version++;
+	}
+}
+
+/*
+ * Take the writer lock of a chunk, for multi-writer tables only
+ */
+static inline void
+efd_chunk_lock(const struct rte_efd_table * const table,
+		const uint32_t chunk_id)
+{
+	if (table->chunk_sync != NULL)
+		rte_spinlock_lock(&table->chunk_sync[chunk_id].lock);
+}
+
+/*
+ * Release the writer lock of a chunk, for multi-writer tables only
+ */
+static inline void
+efd_chunk_unlock(const struct rte_efd_table * const table,
+		const uint32_t chunk_id)
+{
+	if (table->chunk_sync != NULL)
+		rte_spinlock_unlock(&table->chunk_sync[chunk_id].lock);
 }
 
 /*
@@ -923,11 +1006,11 @@ revert_groups(struct efd_offline_group_rules *previous_group,
  * @param value
  *   Value to associate with key
  * @param chunk_id
- *   Chunk ID of the chunk that was modified
+ *   Chunk ID of the key, as computed by efd_compute_ids
  * @param group_id
  *   Group ID of the group that was modified
  * @param bin_id
- *   Bin ID that was modified
+ *   Bin ID of the key, as computed by efd_compute_ids
  * @param new_bin_choice
  *   Newly chosen permutation which this bin will use
  * @param entry
@@ -954,8 +1037,8 @@ revert_groups(struct efd_offline_group_rules *previous_group,
 static inline int
 efd_compute_update(struct rte_efd_table * const table,
 		const unsigned int socket_id, const void *key,
-		const efd_value_t value, uint32_t * const chunk_id,
-		uint32_t * const group_id, uint32_t * const bin_id,
+		const efd_value_t value, const uint32_t chunk_id,
+		uint32_t * const group_id, const uint32_t bin_id,
 		uint8_t * const new_bin_choice,
 		struct efd_online_group_entry * const entry)
 {
@@ -966,15 +1049,13 @@ efd_compute_update(struct rte_efd_table * const table,
 	int status = EXIT_SUCCESS;
 	unsigned int found = 0;
 
-	efd_compute_ids(table, key, chunk_id, bin_id);
-
 	struct efd_offline_chunk_rules * const chunk =
-			&table->offline_chunks[*chunk_id];
+			&table->offline_chunks[chunk_id];
 	struct efd_offline_group_rules *new_group;
 
 	uint8_t current_choice = efd_get_choice(table, socket_id,
-			*chunk_id, *bin_id);
-	uint32_t current_group_id = efd_bin_to_group[current_choice][*bin_id];
+			chunk_id, bin_id);
+	uint32_t current_group_id = efd_bin_to_group[current_choice][bin_id];
 	struct efd_offline_group_rules * const current_group =
 			&chunk->group_rules[current_group_id];
 	uint8_t bin_size = 0;
@@ -984,7 +1065,7 @@ efd_compute_update(struct rte_efd_table * const table,
 
 	/* Scan the current group and see if the key is already present */
 	for (i = 0; i < current_group->num_rules; i++) {
-		if (current_group->bin_id[i] == *bin_id)
+		if (current_group->bin_id[i] == bin_id)
 			bin_size++;
 		else
 			continue;
@@ -1015,8 +1096,8 @@ efd_compute_update(struct rte_efd_table * const table,
 			RTE_LOG(ERR, EFD,
 					"Fatal: No room remaining for insert into "
 					"chunk %u group %u bin %u\n",
-					*chunk_id,
-					current_group_id, *bin_id);
+					chunk_id,
+					current_group_id, bin_id);
 			return RTE_EFD_UPDATE_FAILED;
 		}
 
@@ -1024,12 +1105,16 @@ efd_compute_update(struct rte_efd_table * const table,
 				(EFD_MAX_GROUP_NUM_RULES - 1))) {
 			RTE_LOG(INFO, EFD, "Warn: Insert into last "
 					"available slot in chunk %u "
-					"group %u bin %u\n", *chunk_id,
-					current_group_id, *bin_id);
+					"group %u bin %u\n", chunk_id,
+					current_group_id, bin_id);
 			status = RTE_EFD_UPDATE_WARN_GROUP_FULL;
 		}
 
-		if (rte_ring_sc_dequeue(table->free_slots, &slot_id) != 0)
+		if (table->chunk_sync != NULL)
+			ret = rte_ring_mc_dequeue(table->free_slots, &slot_id);
+		else
+			ret = rte_ring_sc_dequeue(table->free_slots, &slot_id);
+		if (ret != 0)
 			return RTE_EFD_UPDATE_FAILED;
 
 		new_k = RTE_PTR_ADD(table->keys, (uintptr_t) slot_id *
@@ -1040,9 +1125,9 @@ efd_compute_update(struct rte_efd_table * const table,
 		rte_memcpy(EFD_KEY(new_idx, table), key, table->key_len);
 		current_group->key_idx[current_group->num_rules] = new_idx;
 		current_group->value[current_group->num_rules] = value;
-		current_group->bin_id[current_group->num_rules] = *bin_id;
+		current_group->bin_id[current_group->num_rules] = bin_id;
 		current_group->num_rules++;
-		table->num_rules++;
+		rte_atomic32_inc(&table->num_rules);
 		bin_size++;
 	} else {
 		uint32_t last = current_group->num_rules - 1;
@@ -1060,7 +1145,7 @@ efd_compute_update(struct rte_efd_table * const table,
 		 */
 		current_group->key_idx[last] = key_idx_previous;
 		current_group->value[last] = value;
-		current_group->bin_id[last] = *bin_id;
+		current_group->bin_id[last] = bin_id;
 	}
 
 	*new_bin_choice = current_choice;
@@ -1089,7 +1174,7 @@ efd_compute_update(struct rte_efd_table * const table,
 		for (choice = 0; choice < EFD_CHUNK_NUM_BIN_TO_GROUP_SETS;
 				choice++) {
 			uint32_t test_group_id =
-					efd_bin_to_group[choice][*bin_id];
+					efd_bin_to_group[choice][bin_id];
 			uint32_t num_rules =
 					chunk->group_rules[test_group_id].num_rules;
 			if (num_rules < smallest_size) {
@@ -1119,7 +1204,7 @@ efd_compute_update(struct rte_efd_table * const table,
 					choice - 1);
 			goto next_choice;
 		}
-		move_groups(*bin_id, bin_size, new_group, current_group);
+		move_groups(bin_id, bin_size, new_group, current_group);
 		/*
 		 * Recompute the hash function for the modified group,
 		 * and return it to the caller
@@ -1140,14 +1225,14 @@ efd_compute_update(struct rte_efd_table * const table,
 		if (choice == EFD_CHUNK_NUM_BIN_TO_GROUP_SETS)
 			break;
 		*new_bin_choice = choice;
-		*group_id = efd_bin_to_group[choice][*bin_id];
+		*group_id = efd_bin_to_group[choice][bin_id];
 		new_group = &chunk->group_rules[*group_id];
 		choice++;
 	}
 
 	if (!found) {
 		current_group->num_rules--;
-		table->num_rules--;
+		rte_atomic32_dec(&table->num_rules);
 	} else
 		current_group->value[current_group->num_rules - 1] =
 			key_changed_previous_value;
@@ -1162,18 +1247,20 @@ rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
 	uint8_t new_bin_choice = 0;
 	struct efd_online_group_entry entry;
 
+	efd_compute_ids(table, key, &chunk_id, &bin_id);
+	efd_chunk_lock(table, chunk_id);
+
 	int status = efd_compute_update(table, socket_id, key, value,
-			&chunk_id, &group_id, &bin_id,
+			chunk_id, &group_id, bin_id,
 			&new_bin_choice, &entry);
 
 	if (status == RTE_EFD_UPDATE_NO_CHANGE)
-		return EXIT_SUCCESS;
-
-	if (status == RTE_EFD_UPDATE_FAILED)
-		return status;
+		status = EXIT_SUCCESS;
+	else if (status != RTE_EFD_UPDATE_FAILED)
+		efd_apply_update(table, socket_id, chunk_id, group_id, bin_id,
+				new_bin_choice, &entry);
 
-	efd_apply_update(table, socket_id, chunk_id, group_id, bin_id,
-			new_bin_choice, &entry);
+	efd_chunk_unlock(table, chunk_id);
 	return status;
 }
 
@@ -1184,8 +1271,10 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 	unsigned int i;
 	uint32_t chunk_id, bin_id;
 	uint8_t not_found = 1;
+	void *slot_id;
 
 	efd_compute_ids(table, key, &chunk_id, &bin_id);
+	efd_chunk_lock(table, chunk_id);
 
 	struct efd_offline_chunk_rules * const chunk =
 			&table->offline_chunks[chunk_id];
@@ -1210,8 +1299,14 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 					*prev_value = current_group->value[i];
 
 				not_found = 0;
-				rte_ring_sp_enqueue(table->free_slots,
-					(void *)((uintptr_t)current_group->key_idx[i]));
+				slot_id = (void *)((uintptr_t)
+						current_group->key_idx[i]);
+				if (table->chunk_sync != NULL)
+					rte_ring_mp_enqueue(table->free_slots,
+							slot_id);
+				else
+					rte_ring_sp_enqueue(table->free_slots,
+							slot_id);
 			}
 		} else {
 			/*
@@ -1227,10 +1322,11 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 	}
 
 	if (not_found == 0) {
-		table->num_rules--;
+		rte_atomic32_dec(&table->num_rules);
 		current_group->num_rules--;
 	}
 
+	efd_chunk_unlock(table, chunk_id);
 	return not_found;
 }
 
@@ -1284,20 +1380,46 @@ efd_lookup_internal(const struct efd_online_group_entry * const group,
 	return value;
 }
 
-efd_value_t
-rte_efd_lookup(const struct rte_efd_table * const table,
-		const unsigned int socket_id, const void *key)
+/*
+ * Wait until no writer is modifying the chunk and return its version,
+ * for multi-writer tables only
+ */
+static inline uint32_t
+efd_read_begin(const struct rte_efd_table * const table,
+		const uint32_t chunk_id)
+{
+	uint32_t version;
+
+	while ((version = table->chunk_sync[chunk_id].version) & 1)
+		rte_pause();
+	rte_smp_rmb();
+
+	return version;
+}
+
+/*
+ * Check whether a writer modified the chunk since efd_read_begin()
+ */
+static inline int
+efd_read_retry(const struct rte_efd_table * const table,
+		const uint32_t chunk_id, const uint32_t version)
+{
+	rte_smp_rmb();
+	return table->chunk_sync[chunk_id].version != version;
+}
+
+static inline efd_value_t
+efd_lookup_chunk(const struct rte_efd_table * const table,
+		const unsigned int socket_id, const uint32_t chunk_id,
+		const uint32_t bin_id, const void *key)
 {
-	uint32_t chunk_id, group_id, bin_id;
+	uint32_t group_id;
 	uint8_t bin_choice;
 	const struct efd_online_group_entry *group;
-	const struct efd_online_chunk * const chunks = table->chunks[socket_id];
 
-	/* Determine the chunk and group location for the given key */
-	efd_compute_ids(table, key, &chunk_id, &bin_id);
 	bin_choice = efd_get_choice(table, socket_id, chunk_id, bin_id);
 	group_id = efd_bin_to_group[bin_choice][bin_id];
-	group = &chunks[chunk_id].groups[group_id];
+	group = &table->chunks[socket_id][chunk_id].groups[group_id];
 
 	return efd_lookup_internal(group,
 			EFD_HASHFUNCA(key, table),
@@ -1305,6 +1427,29 @@ rte_efd_lookup(const struct rte_efd_table * const table,
 			table->lookup_fn);
 }
 
+efd_value_t
+rte_efd_lookup(const struct rte_efd_table * const table,
+		const unsigned int socket_id, const void *key)
+{
+	uint32_t chunk_id, bin_id, version;
+	efd_value_t value;
+
+	/* Determine the chunk and group location for the given key */
+	efd_compute_ids(table, key, &chunk_id, &bin_id);
+
+	if (table->chunk_sync == NULL)
+		return efd_lookup_chunk(table, socket_id, chunk_id, bin_id,
+				key);
+
+	do {
+		version = efd_read_begin(table, chunk_id);
+		value = efd_lookup_chunk(table, socket_id, chunk_id, bin_id,
+				key);
+	} while (efd_read_retry(table, chunk_id, version));
+
+	return value;
+}
+
 void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 		const unsigned int socket_id, const int num_keys,
 		const void **key_list, efd_value_t * const value_list)
@@ -1314,7 +1459,9 @@ void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 	uint32_t bin_id_list[RTE_EFD_BURST_MAX];
 	uint8_t bin_choice_list[RTE_EFD_BURST_MAX];
 	uint32_t group_id_list[RTE_EFD_BURST_MAX];
+	uint32_t version_list[RTE_EFD_BURST_MAX];
 	struct efd_online_group_entry *group;
+	const int multi_writer = (table->chunk_sync != NULL);
 
 	struct efd_online_chunk *chunks = table->chunks[socket_id];
 
@@ -1325,6 +1472,9 @@ void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 	}
 
 	for (i = 0; i < num_keys; i++) {
+		if (multi_writer)
+			version_list[i] = efd_read_begin(table,
+					chunk_id_list[i]);
 		bin_choice_list[i] = efd_get_choice(table, socket_id,
 				chunk_id_list[i], bin_id_list[i]);
 		group_id_list[i] =
@@ -1339,5 +1489,20 @@ void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 				EFD_HASHFUNCA(key_list[i], table),
 				EFD_HASHFUNCB(key_list[i], table),
 				table->lookup_fn);
+
+		/* A writer raced with this key: redo it on its own */
+		if (multi_writer && unlikely(efd_read_retry(table,
+				chunk_id_list[i], version_list[i]))) {
+			uint32_t version;
+
+			do {
+				version = efd_read_begin(table,
+						chunk_id_list[i]);
+				value_list[i] = efd_lookup_chunk(table,
+						socket_id, chunk_id_list[i],
+						bin_id_list[i], key_list[i]);
+			} while (efd_read_retry(table, chunk_id_list[i],
+					version));
+		}
 	}
 }
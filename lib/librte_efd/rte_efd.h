@@ -131,6 +131,13 @@ extern "C" {
 /** Maximum number of characters in efd name.*/
 #define RTE_EFD_NAMESIZE			32
 
+/**
+ * Flag to allow concurrent calls to rte_efd_update() and rte_efd_delete()
+ * from several threads. Updates to keys in different chunks run in parallel;
+ * lookups stay lock-free.
+ */
+#define RTE_EFD_EXTRA_FLAGS_MULTI_WRITER	0x01
+
 #if (RTE_EFD_VALUE_NUM_BITS > 0 && RTE_EFD_VALUE_NUM_BITS <= 8)
 typedef uint8_t efd_value_t;
 #elif (RTE_EFD_VALUE_NUM_BITS > 8 && RTE_EFD_VALUE_NUM_BITS <= 16)
@@ -170,6 +177,41 @@ struct rte_efd_table *
 rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 	uint8_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket);
 
+/**
+ * Creates an EFD table, as rte_efd_create() does, with extra flags
+ * selecting optional table behaviours.
+ *
+ * When RTE_EFD_EXTRA_FLAGS_MULTI_WRITER is set, every chunk of the table
+ * gets its own lock, taken by rte_efd_update() and rte_efd_delete(), so
+ * that several threads can modify keys living in different chunks at
+ * the same time. Lookups never take the lock: they read a per-chunk
+ * version counter before and after reading the online table and retry
+ * if a writer changed the chunk in between.
+ *
+ * @param name
+ *   EFD table name
+ * @param max_num_rules
+ *   Minimum number of rules the table should be sized to hold.
+ *   Will be rounded up to the next smallest valid table size
+ * @param key_len
+ *   Length of the key
+ * @param online_cpu_socket_bitmask
+ *   Bitmask specifying which sockets should get a copy of the online table.
+ *   LSB = socket 0, etc.
+ * @param offline_cpu_socket
+ *   Identifies the socket where the offline table will be allocated
+ *   (and most efficiently accessed in the case of updates/insertions)
+ * @param extra_flag
+ *   Bitwise OR of RTE_EFD_EXTRA_FLAGS_* values, or 0
+ *
+ * @return
+ *   EFD table, or NULL if table allocation failed or the bitmask is invalid
+ */
+struct rte_efd_table *
+rte_efd_create_with_flags(const char *name, uint32_t max_num_rules,
+	uint32_t key_len, uint8_t online_cpu_socket_bitmask,
+	uint8_t offline_cpu_socket, uint8_t extra_flag);
+
 /**
  * Releases the resources from an EFD table
  *
@@ -201,7 +243,8 @@ rte_efd_find_existing(const char *name);
  * The update is then immediately applied to the provided table and
  * all socket-local copies of the chunks are updated.
  * This operation is not multi-thread safe
- * and should only be called one from thread.
+ * and should only be called one from thread, unless the table was
+ * created with RTE_EFD_EXTRA_FLAGS_MULTI_WRITER.
  *
  * @param table
  *   EFD table to reference
@@ -232,7 +275,8 @@ rte_efd_update(struct rte_efd_table *table, unsigned int socket_id,
 /**
  * Removes any value currently associated with the specified key from the table
  * This operation is not multi-thread safe
- * and should only be called from one thread.
+ * and should only be called from one thread, unless the table was
+ * created with RTE_EFD_EXTRA_FLAGS_MULTI_WRITER.
  *
  * @param table
  *   EFD table to reference
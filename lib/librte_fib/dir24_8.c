@@ -0,0 +1,466 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_atomic.h>
+#include <rte_cpuflags.h>
+
+#include "rte_rib.h"
+#include "rte_fib.h"
+#include "dir24_8.h"
+
+static inline uint64_t
+get_max_nh(uint8_t nh_sz)
+{
+	return (UINT64_MAX >> (64 - ((8 << nh_sz) - 1)));
+}
+
+static inline uint64_t
+read_ent(const uint8_t *tbl, uint64_t idx, uint8_t nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return ((const uint8_t *)tbl)[idx];
+	case RTE_FIB_DIR24_8_2B:
+		return ((const uint16_t *)tbl)[idx];
+	case RTE_FIB_DIR24_8_4B:
+		return ((const uint32_t *)tbl)[idx];
+	default:
+		return ((const uint64_t *)tbl)[idx];
+	}
+}
+
+/* Writes n consecutive entries, each with a single store. */
+static inline void
+write_ents(uint8_t *tbl, uint64_t idx, uint64_t ent, uint64_t n,
+		uint8_t nh_sz)
+{
+	uint64_t i;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		memset(&tbl[idx], (uint8_t)ent, n);
+		break;
+	case RTE_FIB_DIR24_8_2B:
+		for (i = 0; i < n; i++)
+			((volatile uint16_t *)tbl)[idx + i] = (uint16_t)ent;
+		break;
+	case RTE_FIB_DIR24_8_4B:
+		for (i = 0; i < n; i++)
+			((volatile uint32_t *)tbl)[idx + i] = (uint32_t)ent;
+		break;
+	default:
+		for (i = 0; i < n; i++)
+			((volatile uint64_t *)tbl)[idx + i] = ent;
+		break;
+	}
+}
+
+static int32_t
+tbl8_alloc(struct dir24_8_tbl *dp, uint64_t ent)
+{
+	uint32_t tbl8_idx;
+
+	if (dp->tbl8_pool_pos == dp->number_tbl8s)
+		return -ENOSPC;
+
+	tbl8_idx = dp->tbl8_pool[dp->tbl8_pool_pos++];
+	write_ents(dp->tbl8, (uint64_t)tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT,
+			ent, DIR24_8_TBL8_GRP_NUM_ENT, dp->nh_sz);
+	dp->cur_tbl8s++;
+
+	return tbl8_idx;
+}
+
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	dp->tbl8_pool[--dp->tbl8_pool_pos] = tbl8_idx;
+	dp->cur_tbl8s--;
+}
+
+/*
+ * Folds a tbl8 back into its tbl24 entry when all its entries hold the
+ * same next hop.
+ */
+static void
+tbl8_recycle(struct dir24_8_tbl *dp, uint32_t tbl24_idx, uint32_t tbl8_idx)
+{
+	uint64_t first = (uint64_t)tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT;
+	uint64_t ent = read_ent(dp->tbl8, first, dp->nh_sz);
+	uint32_t i;
+
+	for (i = 1; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
+		if (read_ent(dp->tbl8, first + i, dp->nh_sz) != ent)
+			return;
+
+	write_ents(dp->tbl24, tbl24_idx, ent, 1, dp->nh_sz);
+	tbl8_free(dp, tbl8_idx);
+}
+
+/*
+ * Sets the entries of [ledge, redge), which lie in the same /24 and do
+ * not cover it entirely, in the tbl8 of that /24.
+ */
+static int
+write_tbl8_range(struct dir24_8_tbl *dp, uint64_t ledge, uint64_t redge,
+		uint64_t ent)
+{
+	uint32_t tbl24_idx = (uint32_t)(ledge >> 8);
+	uint64_t tbl24_ent;
+	int32_t tbl8_idx;
+
+	tbl24_ent = read_ent(dp->tbl24, tbl24_idx, dp->nh_sz);
+
+	if (!is_entry_extended(tbl24_ent)) {
+		if (tbl24_ent == ent)
+			return 0;
+
+		/* Spread the tbl24 next hop over a new tbl8. */
+		tbl8_idx = tbl8_alloc(dp, tbl24_ent);
+		if (tbl8_idx < 0)
+			return tbl8_idx;
+
+		write_ents(dp->tbl8, (uint64_t)tbl8_idx *
+				DIR24_8_TBL8_GRP_NUM_ENT + (ledge & 0xff),
+				ent, redge - ledge, dp->nh_sz);
+
+		/* The tbl8 must be complete before lookups can reach it. */
+		rte_smp_wmb();
+		write_ents(dp->tbl24, tbl24_idx,
+				((uint64_t)tbl8_idx << 1) | DIR24_8_EXT_ENT, 1,
+				dp->nh_sz);
+		return 0;
+	}
+
+	tbl8_idx = (int32_t)(tbl24_ent >> 1);
+	write_ents(dp->tbl8, (uint64_t)tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT +
+			(ledge & 0xff), ent, redge - ledge, dp->nh_sz);
+	tbl8_recycle(dp, tbl24_idx, tbl8_idx);
+
+	return 0;
+}
+
+/*
+ * Sets the entries of the /24s of [ledge, redge), both aligned on a /24,
+ * in the tbl24 and releases the tbl8s they pointed to.
+ */
+static void
+write_tbl24_range(struct dir24_8_tbl *dp, uint64_t ledge, uint64_t redge,
+		uint64_t ent)
+{
+	uint64_t tbl24_idx, old;
+
+	for (tbl24_idx = ledge >> 8; tbl24_idx < (redge >> 8); tbl24_idx++) {
+		old = read_ent(dp->tbl24, tbl24_idx, dp->nh_sz);
+		write_ents(dp->tbl24, tbl24_idx, ent, 1, dp->nh_sz);
+		if (is_entry_extended(old))
+			tbl8_free(dp, (uint32_t)(old >> 1));
+	}
+}
+
+/* Sets the next hop of all the addresses in [ledge, redge). */
+static int
+install_to_fib(struct dir24_8_tbl *dp, uint64_t ledge, uint64_t redge,
+		uint64_t next_hop)
+{
+	uint64_t ent = next_hop << 1;
+	uint64_t end;
+	int ret;
+
+	/* Head of the range, up to the first /24 boundary. */
+	if ((ledge & 0xff) != 0 || redge - ledge < DIR24_8_TBL8_GRP_NUM_ENT) {
+		end = RTE_MIN(redge, (ledge | 0xff) + 1);
+		ret = write_tbl8_range(dp, ledge, end, ent);
+		if (ret < 0)
+			return ret;
+		ledge = end;
+	}
+
+	/* Whole /24s. */
+	end = redge & ~(uint64_t)0xff;
+	if (ledge < end) {
+		write_tbl24_range(dp, ledge, end, ent);
+		ledge = end;
+	}
+
+	/* Tail of the range. */
+	if (ledge < redge)
+		return write_tbl8_range(dp, ledge, redge, ent);
+
+	return 0;
+}
+
+/*
+ * Sets the next hop of the addresses of a prefix that are not covered by
+ * a more specific route.
+ */
+static int
+modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+		uint8_t depth, uint64_t next_hop)
+{
+	struct rte_rib_node *tmp = NULL;
+	uint64_t ledge, redge;
+	int ret;
+
+	ledge = ip;
+	redge = (uint64_t)ip + (1ULL << (32 - depth));
+
+	while ((tmp = rte_rib_get_nxt(rib, ip, depth, tmp)) != NULL) {
+		if (rte_rib_get_ip(tmp) > ledge) {
+			ret = install_to_fib(dp, ledge, rte_rib_get_ip(tmp),
+					next_hop);
+			if (ret < 0)
+				return ret;
+		}
+		ledge = (uint64_t)rte_rib_get_ip(tmp) +
+				(1ULL << (32 - rte_rib_get_depth(tmp)));
+	}
+
+	if (ledge < redge)
+		return install_to_fib(dp, ledge, redge, next_hop);
+
+	return 0;
+}
+
+/* Whether the /24 of ip holds routes longer than 24 bits. */
+static inline int
+has_long_routes(struct rte_rib *rib, uint32_t ip)
+{
+	return rte_rib_get_nxt(rib, ip & 0xffffff00, 24, NULL) != NULL;
+}
+
+int
+dir24_8_modify(void *p, struct rte_rib *rib, uint32_t ip, uint8_t depth,
+		uint64_t next_hop, int op)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	struct rte_rib_node *node, *parent;
+	uint64_t par_nh;
+	int reserved = 0;
+	int ret;
+
+	if (dp == NULL || rib == NULL || depth > RTE_FIB_MAXDEPTH)
+		return -EINVAL;
+
+	ip &= (depth == 0) ? 0 : (uint32_t)(UINT64_MAX << (32 - depth));
+
+	node = rte_rib_lookup_exact(rib, ip, depth);
+
+	switch (op) {
+	case RTE_FIB_ADD:
+		if (next_hop > get_max_nh(dp->nh_sz))
+			return -EINVAL;
+
+		if (node != NULL) {
+			if (rte_rib_get_nh(node) == next_hop)
+				return 0;
+			ret = modify_fib(dp, rib, ip, depth, next_hop);
+			if (ret == 0)
+				rte_rib_set_nh(node, next_hop);
+			return ret;
+		}
+
+		/*
+		 * Each /24 holding routes longer than 24 bits needs one tbl8,
+		 * reserve it with the first such route so that no update can
+		 * fail half way through for lack of tbl8s.
+		 */
+		if (depth > 24 && !has_long_routes(rib, ip)) {
+			if (dp->rsvd_tbl8s >= dp->number_tbl8s)
+				return -ENOSPC;
+			dp->rsvd_tbl8s++;
+			reserved = 1;
+		}
+
+		node = rte_rib_insert(rib, ip, depth);
+		if (node == NULL) {
+			dp->rsvd_tbl8s -= reserved;
+			return -rte_errno;
+		}
+		rte_rib_set_nh(node, next_hop);
+
+		parent = rte_rib_lookup_parent(node);
+		par_nh = (parent != NULL) ? rte_rib_get_nh(parent) : dp->def_nh;
+		if (par_nh == next_hop)
+			return 0;
+
+		ret = modify_fib(dp, rib, ip, depth, next_hop);
+		if (ret < 0) {
+			rte_rib_remove(rib, ip, depth);
+			dp->rsvd_tbl8s -= reserved;
+		}
+		return ret;
+
+	case RTE_FIB_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		/* The addresses of the route fall back to its parent. */
+		parent = rte_rib_lookup_parent(node);
+		par_nh = (parent != NULL) ? rte_rib_get_nh(parent) : dp->def_nh;
+		if (par_nh != rte_rib_get_nh(node)) {
+			ret = modify_fib(dp, rib, ip, depth, par_nh);
+			if (ret < 0)
+				return ret;
+		}
+
+		rte_rib_remove(rib, ip, depth);
+		if (depth > 24 && !has_long_routes(rib, ip))
+			dp->rsvd_tbl8s--;
+		return 0;
+
+	default:
+		return -EINVAL;
+	}
+}
+
+rte_fib_lookup_fn_t
+dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+
+	if (type == RTE_FIB_LOOKUP_DEFAULT) {
+		type = RTE_FIB_LOOKUP_SCALAR;
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			type = RTE_FIB_LOOKUP_VECTOR_AVX2;
+#endif
+	}
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_SCALAR:
+		switch (dp->nh_sz) {
+		case RTE_FIB_DIR24_8_1B:
+			return dir24_8_lookup_bulk_1b;
+		case RTE_FIB_DIR24_8_2B:
+			return dir24_8_lookup_bulk_2b;
+		case RTE_FIB_DIR24_8_4B:
+			return dir24_8_lookup_bulk_4b;
+		default:
+			return dir24_8_lookup_bulk_8b;
+		}
+#ifdef CC_AVX2_SUPPORT
+	case RTE_FIB_LOOKUP_VECTOR_AVX2:
+		if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			return NULL;
+		switch (dp->nh_sz) {
+		case RTE_FIB_DIR24_8_1B:
+			return dir24_8_vec_lookup_bulk_1b;
+		case RTE_FIB_DIR24_8_2B:
+			return dir24_8_vec_lookup_bulk_2b;
+		case RTE_FIB_DIR24_8_4B:
+			return dir24_8_vec_lookup_bulk_4b;
+		default:
+			return dir24_8_vec_lookup_bulk_8b;
+		}
+#endif
+	default:
+		return NULL;
+	}
+}
+
+void *
+dir24_8_create(const char *name, int socket_id,
+		const struct rte_fib_conf *conf)
+{
+	char mem_name[RTE_FIB_NAMESIZE];
+	struct dir24_8_tbl *dp;
+	uint8_t nh_sz = conf->dir24_8.nh_sz;
+	uint32_t num_tbl8 = conf->dir24_8.num_tbl8;
+	uint32_t i;
+
+	if (nh_sz > RTE_FIB_DIR24_8_8B || num_tbl8 == 0 ||
+			num_tbl8 > RTE_MIN((uint64_t)RTE_FIB_DIR24_8_MAX_TBL8,
+				get_max_nh(nh_sz) + 1) ||
+			conf->default_nh > get_max_nh(nh_sz)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct dir24_8_tbl) +
+			((size_t)DIR24_8_TBL24_NUM_ENT << nh_sz) +
+			DIR24_8_TBL_PAD, RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_%s", name);
+	dp->tbl8 = rte_zmalloc_socket(mem_name, (((size_t)num_tbl8 *
+			DIR24_8_TBL8_GRP_NUM_ENT) << nh_sz) + DIR24_8_TBL_PAD,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	dp->tbl8_pool = rte_malloc_socket(NULL, sizeof(uint32_t) * num_tbl8,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8 == NULL || dp->tbl8_pool == NULL) {
+		rte_free(dp->tbl8_pool);
+		rte_free(dp->tbl8);
+		rte_free(dp);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	dp->number_tbl8s = num_tbl8;
+	dp->nh_sz = nh_sz;
+	dp->def_nh = conf->default_nh;
+
+	for (i = 0; i < num_tbl8; i++)
+		dp->tbl8_pool[i] = i;
+
+	write_ents(dp->tbl24, 0, dp->def_nh << 1, DIR24_8_TBL24_NUM_ENT,
+			nh_sz);
+
+	return dp;
+}
+
+void
+dir24_8_free(void *p)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+
+	if (dp == NULL)
+		return;
+
+	rte_free(dp->tbl8_pool);
+	rte_free(dp->tbl8);
+	rte_free(dp);
+}
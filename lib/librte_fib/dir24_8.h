@@ -0,0 +1,165 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _DIR24_8_H_
+#define _DIR24_8_H_
+
+/**
+ * @file
+ * DIR-24-8 dataplane of the FIB library, internal to the library.
+ */
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_prefetch.h>
+#include <rte_branch_prediction.h>
+
+#include "rte_fib.h"
+
+#define DIR24_8_TBL24_NUM_ENT		(1 << 24)
+#define DIR24_8_TBL8_GRP_NUM_ENT	256U
+/** Lowest bit of an entry, set when it holds a tbl8 index. */
+#define DIR24_8_EXT_ENT			1
+/** Bytes read past the end of a table by the vector lookups. */
+#define DIR24_8_TBL_PAD			8
+
+/** Number of lookups the bulk functions prefetch ahead. */
+#define DIR24_8_BULK_PREFETCH		4
+
+/** Operations on the FIB passed to dir24_8_modify(). */
+enum {
+	RTE_FIB_ADD,
+	RTE_FIB_DEL
+};
+
+typedef void (*rte_fib_lookup_fn_t)(void *dp, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned int n);
+
+struct dir24_8_tbl {
+	uint32_t number_tbl8s;	/**< Total number of tbl8s. */
+	uint32_t rsvd_tbl8s;	/**< tbl8s reserved by routes longer than 24. */
+	uint32_t cur_tbl8s;	/**< tbl8s in use. */
+	enum rte_fib_dir24_8_nh_sz nh_sz; /**< Size of the entries. */
+	uint64_t def_nh;	/**< Default next hop. */
+	uint8_t *tbl8;		/**< tbl8s. */
+	uint32_t *tbl8_pool;	/**< Stack of the free tbl8s. */
+	uint32_t tbl8_pool_pos;	/**< Number of tbl8s taken from the stack. */
+	uint8_t tbl24[] __rte_cache_aligned; /**< tbl24, entries of nh_sz. */
+};
+
+static inline void *
+get_tbl24_p(struct dir24_8_tbl *dp, uint32_t ip, uint8_t nh_sz)
+{
+	return (void *)&dp->tbl24[(size_t)(ip >> 8) << nh_sz];
+}
+
+static inline int
+is_entry_extended(uint64_t ent)
+{
+	return (ent & DIR24_8_EXT_ENT) == DIR24_8_EXT_ENT;
+}
+
+/*
+ * Scalar bulk lookups, one per entry size. The tbl24 entries of the next
+ * addresses are prefetched while the current one is resolved.
+ */
+#define LOOKUP_FUNC(suffix, type, nh_sz)				\
+static inline void							\
+dir24_8_lookup_bulk_##suffix(void *p, const uint32_t *ips,		\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;		\
+	const type *tbl24 = (const type *)dp->tbl24;			\
+	const type *tbl8 = (const type *)dp->tbl8;			\
+	uint64_t tmp;							\
+	uint32_t i;							\
+	uint32_t prefetch_offset =					\
+		RTE_MIN((unsigned int)DIR24_8_BULK_PREFETCH, n);	\
+									\
+	for (i = 0; i < prefetch_offset; i++)				\
+		rte_prefetch0(get_tbl24_p(dp, ips[i], nh_sz));		\
+	for (i = 0; i < (n - prefetch_offset); i++) {			\
+		rte_prefetch0(get_tbl24_p(dp,				\
+			ips[i + prefetch_offset], nh_sz));		\
+		tmp = tbl24[ips[i] >> 8];				\
+		if (unlikely(is_entry_extended(tmp)))			\
+			tmp = tbl8[(uint8_t)ips[i] +			\
+				((tmp >> 1) * DIR24_8_TBL8_GRP_NUM_ENT)]; \
+		next_hops[i] = tmp >> 1;				\
+	}								\
+	for (; i < n; i++) {						\
+		tmp = tbl24[ips[i] >> 8];				\
+		if (unlikely(is_entry_extended(tmp)))			\
+			tmp = tbl8[(uint8_t)ips[i] +			\
+				((tmp >> 1) * DIR24_8_TBL8_GRP_NUM_ENT)]; \
+		next_hops[i] = tmp >> 1;				\
+	}								\
+}
+
+LOOKUP_FUNC(1b, uint8_t, 0)
+LOOKUP_FUNC(2b, uint16_t, 1)
+LOOKUP_FUNC(4b, uint32_t, 2)
+LOOKUP_FUNC(8b, uint64_t, 3)
+
+void *
+dir24_8_create(const char *name, int socket_id,
+		const struct rte_fib_conf *conf);
+
+void
+dir24_8_free(void *p);
+
+rte_fib_lookup_fn_t
+dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type);
+
+int
+dir24_8_modify(void *p, struct rte_rib *rib, uint32_t ip, uint8_t depth,
+		uint64_t next_hop, int op);
+
+/* AVX2 lookup functions, only built when the compiler supports AVX2. */
+void
+dir24_8_vec_lookup_bulk_1b(void *p, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned int n);
+
+void
+dir24_8_vec_lookup_bulk_2b(void *p, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned int n);
+
+void
+dir24_8_vec_lookup_bulk_4b(void *p, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned int n);
+
+void
+dir24_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned int n);
+
+#endif /* _DIR24_8_H_ */
@@ -0,0 +1,155 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_fib.h"
+#include "dir24_8.h"
+
+/*
+ * Looks up eight addresses with 1, 2 or 4 byte entries. Entries are
+ * gathered as 32 bit words, the bytes past the entry are masked off,
+ * which is why the tables are padded.
+ */
+static inline void
+dir24_8_vec_lookup_x8(void *p, const uint32_t *ips, uint64_t *next_hops,
+		int size)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	const __m256i lsb = _mm256_set1_epi32(1);
+	const __m256i lsbyte_msk = _mm256_set1_epi32(0xff);
+	__m256i msk, ip_vec, idxes, res, ext;
+
+	if (size == sizeof(uint8_t))
+		msk = _mm256_set1_epi32(UINT8_MAX);
+	else if (size == sizeof(uint16_t))
+		msk = _mm256_set1_epi32(UINT16_MAX);
+	else
+		msk = _mm256_set1_epi32(-1);
+
+	ip_vec = _mm256_loadu_si256((const __m256i *)ips);
+	idxes = _mm256_srli_epi32(ip_vec, 8);
+
+	/* The scale of a gather has to be a constant. */
+	if (size == sizeof(uint8_t))
+		res = _mm256_i32gather_epi32((const int *)dp->tbl24, idxes, 1);
+	else if (size == sizeof(uint16_t))
+		res = _mm256_i32gather_epi32((const int *)dp->tbl24, idxes, 2);
+	else
+		res = _mm256_i32gather_epi32((const int *)dp->tbl24, idxes, 4);
+	res = _mm256_and_si256(res, msk);
+
+	/* Resolve the entries pointing to a tbl8. */
+	ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, lsb), lsb);
+	if (!_mm256_testz_si256(ext, ext)) {
+		idxes = _mm256_add_epi32(
+				_mm256_slli_epi32(_mm256_srli_epi32(res, 1), 8),
+				_mm256_and_si256(ip_vec, lsbyte_msk));
+		if (size == sizeof(uint8_t))
+			res = _mm256_mask_i32gather_epi32(res,
+					(const int *)dp->tbl8, idxes, ext, 1);
+		else if (size == sizeof(uint16_t))
+			res = _mm256_mask_i32gather_epi32(res,
+					(const int *)dp->tbl8, idxes, ext, 2);
+		else
+			res = _mm256_mask_i32gather_epi32(res,
+					(const int *)dp->tbl8, idxes, ext, 4);
+		res = _mm256_and_si256(res, msk);
+	}
+
+	res = _mm256_srli_epi32(res, 1);
+	_mm256_storeu_si256((__m256i *)next_hops,
+			_mm256_cvtepu32_epi64(_mm256_castsi256_si128(res)));
+	_mm256_storeu_si256((__m256i *)(next_hops + 4),
+			_mm256_cvtepu32_epi64(_mm256_extracti128_si256(res, 1)));
+}
+
+/* Looks up four addresses with 8 byte entries. */
+static inline void
+dir24_8_vec_lookup_x4_8b(void *p, const uint32_t *ips, uint64_t *next_hops)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	const __m256i lsb = _mm256_set1_epi64x(1);
+	__m128i ip_vec, idxes;
+	__m256i res, ext, idxes8;
+
+	ip_vec = _mm_loadu_si128((const __m128i *)ips);
+	idxes = _mm_srli_epi32(ip_vec, 8);
+	res = _mm256_i32gather_epi64((const long long *)dp->tbl24, idxes, 8);
+
+	ext = _mm256_cmpeq_epi64(_mm256_and_si256(res, lsb), lsb);
+	if (!_mm256_testz_si256(ext, ext)) {
+		idxes8 = _mm256_add_epi64(
+				_mm256_slli_epi64(_mm256_srli_epi64(res, 1), 8),
+				_mm256_cvtepu32_epi64(_mm_and_si128(ip_vec,
+					_mm_set1_epi32(0xff))));
+		res = _mm256_mask_i64gather_epi64(res,
+				(const long long *)dp->tbl8, idxes8, ext, 8);
+	}
+
+	_mm256_storeu_si256((__m256i *)next_hops, _mm256_srli_epi64(res, 1));
+}
+
+#define VEC_LOOKUP_FUNC(suffix, type)					\
+void									\
+dir24_8_vec_lookup_bulk_##suffix(void *p, const uint32_t *ips,		\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	uint32_t i;							\
+									\
+	for (i = 0; i < n / 8; i++)					\
+		dir24_8_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8, \
+				sizeof(type));				\
+									\
+	dir24_8_lookup_bulk_##suffix(p, ips + i * 8, next_hops + i * 8, \
+			n - i * 8);					\
+}
+
+VEC_LOOKUP_FUNC(1b, uint8_t)
+VEC_LOOKUP_FUNC(2b, uint16_t)
+VEC_LOOKUP_FUNC(4b, uint32_t)
+
+void
+dir24_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < n / 4; i++)
+		dir24_8_vec_lookup_x4_8b(p, ips + i * 4, next_hops + i * 4);
+
+	dir24_8_lookup_bulk_8b(p, ips + i * 4, next_hops + i * 4, n - i * 4);
+}
@@ -0,0 +1,271 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_rwlock.h>
+#include <rte_tailq.h>
+
+#include "rte_rib.h"
+#include "rte_fib.h"
+#include "dir24_8.h"
+
+TAILQ_HEAD(rte_fib_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_fib_tailq = {
+	.name = "RTE_FIB",
+};
+EAL_REGISTER_TAILQ(rte_fib_tailq)
+
+struct rte_fib {
+	char name[RTE_FIB_NAMESIZE];	/**< Name of the FIB. */
+	enum rte_fib_type type;		/**< Type of dataplane. */
+	struct rte_rib *rib;		/**< Routes of the FIB. */
+	void *dp;			/**< Dataplane. */
+	rte_fib_lookup_fn_t lookup;	/**< Bulk lookup of the dataplane. */
+};
+
+struct rte_fib *
+rte_fib_create(const char *name, int socket_id,
+		const struct rte_fib_conf *conf)
+{
+	char mem_name[RTE_FIB_NAMESIZE];
+	struct rte_fib *fib = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_fib_list *fib_list;
+	struct rte_rib_conf rib_conf;
+	struct rte_rib *rib;
+
+	fib_list = RTE_TAILQ_CAST(rte_fib_tailq.head, rte_fib_list);
+
+	/* Check user arguments. */
+	if (name == NULL || conf == NULL || socket_id < -1 ||
+			conf->type != RTE_FIB_DIR24_8 ||
+			conf->max_routes == 0 ||
+			conf->max_routes > UINT32_MAX / 2) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "FIB_%s", name);
+
+	/*
+	 * The RIB takes the tailq lock itself. A route takes a node, plus
+	 * a branching point at most.
+	 */
+	rib_conf.max_nodes = conf->max_routes * 2;
+	rib = rte_rib_create(name, socket_id, &rib_conf);
+	if (rib == NULL) {
+		RTE_LOG(ERR, LPM, "Can not allocate RIB %s\n", name);
+		return NULL;
+	}
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, fib_list, next) {
+		fib = (struct rte_fib *)te->data;
+		if (strncmp(name, fib->name, RTE_FIB_NAMESIZE) == 0)
+			break;
+	}
+	fib = NULL;
+	if (te != NULL) {
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("FIB_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, LPM, "Failed to allocate tailq entry for FIB %s\n",
+				name);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	fib = (struct rte_fib *)rte_zmalloc_socket(mem_name, sizeof(*fib),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (fib == NULL) {
+		RTE_LOG(ERR, LPM, "FIB %s memory allocation failed\n", name);
+		rte_errno = ENOMEM;
+		goto free_te;
+	}
+
+	fib->dp = dir24_8_create(name, socket_id, conf);
+	if (fib->dp == NULL) {
+		RTE_LOG(ERR, LPM, "Can not allocate dataplane of FIB %s\n",
+				name);
+		goto free_fib;
+	}
+
+	fib->rib = rib;
+	fib->lookup = dir24_8_get_lookup_fn(fib->dp, RTE_FIB_LOOKUP_DEFAULT);
+	fib->type = conf->type;
+	snprintf(fib->name, sizeof(fib->name), "%s", name);
+
+	te->data = (void *)fib;
+	TAILQ_INSERT_TAIL(fib_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	return fib;
+
+free_fib:
+	rte_free(fib);
+free_te:
+	rte_free(te);
+exit:
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+	rte_rib_free(rib);
+
+	return NULL;
+}
+
+struct rte_fib *
+rte_fib_find_existing(const char *name)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_fib_list *fib_list;
+
+	fib_list = RTE_TAILQ_CAST(rte_fib_tailq.head, rte_fib_list);
+
+	rte_rwlock_read_lock(RTE_EAL_TAILQ_RWLOCK);
+	TAILQ_FOREACH(te, fib_list, next) {
+		fib = (struct rte_fib *)te->data;
+		if (strncmp(name, fib->name, RTE_FIB_NAMESIZE) == 0)
+			break;
+	}
+	rte_rwlock_read_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	if (te == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	return fib;
+}
+
+void
+rte_fib_free(struct rte_fib *fib)
+{
+	struct rte_tailq_entry *te;
+	struct rte_fib_list *fib_list;
+
+	if (fib == NULL)
+		return;
+
+	fib_list = RTE_TAILQ_CAST(rte_fib_tailq.head, rte_fib_list);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, fib_list, next) {
+		if (te->data == (void *)fib)
+			break;
+	}
+	if (te != NULL)
+		TAILQ_REMOVE(fib_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	dir24_8_free(fib->dp);
+	rte_rib_free(fib->rib);
+	rte_free(fib);
+	rte_free(te);
+}
+
+int
+rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+		uint64_t next_hop)
+{
+	if (fib == NULL || depth > RTE_FIB_MAXDEPTH)
+		return -EINVAL;
+
+	return dir24_8_modify(fib->dp, fib->rib, ip, depth, next_hop,
+			RTE_FIB_ADD);
+}
+
+int
+rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
+{
+	if (fib == NULL || depth > RTE_FIB_MAXDEPTH)
+		return -EINVAL;
+
+	return dir24_8_modify(fib->dp, fib->rib, ip, depth, 0, RTE_FIB_DEL);
+}
+
+int
+rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
+		uint64_t *next_hops, int n)
+{
+	if (fib == NULL || ips == NULL || next_hops == NULL || n < 0)
+		return -EINVAL;
+
+	fib->lookup(fib->dp, ips, next_hops, n);
+
+	return 0;
+}
+
+int
+rte_fib_set_lookup_fn(struct rte_fib *fib, enum rte_fib_lookup_type type)
+{
+	rte_fib_lookup_fn_t fn;
+
+	if (fib == NULL)
+		return -EINVAL;
+
+	fn = dir24_8_get_lookup_fn(fib->dp, type);
+	if (fn == NULL)
+		return -EINVAL;
+
+	fib->lookup = fn;
+
+	return 0;
+}
+
+struct rte_rib *
+rte_fib_get_rib(struct rte_fib *fib)
+{
+	return (fib == NULL) ? NULL : fib->rib;
+}
@@ -0,0 +1,229 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_FIB_H_
+#define _RTE_FIB_H_
+
+/**
+ * @file
+ *
+ * RTE IPv4 Forwarding Information Base
+ *
+ * A FIB keeps the routes in two structures: a RIB (see rte_rib.h), used
+ * by the control plane to add and delete routes, and a dataplane built
+ * from it for lookups. The only dataplane for now is DIR-24-8, a tbl24
+ * indexed by the first 24 bits of the address plus tbl8s for the routes
+ * longer than 24 bits, with a next hop width of 1, 2, 4 or 8 bytes chosen
+ * per table. The lowest bit of each entry tells whether the entry holds
+ * a next hop or points to a tbl8, so a next hop takes up to 7, 15, 31 or
+ * 63 bits. Addresses not covered by any route get the default next hop.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct rte_fib;
+struct rte_rib;
+
+/** Max number of characters in FIB name. */
+#define RTE_FIB_NAMESIZE		32
+
+/** Maximum depth value possible for IPv4 FIB. */
+#define RTE_FIB_MAXDEPTH		32
+
+/** Maximum number of tbl8s of a DIR-24-8 FIB. */
+#define RTE_FIB_DIR24_8_MAX_TBL8	(1 << 23)
+
+/** Type of FIB dataplane. */
+enum rte_fib_type {
+	RTE_FIB_DIR24_8		/**< DIR-24-8 tables */
+};
+
+/** Size of a DIR-24-8 entry, which holds a next hop or a tbl8 index. */
+enum rte_fib_dir24_8_nh_sz {
+	RTE_FIB_DIR24_8_1B,	/**< 7 bit next hops, up to 128 tbl8s */
+	RTE_FIB_DIR24_8_2B,	/**< 15 bit next hops, up to 32768 tbl8s */
+	RTE_FIB_DIR24_8_4B,	/**< 31 bit next hops */
+	RTE_FIB_DIR24_8_8B	/**< 63 bit next hops */
+};
+
+/** Lookup function implementations. */
+enum rte_fib_lookup_type {
+	RTE_FIB_LOOKUP_DEFAULT,		/**< Best available */
+	RTE_FIB_LOOKUP_SCALAR,		/**< One address at a time */
+	RTE_FIB_LOOKUP_VECTOR_AVX2	/**< Eight addresses at a time */
+};
+
+/** FIB configuration structure */
+struct rte_fib_conf {
+	enum rte_fib_type type;	/**< Type of dataplane. */
+	/** Next hop of the addresses not covered by any route. */
+	uint64_t default_nh;
+	uint32_t max_routes;	/**< Max number of routes. */
+	union {
+		struct {
+			enum rte_fib_dir24_8_nh_sz nh_sz;
+			uint32_t num_tbl8;	/**< Number of tbl8s. */
+		} dir24_8;	/**< DIR-24-8 parameters. */
+	};
+};
+
+/**
+ * Create a FIB object.
+ *
+ * @param name
+ *   FIB object name
+ * @param socket_id
+ *   NUMA socket ID for FIB table memory allocation
+ * @param conf
+ *   Structure containing the configuration
+ * @return
+ *   Handle to FIB object on success, NULL otherwise with rte_errno set
+ *   to an appropriate value. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - EEXIST - a FIB with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_fib *
+rte_fib_create(const char *name, int socket_id,
+		const struct rte_fib_conf *conf);
+
+/**
+ * Find an existing FIB object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the FIB object as passed to rte_fib_create()
+ * @return
+ *   Pointer to FIB object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_fib *
+rte_fib_find_existing(const char *name);
+
+/**
+ * Free a FIB object.
+ *
+ * @param fib
+ *   FIB object handle
+ */
+void
+rte_fib_free(struct rte_fib *fib);
+
+/**
+ * Add a route to the FIB, or update the next hop of an existing route.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ip
+ *   IP of the route, bits beyond depth are ignored
+ * @param depth
+ *   Depth of the route, 0 to RTE_FIB_MAXDEPTH
+ * @param next_hop
+ *   Next hop of the route
+ * @return
+ *   0 on success, -EINVAL on invalid parameters (including a next hop
+ *   too large for the entry size), -ENOSPC when the route or tbl8 limit
+ *   is reached
+ */
+int
+rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+		uint64_t next_hop);
+
+/**
+ * Delete a route from the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ip
+ *   IP of the route
+ * @param depth
+ *   Depth of the route
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -ENOENT if the route
+ *   is not present
+ */
+int
+rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth);
+
+/**
+ * Look up several IP addresses in the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPs to be looked up
+ * @param next_hops
+ *   Next hop of each IP, the default next hop for IPs without a route
+ * @param n
+ *   Number of elements in the ips and next_hops arrays
+ * @return
+ *   0 on success, -EINVAL on invalid parameters
+ */
+int
+rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
+		uint64_t *next_hops, int n);
+
+/**
+ * Select the lookup function used by rte_fib_lookup_bulk().
+ *
+ * @param fib
+ *   FIB object handle
+ * @param type
+ *   Lookup implementation
+ * @return
+ *   0 on success, -EINVAL if the implementation is not supported by the
+ *   build or the CPU
+ */
+int
+rte_fib_set_lookup_fn(struct rte_fib *fib, enum rte_fib_lookup_type type);
+
+/**
+ * Get the RIB of a FIB, which can be used to walk the routes.
+ *
+ * @param fib
+ *   FIB object handle
+ * @return
+ *   RIB object handle
+ */
+struct rte_rib *
+rte_fib_get_rib(struct rte_fib *fib);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_FIB_H_ */
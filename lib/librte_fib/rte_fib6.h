@@ -0,0 +1,233 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_FIB6_H_
+#define _RTE_FIB6_H_
+
+/**
+ * @file
+ *
+ * RTE IPv6 Forwarding Information Base
+ *
+ * The IPv6 counterpart of rte_fib.h, with the same interface so that an
+ * application can use either engine the same way. The routes are kept in
+ * a RIB (see rte_rib6.h) and the dataplane is a multibit trie: a tbl24
+ * indexed by the first 24 bits of the address, then up to 13 levels of
+ * tbl8 groups, one per following byte, created only where routes longer
+ * than the level exist. Entries are 2, 4 or 8 bytes wide, the lowest bit
+ * telling whether the entry holds a next hop or the index of the tbl8
+ * group of the next level.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct rte_fib6;
+struct rte_rib6;
+
+/** Size of an IPv6 address in bytes. */
+#define RTE_FIB6_IPV6_ADDR_SIZE		16
+
+/** Max number of characters in FIB name. */
+#define RTE_FIB6_NAMESIZE		32
+
+/** Maximum depth value possible for IPv6 FIB. */
+#define RTE_FIB6_MAXDEPTH		128
+
+/** Maximum number of tbl8s of a trie FIB. */
+#define RTE_FIB6_TRIE_MAX_TBL8		(1 << 23)
+
+/** Type of FIB dataplane. */
+enum rte_fib6_type {
+	RTE_FIB6_TRIE		/**< Multibit trie, 24 then 8 bits per level */
+};
+
+/** Size of a trie entry, which holds a next hop or a tbl8 index. */
+enum rte_fib6_trie_nh_sz {
+	RTE_FIB6_TRIE_2B = 1,	/**< 15 bit next hops, up to 32768 tbl8s */
+	RTE_FIB6_TRIE_4B,	/**< 31 bit next hops */
+	RTE_FIB6_TRIE_8B	/**< 63 bit next hops */
+};
+
+/** Lookup function implementations. */
+enum rte_fib6_lookup_type {
+	RTE_FIB6_LOOKUP_DEFAULT,	/**< Interleaved scalar lookups */
+	RTE_FIB6_LOOKUP_SCALAR,		/**< Interleaved scalar lookups */
+	RTE_FIB6_LOOKUP_VECTOR_AVX2	/**< AVX2 gathers, 32 at a time */
+};
+
+/** FIB configuration structure */
+struct rte_fib6_conf {
+	enum rte_fib6_type type; /**< Type of dataplane. */
+	/** Next hop of the addresses not covered by any route. */
+	uint64_t default_nh;
+	uint32_t max_routes;	/**< Max number of routes. */
+	union {
+		struct {
+			enum rte_fib6_trie_nh_sz nh_sz;
+			uint32_t num_tbl8;	/**< Number of tbl8s. */
+		} trie;		/**< Trie parameters. */
+	};
+};
+
+/**
+ * Create a FIB object.
+ *
+ * @param name
+ *   FIB object name
+ * @param socket_id
+ *   NUMA socket ID for FIB table memory allocation
+ * @param conf
+ *   Structure containing the configuration
+ * @return
+ *   Handle to FIB object on success, NULL otherwise with rte_errno set
+ *   to an appropriate value. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - EEXIST - a FIB with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_fib6 *
+rte_fib6_create(const char *name, int socket_id,
+		const struct rte_fib6_conf *conf);
+
+/**
+ * Find an existing FIB object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the FIB object as passed to rte_fib6_create()
+ * @return
+ *   Pointer to FIB object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_fib6 *
+rte_fib6_find_existing(const char *name);
+
+/**
+ * Free a FIB object.
+ *
+ * @param fib
+ *   FIB object handle
+ */
+void
+rte_fib6_free(struct rte_fib6 *fib);
+
+/**
+ * Add a route to the FIB, or update the next hop of an existing route.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ip
+ *   IP of the route, bits beyond depth are ignored
+ * @param depth
+ *   Depth of the route, 0 to RTE_FIB6_MAXDEPTH
+ * @param next_hop
+ *   Next hop of the route
+ * @return
+ *   0 on success, -EINVAL on invalid parameters (including a next hop
+ *   too large for the entry size), -ENOSPC when the route or tbl8 limit
+ *   is reached
+ */
+int
+rte_fib6_add(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+		uint8_t depth, uint64_t next_hop);
+
+/**
+ * Delete a route from the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ip
+ *   IP of the route
+ * @param depth
+ *   Depth of the route
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -ENOENT if the route
+ *   is not present
+ */
+int
+rte_fib6_delete(struct rte_fib6 *fib,
+		const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth);
+
+/**
+ * Look up several IP addresses in the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPs to be looked up
+ * @param next_hops
+ *   Next hop of each IP, the default next hop for IPs without a route
+ * @param n
+ *   Number of elements in the ips and next_hops arrays
+ * @return
+ *   0 on success, -EINVAL on invalid parameters
+ */
+int
+rte_fib6_lookup_bulk(struct rte_fib6 *fib,
+		uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, int n);
+
+/**
+ * Select the lookup function used by rte_fib6_lookup_bulk().
+ *
+ * @param fib
+ *   FIB object handle
+ * @param type
+ *   Lookup implementation
+ * @return
+ *   0 on success, -EINVAL if the implementation is not supported by the
+ *   build or the CPU
+ */
+int
+rte_fib6_set_lookup_fn(struct rte_fib6 *fib, enum rte_fib6_lookup_type type);
+
+/**
+ * Get the RIB of a FIB, which can be used to walk the routes.
+ *
+ * @param fib
+ *   FIB object handle
+ * @return
+ *   RIB object handle
+ */
+struct rte_rib6 *
+rte_fib6_get_rib(struct rte_fib6 *fib);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_FIB6_H_ */
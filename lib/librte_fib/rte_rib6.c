@@ -0,0 +1,553 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <rte_log.h>
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_rwlock.h>
+#include <rte_tailq.h>
+
+#include "rte_rib6.h"
+
+TAILQ_HEAD(rte_rib6_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_rib6_tailq = {
+	.name = "RTE_RIB6",
+};
+EAL_REGISTER_TAILQ(rte_rib6_tailq)
+
+/** The node holds a route, as opposed to a branching point. */
+#define RTE_RIB6_VALID_NODE	1
+
+struct rte_rib6_node {
+	struct rte_rib6_node *left;   /**< Subtree where the next bit is 0. */
+	struct rte_rib6_node *right;  /**< Subtree where the next bit is 1. */
+	struct rte_rib6_node *parent; /**< Parent node, NULL for the root. */
+	uint64_t nh;                 /**< Next hop of the route. */
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE]; /**< Prefix, masked to depth. */
+	uint8_t depth;               /**< Prefix length. */
+	uint8_t flag;                /**< RTE_RIB6_VALID_NODE or 0. */
+};
+
+struct rte_rib6 {
+	char name[RTE_RIB6_NAMESIZE]; /**< Name of the RIB. */
+	struct rte_rib6_node *tree;   /**< Root of the trie. */
+	struct rte_rib6_node *free_nodes; /**< Free nodes, chained by left. */
+	uint32_t max_nodes;          /**< Number of nodes. */
+	uint32_t cur_nodes;          /**< Nodes in use. */
+	uint32_t cur_routes;         /**< Routes in the trie. */
+	struct rte_rib6_node nodes[] __rte_cache_aligned; /**< Node pool. */
+};
+
+static inline int
+is_valid_node(const struct rte_rib6_node *node)
+{
+	return (node->flag & RTE_RIB6_VALID_NODE) == RTE_RIB6_VALID_NODE;
+}
+
+/* Copy the first depth bits of src to dst, clearing the others. */
+static inline void
+mask_ip(uint8_t *dst, const uint8_t *src, uint8_t depth)
+{
+	int i;
+
+	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++) {
+		if (depth >= 8)
+			dst[i] = src[i];
+		else if (depth > 0)
+			dst[i] = src[i] & (uint8_t)(0xff << (8 - depth));
+		else
+			dst[i] = 0;
+		depth -= RTE_MIN(depth, 8);
+	}
+}
+
+/* Whether ip1 and ip2 share their first depth bits. */
+static inline int
+is_covered(const uint8_t *ip1, const uint8_t *ip2, uint8_t depth)
+{
+	int i;
+
+	for (i = 0; depth >= 8; i++, depth -= 8)
+		if (ip1[i] != ip2[i])
+			return 0;
+
+	return (depth == 0) ||
+		((ip1[i] ^ ip2[i]) & (uint8_t)(0xff << (8 - depth))) == 0;
+}
+
+/* Length of the common prefix of ip1 and ip2. */
+static inline uint8_t
+common_depth(const uint8_t *ip1, const uint8_t *ip2)
+{
+	int i;
+
+	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
+		if (ip1[i] != ip2[i])
+			return i * 8 + __builtin_clz(ip1[i] ^ ip2[i]) - 24;
+
+	return RTE_RIB6_MAXDEPTH;
+}
+
+/* Bit of ip right after the first depth bits, depth must be below 128. */
+static inline int
+get_dir(const uint8_t *ip, uint8_t depth)
+{
+	return (ip[depth / 8] >> (7 - depth % 8)) & 1;
+}
+
+static inline struct rte_rib6_node *
+get_nxt_node(const struct rte_rib6_node *node, const uint8_t *ip)
+{
+	if (node->depth == RTE_RIB6_MAXDEPTH)
+		return NULL;
+	return get_dir(ip, node->depth) ? node->right : node->left;
+}
+
+static inline struct rte_rib6_node *
+node_alloc(struct rte_rib6 *rib)
+{
+	struct rte_rib6_node *node = rib->free_nodes;
+
+	rib->free_nodes = node->left;
+	rib->cur_nodes++;
+	memset(node, 0, sizeof(*node));
+
+	return node;
+}
+
+static inline void
+node_free(struct rte_rib6 *rib, struct rte_rib6_node *node)
+{
+	node->left = rib->free_nodes;
+	rib->free_nodes = node;
+	rib->cur_nodes--;
+}
+
+struct rte_rib6_node *
+rte_rib6_lookup(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
+{
+	struct rte_rib6_node *cur, *prev = NULL;
+
+	if (rib == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	cur = rib->tree;
+	while (cur != NULL && is_covered(ip, cur->ip, cur->depth)) {
+		if (is_valid_node(cur))
+			prev = cur;
+		cur = get_nxt_node(cur, ip);
+	}
+
+	return prev;
+}
+
+struct rte_rib6_node *
+rte_rib6_lookup_exact(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *cur;
+	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+
+	if (rib == NULL || depth > RTE_RIB6_MAXDEPTH) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	mask_ip(tmp_ip, ip, depth);
+
+	cur = rib->tree;
+	while (cur != NULL) {
+		if (cur->depth == depth && is_covered(cur->ip, tmp_ip, depth))
+			return is_valid_node(cur) ? cur : NULL;
+		if (cur->depth >= depth ||
+				!is_covered(tmp_ip, cur->ip, cur->depth))
+			return NULL;
+		cur = get_nxt_node(cur, tmp_ip);
+	}
+
+	return NULL;
+}
+
+struct rte_rib6_node *
+rte_rib6_lookup_parent(struct rte_rib6_node *node)
+{
+	struct rte_rib6_node *cur;
+
+	if (node == NULL)
+		return NULL;
+
+	for (cur = node->parent; cur != NULL; cur = cur->parent)
+		if (is_valid_node(cur))
+			return cur;
+
+	return NULL;
+}
+
+struct rte_rib6_node *
+rte_rib6_get_nxt(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth,
+		struct rte_rib6_node *last)
+{
+	struct rte_rib6_node *tmp;
+	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+
+	if (rib == NULL || depth >= RTE_RIB6_MAXDEPTH)
+		return NULL;
+
+	mask_ip(tmp_ip, ip, depth);
+
+	if (last == NULL) {
+		/* Find the root of the subtree of more specific routes. */
+		tmp = rib->tree;
+		while (tmp != NULL && tmp->depth < depth) {
+			if (!is_covered(tmp_ip, tmp->ip, tmp->depth))
+				return NULL;
+			tmp = get_nxt_node(tmp, tmp_ip);
+		}
+		if (tmp == NULL || !is_covered(tmp->ip, tmp_ip, depth))
+			return NULL;
+		/* The prefix itself is not part of the result. */
+		if (tmp->depth == depth) {
+			tmp = (tmp->left != NULL) ? tmp->left : tmp->right;
+			if (tmp == NULL)
+				return NULL;
+		}
+	} else {
+		/*
+		 * Skip the subtree of the last route, climbing up until a
+		 * right branch that has not been visited yet.
+		 */
+		tmp = last;
+		while (tmp->parent != NULL && tmp->parent->depth >= depth &&
+				(tmp->parent->right == tmp ||
+				tmp->parent->right == NULL))
+			tmp = tmp->parent;
+		if (tmp->parent == NULL || tmp->parent->depth < depth)
+			return NULL;
+		tmp = tmp->parent->right;
+	}
+
+	/* Branching points always have two children. */
+	while (!is_valid_node(tmp))
+		tmp = (tmp->left != NULL) ? tmp->left : tmp->right;
+
+	return tmp;
+}
+
+struct rte_rib6_node *
+rte_rib6_insert(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node **tmp, *cur, *prev = NULL;
+	struct rte_rib6_node *new_node, *common_node;
+	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	uint32_t needed = 1;
+	uint8_t com_depth = 0;
+
+	if (rib == NULL || depth > RTE_RIB6_MAXDEPTH) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	mask_ip(tmp_ip, ip, depth);
+
+	/* Walk down while the nodes on the way cover the new route. */
+	tmp = &rib->tree;
+	while (*tmp != NULL) {
+		cur = *tmp;
+		if (cur->depth == depth && is_covered(cur->ip, tmp_ip, depth)) {
+			if (is_valid_node(cur)) {
+				rte_errno = EEXIST;
+				return NULL;
+			}
+			/* Turn the branching point into a route. */
+			cur->flag |= RTE_RIB6_VALID_NODE;
+			cur->nh = 0;
+			rib->cur_routes++;
+			return cur;
+		}
+		if (cur->depth >= depth ||
+				!is_covered(tmp_ip, cur->ip, cur->depth))
+			break;
+		prev = cur;
+		tmp = get_dir(tmp_ip, cur->depth) ? &cur->right : &cur->left;
+	}
+
+	/*
+	 * Either the new route covers the node in its place, or both need
+	 * a new branching point at the length of their common prefix.
+	 */
+	cur = *tmp;
+	if (cur != NULL) {
+		com_depth = common_depth(tmp_ip, cur->ip);
+		com_depth = RTE_MIN(com_depth, RTE_MIN(depth, cur->depth));
+		if (com_depth != depth)
+			needed = 2;
+	}
+
+	if (rib->max_nodes - rib->cur_nodes < needed) {
+		rte_errno = ENOSPC;
+		return NULL;
+	}
+
+	new_node = node_alloc(rib);
+	memcpy(new_node->ip, tmp_ip, RTE_RIB6_IPV6_ADDR_SIZE);
+	new_node->depth = depth;
+	new_node->flag = RTE_RIB6_VALID_NODE;
+	new_node->parent = prev;
+
+	if (cur == NULL) {
+		*tmp = new_node;
+	} else if (com_depth == depth) {
+		if (get_dir(cur->ip, depth))
+			new_node->right = cur;
+		else
+			new_node->left = cur;
+		cur->parent = new_node;
+		*tmp = new_node;
+	} else {
+		common_node = node_alloc(rib);
+		mask_ip(common_node->ip, tmp_ip, com_depth);
+		common_node->depth = com_depth;
+		common_node->parent = prev;
+		if (get_dir(tmp_ip, com_depth)) {
+			common_node->right = new_node;
+			common_node->left = cur;
+		} else {
+			common_node->left = new_node;
+			common_node->right = cur;
+		}
+		new_node->parent = common_node;
+		cur->parent = common_node;
+		*tmp = common_node;
+	}
+
+	rib->cur_routes++;
+
+	return new_node;
+}
+
+void
+rte_rib6_remove(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *cur, *parent, *child;
+
+	cur = rte_rib6_lookup_exact(rib, ip, depth);
+	if (cur == NULL)
+		return;
+
+	cur->flag &= ~RTE_RIB6_VALID_NODE;
+	rib->cur_routes--;
+
+	/* Drop the nodes that no longer hold a route nor split branches. */
+	while (cur != NULL && !is_valid_node(cur)) {
+		if (cur->left != NULL && cur->right != NULL)
+			break;
+
+		child = (cur->left != NULL) ? cur->left : cur->right;
+		parent = cur->parent;
+		if (child != NULL)
+			child->parent = parent;
+		if (parent == NULL)
+			rib->tree = child;
+		else if (parent->left == cur)
+			parent->left = child;
+		else
+			parent->right = child;
+
+		node_free(rib, cur);
+		cur = parent;
+	}
+}
+
+void
+rte_rib6_get_ip(const struct rte_rib6_node *node,
+		uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
+{
+	memcpy(ip, node->ip, RTE_RIB6_IPV6_ADDR_SIZE);
+}
+
+uint8_t
+rte_rib6_get_depth(const struct rte_rib6_node *node)
+{
+	return node->depth;
+}
+
+uint64_t
+rte_rib6_get_nh(const struct rte_rib6_node *node)
+{
+	return node->nh;
+}
+
+void
+rte_rib6_set_nh(struct rte_rib6_node *node, uint64_t nh)
+{
+	node->nh = nh;
+}
+
+struct rte_rib6 *
+rte_rib6_create(const char *name, int socket_id,
+		const struct rte_rib6_conf *conf)
+{
+	char mem_name[RTE_RIB6_NAMESIZE];
+	struct rte_rib6 *rib = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_rib6_list *rib_list;
+	uint32_t i;
+
+	rib_list = RTE_TAILQ_CAST(rte_rib6_tailq.head, rte_rib6_list);
+
+	/* Check user arguments. */
+	if (name == NULL || conf == NULL || socket_id < -1 ||
+			conf->max_nodes == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "RIB6_%s", name);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, rib_list, next) {
+		rib = (struct rte_rib6 *)te->data;
+		if (strncmp(name, rib->name, RTE_RIB6_NAMESIZE) == 0)
+			break;
+	}
+	rib = NULL;
+	if (te != NULL) {
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("RIB6_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, LPM, "Failed to allocate tailq entry for RIB %s\n",
+				name);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	rib = (struct rte_rib6 *)rte_zmalloc_socket(mem_name, sizeof(*rib) +
+			sizeof(struct rte_rib6_node) * (size_t)conf->max_nodes,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (rib == NULL) {
+		RTE_LOG(ERR, LPM, "RIB %s memory allocation failed\n", name);
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	snprintf(rib->name, sizeof(rib->name), "%s", name);
+	rib->max_nodes = conf->max_nodes;
+
+	for (i = 0; i < conf->max_nodes; i++)
+		node_free(rib, &rib->nodes[i]);
+	rib->cur_nodes = 0;
+
+	te->data = (void *)rib;
+	TAILQ_INSERT_TAIL(rib_list, te, next);
+
+exit:
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	return rib;
+}
+
+struct rte_rib6 *
+rte_rib6_find_existing(const char *name)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_rib6_list *rib_list;
+
+	rib_list = RTE_TAILQ_CAST(rte_rib6_tailq.head, rte_rib6_list);
+
+	rte_rwlock_read_lock(RTE_EAL_TAILQ_RWLOCK);
+	TAILQ_FOREACH(te, rib_list, next) {
+		rib = (struct rte_rib6 *)te->data;
+		if (strncmp(name, rib->name, RTE_RIB6_NAMESIZE) == 0)
+			break;
+	}
+	rte_rwlock_read_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	if (te == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	return rib;
+}
+
+void
+rte_rib6_free(struct rte_rib6 *rib)
+{
+	struct rte_tailq_entry *te;
+	struct rte_rib6_list *rib_list;
+
+	if (rib == NULL)
+		return;
+
+	rib_list = RTE_TAILQ_CAST(rte_rib6_tailq.head, rte_rib6_list);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, rib_list, next) {
+		if (te->data == (void *)rib)
+			break;
+	}
+	if (te != NULL)
+		TAILQ_REMOVE(rib_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	rte_free(rib);
+	rte_free(te);
+}
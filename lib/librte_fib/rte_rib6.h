@@ -0,0 +1,266 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_RIB6_H_
+#define _RTE_RIB6_H_
+
+/**
+ * @file
+ *
+ * RTE IPv6 Routing Information Base
+ *
+ * The IPv6 counterpart of rte_rib.h, the control plane copy of the routes
+ * of an IPv6 FIB. It stores the prefixes in a path compressed binary trie,
+ * so it needs at most two nodes per route, and answers the questions a FIB
+ * dataplane asks when a route is added or deleted: which route covers a
+ * prefix and which more specific routes it contains.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max number of characters in RIB name. */
+#define RTE_RIB6_NAMESIZE		32
+
+/** Maximum depth value possible for IPv6 RIB. */
+#define RTE_RIB6_MAXDEPTH		128
+
+/** Size of an IPv6 address in bytes. */
+#define RTE_RIB6_IPV6_ADDR_SIZE		16
+
+/** @internal RIB node, only accessed through the functions below. */
+struct rte_rib6_node;
+
+/** @internal RIB structure. */
+struct rte_rib6;
+
+/** RIB configuration structure */
+struct rte_rib6_conf {
+	/**
+	 * Max number of nodes, each route takes one node and at most one
+	 * more node is needed per route where two branches of the trie split.
+	 */
+	uint32_t max_nodes;
+};
+
+/**
+ * Create a RIB object.
+ *
+ * @param name
+ *   RIB object name
+ * @param socket_id
+ *   NUMA socket ID for RIB table memory allocation
+ * @param conf
+ *   Structure containing the configuration
+ * @return
+ *   Handle to RIB object on success, NULL otherwise with rte_errno set
+ *   to an appropriate value. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - EEXIST - a RIB with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_rib6 *
+rte_rib6_create(const char *name, int socket_id,
+		const struct rte_rib6_conf *conf);
+
+/**
+ * Find an existing RIB object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the RIB object as passed to rte_rib6_create()
+ * @return
+ *   Pointer to RIB object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_rib6 *
+rte_rib6_find_existing(const char *name);
+
+/**
+ * Free a RIB object.
+ *
+ * @param rib
+ *   RIB object handle
+ */
+void
+rte_rib6_free(struct rte_rib6 *rib);
+
+/**
+ * Insert a route into the RIB.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param ip
+ *   IP of the route, bits beyond depth are ignored
+ * @param depth
+ *   Depth of the route, 0 to RTE_RIB6_MAXDEPTH
+ * @return
+ *   Node of the new route, or NULL with rte_errno set to EEXIST if the
+ *   route is already present, ENOSPC if there are no free nodes left or
+ *   EINVAL on invalid parameters
+ */
+struct rte_rib6_node *
+rte_rib6_insert(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
+
+/**
+ * Remove a route from the RIB. Does nothing if it is not present.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param ip
+ *   IP of the route
+ * @param depth
+ *   Depth of the route
+ */
+void
+rte_rib6_remove(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
+
+/**
+ * Longest prefix match of an IP in the RIB.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param ip
+ *   IP to be looked up
+ * @return
+ *   Node of the longest route matching ip, NULL if none does
+ */
+struct rte_rib6_node *
+rte_rib6_lookup(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE]);
+
+/**
+ * Find a route with exactly the given prefix.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param ip
+ *   IP of the route, bits beyond depth are ignored
+ * @param depth
+ *   Depth of the route
+ * @return
+ *   Node of the route, NULL if it is not present
+ */
+struct rte_rib6_node *
+rte_rib6_lookup_exact(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
+
+/**
+ * Find the longest route covering a route, i.e. the one its addresses
+ * fall back to when it is removed.
+ *
+ * @param node
+ *   Node of a route
+ * @return
+ *   Node of the covering route, NULL if there is none
+ */
+struct rte_rib6_node *
+rte_rib6_lookup_parent(struct rte_rib6_node *node);
+
+/**
+ * Iterate, in address order, over the routes more specific than a prefix
+ * that are not themselves covered by another more specific route of that
+ * prefix. The address ranges of these routes are the holes a route for
+ * the prefix leaves in the dataplane.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param ip
+ *   IP of the prefix, bits beyond depth are ignored
+ * @param depth
+ *   Depth of the prefix
+ * @param last
+ *   Node returned by the previous call, NULL to start the iteration
+ * @return
+ *   Next node, NULL when the iteration is over
+ */
+struct rte_rib6_node *
+rte_rib6_get_nxt(struct rte_rib6 *rib,
+		const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth,
+		struct rte_rib6_node *last);
+
+/**
+ * Get the IP of a route.
+ *
+ * @param node
+ *   Node of a route
+ * @param ip
+ *   Filled with the IP of the route, masked to its depth
+ */
+void
+rte_rib6_get_ip(const struct rte_rib6_node *node,
+		uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE]);
+
+/**
+ * Get the depth of a route.
+ *
+ * @param node
+ *   Node of a route
+ * @return
+ *   Depth of the route
+ */
+uint8_t
+rte_rib6_get_depth(const struct rte_rib6_node *node);
+
+/**
+ * Get the next hop of a route.
+ *
+ * @param node
+ *   Node of a route
+ * @return
+ *   Next hop of the route
+ */
+uint64_t
+rte_rib6_get_nh(const struct rte_rib6_node *node);
+
+/**
+ * Set the next hop of a route.
+ *
+ * @param node
+ *   Node of a route
+ * @param nh
+ *   Next hop of the route
+ */
+void
+rte_rib6_set_nh(struct rte_rib6_node *node, uint64_t nh);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RIB6_H_ */
@@ -0,0 +1,461 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_atomic.h>
+#include <rte_cpuflags.h>
+
+#include "rte_rib6.h"
+#include "rte_fib6.h"
+#include "trie.h"
+
+/** Number of levels: tbl24 then one tbl8 per remaining byte. */
+#define TRIE_MAX_LEVELS	(RTE_FIB6_IPV6_ADDR_SIZE - TRIE_TBL8_FIRST_BYTE + 1)
+
+static inline uint64_t
+get_max_nh(uint8_t nh_sz)
+{
+	return (UINT64_MAX >> (64 - ((8 << nh_sz) - 1)));
+}
+
+/* Writes n consecutive entries, each with a single store. */
+static inline void
+write_ents(uint8_t *tbl, uint64_t idx, uint64_t ent, uint64_t n,
+		uint8_t nh_sz)
+{
+	uint64_t i;
+
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		for (i = 0; i < n; i++)
+			((volatile uint16_t *)tbl)[idx + i] = (uint16_t)ent;
+		break;
+	case RTE_FIB6_TRIE_4B:
+		for (i = 0; i < n; i++)
+			((volatile uint32_t *)tbl)[idx + i] = (uint32_t)ent;
+		break;
+	default:
+		for (i = 0; i < n; i++)
+			((volatile uint64_t *)tbl)[idx + i] = ent;
+		break;
+	}
+}
+
+static int32_t
+tbl8_alloc(struct rte_trie_tbl *dp, uint64_t ent)
+{
+	uint32_t tbl8_idx;
+
+	if (dp->tbl8_pool_pos == dp->number_tbl8s)
+		return -ENOSPC;
+
+	tbl8_idx = dp->tbl8_pool[dp->tbl8_pool_pos++];
+	write_ents(dp->tbl8, (uint64_t)tbl8_idx * TRIE_TBL8_GRP_NUM_ENT,
+			ent, TRIE_TBL8_GRP_NUM_ENT, dp->nh_sz);
+	dp->cur_tbl8s++;
+
+	return tbl8_idx;
+}
+
+static void
+tbl8_free(struct rte_trie_tbl *dp, uint32_t tbl8_idx)
+{
+	dp->tbl8_pool[--dp->tbl8_pool_pos] = tbl8_idx;
+	dp->cur_tbl8s--;
+}
+
+/* Frees a tbl8 and the tbl8s of the levels below it. */
+static void
+tbl8_free_subtree(struct rte_trie_tbl *dp, uint32_t tbl8_idx)
+{
+	uint64_t first = (uint64_t)tbl8_idx * TRIE_TBL8_GRP_NUM_ENT;
+	uint64_t ent;
+	uint32_t i;
+
+	for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
+		ent = get_ent(dp->tbl8, first + i, dp->nh_sz);
+		if (is_entry_extended(ent))
+			tbl8_free_subtree(dp, (uint32_t)(ent >> 1));
+	}
+	tbl8_free(dp, tbl8_idx);
+}
+
+/*
+ * Folds a tbl8 back into the entry pointing to it when all its entries
+ * hold the same next hop. Returns whether it did.
+ */
+static int
+tbl8_recycle(struct rte_trie_tbl *dp, uint8_t *tbl, uint64_t idx,
+		uint32_t tbl8_idx)
+{
+	uint64_t first = (uint64_t)tbl8_idx * TRIE_TBL8_GRP_NUM_ENT;
+	uint64_t ent = get_ent(dp->tbl8, first, dp->nh_sz);
+	uint32_t i;
+
+	if (is_entry_extended(ent))
+		return 0;
+	for (i = 1; i < TRIE_TBL8_GRP_NUM_ENT; i++)
+		if (get_ent(dp->tbl8, first + i, dp->nh_sz) != ent)
+			return 0;
+
+	write_ents(tbl, idx, ent, 1, dp->nh_sz);
+	tbl8_free(dp, tbl8_idx);
+
+	return 1;
+}
+
+/*
+ * Sets all the entries of a prefix to a next hop, creating the tbl8s down
+ * to the level of the prefix and freeing the ones below it, then folds
+ * the tbl8s of the path that became uniform.
+ */
+static int
+write_prefix(struct rte_trie_tbl *dp, const uint8_t *ip, uint8_t depth,
+		uint64_t next_hop)
+{
+	uint8_t *path_tbl[TRIE_MAX_LEVELS];
+	uint64_t path_idx[TRIE_MAX_LEVELS];
+	uint8_t *tbl = dp->tbl24;
+	uint64_t idx = get_tbl24_idx(ip);
+	uint64_t ent, i, n;
+	unsigned int bits = 24, byte = TRIE_TBL8_FIRST_BYTE, lvl = 0;
+	int32_t tbl8_idx;
+
+	while (depth > bits) {
+		ent = get_ent(tbl, idx, dp->nh_sz);
+		if (!is_entry_extended(ent)) {
+			if (ent == next_hop << 1)
+				return 0;
+
+			/* Spread the next hop over a new tbl8. */
+			tbl8_idx = tbl8_alloc(dp, ent);
+			if (tbl8_idx < 0)
+				return tbl8_idx;
+			ent = ((uint64_t)tbl8_idx << 1) | TRIE_EXT_ENT;
+
+			/* The tbl8 must be complete before lookups reach it. */
+			rte_smp_wmb();
+			write_ents(tbl, idx, ent, 1, dp->nh_sz);
+		}
+		path_tbl[lvl] = tbl;
+		path_idx[lvl++] = idx;
+		tbl = dp->tbl8;
+		idx = get_tbl8_idx(ent, ip, byte++);
+		bits += 8;
+	}
+
+	/* The entries of the prefix in the table of its level. */
+	n = 1ULL << (bits - depth);
+	idx &= ~(n - 1);
+	for (i = 0; i < n; i++) {
+		ent = get_ent(tbl, idx + i, dp->nh_sz);
+		write_ents(tbl, idx + i, next_hop << 1, 1, dp->nh_sz);
+		if (is_entry_extended(ent))
+			tbl8_free_subtree(dp, (uint32_t)(ent >> 1));
+	}
+
+	while (lvl > 0) {
+		lvl--;
+		ent = get_ent(path_tbl[lvl], path_idx[lvl], dp->nh_sz);
+		if (!tbl8_recycle(dp, path_tbl[lvl], path_idx[lvl],
+				(uint32_t)(ent >> 1)))
+			break;
+	}
+
+	return 0;
+}
+
+/*
+ * Sets the next hop of the addresses of a prefix that are not covered by
+ * a more specific route, splitting the prefix in halves around them.
+ */
+static int
+modify_fib(struct rte_trie_tbl *dp, struct rte_rib6 *rib, const uint8_t *ip,
+		uint8_t depth, uint64_t next_hop, int is_route)
+{
+	uint8_t half[RTE_FIB6_IPV6_ADDR_SIZE];
+	int ret;
+
+	/* A more specific route owns the whole prefix. */
+	if (!is_route && rte_rib6_lookup_exact(rib, ip, depth) != NULL)
+		return 0;
+
+	if (rte_rib6_get_nxt(rib, ip, depth, NULL) == NULL)
+		return write_prefix(dp, ip, depth, next_hop);
+
+	memcpy(half, ip, RTE_FIB6_IPV6_ADDR_SIZE);
+	ret = modify_fib(dp, rib, half, depth + 1, next_hop, 0);
+	if (ret < 0)
+		return ret;
+	half[depth / 8] |= 0x80 >> (depth % 8);
+
+	return modify_fib(dp, rib, half, depth + 1, next_hop, 0);
+}
+
+/* Copy the first depth bits of src to dst, clearing the others. */
+static inline void
+mask_ip(uint8_t *dst, const uint8_t *src, uint8_t depth)
+{
+	int i;
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++) {
+		if (depth >= 8)
+			dst[i] = src[i];
+		else if (depth > 0)
+			dst[i] = src[i] & (uint8_t)(0xff << (8 - depth));
+		else
+			dst[i] = 0;
+		depth -= RTE_MIN(depth, 8);
+	}
+}
+
+/*
+ * Number of tbl8s a route needs on top of the other routes of the RIB,
+ * which must not contain it. A tbl8 of a level is needed where a route
+ * longer than the level is, so these are the levels above the route
+ * with no other longer route under the same prefix. Their sum over the
+ * routes, kept in rsvd_tbl8s, bounds the tbl8s in use.
+ */
+static uint32_t
+route_tbl8s(struct rte_rib6 *rib, const uint8_t *ip, uint8_t depth)
+{
+	uint8_t prefix[RTE_FIB6_IPV6_ADDR_SIZE];
+	unsigned int bits;
+	uint32_t n = 0;
+
+	for (bits = 24; bits < depth; bits += 8) {
+		mask_ip(prefix, ip, bits);
+		if (rte_rib6_get_nxt(rib, prefix, bits, NULL) == NULL)
+			n++;
+	}
+
+	return n;
+}
+
+int
+trie_modify(void *p, struct rte_rib6 *rib,
+		const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth,
+		uint64_t next_hop, int op)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	struct rte_rib6_node *node, *parent;
+	uint8_t ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t par_nh;
+	uint32_t n;
+	int ret;
+
+	if (dp == NULL || rib == NULL || ip == NULL ||
+			depth > RTE_FIB6_MAXDEPTH)
+		return -EINVAL;
+
+	mask_ip(ip_masked, ip, depth);
+
+	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
+
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (next_hop > get_max_nh(dp->nh_sz))
+			return -EINVAL;
+
+		if (node != NULL) {
+			if (rte_rib6_get_nh(node) == next_hop)
+				return 0;
+			ret = modify_fib(dp, rib, ip_masked, depth, next_hop, 1);
+			if (ret == 0)
+				rte_rib6_set_nh(node, next_hop);
+			return ret;
+		}
+
+		/*
+		 * Reserve the tbl8s the route may need up front, so that no
+		 * update can fail half way through for lack of tbl8s.
+		 */
+		n = route_tbl8s(rib, ip_masked, depth);
+		if (dp->rsvd_tbl8s + n > dp->number_tbl8s)
+			return -ENOSPC;
+
+		node = rte_rib6_insert(rib, ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		dp->rsvd_tbl8s += n;
+
+		parent = rte_rib6_lookup_parent(node);
+		par_nh = (parent != NULL) ? rte_rib6_get_nh(parent) : dp->def_nh;
+		if (par_nh == next_hop)
+			return 0;
+
+		ret = modify_fib(dp, rib, ip_masked, depth, next_hop, 1);
+		if (ret < 0) {
+			rte_rib6_remove(rib, ip_masked, depth);
+			dp->rsvd_tbl8s -= n;
+		}
+		return ret;
+
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		/* The addresses of the route fall back to its parent. */
+		parent = rte_rib6_lookup_parent(node);
+		par_nh = (parent != NULL) ? rte_rib6_get_nh(parent) : dp->def_nh;
+		if (par_nh != rte_rib6_get_nh(node)) {
+			ret = modify_fib(dp, rib, ip_masked, depth, par_nh, 1);
+			if (ret < 0)
+				return ret;
+		}
+
+		rte_rib6_remove(rib, ip_masked, depth);
+		dp->rsvd_tbl8s -= route_tbl8s(rib, ip_masked, depth);
+		return 0;
+
+	default:
+		return -EINVAL;
+	}
+}
+
+rte_fib6_lookup_fn_t
+trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+
+	/*
+	 * The interleaved scalar lookup keeps more cache misses in flight
+	 * than the gathers, which wait for all their lanes, and measured
+	 * faster once the tables no longer fit in the cache.
+	 */
+	if (type == RTE_FIB6_LOOKUP_DEFAULT)
+		type = RTE_FIB6_LOOKUP_SCALAR;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_SCALAR:
+		switch (dp->nh_sz) {
+		case RTE_FIB6_TRIE_2B:
+			return trie_lookup_bulk_2b;
+		case RTE_FIB6_TRIE_4B:
+			return trie_lookup_bulk_4b;
+		default:
+			return trie_lookup_bulk_8b;
+		}
+#ifdef CC_AVX2_SUPPORT
+	case RTE_FIB6_LOOKUP_VECTOR_AVX2:
+		if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			return NULL;
+		switch (dp->nh_sz) {
+		case RTE_FIB6_TRIE_2B:
+			return trie_vec_lookup_bulk_2b;
+		case RTE_FIB6_TRIE_4B:
+			return trie_vec_lookup_bulk_4b;
+		default:
+			return trie_vec_lookup_bulk_8b;
+		}
+#endif
+	default:
+		return NULL;
+	}
+}
+
+void *
+trie_create(const char *name, int socket_id,
+		const struct rte_fib6_conf *conf)
+{
+	char mem_name[RTE_FIB6_NAMESIZE];
+	struct rte_trie_tbl *dp;
+	uint8_t nh_sz = conf->trie.nh_sz;
+	uint32_t num_tbl8 = conf->trie.num_tbl8;
+	uint32_t i;
+
+	if (nh_sz < RTE_FIB6_TRIE_2B || nh_sz > RTE_FIB6_TRIE_8B ||
+			num_tbl8 == 0 ||
+			num_tbl8 > RTE_MIN((uint64_t)RTE_FIB6_TRIE_MAX_TBL8,
+				get_max_nh(nh_sz) + 1) ||
+			conf->default_nh > get_max_nh(nh_sz)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct rte_trie_tbl) +
+			((size_t)TRIE_TBL24_NUM_ENT << nh_sz) + TRIE_TBL_PAD,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_%s", name);
+	dp->tbl8 = rte_zmalloc_socket(mem_name, (((size_t)num_tbl8 *
+			TRIE_TBL8_GRP_NUM_ENT) << nh_sz) + TRIE_TBL_PAD,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	dp->tbl8_pool = rte_malloc_socket(NULL, sizeof(uint32_t) * num_tbl8,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8 == NULL || dp->tbl8_pool == NULL) {
+		rte_free(dp->tbl8_pool);
+		rte_free(dp->tbl8);
+		rte_free(dp);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	dp->number_tbl8s = num_tbl8;
+	dp->nh_sz = nh_sz;
+	dp->def_nh = conf->default_nh;
+
+	for (i = 0; i < num_tbl8; i++)
+		dp->tbl8_pool[i] = i;
+
+	write_ents(dp->tbl24, 0, dp->def_nh << 1, TRIE_TBL24_NUM_ENT, nh_sz);
+
+	return dp;
+}
+
+void
+trie_free(void *p)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+
+	if (dp == NULL)
+		return;
+
+	rte_free(dp->tbl8_pool);
+	rte_free(dp->tbl8);
+	rte_free(dp);
+}
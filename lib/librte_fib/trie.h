@@ -0,0 +1,213 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _TRIE_H_
+#define _TRIE_H_
+
+/**
+ * @file
+ * Multibit trie dataplane of the IPv6 FIB, internal to the library.
+ */
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_prefetch.h>
+#include <rte_branch_prediction.h>
+
+#include "rte_fib6.h"
+
+#define TRIE_TBL24_NUM_ENT		(1 << 24)
+#define TRIE_TBL8_GRP_NUM_ENT		256U
+/** Lowest bit of an entry, set when it holds a tbl8 index. */
+#define TRIE_EXT_ENT			1
+/** Bytes read past the end of a table by the vector lookups. */
+#define TRIE_TBL_PAD			8
+/** Byte of the address indexing the first tbl8 level. */
+#define TRIE_TBL8_FIRST_BYTE		3
+
+/** Number of lookups the bulk functions interleave. */
+#define TRIE_BULK			32
+
+struct rte_rib6;
+
+/** Operations on the FIB passed to trie_modify(). */
+enum {
+	RTE_FIB6_ADD,
+	RTE_FIB6_DEL
+};
+
+typedef void (*rte_fib6_lookup_fn_t)(void *dp,
+		uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, const unsigned int n);
+
+struct rte_trie_tbl {
+	uint32_t number_tbl8s;	/**< Total number of tbl8s. */
+	uint32_t rsvd_tbl8s;	/**< tbl8s needed by the routes. */
+	uint32_t cur_tbl8s;	/**< tbl8s in use. */
+	enum rte_fib6_trie_nh_sz nh_sz; /**< Size of the entries. */
+	uint64_t def_nh;	/**< Default next hop. */
+	uint8_t *tbl8;		/**< tbl8s. */
+	uint32_t *tbl8_pool;	/**< Stack of the free tbl8s. */
+	uint32_t tbl8_pool_pos;	/**< Number of tbl8s taken from the stack. */
+	uint8_t tbl24[] __rte_cache_aligned; /**< tbl24, entries of nh_sz. */
+};
+
+static inline uint32_t
+get_tbl24_idx(const uint8_t *ip)
+{
+	return (uint32_t)ip[0] << 16 | (uint32_t)ip[1] << 8 | ip[2];
+}
+
+static inline int
+is_entry_extended(uint64_t ent)
+{
+	return (ent & TRIE_EXT_ENT) == TRIE_EXT_ENT;
+}
+
+static inline uint64_t
+get_ent(const uint8_t *tbl, uint64_t idx, uint8_t nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return ((const uint16_t *)tbl)[idx];
+	case RTE_FIB6_TRIE_4B:
+		return ((const uint32_t *)tbl)[idx];
+	default:
+		return ((const uint64_t *)tbl)[idx];
+	}
+}
+
+static inline uint64_t
+get_tbl8_idx(uint64_t ent, const uint8_t *ip, unsigned int byte)
+{
+	return (ent >> 1) * TRIE_TBL8_GRP_NUM_ENT + ip[byte];
+}
+
+/*
+ * Scalar bulk lookup. The addresses are handled TRIE_BULK at a time one
+ * level after the other: the entries of the next level of all of them
+ * are prefetched before any is read, so the cache misses of the burst
+ * overlap instead of adding up.
+ */
+static inline void
+trie_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, const unsigned int n, uint8_t nh_sz)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	uint64_t ents[TRIE_BULK];
+	uint8_t pending[TRIE_BULK];
+	unsigned int i, j, k, cnt, nb_pending, byte;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = RTE_MIN(n - i, (unsigned int)TRIE_BULK);
+
+		for (j = 0; j < cnt; j++)
+			rte_prefetch0(&dp->tbl24[(size_t)get_tbl24_idx(
+					ips[i + j]) << nh_sz]);
+
+		nb_pending = 0;
+		for (j = 0; j < cnt; j++) {
+			ents[j] = get_ent(dp->tbl24,
+					get_tbl24_idx(ips[i + j]), nh_sz);
+			if (unlikely(is_entry_extended(ents[j]))) {
+				pending[nb_pending++] = j;
+				rte_prefetch0(&dp->tbl8[get_tbl8_idx(ents[j],
+					ips[i + j], TRIE_TBL8_FIRST_BYTE) <<
+					nh_sz]);
+			} else
+				next_hops[i + j] = ents[j] >> 1;
+		}
+
+		for (byte = TRIE_TBL8_FIRST_BYTE; nb_pending != 0; byte++) {
+			k = 0;
+			for (j = 0; j < nb_pending; j++) {
+				uint8_t l = pending[j];
+
+				ents[l] = get_ent(dp->tbl8, get_tbl8_idx(
+						ents[l], ips[i + l], byte),
+						nh_sz);
+				if (is_entry_extended(ents[l])) {
+					pending[k++] = l;
+					rte_prefetch0(&dp->tbl8[get_tbl8_idx(
+						ents[l], ips[i + l],
+						byte + 1) << nh_sz]);
+				} else
+					next_hops[i + l] = ents[l] >> 1;
+			}
+			nb_pending = k;
+		}
+	}
+}
+
+#define TRIE_LOOKUP_FUNC(suffix, nh_sz)					\
+static inline void							\
+trie_lookup_bulk_##suffix(void *p,					\
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],				\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	trie_lookup_bulk(p, ips, next_hops, n, nh_sz);			\
+}
+
+TRIE_LOOKUP_FUNC(2b, RTE_FIB6_TRIE_2B)
+TRIE_LOOKUP_FUNC(4b, RTE_FIB6_TRIE_4B)
+TRIE_LOOKUP_FUNC(8b, RTE_FIB6_TRIE_8B)
+
+void *
+trie_create(const char *name, int socket_id,
+		const struct rte_fib6_conf *conf);
+
+void
+trie_free(void *p);
+
+rte_fib6_lookup_fn_t
+trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type);
+
+int
+trie_modify(void *p, struct rte_rib6 *rib,
+		const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth,
+		uint64_t next_hop, int op);
+
+/* AVX2 lookup functions, only built when the compiler supports AVX2. */
+void
+trie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, const unsigned int n);
+
+void
+trie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, const unsigned int n);
+
+void
+trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, const unsigned int n);
+
+#endif /* _TRIE_H_ */
@@ -0,0 +1,302 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_vect.h>
+#include <rte_prefetch.h>
+
+#include "rte_fib6.h"
+#include "trie.h"
+
+/*
+ * The addresses are 16 bytes apart, so a byte of eight of them is read
+ * with a single gather of the 32 bit words ending with that byte.
+ */
+static inline __m256i
+get_byte_x8(uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], unsigned int byte)
+{
+	const __m256i offsets = _mm256_set_epi32(112, 96, 80, 64,
+			48, 32, 16, 0);
+
+	return _mm256_srli_epi32(_mm256_i32gather_epi32(
+			(const int *)&ips[0][byte - 3], offsets, 1), 24);
+}
+
+/* tbl24 index of eight addresses, their first three bytes big endian. */
+static inline __m256i
+get_tbl24_idx_x8(uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE])
+{
+	const __m256i offsets = _mm256_set_epi32(112, 96, 80, 64,
+			48, 32, 16, 0);
+	const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+			4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11,
+			4, 5, 6, 7, 0, 1, 2, 3);
+	__m256i words;
+
+	words = _mm256_i32gather_epi32((const int *)&ips[0][0], offsets, 1);
+
+	return _mm256_srli_epi32(_mm256_shuffle_epi8(words, bswap), 8);
+}
+
+/* Number of vectors looked up together, their gathers overlap. */
+#define TRIE_VEC_NUM 4
+/*
+ * A vector with this few lanes left to resolve leaves the gather loop,
+ * the few deep routes are cheaper to finish one address at a time than
+ * to keep gathering for all the lanes.
+ */
+#define TRIE_VEC_TAIL_LANES 2
+
+/* Finishes the lookup of the lanes set in lanes from the given level. */
+static inline void
+trie_lookup_tail(struct rte_trie_tbl *dp,
+		uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], uint64_t *next_hops,
+		unsigned int lanes, unsigned int byte, uint8_t nh_sz)
+{
+	unsigned int l, b;
+	uint64_t ent;
+
+	for (l = 0; lanes != 0; l++, lanes >>= 1) {
+		if (!(lanes & 1))
+			continue;
+		/* The stored next hop is the entry without its extended bit. */
+		ent = (next_hops[l] << 1) | TRIE_EXT_ENT;
+		for (b = byte; is_entry_extended(ent); b++)
+			ent = get_ent(dp->tbl8, get_tbl8_idx(ent, ips[l], b),
+					nh_sz);
+		next_hops[l] = ent >> 1;
+	}
+}
+
+/*
+ * Looks up TRIE_VEC_NUM * 8 addresses with 2 or 4 byte entries. Entries
+ * are gathered as 32 bit words, the bytes past the entry are masked off,
+ * which is why the tables are padded. Each round resolves one more tbl8
+ * level for the lanes that still hold a tbl8 index; the vectors are
+ * independent so the gathers of one round are in flight together.
+ */
+static inline void
+trie_vec_lookup_x8(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, int size)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m256i lsb = _mm256_set1_epi32(1);
+	__m256i msk, idxes, res[TRIE_VEC_NUM], ext[TRIE_VEC_NUM];
+	__m256i idx24[TRIE_VEC_NUM];
+	uint32_t tmp[TRIE_VEC_NUM * 8];
+	unsigned int lanes[TRIE_VEC_NUM], stop[TRIE_VEC_NUM];
+	unsigned int byte, v, pending;
+
+	if (size == sizeof(uint16_t))
+		msk = _mm256_set1_epi32(UINT16_MAX);
+	else
+		msk = _mm256_set1_epi32(-1);
+
+	/*
+	 * The gathers stall until all their lanes are loaded, prefetch the
+	 * entries of all the vectors first so their misses overlap.
+	 */
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		idx24[v] = get_tbl24_idx_x8(ips + v * 8);
+		_mm256_storeu_si256((__m256i *)&tmp[v * 8], idx24[v]);
+	}
+	for (v = 0; v < TRIE_VEC_NUM * 8; v++)
+		rte_prefetch0(&dp->tbl24[(size_t)tmp[v] * size]);
+
+	pending = 0;
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		idxes = idx24[v];
+		/* The scale of a gather has to be a constant. */
+		if (size == sizeof(uint16_t))
+			res[v] = _mm256_i32gather_epi32(
+					(const int *)dp->tbl24, idxes, 2);
+		else
+			res[v] = _mm256_i32gather_epi32(
+					(const int *)dp->tbl24, idxes, 4);
+		res[v] = _mm256_and_si256(res[v], msk);
+		ext[v] = _mm256_cmpeq_epi32(_mm256_and_si256(res[v], lsb),
+				lsb);
+		lanes[v] = _mm256_movemask_ps(_mm256_castsi256_ps(ext[v]));
+		stop[v] = TRIE_TBL8_FIRST_BYTE;
+		if (__builtin_popcount(lanes[v]) > TRIE_VEC_TAIL_LANES)
+			pending |= 1 << v;
+	}
+
+	for (byte = TRIE_TBL8_FIRST_BYTE; pending != 0; byte++) {
+		for (v = 0; v < TRIE_VEC_NUM; v++) {
+			if (!(pending & (1 << v)))
+				continue;
+			idxes = _mm256_add_epi32(_mm256_slli_epi32(
+					_mm256_srli_epi32(res[v], 1), 8),
+					get_byte_x8(ips + v * 8, byte));
+			if (size == sizeof(uint16_t))
+				res[v] = _mm256_mask_i32gather_epi32(res[v],
+						(const int *)dp->tbl8, idxes,
+						ext[v], 2);
+			else
+				res[v] = _mm256_mask_i32gather_epi32(res[v],
+						(const int *)dp->tbl8, idxes,
+						ext[v], 4);
+			res[v] = _mm256_and_si256(res[v], msk);
+			ext[v] = _mm256_cmpeq_epi32(
+					_mm256_and_si256(res[v], lsb), lsb);
+			lanes[v] = _mm256_movemask_ps(
+					_mm256_castsi256_ps(ext[v]));
+			stop[v] = byte + 1;
+			if (__builtin_popcount(lanes[v]) <=
+					TRIE_VEC_TAIL_LANES)
+				pending &= ~(1 << v);
+		}
+	}
+
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		res[v] = _mm256_srli_epi32(res[v], 1);
+		_mm256_storeu_si256((__m256i *)(next_hops + v * 8),
+				_mm256_cvtepu32_epi64(
+				_mm256_castsi256_si128(res[v])));
+		_mm256_storeu_si256((__m256i *)(next_hops + v * 8 + 4),
+				_mm256_cvtepu32_epi64(
+				_mm256_extracti128_si256(res[v], 1)));
+		if (lanes[v] != 0)
+			trie_lookup_tail(dp, ips + v * 8, next_hops + v * 8,
+					lanes[v], stop[v], dp->nh_sz);
+	}
+}
+
+/* Looks up TRIE_VEC_NUM * 4 addresses with 8 byte entries. */
+static inline void
+trie_vec_lookup_x4_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m128i offsets = _mm_set_epi32(48, 32, 16, 0);
+	const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+			4, 5, 6, 7, 0, 1, 2, 3);
+	const __m256i lsb = _mm256_set1_epi64x(1);
+	__m128i idxes, bytes, idx24[TRIE_VEC_NUM];
+	__m256i res[TRIE_VEC_NUM], ext[TRIE_VEC_NUM], idxes8;
+	uint32_t tmp[TRIE_VEC_NUM * 4];
+	unsigned int lanes[TRIE_VEC_NUM], stop[TRIE_VEC_NUM];
+	unsigned int byte, v, pending;
+
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		idx24[v] = _mm_i32gather_epi32((const int *)&ips[v * 4][0],
+				offsets, 1);
+		idx24[v] = _mm_srli_epi32(_mm_shuffle_epi8(idx24[v], bswap),
+				8);
+		_mm_storeu_si128((__m128i *)&tmp[v * 4], idx24[v]);
+	}
+	for (v = 0; v < TRIE_VEC_NUM * 4; v++)
+		rte_prefetch0(&((uint64_t *)dp->tbl24)[tmp[v]]);
+
+	pending = 0;
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		idxes = idx24[v];
+		res[v] = _mm256_i32gather_epi64((const long long *)dp->tbl24,
+				idxes, 8);
+		ext[v] = _mm256_cmpeq_epi64(_mm256_and_si256(res[v], lsb),
+				lsb);
+		lanes[v] = _mm256_movemask_pd(_mm256_castsi256_pd(ext[v]));
+		stop[v] = TRIE_TBL8_FIRST_BYTE;
+		if (__builtin_popcount(lanes[v]) > TRIE_VEC_TAIL_LANES)
+			pending |= 1 << v;
+	}
+
+	for (byte = TRIE_TBL8_FIRST_BYTE; pending != 0; byte++) {
+		for (v = 0; v < TRIE_VEC_NUM; v++) {
+			if (!(pending & (1 << v)))
+				continue;
+			bytes = _mm_srli_epi32(_mm_i32gather_epi32(
+					(const int *)&ips[v * 4][byte - 3],
+					offsets, 1), 24);
+			idxes8 = _mm256_add_epi64(_mm256_slli_epi64(
+					_mm256_srli_epi64(res[v], 1), 8),
+					_mm256_cvtepu32_epi64(bytes));
+			res[v] = _mm256_mask_i64gather_epi64(res[v],
+					(const long long *)dp->tbl8, idxes8,
+					ext[v], 8);
+			ext[v] = _mm256_cmpeq_epi64(
+					_mm256_and_si256(res[v], lsb), lsb);
+			lanes[v] = _mm256_movemask_pd(
+					_mm256_castsi256_pd(ext[v]));
+			stop[v] = byte + 1;
+			if (__builtin_popcount(lanes[v]) <=
+					TRIE_VEC_TAIL_LANES)
+				pending &= ~(1 << v);
+		}
+	}
+
+	for (v = 0; v < TRIE_VEC_NUM; v++) {
+		_mm256_storeu_si256((__m256i *)(next_hops + v * 4),
+				_mm256_srli_epi64(res[v], 1));
+		if (lanes[v] != 0)
+			trie_lookup_tail(dp, ips + v * 4, next_hops + v * 4,
+					lanes[v], stop[v], RTE_FIB6_TRIE_8B);
+	}
+}
+
+#define VEC_LOOKUP_FUNC(suffix, type)					\
+void									\
+trie_vec_lookup_bulk_##suffix(void *p,					\
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],				\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	uint32_t i;							\
+									\
+	const uint32_t k = TRIE_VEC_NUM * 8;				\
+									\
+	for (i = 0; i < n / k; i++)					\
+		trie_vec_lookup_x8(p, ips + i * k, next_hops + i * k,	\
+				sizeof(type));				\
+									\
+	trie_lookup_bulk_##suffix(p, ips + i * k, next_hops + i * k,	\
+			n - i * k);					\
+}
+
+VEC_LOOKUP_FUNC(2b, uint16_t)
+VEC_LOOKUP_FUNC(4b, uint32_t)
+
+void
+trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	const uint32_t k = TRIE_VEC_NUM * 4;
+
+	for (i = 0; i < n / k; i++)
+		trie_vec_lookup_x4_8b(p, ips + i * k, next_hops + i * k);
+
+	trie_lookup_bulk_8b(p, ips + i * k, next_hops + i * k, n - i * k);
+}
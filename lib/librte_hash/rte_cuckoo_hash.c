@@ -61,6 +61,14 @@
 #include "rte_hash.h"
 #include "rte_cuckoo_hash.h"
 
+#if defined(RTE_ARCH_X86)
+#include "rte_cmp_x86.h"
+#endif
+
+#if defined(RTE_ARCH_ARM64)
+#include "rte_cmp_arm64.h"
+#endif
+
 #if defined(RTE_ARCH_X86)
 #include "rte_cuckoo_hash_x86.h"
 #endif
@@ -96,12 +104,73 @@ rte_hash_find_existing(const char *name)
 	return h;
 }
 
+/*
+ * Table storing all different key compare functions
+ * (multi-process supported)
+ */
+#if defined(RTE_ARCH_X86) || defined(RTE_ARCH_ARM64)
+const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+	NULL,
+	rte_hash_k16_cmp_eq,
+	rte_hash_k32_cmp_eq,
+	rte_hash_k48_cmp_eq,
+	rte_hash_k64_cmp_eq,
+	rte_hash_k80_cmp_eq,
+	rte_hash_k96_cmp_eq,
+	rte_hash_k112_cmp_eq,
+	rte_hash_k128_cmp_eq,
+	memcmp
+};
+#else
+const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+	NULL,
+	memcmp
+};
+#endif
+
 void rte_hash_set_cmp_func(struct rte_hash *h, rte_hash_cmp_eq_t func)
 {
 	h->cmp_jump_table_idx = KEY_CUSTOM;
 	h->rte_hash_custom_cmp_eq = func;
 }
 
+/* Check if a signature compare method is built in and supported by the CPU */
+static int
+sig_cmp_fn_supported(enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	switch (sig_cmp_fn) {
+	case RTE_HASH_COMPARE_SCALAR:
+		return 1;
+#ifdef RTE_MACHINE_CPUFLAG_SSE2
+	case RTE_HASH_COMPARE_SSE:
+		return 1;
+#endif
+#ifdef CC_AVX2_SUPPORT
+	case RTE_HASH_COMPARE_AVX2:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2);
+#endif
+#ifdef CC_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F);
+#endif
+	default:
+		return 0;
+	}
+}
+
+int
+rte_hash_set_sig_cmp_fn(struct rte_hash *h,
+		enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	if (h == NULL || sig_cmp_fn >= RTE_HASH_COMPARE_NUM)
+		return -EINVAL;
+	if (!sig_cmp_fn_supported(sig_cmp_fn))
+		return -ENOTSUP;
+
+	h->sig_cmp_fn = sig_cmp_fn;
+	return 0;
+}
+
 static inline int
 rte_hash_cmp_eq(const void *key1, const void *key2, const struct rte_hash *h)
 {
@@ -118,12 +187,18 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	struct rte_tailq_entry *te = NULL;
 	struct rte_hash_list *hash_list;
 	struct rte_ring *r = NULL;
+	struct rte_ring *r_ext = NULL;
 	char hash_name[RTE_HASH_NAMESIZE];
 	void *k = NULL;
 	void *buckets = NULL;
+	void *buckets_ext = NULL;
+	uint32_t *ext_bkt_to_free = NULL;
+	struct rte_hash_resize *resize = NULL;
 	char ring_name[RTE_RING_NAMESIZE];
 	unsigned num_key_slots;
 	unsigned hw_trans_mem_support = 0;
+	unsigned ext_table_support = 0;
+	uint32_t entries;
 	unsigned i;
 
 	hash_list = RTE_TAILQ_CAST(rte_hash_tailq.head, rte_hash_list);
@@ -147,6 +222,39 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE)
+		ext_table_support = 1;
+
+	/* lock-free readers only support a single writer */
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) &&
+			(params->extra_flag &
+			 RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD)) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "lock-free readers require a single "
+			"writer\n");
+		return NULL;
+	}
+
+	/*
+	 * A resizable table is grown by a single writer, and its capacity
+	 * is kept a power of two so that key slots are easily found in the
+	 * key store segments.
+	 */
+	entries = params->entries;
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) {
+		if (params->extra_flag &
+				(RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT |
+				 RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				 RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+				 RTE_HASH_EXTRA_FLAGS_EXT_TABLE)) {
+			rte_errno = EINVAL;
+			RTE_LOG(ERR, HASH, "resizable hash table only supports "
+				"a single writer\n");
+			return NULL;
+		}
+		entries = rte_align32pow2(params->entries);
+	}
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (hw_trans_mem_support)
 		/*
@@ -154,20 +262,40 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		 * that can be stored in the lcore caches
 		 * except for the first cache
 		 */
-		num_key_slots = params->entries + (RTE_MAX_LCORE - 1) *
+		num_key_slots = entries + (RTE_MAX_LCORE - 1) *
 					LCORE_CACHE_SIZE + 1;
 	else
-		num_key_slots = params->entries + 1;
+		num_key_slots = entries + 1;
 
 	snprintf(ring_name, sizeof(ring_name), "HT_%s", params->name);
-	/* Create ring (Dummy slot index is not enqueued) */
-	r = rte_ring_create(ring_name, rte_align32pow2(num_key_slots - 1),
+	/*
+	 * Create ring (Dummy slot index is not enqueued, but a ring
+	 * can only hold its size minus one entries)
+	 */
+	r = rte_ring_create(ring_name, rte_align32pow2(num_key_slots),
 			params->socket_id, 0);
 	if (r == NULL) {
 		RTE_LOG(ERR, HASH, "memory allocation failed\n");
 		goto err;
 	}
 
+	const uint32_t num_buckets = rte_align32pow2(entries)
+					/ RTE_HASH_BUCKET_ENTRIES;
+
+	/* Ring of free extendable buckets, one per bucket of the table */
+	if (ext_table_support) {
+		snprintf(ring_name, sizeof(ring_name), "HT_EXT_%s",
+				params->name);
+		r_ext = rte_ring_create(ring_name,
+				rte_align32pow2(num_buckets + 1),
+				params->socket_id, 0);
+		if (r_ext == NULL) {
+			RTE_LOG(ERR, HASH, "ext buckets memory allocation "
+					"failed\n");
+			goto err;
+		}
+	}
+
 	snprintf(hash_name, sizeof(hash_name), "HT_%s", params->name);
 
 	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
@@ -200,9 +328,6 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
-	const uint32_t num_buckets = rte_align32pow2(params->entries)
-					/ RTE_HASH_BUCKET_ENTRIES;
-
 	buckets = rte_zmalloc_socket(NULL,
 				num_buckets * sizeof(struct rte_hash_bucket),
 				RTE_CACHE_LINE_SIZE, params->socket_id);
@@ -212,6 +337,33 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (ext_table_support) {
+		buckets_ext = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (buckets_ext == NULL) {
+			RTE_LOG(ERR, HASH, "ext buckets memory allocation "
+					"failed\n");
+			goto err_unlock;
+		}
+		/*
+		 * With lock-free readers, an emptied extendable bucket is
+		 * only recycled with the key slot whose deletion emptied it.
+		 */
+		if (params->extra_flag &
+				RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) {
+			ext_bkt_to_free = rte_zmalloc_socket(NULL,
+					sizeof(uint32_t) * num_key_slots,
+					RTE_CACHE_LINE_SIZE,
+					params->socket_id);
+			if (ext_bkt_to_free == NULL) {
+				RTE_LOG(ERR, HASH, "ext buckets memory "
+						"allocation failed\n");
+				goto err_unlock;
+			}
+		}
+	}
+
 	const uint32_t key_entry_size = sizeof(struct rte_hash_key) + params->key_len;
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
 
@@ -268,11 +420,27 @@ rte_hash_create(const struct rte_hash_parameters *params)
 				RTE_CACHE_LINE_SIZE, params->socket_id);
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) {
+		resize = rte_zmalloc_socket(NULL, sizeof(*resize),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (resize == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err_unlock;
+		}
+		resize->next_fresh = 1;
+		resize->socket_id = params->socket_id;
+		resize->nb_segs = 1;
+		resize->key_segs[0] = k;
+		resize->key_store_shift = rte_bsf32(entries);
+	}
+
 	/* Setup hash context */
 	snprintf(h->name, sizeof(h->name), "%s", params->name);
-	h->entries = params->entries;
+	h->entries = entries;
 	h->key_len = params->key_len;
 	h->key_entry_size = key_entry_size;
+	h->key_store_entries = num_key_slots - 1;
+	h->resize = resize;
 	h->hash_func_init_val = params->hash_func_init_val;
 
 	h->num_buckets = num_buckets;
@@ -283,21 +451,22 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->key_store = k;
 	h->free_slots = r;
 	h->hw_trans_mem_support = hw_trans_mem_support;
+	h->ext_table_support = ext_table_support;
+	h->buckets_ext = buckets_ext;
+	h->free_ext_bkts = r_ext;
+	h->ext_bkt_to_free = ext_bkt_to_free;
 
-#if defined(RTE_ARCH_X86)
-	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
-		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX2;
-	else if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
-		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
-	else
-#endif
-		h->sig_cmp_fn = RTE_HASH_COMPARE_SCALAR;
+	/* Select the best signature compare method */
+	h->sig_cmp_fn = RTE_HASH_COMPARE_NUM - 1;
+	while (!sig_cmp_fn_supported(h->sig_cmp_fn))
+		h->sig_cmp_fn--;
 
 	/* Turn on multi-writer only with explicit flat from user and TM
-	 * support.
+	 * support. Transactions do not cover the extendable buckets
+	 * chains, so the lock is always used with them.
 	 */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD) {
-		if (h->hw_trans_mem_support) {
+		if (h->hw_trans_mem_support && !h->ext_table_support) {
 			h->add_key = ADD_KEY_MULTIWRITER_TM;
 		} else {
 			h->add_key = ADD_KEY_MULTIWRITER;
@@ -309,10 +478,29 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	} else
 		h->add_key = ADD_KEY_SINGLEWRITER;
 
-	/* Populate free slots ring. Entry zero is reserved for key misses. */
-	for (i = 1; i < params->entries + 1; i++)
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+		h->readwrite_concur_lf_support = 1;
+
+	/* The last hit time fits in the padding of the key slots */
+	RTE_BUILD_BUG_ON(sizeof(struct rte_hash_key) -
+			offsetof(struct rte_hash_key, key) <
+			2 * sizeof(uint32_t) - 1);
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING)
+		h->aging_support = 1;
+
+	/*
+	 * Populate free slots ring. Entry zero is reserved for key misses.
+	 * Resizable tables use a free list of key slots instead.
+	 */
+	for (i = 1; resize == NULL && i < entries + 1; i++)
 		rte_ring_sp_enqueue(r, (void *)((uintptr_t) i));
 
+	/* Populate free extendable buckets ring, indexes start at one. */
+	if (ext_table_support) {
+		for (i = 1; i <= num_buckets; i++)
+			rte_ring_sp_enqueue(r_ext, (void *)((uintptr_t) i));
+	}
+
 	te->data = (void *) h;
 	TAILQ_INSERT_TAIL(hash_list, te, next);
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
@@ -322,9 +510,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 err:
 	rte_ring_free(r);
+	rte_ring_free(r_ext);
 	rte_free(te);
 	rte_free(h);
 	rte_free(buckets);
+	rte_free(buckets_ext);
+	rte_free(ext_bkt_to_free);
+	rte_free(resize);
 	rte_free(k);
 	return NULL;
 }
@@ -334,6 +526,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	unsigned i;
 
 	if (h == NULL)
 		return;
@@ -360,11 +553,21 @@ rte_hash_free(struct rte_hash *h)
 	if (h->hw_trans_mem_support)
 		rte_free(h->local_free_slots);
 
+	if (h->resize != NULL) {
+		for (i = 1; i < h->resize->nb_segs; i++)
+			rte_free(h->resize->key_segs[i]);
+		rte_free(h->resize->old_buckets);
+		rte_free(h->resize);
+	}
+
 	if (h->add_key == ADD_KEY_MULTIWRITER)
 		rte_free(h->multiwriter_lock);
 	rte_ring_free(h->free_slots);
+	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
 	rte_free(h->buckets);
+	rte_free(h->buckets_ext);
+	rte_free(h->ext_bkt_to_free);
 	rte_free(h);
 	rte_free(te);
 }
@@ -398,7 +601,17 @@ rte_hash_reset(struct rte_hash *h)
 		return;
 
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
-	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	memset(h->key_store, 0, h->key_entry_size * (h->key_store_entries + 1));
+
+	/* A resizable table keeps its current size */
+	if (h->resize != NULL) {
+		rte_free(h->resize->old_buckets);
+		h->resize->old_buckets = NULL;
+		h->resize->nb_keys = 0;
+		h->resize->free_head = 0;
+		h->resize->next_fresh = 1;
+		return;
+	}
 
 	/* clear the free ring */
 	while (rte_ring_dequeue(h->free_slots, &ptr) == 0)
@@ -408,6 +621,20 @@ rte_hash_reset(struct rte_hash *h)
 	for (i = 1; i < h->entries + 1; i++)
 		rte_ring_sp_enqueue(h->free_slots, (void *)((uintptr_t) i));
 
+	if (h->ext_table_support) {
+		memset(h->buckets_ext, 0,
+			h->num_buckets * sizeof(struct rte_hash_bucket));
+		if (h->ext_bkt_to_free != NULL)
+			memset(h->ext_bkt_to_free, 0,
+				sizeof(uint32_t) * (h->entries + 1));
+
+		while (rte_ring_dequeue(h->free_ext_bkts, &ptr) == 0)
+			rte_pause();
+		for (i = 1; i <= h->num_buckets; i++)
+			rte_ring_sp_enqueue(h->free_ext_bkts,
+					(void *)((uintptr_t) i));
+	}
+
 	if (h->hw_trans_mem_support) {
 		/* Reset local caches per lcore */
 		for (i = 0; i < RTE_MAX_LCORE; i++)
@@ -446,7 +673,10 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
 	if (i != RTE_HASH_BUCKET_ENTRIES) {
 		next_bkt[i]->sig_alt[j] = bkt->sig_current[i];
 		next_bkt[i]->sig_current[j] = bkt->sig_alt[i];
+		rte_smp_wmb();
 		next_bkt[i]->key_idx[j] = bkt->key_idx[i];
+		/* Entry i is overwritten by the caller */
+		bucket_chng_cnt_inc(bkt);
 		return i;
 	}
 
@@ -476,13 +706,207 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
 	if (ret >= 0) {
 		next_bkt[i]->sig_alt[ret] = bkt->sig_current[i];
 		next_bkt[i]->sig_current[ret] = bkt->sig_alt[i];
+		rte_smp_wmb();
 		next_bkt[i]->key_idx[ret] = bkt->key_idx[i];
+		bucket_chng_cnt_inc(bkt);
 		return i;
 	} else
 		return ret;
 
 }
 
+/*
+ * Insert an entry in a bucket of the cuckoo table, pushing one of its
+ * entries to its alternative location if it is full.
+ */
+static inline int
+cuckoo_insert(const struct rte_hash *h, struct rte_hash_bucket *prim_bkt,
+		hash_sig_t sig, hash_sig_t alt_hash, uint32_t new_idx)
+{
+	unsigned i;
+	int ret;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		/* Check if slot is available */
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = sig;
+			prim_bkt->sig_alt[i] = alt_hash;
+			rte_smp_wmb();
+			prim_bkt->key_idx[i] = new_idx;
+			return 0;
+		}
+	}
+
+	/* Primary bucket full, need to make space for new entry
+	 * After recursive function.
+	 * Insert the new entry in the position of the pushed entry
+	 * if successful or return error
+	 */
+	ret = make_space_bucket(h, prim_bkt);
+	if (ret >= 0) {
+		prim_bkt->sig_current[ret] = sig;
+		prim_bkt->sig_alt[ret] = alt_hash;
+		rte_smp_wmb();
+		prim_bkt->key_idx[ret] = new_idx;
+		return 0;
+	}
+
+	return ret;
+}
+
+/* Key slots of resizable tables: free list first, then never used slots */
+static inline uint32_t
+resize_alloc_slot(const struct rte_hash *h)
+{
+	struct rte_hash_resize *rs = h->resize;
+	uint32_t key_idx = rs->free_head;
+
+	if (key_idx != 0) {
+		rs->free_head = (uint32_t)get_key_slot(h, key_idx)->idata;
+		return key_idx;
+	}
+	if (rs->next_fresh > h->entries)
+		return 0;
+	return rs->next_fresh++;
+}
+
+static inline void
+resize_free_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	struct rte_hash_resize *rs = h->resize;
+
+	get_key_slot(h, key_idx)->idata = rs->free_head;
+	rs->free_head = key_idx;
+}
+
+/*
+ * Move the entries of up to @n buckets of the old table to the new one,
+ * through the cuckoo insertion. The migration of a bucket stops at the
+ * first entry which cannot be placed, and is resumed by the next call.
+ * Return the number of buckets fully migrated.
+ */
+static unsigned
+resize_migrate(const struct rte_hash *h, unsigned n)
+{
+	struct rte_hash_resize *rs = h->resize;
+	struct rte_hash_bucket *old_bkt;
+	unsigned i, done;
+
+	for (done = 0; done < n && rs->old_buckets != NULL; done++) {
+		old_bkt = &rs->old_buckets[rs->migrate_idx];
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (old_bkt->key_idx[i] == EMPTY_SLOT)
+				continue;
+			if (cuckoo_insert(h, &h->buckets[
+					old_bkt->sig_current[i] &
+					h->bucket_bitmask],
+					old_bkt->sig_current[i],
+					old_bkt->sig_alt[i],
+					old_bkt->key_idx[i]) < 0)
+				return done;
+			old_bkt->sig_current[i] = NULL_SIGNATURE;
+			old_bkt->sig_alt[i] = NULL_SIGNATURE;
+			old_bkt->key_idx[i] = EMPTY_SLOT;
+		}
+
+		if (++rs->migrate_idx == rs->old_num_buckets) {
+			rte_free(rs->old_buckets);
+			rs->old_buckets = NULL;
+		}
+	}
+
+	return done;
+}
+
+/*
+ * Double the capacity of a resizable table: allocate a bucket array twice
+ * as large and a new key store segment, the entries of the current bucket
+ * array being migrated later on.
+ * Return -EAGAIN if the previous growth is still being migrated: it is
+ * then only helped with a bounded number of buckets, so that no operation
+ * has to rehash the whole table.
+ */
+static int
+resize_grow(const struct rte_hash *h)
+{
+	/* The table geometry is only changed by its single writer */
+	struct rte_hash *hw = (struct rte_hash *)(uintptr_t)h;
+	struct rte_hash_resize *rs = h->resize;
+	struct rte_hash_bucket *buckets;
+	void *seg;
+
+	if (h->entries > RTE_HASH_ENTRIES_MAX / 2 ||
+			rs->nb_segs == RTE_HASH_RESIZE_MAX_SEGS)
+		return -ENOSPC;
+
+	if (rs->old_buckets != NULL) {
+		if (resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BUCKETS) == 0)
+			return -ENOSPC;
+		if (rs->old_buckets != NULL)
+			return -EAGAIN;
+	}
+
+	buckets = rte_zmalloc_socket(NULL,
+			2 * h->num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, rs->socket_id);
+	/* Key slots are initialized when used */
+	seg = rte_malloc_socket(NULL, (size_t)h->entries * h->key_entry_size,
+			RTE_CACHE_LINE_SIZE, rs->socket_id);
+	if (buckets == NULL || seg == NULL) {
+		RTE_LOG(ERR, HASH, "%s: cannot grow to %u entries\n",
+			h->name, 2 * h->entries);
+		rte_free(buckets);
+		rte_free(seg);
+		return -ENOMEM;
+	}
+
+	rs->key_segs[rs->nb_segs++] = seg;
+	rs->old_buckets = h->buckets;
+	rs->old_num_buckets = h->num_buckets;
+	rs->old_bucket_bitmask = h->bucket_bitmask;
+	rs->migrate_idx = 0;
+
+	hw->buckets = buckets;
+	hw->num_buckets *= 2;
+	hw->bucket_bitmask = hw->num_buckets - 1;
+	hw->entries *= 2;
+
+	return 0;
+}
+
+/*
+ * Called on each addition and deletion of a resizable table: migrate a few
+ * buckets while growing, otherwise grow it when it is 7/8 full.
+ */
+static inline void
+resize_step(const struct rte_hash *h)
+{
+	struct rte_hash_resize *rs = h->resize;
+
+	if (rs->old_buckets != NULL)
+		resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BUCKETS);
+	else if (rs->nb_keys >= h->entries - h->entries / 8)
+		resize_grow(h);
+}
+
+/*
+ * Return the bucket of the old table indexed by @sig, if it may still hold
+ * entries not migrated yet, NULL otherwise.
+ */
+static inline struct rte_hash_bucket *
+resize_old_bucket(const struct rte_hash *h, hash_sig_t sig)
+{
+	struct rte_hash_resize *rs = h->resize;
+	uint32_t bkt_idx;
+
+	if (rs == NULL || rs->old_buckets == NULL)
+		return NULL;
+	bkt_idx = sig & rs->old_bucket_bitmask;
+	if (bkt_idx < rs->migrate_idx)
+		return NULL;
+	return &rs->old_buckets[bkt_idx];
+}
+
 /*
  * Function called to enqueue back an index in the cache/ring,
  * as slot has not being used and it can be used in the
@@ -493,22 +917,115 @@ enqueue_slot_back(const struct rte_hash *h,
 		struct lcore_cache *cached_free_slots,
 		void *slot_id)
 {
-	if (h->hw_trans_mem_support) {
+	if (h->resize != NULL)
+		resize_free_slot(h, (uint32_t)((uintptr_t)slot_id));
+	else if (h->hw_trans_mem_support) {
 		cached_free_slots->objs[cached_free_slots->len] = slot_id;
 		cached_free_slots->len++;
 	} else
 		rte_ring_sp_enqueue(h->free_slots, slot_id);
 }
 
+/*
+ * Record the current time in a key slot added or found by a lookup.
+ * Lookups only see const key slots; the age is the one field they write,
+ * so this is the only place where the const is cast away. The age is only
+ * stored when it changed, so that lookups hitting the same keys on several
+ * lcores do not keep dirtying the key cache lines.
+ */
+static inline void
+key_slot_hit(const struct rte_hash *h, const struct rte_hash_key *k)
+{
+	uint32_t *age;
+
+	if (!h->aging_support)
+		return;
+
+	age = key_slot_age(h, (struct rte_hash_key *)(uintptr_t)k);
+	if (*age != h->age_time)
+		*age = h->age_time;
+}
+
+/*
+ * Search a key in one bucket, where it would be stored as (sig, alt_hash),
+ * and update its data if found.
+ */
+static inline int32_t
+search_and_update(const struct rte_hash *h, void *data, const void *key,
+		struct rte_hash_bucket *bkt, hash_sig_t sig,
+		hash_sig_t alt_hash)
+{
+	unsigned i;
+	struct rte_hash_key *k;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->sig_current[i] == sig &&
+				bkt->sig_alt[i] == alt_hash) {
+			k = get_key_slot(h, bkt->key_idx[i]);
+			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+				/* Update data */
+				k->pdata = data;
+				key_slot_hit(h, k);
+				/*
+				 * Return index where key is stored,
+				 * subtracting the first dummy index
+				 */
+				return bkt->key_idx[i] - 1;
+			}
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * Store an entry which found no room in the cuckoo table in the chain of
+ * extendable buckets of its secondary bucket, appending a new bucket to
+ * the chain if it is full.
+ */
+static inline int
+add_key_ext_bkt(const struct rte_hash *h, struct rte_hash_bucket *sec_bkt,
+		hash_sig_t sig, hash_sig_t alt_hash, uint32_t new_idx)
+{
+	struct rte_hash_bucket *cur_bkt, *last_bkt = sec_bkt;
+	void *ext_bkt_id = NULL;
+	unsigned i;
+
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt->next) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (cur_bkt->key_idx[i] == EMPTY_SLOT) {
+				cur_bkt->sig_current[i] = alt_hash;
+				cur_bkt->sig_alt[i] = sig;
+				rte_smp_wmb();
+				cur_bkt->key_idx[i] = new_idx;
+				return 0;
+			}
+		}
+		last_bkt = cur_bkt;
+	}
+
+	if (rte_ring_dequeue(h->free_ext_bkts, &ext_bkt_id) != 0)
+		return -ENOSPC;
+
+	cur_bkt = &h->buckets_ext[(uintptr_t)ext_bkt_id - 1];
+	cur_bkt->next = NULL;
+	cur_bkt->sig_current[0] = alt_hash;
+	cur_bkt->sig_alt[0] = sig;
+	cur_bkt->key_idx[0] = new_idx;
+	/* Link the new bucket once filled in */
+	rte_smp_wmb();
+	last_bkt->next = cur_bkt;
+	return 0;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
 {
 	hash_sig_t alt_hash;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	unsigned i;
-	struct rte_hash_bucket *prim_bkt, *sec_bkt;
-	struct rte_hash_key *new_k, *k, *keys = h->key_store;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
+	struct rte_hash_key *new_k;
 	void *slot_id = NULL;
 	uint32_t new_idx;
 	int ret;
@@ -519,6 +1036,9 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (h->add_key == ADD_KEY_MULTIWRITER)
 		rte_spinlock_lock(h->multiwriter_lock);
 
+	if (h->resize != NULL)
+		resize_step(h);
+
 	prim_bucket_idx = sig & h->bucket_bitmask;
 	prim_bkt = &h->buckets[prim_bucket_idx];
 	rte_prefetch0(prim_bkt);
@@ -529,7 +1049,11 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	rte_prefetch0(sec_bkt);
 
 	/* Get a new slot for storing the new key */
-	if (h->hw_trans_mem_support) {
+	if (h->resize != NULL) {
+		slot_id = (void *)((uintptr_t)resize_alloc_slot(h));
+		if (slot_id == NULL)
+			return -ENOSPC;
+	} else if (h->hw_trans_mem_support) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
 		/* Try to get a free slot from the local cache */
@@ -538,8 +1062,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			n_slots = rte_ring_mc_dequeue_burst(h->free_slots,
 					cached_free_slots->objs,
 					LCORE_CACHE_SIZE, NULL);
-			if (n_slots == 0)
+			if (n_slots == 0) {
+				if (h->add_key == ADD_KEY_MULTIWRITER)
+					rte_spinlock_unlock(
+						h->multiwriter_lock);
 				return -ENOSPC;
+			}
 
 			cached_free_slots->len += n_slots;
 		}
@@ -548,57 +1076,58 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		cached_free_slots->len--;
 		slot_id = cached_free_slots->objs[cached_free_slots->len];
 	} else {
-		if (rte_ring_sc_dequeue(h->free_slots, &slot_id) != 0)
+		if (rte_ring_sc_dequeue(h->free_slots, &slot_id) != 0) {
+			if (h->add_key == ADD_KEY_MULTIWRITER)
+				rte_spinlock_unlock(h->multiwriter_lock);
 			return -ENOSPC;
+		}
 	}
 
-	new_k = RTE_PTR_ADD(keys, (uintptr_t)slot_id * h->key_entry_size);
+	new_k = get_key_slot(h, (uint32_t)((uintptr_t) slot_id));
 	rte_prefetch0(new_k);
 	new_idx = (uint32_t)((uintptr_t) slot_id);
 
 	/* Check if key is already inserted in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (prim_bkt->sig_current[i] == sig &&
-				prim_bkt->sig_alt[i] == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					prim_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				return prim_bkt->key_idx[i] - 1;
-			}
+	ret = search_and_update(h, data, key, prim_bkt, sig, alt_hash);
+	if (ret == -1) {
+		/* Check if key is already inserted in secondary location */
+		FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+			ret = search_and_update(h, data, key, cur_bkt,
+						alt_hash, sig);
+			if (ret != -1)
+				break;
 		}
 	}
-
-	/* Check if key is already inserted in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (sec_bkt->sig_alt[i] == sig &&
-				sec_bkt->sig_current[i] == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					sec_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				return sec_bkt->key_idx[i] - 1;
-			}
-		}
+	/* Also check the part of the old table not migrated yet */
+	if (ret == -1) {
+		cur_bkt = resize_old_bucket(h, sig);
+		if (cur_bkt != NULL)
+			ret = search_and_update(h, data, key, cur_bkt,
+						sig, alt_hash);
+	}
+	if (ret == -1) {
+		cur_bkt = resize_old_bucket(h, alt_hash);
+		if (cur_bkt != NULL)
+			ret = search_and_update(h, data, key, cur_bkt,
+						alt_hash, sig);
+	}
+	if (ret != -1) {
+		/* Enqueue index of free slot back in the ring. */
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		if (h->add_key == ADD_KEY_MULTIWRITER)
+			rte_spinlock_unlock(h->multiwriter_lock);
+		return ret;
 	}
 
 	/* Copy key */
 	rte_memcpy(new_k->key, key, h->key_len);
 	new_k->pdata = data;
+	key_slot_hit(h, new_k);
+	/*
+	 * Key and data must be visible before the slot index is published
+	 * in a bucket, for the benefit of lock-free readers.
+	 */
+	rte_smp_wmb();
 
 #if defined(RTE_ARCH_X86) /* currently only x86 support HTM */
 	if (h->add_key == ADD_KEY_MULTIWRITER_TM) {
@@ -622,40 +1151,41 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			return new_idx - 1;
 	} else {
 #endif
-		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-			/* Check if slot is available */
-			if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
-				prim_bkt->sig_current[i] = sig;
-				prim_bkt->sig_alt[i] = alt_hash;
-				prim_bkt->key_idx[i] = new_idx;
-				break;
-			}
-		}
-
-		if (i != RTE_HASH_BUCKET_ENTRIES) {
+		ret = cuckoo_insert(h, prim_bkt, sig, alt_hash, new_idx);
+		if (ret == 0) {
+			if (h->resize != NULL)
+				h->resize->nb_keys++;
 			if (h->add_key == ADD_KEY_MULTIWRITER)
 				rte_spinlock_unlock(h->multiwriter_lock);
 			return new_idx - 1;
 		}
+#if defined(RTE_ARCH_X86)
+	}
+#endif
+	/* No room in the cuckoo table, grow it if resizable and retry */
+	if (h->resize != NULL) {
+		ret = resize_grow(h);
+		if (ret == 0) {
+			prim_bkt = &h->buckets[sig & h->bucket_bitmask];
+			ret = cuckoo_insert(h, prim_bkt, sig, alt_hash,
+					new_idx);
+			if (ret == 0) {
+				h->resize->nb_keys++;
+				return new_idx - 1;
+			}
+		}
+	}
 
-		/* Primary bucket full, need to make space for new entry
-		 * After recursive function.
-		 * Insert the new entry in the position of the pushed entry
-		 * if successful or return error and
-		 * store the new slot back in the ring
-		 */
-		ret = make_space_bucket(h, prim_bkt);
+	/* No room in the cuckoo table, use the extendable buckets */
+	if (h->ext_table_support) {
+		ret = add_key_ext_bkt(h, sec_bkt, sig, alt_hash, new_idx);
 		if (ret >= 0) {
-			prim_bkt->sig_current[ret] = sig;
-			prim_bkt->sig_alt[ret] = alt_hash;
-			prim_bkt->key_idx[ret] = new_idx;
 			if (h->add_key == ADD_KEY_MULTIWRITER)
 				rte_spinlock_unlock(h->multiwriter_lock);
 			return new_idx - 1;
 		}
-#if defined(RTE_ARCH_X86)
 	}
-#endif
+
 	/* Error in addition, store new slot back in the ring and return error */
 	enqueue_slot_back(h, cached_free_slots, (void *)((uintptr_t) new_idx));
 
@@ -706,59 +1236,120 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 	else
 		return ret;
 }
+
+/* Search a key in one bucket, where it would be stored as (sig, alt_hash) */
 static inline int32_t
-__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
-					hash_sig_t sig, void **data)
+search_one_bucket(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		hash_sig_t alt_hash, void **data,
+		const struct rte_hash_bucket *bkt)
 {
-	uint32_t bucket_idx;
-	hash_sig_t alt_hash;
 	unsigned i;
-	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
-
-	bucket_idx = sig & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	uint32_t key_idx;
+	struct rte_hash_key *k;
 
-	/* Check if key is in primary location */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig &&
-				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+				bkt->sig_alt[i] == alt_hash) {
+			/*
+			 * The writer stores the signatures before the key
+			 * index, do not load the key index before them.
+			 */
+			rte_smp_rmb();
+			key_idx = bkt->key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+			k = get_key_slot(h, key_idx);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				if (data != NULL)
 					*data = k->pdata;
+				key_slot_hit(h, k);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
 				 */
-				return bkt->key_idx[i] - 1;
+				return key_idx - 1;
 			}
 		}
 	}
 
+	return -ENOENT;
+}
+
+/* Search a key in the old table of a resizable hash table being grown */
+static inline int32_t
+resize_old_lookup(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		hash_sig_t alt_hash, void **data)
+{
+	const struct rte_hash_bucket *old_bkt;
+	int32_t ret;
+
+	old_bkt = resize_old_bucket(h, sig);
+	if (old_bkt != NULL) {
+		ret = search_one_bucket(h, key, sig, alt_hash, data, old_bkt);
+		if (ret != -ENOENT)
+			return ret;
+	}
+
+	old_bkt = resize_old_bucket(h, alt_hash);
+	if (old_bkt != NULL)
+		return search_one_bucket(h, key, alt_hash, sig, data,
+					old_bkt);
+
+	return -ENOENT;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	hash_sig_t alt_hash;
+	const struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
+	uint32_t prim_cnt, sec_cnt;
+	int32_t ret;
+
+	prim_bkt = &h->buckets[sig & h->bucket_bitmask];
 	/* Calculate secondary hash */
 	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	sec_bkt = &h->buckets[alt_hash & h->bucket_bitmask];
 
-	/* Check if key is in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == alt_hash &&
-				bkt->sig_alt[i] == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				if (data != NULL)
-					*data = k->pdata;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
+	do {
+		prim_cnt = prim_bkt->chng_cnt;
+		sec_cnt = sec_bkt->chng_cnt;
+		rte_smp_rmb();
+
+		/* Check if key is in primary location */
+		ret = search_one_bucket(h, key, sig, alt_hash, data, prim_bkt);
+		if (ret != -ENOENT)
+			return ret;
+
+		/*
+		 * Check if key is in secondary location, or in the
+		 * extendable buckets chained to it
+		 */
+		FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+			ret = search_one_bucket(h, key, alt_hash, sig, data,
+						cur_bkt);
+			if (ret != -ENOENT)
+				return ret;
 		}
-	}
+
+		/*
+		 * With a concurrent writer, the key may have been moved
+		 * from the secondary to the primary bucket while both were
+		 * searched, or towards the head of the extendable buckets
+		 * chain. The writer bumps the change counter of the source
+		 * bucket (of the chain head for the latter) between the
+		 * copy and the removal, so searching again if a counter
+		 * moved is enough not to miss it.
+		 */
+		rte_smp_rmb();
+	} while (h->readwrite_concur_lf_support &&
+			(prim_cnt != prim_bkt->chng_cnt ||
+			 sec_cnt != sec_bkt->chng_cnt));
+
+	/* Check the part of the old table not migrated yet */
+	if (unlikely(h->resize != NULL))
+		return resize_old_lookup(h, key, sig, alt_hash, data);
 
 	return -ENOENT;
 }
@@ -793,15 +1384,16 @@ rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
 	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
 }
 
+/* Put back a key slot in the cache/ring of free slots */
 static inline void
-remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
+free_key_slot(const struct rte_hash *h, uint32_t key_idx)
 {
 	unsigned lcore_id, n_slots;
 	struct lcore_cache *cached_free_slots;
 
-	bkt->sig_current[i] = NULL_SIGNATURE;
-	bkt->sig_alt[i] = NULL_SIGNATURE;
-	if (h->hw_trans_mem_support) {
+	if (h->resize != NULL) {
+		resize_free_slot(h, key_idx);
+	} else if (h->hw_trans_mem_support) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
 		/* Cache full, need to free it. */
@@ -814,73 +1406,172 @@ remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 		}
 		/* Put index of new free slot in cache. */
 		cached_free_slots->objs[cached_free_slots->len] =
-				(void *)((uintptr_t)bkt->key_idx[i]);
+				(void *)((uintptr_t)key_idx);
 		cached_free_slots->len++;
 	} else {
 		rte_ring_sp_enqueue(h->free_slots,
-				(void *)((uintptr_t)bkt->key_idx[i]));
+				(void *)((uintptr_t)key_idx));
+	}
+}
+
+static inline void
+remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
+{
+	bkt->sig_current[i] = NULL_SIGNATURE;
+	bkt->sig_alt[i] = NULL_SIGNATURE;
+	/*
+	 * Lock-free readers may still be comparing against the key, so
+	 * the slot is only recycled by rte_hash_free_key_with_position().
+	 */
+	if (!h->readwrite_concur_lf_support)
+		free_key_slot(h, bkt->key_idx[i]);
+}
+
+/* Search a key in one bucket and return the slot storing it, or -1 */
+static inline int
+search_key_slot(const struct rte_hash *h, const void *key,
+		const struct rte_hash_bucket *bkt, hash_sig_t sig)
+{
+	unsigned i;
+	struct rte_hash_key *k;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->sig_current[i] == sig &&
+				bkt->key_idx[i] != EMPTY_SLOT) {
+			k = get_key_slot(h, bkt->key_idx[i]);
+			if (rte_hash_cmp_eq(key, k->key, h) == 0)
+				return i;
+		}
+	}
+
+	return -1;
+}
+
+static inline int32_t
+delete_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt,
+		unsigned i)
+{
+	int32_t ret;
+
+	remove_entry(h, bkt, i);
+	if (h->resize != NULL)
+		h->resize->nb_keys--;
+
+	/*
+	 * Return index where key is stored,
+	 * subtracting the first dummy index
+	 */
+	ret = bkt->key_idx[i] - 1;
+	bkt->key_idx[i] = EMPTY_SLOT;
+	return ret;
+}
+
+/*
+ * Fill the hole left by a deletion in the extendable buckets chained to
+ * @sec_bkt with the last entry of the chain, so that all the buckets of a
+ * chain but the last one are full, and release the last bucket when it
+ * gets empty.
+ */
+static inline void
+compact_ext_chain(const struct rte_hash *h, struct rte_hash_bucket *sec_bkt,
+		struct rte_hash_bucket *bkt, unsigned pos, uint32_t key_idx)
+{
+	struct rte_hash_bucket *last_bkt, *prev_bkt = sec_bkt;
+	uint32_t ext_bkt_id;
+	int i;
+
+	for (last_bkt = sec_bkt->next; last_bkt->next != NULL;
+			last_bkt = last_bkt->next)
+		prev_bkt = last_bkt;
+
+	if (last_bkt != bkt) {
+		for (i = RTE_HASH_BUCKET_ENTRIES - 1; i >= 0; i--)
+			if (last_bkt->key_idx[i] != EMPTY_SLOT)
+				break;
+
+		/* Buckets before the last one are full */
+		bkt->sig_current[pos] = last_bkt->sig_current[i];
+		bkt->sig_alt[pos] = last_bkt->sig_alt[i];
+		rte_smp_wmb();
+		bkt->key_idx[pos] = last_bkt->key_idx[i];
+		bucket_chng_cnt_inc(sec_bkt);
+		last_bkt->sig_current[i] = NULL_SIGNATURE;
+		last_bkt->sig_alt[i] = NULL_SIGNATURE;
+		last_bkt->key_idx[i] = EMPTY_SLOT;
 	}
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++)
+		if (last_bkt->key_idx[i] != EMPTY_SLOT)
+			return;
+
+	/*
+	 * Unlink the empty bucket. Its next pointer is left untouched for
+	 * the readers that may still be walking it.
+	 */
+	prev_bkt->next = NULL;
+	ext_bkt_id = last_bkt - h->buckets_ext + 1;
+	if (h->readwrite_concur_lf_support)
+		h->ext_bkt_to_free[key_idx] = ext_bkt_id;
+	else
+		rte_ring_enqueue(h->free_ext_bkts,
+				(void *)((uintptr_t)ext_bkt_id));
 }
 
 static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
-	uint32_t bucket_idx;
 	hash_sig_t alt_hash;
-	unsigned i;
-	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
 	int32_t ret;
+	int pos;
 
-	bucket_idx = sig & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	if (h->resize != NULL)
+		resize_step(h);
 
-	/* Check if key is in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == sig &&
-				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				remove_entry(h, bkt, i);
+	prim_bkt = &h->buckets[sig & h->bucket_bitmask];
 
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				ret = bkt->key_idx[i] - 1;
-				bkt->key_idx[i] = EMPTY_SLOT;
-				return ret;
-			}
-		}
-	}
+	/* Check if key is in primary location */
+	pos = search_key_slot(h, key, prim_bkt, sig);
+	if (pos >= 0)
+		return delete_entry(h, prim_bkt, pos);
 
 	/* Calculate secondary hash */
 	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	sec_bkt = &h->buckets[alt_hash & h->bucket_bitmask];
 
 	/* Check if key is in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == alt_hash &&
-				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				remove_entry(h, bkt, i);
-
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				ret = bkt->key_idx[i] - 1;
-				bkt->key_idx[i] = EMPTY_SLOT;
+	pos = search_key_slot(h, key, sec_bkt, alt_hash);
+	if (pos >= 0)
+		return delete_entry(h, sec_bkt, pos);
+
+	/* Check if key is in the extendable buckets */
+	if (h->ext_table_support) {
+		FOR_EACH_BUCKET(cur_bkt, sec_bkt->next) {
+			pos = search_key_slot(h, key, cur_bkt, alt_hash);
+			if (pos >= 0) {
+				ret = delete_entry(h, cur_bkt, pos);
+				compact_ext_chain(h, sec_bkt, cur_bkt, pos,
+						ret + 1);
 				return ret;
 			}
 		}
 	}
 
+	/* Check the part of the old table not migrated yet */
+	cur_bkt = resize_old_bucket(h, sig);
+	if (cur_bkt != NULL) {
+		pos = search_key_slot(h, key, cur_bkt, sig);
+		if (pos >= 0)
+			return delete_entry(h, cur_bkt, pos);
+	}
+	cur_bkt = resize_old_bucket(h, alt_hash);
+	if (cur_bkt != NULL) {
+		pos = search_key_slot(h, key, cur_bkt, alt_hash);
+		if (pos >= 0)
+			return delete_entry(h, cur_bkt, pos);
+	}
+
 	return -ENOENT;
 }
 
@@ -899,15 +1590,37 @@ rte_hash_del_key(const struct rte_hash *h, const void *key)
 	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
 }
 
+int
+rte_hash_free_key_with_position(const struct rte_hash *h,
+				const int32_t position)
+{
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+
+	if (!h->readwrite_concur_lf_support ||
+			(uint32_t)position >= h->entries)
+		return -EINVAL;
+
+	/* Skip the first dummy index */
+	free_key_slot(h, position + 1);
+
+	/* Release the extendable bucket emptied by this key deletion */
+	if (h->ext_bkt_to_free != NULL &&
+			h->ext_bkt_to_free[position + 1] != 0) {
+		rte_ring_enqueue(h->free_ext_bkts, (void *)(uintptr_t)
+				h->ext_bkt_to_free[position + 1]);
+		h->ext_bkt_to_free[position + 1] = 0;
+	}
+	return 0;
+}
+
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 			       void **key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	struct rte_hash_key *k, *keys = h->key_store;
-	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
-				     h->key_entry_size);
+	struct rte_hash_key *k;
+	k = get_key_slot(h, position + 1);
 	*key = k->key;
 
 	if (position !=
@@ -929,18 +1642,6 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	unsigned int i;
 
 	switch (sig_cmp_fn) {
-#ifdef RTE_MACHINE_CPUFLAG_AVX2
-	case RTE_HASH_COMPARE_AVX2:
-		*prim_hash_matches = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
-				_mm256_load_si256(
-					(__m256i const *)prim_bkt->sig_current),
-				_mm256_set1_epi32(prim_hash)));
-		*sec_hash_matches = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
-				_mm256_load_si256(
-					(__m256i const *)sec_bkt->sig_current),
-				_mm256_set1_epi32(sec_hash)));
-		break;
-#endif
 #ifdef RTE_MACHINE_CPUFLAG_SSE2
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare the first 4 signatures in the bucket */
@@ -974,6 +1675,41 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 
 }
 
+/* Compare the signatures of a burst of keys with their two buckets */
+static inline void
+compare_signatures_bulk(const struct rte_hash *h, uint32_t *prim_hitmask,
+			uint32_t *sec_hitmask,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+			int32_t num_keys)
+{
+	int32_t i;
+
+	switch (h->sig_cmp_fn) {
+#ifdef CC_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+		rte_hash_compare_signatures_avx512(prim_hitmask, sec_hitmask,
+				primary_bkt, secondary_bkt,
+				prim_hash, sec_hash, num_keys);
+		break;
+#endif
+#ifdef CC_AVX2_SUPPORT
+	case RTE_HASH_COMPARE_AVX2:
+		rte_hash_compare_signatures_avx2(prim_hitmask, sec_hitmask,
+				primary_bkt, secondary_bkt,
+				prim_hash, sec_hash, num_keys);
+		break;
+#endif
+	default:
+		for (i = 0; i < num_keys; i++)
+			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
+					primary_bkt[i], secondary_bkt[i],
+					prim_hash[i], sec_hash[i],
+					h->sig_cmp_fn);
+	}
+}
+
 #define PREFETCH_OFFSET 4
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
@@ -988,6 +1724,8 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t prim_cnt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_cnt[RTE_HASH_LOOKUP_BULK_MAX];
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -1022,19 +1760,30 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	/* Compare signatures and prefetch key slot of first hit */
-	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				prim_hash[i], sec_hash[i], h->sig_cmp_fn);
+	/* Snapshot bucket change counters before reading their entries */
+	if (h->readwrite_concur_lf_support) {
+		for (i = 0; i < num_keys; i++) {
+			prim_cnt[i] = primary_bkt[i]->chng_cnt;
+			sec_cnt[i] = secondary_bkt[i]->chng_cnt;
+		}
+		rte_smp_rmb();
+	}
+
+	/* Compare signatures */
+	compare_signatures_bulk(h, prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, prim_hash, sec_hash, num_keys);
+
+	/* Load the key indexes after the signatures they were matched with */
+	if (h->readwrite_concur_lf_support)
+		rte_smp_rmb();
 
+	/* Prefetch key slot of first hit */
+	for (i = 0; i < num_keys; i++) {
 		if (prim_hitmask[i]) {
 			uint32_t first_hit = __builtin_ctzl(prim_hitmask[i]);
 			uint32_t key_idx = primary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 			continue;
 		}
@@ -1043,9 +1792,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			uint32_t first_hit = __builtin_ctzl(sec_hitmask[i]);
 			uint32_t key_idx = secondary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 		}
 	}
@@ -1058,9 +1805,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 
 			uint32_t key_idx = primary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			/*
 			 * If key index is 0, do not compare key,
 			 * as it is checking the dummy slot
@@ -1068,6 +1813,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, keys[i], h)) {
 				if (data != NULL)
 					data[i] = key_slot->pdata;
+				key_slot_hit(h, key_slot);
 
 				hits |= 1ULL << i;
 				positions[i] = key_idx - 1;
@@ -1081,9 +1827,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 
 			uint32_t key_idx = secondary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			/*
 			 * If key index is 0, do not compare key,
 			 * as it is checking the dummy slot
@@ -1092,6 +1836,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, keys[i], h)) {
 				if (data != NULL)
 					data[i] = key_slot->pdata;
+				key_slot_hit(h, key_slot);
 
 				hits |= 1ULL << i;
 				positions[i] = key_idx - 1;
@@ -1104,6 +1849,44 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		continue;
 	}
 
+	/*
+	 * Search again the keys missed while a concurrent writer moved
+	 * entries out of one of their buckets, and search the missed keys
+	 * in the extendable buckets.
+	 */
+	if (h->readwrite_concur_lf_support || h->ext_table_support) {
+		rte_smp_rmb();
+		for (i = 0; i < num_keys; i++) {
+			if (positions[i] != -ENOENT)
+				continue;
+			if (secondary_bkt[i]->next == NULL &&
+					(!h->readwrite_concur_lf_support ||
+					(prim_cnt[i] == primary_bkt[i]->chng_cnt &&
+					 sec_cnt[i] == secondary_bkt[i]->chng_cnt)))
+				continue;
+
+			positions[i] = __rte_hash_lookup_with_hash(h, keys[i],
+					prim_hash[i],
+					data != NULL ? &data[i] : NULL);
+			if (positions[i] >= 0)
+				hits |= 1ULL << i;
+		}
+	}
+
+	/* Search the missed keys in the old table of a table being grown */
+	if (unlikely(h->resize != NULL && h->resize->old_buckets != NULL)) {
+		for (i = 0; i < num_keys; i++) {
+			if (positions[i] != -ENOENT)
+				continue;
+
+			positions[i] = resize_old_lookup(h, keys[i],
+					prim_hash[i], sec_hash[i],
+					data != NULL ? &data[i] : NULL);
+			if (positions[i] >= 0)
+				hits |= 1ULL << i;
+		}
+	}
+
 	if (hit_mask != NULL)
 		*hit_mask = hits;
 }
@@ -1136,37 +1919,197 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/*
+ * First stages of the bulk additions and deletions, as for the bulk
+ * lookups: hash all the keys, prefetch their primary and secondary
+ * buckets, then compare the signatures and prefetch the key slots of the
+ * hits, which are compared to find an existing key to update or delete.
+ */
+static inline void
+__rte_hash_prefetch_bulk(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, hash_sig_t *prim_hash)
+{
+	hash_sig_t sec_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t hit_index, key_idx;
+	int32_t i;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	/* Hash all the keys, prefetching the next ones */
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		prim_hash[i] = rte_hash_hash(h, keys[i]);
+		sec_hash[i] = rte_hash_secondary_hash(prim_hash[i]);
+	}
+
+	/* Calculate and prefetch both buckets */
+	for (i = 0; i < num_keys; i++) {
+		primary_bkt[i] = &h->buckets[prim_hash[i] & h->bucket_bitmask];
+		secondary_bkt[i] = &h->buckets[sec_hash[i] & h->bucket_bitmask];
+
+		rte_prefetch0(primary_bkt[i]);
+		rte_prefetch0(secondary_bkt[i]);
+	}
+
+	/* Compare signatures */
+	compare_signatures_bulk(h, prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, prim_hash, sec_hash, num_keys);
+
+	/* Prefetch the key slots of the hits */
+	for (i = 0; i < num_keys; i++) {
+		while (prim_hitmask[i]) {
+			hit_index = __builtin_ctzl(prim_hitmask[i]);
+			key_idx = primary_bkt[i]->key_idx[hit_index];
+			if (key_idx != EMPTY_SLOT)
+				rte_prefetch0(get_key_slot(h, key_idx));
+			prim_hitmask[i] &= ~(1 << hit_index);
+		}
+		while (sec_hitmask[i]) {
+			hit_index = __builtin_ctzl(sec_hitmask[i]);
+			key_idx = secondary_bkt[i]->key_idx[hit_index];
+			if (key_idx != EMPTY_SLOT)
+				rte_prefetch0(get_key_slot(h, key_idx));
+			sec_hitmask[i] &= ~(1 << hit_index);
+		}
+	}
+}
+
+static inline int
+__rte_hash_add_key_bulk(const struct rte_hash *h, const void **keys,
+			void **data, int32_t num_keys, int32_t *positions)
+{
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	int nb_added = 0;
+	int32_t i;
+
+	__rte_hash_prefetch_bulk(h, keys, num_keys, prim_hash);
+
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_add_key_with_hash(h, keys[i],
+				prim_hash[i], data != NULL ? data[i] : NULL);
+		if (positions[i] >= 0)
+			nb_added++;
+	}
+
+	return nb_added;
+}
+
+int
+rte_hash_add_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	return __rte_hash_add_key_bulk(h, keys, NULL, num_keys, positions);
+}
+
+int
+rte_hash_add_key_data_bulk(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions)
+{
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (data == NULL) ||
+			(num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	return __rte_hash_add_key_bulk(h, keys, data, num_keys, positions);
+}
+
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	int nb_deleted = 0;
+	uint32_t i;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	__rte_hash_prefetch_bulk(h, keys, num_keys, prim_hash);
+
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_with_hash(h, keys[i],
+				prim_hash[i]);
+		if (positions[i] >= 0)
+			nb_deleted++;
+	}
+
+	return nb_deleted;
+}
+
+/*
+ * Bucket of the iterator position, the extendable buckets (if any) or the
+ * old table of a table being grown being walked after the main table.
+ */
+static inline const struct rte_hash_bucket *
+iterate_bucket(const struct rte_hash *h, uint32_t next)
+{
+	uint32_t bucket_idx = next / RTE_HASH_BUCKET_ENTRIES;
+
+	if (bucket_idx < h->num_buckets)
+		return &h->buckets[bucket_idx];
+	if (h->resize != NULL)
+		return &h->resize->old_buckets[bucket_idx - h->num_buckets];
+	return &h->buckets_ext[bucket_idx - h->num_buckets];
+}
+
+/* Number of iterator positions, as walked by iterate_bucket() */
+static inline uint32_t
+iterate_total_entries(const struct rte_hash *h)
+{
+	uint32_t total_entries = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+
+	if (h->ext_table_support)
+		total_entries *= 2;
+	else if (h->resize != NULL && h->resize->old_buckets != NULL)
+		total_entries += h->resize->old_num_buckets *
+				RTE_HASH_BUCKET_ENTRIES;
+	return total_entries;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
-	uint32_t bucket_idx, idx, position;
+	uint32_t idx, position;
+	const struct rte_hash_bucket *bkt;
 	struct rte_hash_key *next_key;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
-	const uint32_t total_entries = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	uint32_t total_entries = iterate_total_entries(h);
 	/* Out of bounds */
 	if (*next >= total_entries)
 		return -ENOENT;
 
 	/* Calculate bucket and index of current iterator */
-	bucket_idx = *next / RTE_HASH_BUCKET_ENTRIES;
+	bkt = iterate_bucket(h, *next);
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
 	/* If current position is empty, go to the next one */
-	while (h->buckets[bucket_idx].key_idx[idx] == EMPTY_SLOT) {
+	while (bkt->key_idx[idx] == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
 		if (*next == total_entries)
 			return -ENOENT;
-		bucket_idx = *next / RTE_HASH_BUCKET_ENTRIES;
+		bkt = iterate_bucket(h, *next);
 		idx = *next % RTE_HASH_BUCKET_ENTRIES;
 	}
 
 	/* Get position of entry in key table */
-	position = h->buckets[bucket_idx].key_idx[idx];
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	position = bkt->key_idx[idx];
+	next_key = get_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -1176,3 +2119,54 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 	return position - 1;
 }
+
+void
+rte_hash_set_age_time(struct rte_hash *h, uint32_t now)
+{
+	h->age_time = now;
+}
+
+int
+rte_hash_age_sweep(const struct rte_hash *h, uint32_t *next,
+		uint32_t nb_buckets, uint32_t max_age, const void **keys,
+		int32_t *positions, uint32_t max_keys)
+{
+	uint32_t total_entries, end, key_idx;
+	const struct rte_hash_bucket *bkt;
+	struct rte_hash_key *k;
+	uint32_t nb_expired = 0;
+
+	if (h == NULL || next == NULL || positions == NULL ||
+			!h->aging_support)
+		return -EINVAL;
+
+	total_entries = iterate_total_entries(h);
+	if (*next >= total_entries)
+		*next = 0;
+	end = total_entries;
+	if (nb_buckets < (total_entries - *next) / RTE_HASH_BUCKET_ENTRIES)
+		end = *next + nb_buckets * RTE_HASH_BUCKET_ENTRIES;
+
+	for (; *next < end && nb_expired < max_keys; (*next)++) {
+		bkt = iterate_bucket(h, *next);
+		key_idx = bkt->key_idx[*next % RTE_HASH_BUCKET_ENTRIES];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		/* Unsigned difference, to handle time wrap around */
+		k = get_key_slot(h, key_idx);
+		if (h->age_time - *key_slot_age(h, k) <= max_age)
+			continue;
+
+		if (keys != NULL)
+			keys[nb_expired] = k->key;
+		/* Subtract the first dummy index */
+		positions[nb_expired++] = key_idx - 1;
+	}
+
+	/* End of table, start over on next call */
+	if (*next == total_entries)
+		*next = 0;
+
+	return nb_expired;
+}
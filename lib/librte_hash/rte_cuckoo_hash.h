@@ -39,14 +39,6 @@
 #ifndef _RTE_CUCKOO_HASH_H_
 #define _RTE_CUCKOO_HASH_H_
 
-#if defined(RTE_ARCH_X86)
-#include "rte_cmp_x86.h"
-#endif
-
-#if defined(RTE_ARCH_ARM64)
-#include "rte_cmp_arm64.h"
-#endif
-
 /* Macro to enable/disable run-time checking of function parameters */
 #if defined(RTE_LIBRTE_HASH_DEBUG)
 #define RETURN_IF_TRUE(cond, retval) do { \
@@ -84,23 +76,6 @@ enum cmp_jump_table_case {
 	KEY_OTHER_BYTES,
 	NUM_KEY_CMP_CASES,
 };
-
-/*
- * Table storing all different key compare functions
- * (multi-process supported)
- */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
-	NULL,
-	rte_hash_k16_cmp_eq,
-	rte_hash_k32_cmp_eq,
-	rte_hash_k48_cmp_eq,
-	rte_hash_k64_cmp_eq,
-	rte_hash_k80_cmp_eq,
-	rte_hash_k96_cmp_eq,
-	rte_hash_k112_cmp_eq,
-	rte_hash_k128_cmp_eq,
-	memcmp
-};
 #else
 /*
  * All different options to select a key compare function,
@@ -112,15 +87,6 @@ enum cmp_jump_table_case {
 	NUM_KEY_CMP_CASES,
 };
 
-/*
- * Table storing all different key compare functions
- * (multi-process supported)
- */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
-	NULL,
-	memcmp
-};
-
 #endif
 
 enum add_key_case {
@@ -148,6 +114,12 @@ enum add_key_case {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Buckets of the old table migrated on each add/delete while growing */
+#define RTE_HASH_RESIZE_MIGRATE_BUCKETS	4
+
+/** Maximum number of key store segments of a resizable table */
+#define RTE_HASH_RESIZE_MAX_SEGS	32
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	void *objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -163,14 +135,6 @@ struct rte_hash_key {
 	char key[0];
 } __attribute__((aligned(KEY_ALIGNMENT)));
 
-/* All different signature compare functions */
-enum rte_hash_sig_compare_function {
-	RTE_HASH_COMPARE_SCALAR = 0,
-	RTE_HASH_COMPARE_SSE,
-	RTE_HASH_COMPARE_AVX2,
-	RTE_HASH_COMPARE_NUM
-};
-
 /** Bucket structure */
 struct rte_hash_bucket {
 	hash_sig_t sig_current[RTE_HASH_BUCKET_ENTRIES];
@@ -180,8 +144,56 @@ struct rte_hash_bucket {
 	hash_sig_t sig_alt[RTE_HASH_BUCKET_ENTRIES];
 
 	uint8_t flag[RTE_HASH_BUCKET_ENTRIES];
+
+	uint32_t chng_cnt;
+	/**< Incremented each time an entry is moved out of this bucket */
+
+	struct rte_hash_bucket *next;
+	/**< Next extendable bucket chained to this one, if any */
 } __rte_cache_aligned;
 
+/*
+ * Signature compare stage of the bulk lookup, for the vector instruction
+ * sets not enabled at build time: set the bits of the entries of the
+ * primary and secondary buckets of each key matching its signatures.
+ */
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches,
+		const struct rte_hash_bucket **prim_bkt,
+		const struct rte_hash_bucket **sec_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys);
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches,
+		const struct rte_hash_bucket **prim_bkt,
+		const struct rte_hash_bucket **sec_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys);
+
+/** Growth state of a resizable hash table. */
+struct rte_hash_resize {
+	struct rte_hash_bucket *old_buckets;
+	/**< Table being migrated, NULL when not growing */
+	uint32_t old_num_buckets;       /**< Number of buckets of old table */
+	uint32_t old_bucket_bitmask;    /**< Bucket index mask of old table */
+	uint32_t migrate_idx;
+	/**< Buckets of the old table below this index are migrated */
+	uint32_t nb_keys;               /**< Number of keys in the table */
+	uint32_t free_head;
+	/**< First free key slot, the next ones are linked by their data */
+	uint32_t next_fresh;            /**< First key slot never used */
+	int socket_id;                  /**< Socket to allocate memory on */
+	uint32_t nb_segs;               /**< Number of key store segments */
+	void *key_segs[RTE_HASH_RESIZE_MAX_SEGS];
+	/**< Key store segments, segment n holds key_store_entries << (n - 1)
+	 * key slots, the first one being the key store itself.
+	 */
+	uint32_t key_store_shift;       /**< log2 of key_store_entries */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -197,6 +209,15 @@ struct rte_hash {
 	enum add_key_case add_key; /**< Multi-writer hash add behavior */
 
 	rte_spinlock_t *multiwriter_lock; /**< Multi-writer spinlock for w/o TM */
+	uint8_t readwrite_concur_lf_support;
+	/**< Lock-free readers with a single writer */
+	uint8_t ext_table_support;     /**< Extendable buckets enabled */
+	struct rte_ring *free_ext_bkts;
+	/**< Ring that stores the indexes of the free extendable buckets */
+	struct rte_hash_bucket *buckets_ext; /**< Extendable buckets array */
+	uint32_t *ext_bkt_to_free;
+	/**< Extendable bucket to free along with each key slot (LF mode) */
+	uint8_t aging_support;          /**< Last hit time kept per entry */
 
 	/* Fields used in lookup */
 
@@ -213,6 +234,10 @@ struct rte_hash {
 	uint32_t bucket_bitmask;
 	/**< Bitmask for getting bucket index from hash signature. */
 	uint32_t key_entry_size;         /**< Size of each key entry. */
+	uint32_t key_store_entries;
+	/**< Key slots in key_store, other than the dummy one */
+	struct rte_hash_resize *resize;  /**< Growth state, if resizable */
+	uint32_t age_time;               /**< Time recorded on hits */
 
 	void *key_store;                /**< Table storing all keys and data */
 	struct rte_hash_bucket *buckets;
@@ -221,6 +246,58 @@ struct rte_hash {
 	 */
 } __rte_cache_aligned;
 
+/*
+ * Get a key slot. Key slots beyond the key store belong to the segments
+ * added when a resizable table grows, so that key indexes stay stable.
+ */
+static inline struct rte_hash_key *
+get_key_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	const struct rte_hash_resize *rs = h->resize;
+	uint32_t seg;
+
+	if (likely(key_idx <= h->key_store_entries))
+		return (struct rte_hash_key *)((char *)h->key_store +
+				key_idx * h->key_entry_size);
+
+	/* Segment n holds slots key_store_entries << (n - 1) + 1 onwards */
+	seg = 31 - __builtin_clz(key_idx - 1) - rs->key_store_shift + 1;
+	key_idx -= (h->key_store_entries << (seg - 1)) + 1;
+	return (struct rte_hash_key *)((char *)rs->key_segs[seg] +
+			key_idx * h->key_entry_size);
+}
+
+/*
+ * Last hit time of a key slot, with aging support. It is kept in the
+ * padding which follows the key, as a key slot is
+ * sizeof(struct rte_hash_key) + key_len bytes long.
+ */
+static inline uint32_t *
+key_slot_age(const struct rte_hash *h, struct rte_hash_key *k)
+{
+	return (uint32_t *)RTE_PTR_ALIGN_CEIL(k->key + h->key_len,
+			sizeof(uint32_t));
+}
+
+/* Walk a bucket and the extendable buckets chained to it */
+#define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
+	for (CURRENT_BKT = START_BUCKET;                                      \
+		CURRENT_BKT != NULL;                                          \
+		CURRENT_BKT = CURRENT_BKT->next)
+
+/*
+ * Called by the writer once an entry of @bkt has been copied to its
+ * alternative bucket and before its slot in @bkt is overwritten, so that
+ * a lock-free reader that missed the entry in both buckets retries.
+ */
+static inline void
+bucket_chng_cnt_inc(struct rte_hash_bucket *bkt)
+{
+	rte_smp_wmb();
+	bkt->chng_cnt++;
+	rte_smp_wmb();
+}
+
 struct queue_node {
 	struct rte_hash_bucket *bkt; /* Current bucket on the bfs search */
 
@@ -0,0 +1,77 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_atomic.h>
+#include <rte_memory.h>
+#include <rte_spinlock.h>
+#include <rte_vect.h>
+
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches,
+		const struct rte_hash_bucket **prim_bkt,
+		const struct rte_hash_bucket **sec_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys)
+{
+	__m512i sigs, hashes;
+	__mmask16 matches;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		/*
+		 * Compare the 8 signatures of the primary bucket in the
+		 * lower half and those of the secondary bucket in the
+		 * upper half at once.
+		 */
+		sigs = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm256_load_si256(
+				(__m256i const *)prim_bkt[i]->sig_current)),
+				_mm256_load_si256(
+				(__m256i const *)sec_bkt[i]->sig_current), 1);
+		hashes = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm256_set1_epi32(prim_hash[i])),
+				_mm256_set1_epi32(sec_hash[i]), 1);
+		matches = _mm512_cmpeq_epi32_mask(sigs, hashes);
+
+		prim_hash_matches[i] = matches & 0xff;
+		sec_hash_matches[i] = matches >> 8;
+	}
+}
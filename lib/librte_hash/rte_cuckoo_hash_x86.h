@@ -119,6 +119,7 @@ rte_hash_cuckoo_move_insert_mw_tm(const struct rte_hash *h,
 				    prev_bkt->sig_alt[prev_slot];
 				curr_bkt->key_idx[curr_slot]
 				    = prev_bkt->key_idx[prev_slot];
+				bucket_chng_cnt_inc(prev_bkt);
 
 				curr_slot = prev_slot;
 				curr_node = prev_node;
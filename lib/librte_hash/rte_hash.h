@@ -63,9 +63,57 @@ extern "C" {
 /** Default behavior of insertion, single writer/multi writer */
 #define RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD 0x02
 
+/**
+ * Lock-free reader/writer concurrency. Lookups may run on any number of
+ * threads while a single writer adds and deletes keys, without taking any
+ * lock. Key slots of deleted entries are not recycled until
+ * rte_hash_free_key_with_position() is called for them. It cannot be
+ * combined with RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x04
+
+/**
+ * Extendable buckets. When a key cannot be placed in its primary or
+ * secondary bucket, it is stored in an overflow bucket chained to its
+ * secondary bucket, so that adding keys only fails once all the entries
+ * of the table are in use.
+ */
+#define RTE_HASH_EXTRA_FLAGS_EXT_TABLE 0x08
+
+/**
+ * Resizable table. The entries parameter is the initial capacity, and the
+ * table doubles when it gets close to full. The entries are then migrated
+ * to the larger table a few buckets at a time by the following additions
+ * and deletions, and the key positions do not change. Only available with
+ * a single writer, and without lock-free readers or extendable buckets.
+ * As for other tables without lock-free readers, lookups must not run
+ * concurrently with an addition or a deletion (e.g. they are serialized
+ * with a reader/writer lock). They may run between them while a growth is
+ * in progress, and then find the keys migrated or not. As each addition or
+ * deletion only migrates a bounded number of buckets, a growth never holds
+ * the readers for long.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x10
+
+/**
+ * Aging support. Each entry records the time set with
+ * rte_hash_set_age_time() when it is added or found by a lookup, and
+ * rte_hash_age_sweep() returns the entries not hit for a given time.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x20
+
 /** Signature of key that is stored internally. */
 typedef uint32_t hash_sig_t;
 
+/** Methods to compare the key signatures of a bucket in bulk lookups. */
+enum rte_hash_sig_compare_function {
+	RTE_HASH_COMPARE_SCALAR = 0,
+	RTE_HASH_COMPARE_SSE,
+	RTE_HASH_COMPARE_AVX2,
+	RTE_HASH_COMPARE_AVX512,
+	RTE_HASH_COMPARE_NUM
+};
+
 /** Type of function that can be used for calculating the hash value. */
 typedef uint32_t (*rte_hash_function)(const void *key, uint32_t key_len,
 				      uint32_t init_val);
@@ -123,6 +171,22 @@ rte_hash_create(const struct rte_hash_parameters *params);
  */
 void rte_hash_set_cmp_func(struct rte_hash *h, rte_hash_cmp_eq_t func);
 
+/**
+ * Change the method used to compare the key signatures in bulk lookups.
+ * By default, the best method supported by the CPU is used.
+ *
+ * @param h
+ *   Hash table for which the method is to be changed
+ * @param sig_cmp_fn
+ *   New signature compare method
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOTSUP if the method is not supported by the build or the CPU
+ */
+int rte_hash_set_sig_cmp_fn(struct rte_hash *h,
+		enum rte_hash_sig_compare_function sig_cmp_fn);
+
 /**
  * Find an existing hash table object and return a pointer to it.
  *
@@ -167,6 +231,9 @@ rte_hash_reset(struct rte_hash *h);
  *   - 0 if added successfully
  *   - -EINVAL if the parameters are invalid.
  *   - -ENOSPC if there is no space in the hash for this key.
+ *   - -EAGAIN if a resizable table must grow again before its previous
+ *     growth is migrated. Each call migrates a part of it, so the key can
+ *     be added again later.
  */
 int
 rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data);
@@ -189,6 +256,9 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data);
  *   - 0 if added successfully
  *   - -EINVAL if the parameters are invalid.
  *   - -ENOSPC if there is no space in the hash for this key.
+ *   - -EAGAIN if a resizable table must grow again before its previous
+ *     growth is migrated. Each call migrates a part of it, so the key can
+ *     be added again later.
  */
 int32_t
 rte_hash_add_key_with_hash_data(const struct rte_hash *h, const void *key,
@@ -205,6 +275,9 @@ rte_hash_add_key_with_hash_data(const struct rte_hash *h, const void *key,
  * @return
  *   - -EINVAL if the parameters are invalid.
  *   - -ENOSPC if there is no space in the hash for this key.
+ *   - -EAGAIN if a resizable table must grow again before its previous
+ *     growth is migrated. Each call migrates a part of it, so the key can
+ *     be added again later.
  *   - A positive value that can be used by the caller as an offset into an
  *     array of user data. This value is unique for this key.
  */
@@ -225,6 +298,9 @@ rte_hash_add_key(const struct rte_hash *h, const void *key);
  * @return
  *   - -EINVAL if the parameters are invalid.
  *   - -ENOSPC if there is no space in the hash for this key.
+ *   - -EAGAIN if a resizable table must grow again before its previous
+ *     growth is migrated. Each call migrates a part of it, so the key can
+ *     be added again later.
  *   - A positive value that can be used by the caller as an offset into an
  *     array of user data. This value is unique for this key.
  */
@@ -271,6 +347,102 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * Add multiple keys to an existing hash table. As for the bulk lookups, the
+ * whole burst is processed in stages: all the keys are hashed, their two
+ * buckets prefetched, then the key slots whose signature matches, before
+ * inserting the keys one after the other.
+ * If a key is already in the table, its position is returned.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread,
+ * unless the table was created with multi-writer support.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the value rte_hash_add_key() would
+ *   have returned: its position, or a negative error code.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added or found.
+ */
+int
+rte_hash_add_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
+/**
+ * Add multiple key-value pairs to an existing hash table, as
+ * rte_hash_add_key_bulk() does. The data of a key already in the table
+ * is updated.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread,
+ * unless the table was created with multi-writer support.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A pointer to a list of data to add, one per key.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, its position or a negative error
+ *   code.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added or updated.
+ */
+int
+rte_hash_add_key_data_bulk(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions);
+
+/**
+ * Remove multiple keys from an existing hash table, processing the burst
+ * in stages as rte_hash_add_key_bulk() does before removing the keys one
+ * after the other.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread.
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the value rte_hash_del_key() would
+ *   have returned: its former position, or -ENOENT if it was not found.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys removed.
+ */
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
+/**
+ * Free the key slot of an entry previously deleted from a hash table
+ * created with RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, so it can be used
+ * by further additions. The caller must make sure that no reader still
+ * references the deleted entry (e.g. all readers went through a quiescent
+ * state after the deletion).
+ * This operation is not multi-thread safe and should only be called from
+ * the writer thread.
+ *
+ * @param h
+ *   Hash table the key was deleted from.
+ * @param position
+ *   Position returned when the key was deleted.
+ * @return
+ *   - 0 if freed successfully
+ *   - -EINVAL if the parameters are invalid.
+ */
+int
+rte_hash_free_key_with_position(const struct rte_hash *h,
+				const int32_t position);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe.
@@ -427,6 +599,56 @@ int
 rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		      uint32_t num_keys, int32_t *positions);
 
+/**
+ * Set the current time of a hash table created with aging support,
+ * recorded in the entries added or looked up from then on. The time unit
+ * is up to the application, e.g. seconds or a counter incremented on each
+ * aging round. The time is expected to wrap around.
+ *
+ * @param h
+ *   Hash table to set the time of.
+ * @param now
+ *   Current time.
+ */
+void
+rte_hash_set_age_time(struct rte_hash *h, uint32_t now);
+
+/**
+ * Sweep part of a hash table created with aging support, returning the
+ * keys not added or found by a lookup for more than a given time. The
+ * sweep resumes where the previous call stopped, so that a large table
+ * can be aged in small slices. It does not remove the expired keys.
+ * Keys moved by additions between two calls may be missed until the
+ * next pass, or returned twice.
+ * This operation is not multi-thread safe
+ * and should only be called from the thread writing to the table.
+ *
+ * @param h
+ *   Hash table to sweep.
+ * @param next
+ *   Pointer to the sweep iterator. Should be 0 to start sweeping the hash
+ *   table, and is set back to 0 when the end of the table is reached.
+ * @param nb_buckets
+ *   Maximum number of buckets to sweep.
+ * @param max_age
+ *   Keys whose last hit is more than max_age before the current time
+ *   are expired.
+ * @param keys
+ *   Output containing the expired keys, may be NULL.
+ * @param positions
+ *   Output containing the positions of the expired keys.
+ * @param max_keys
+ *   Size of the keys and positions arrays. The sweep stops early when
+ *   they are full.
+ * @return
+ *   Number of expired keys returned, or -EINVAL if the parameters are
+ *   invalid or the table has no aging support.
+ */
+int
+rte_hash_age_sweep(const struct rte_hash *h, uint32_t *next,
+		uint32_t nb_buckets, uint32_t max_age, const void **keys,
+		int32_t *positions, uint32_t max_keys);
+
 /**
  * Iterate through the hash table, returning key-value pairs.
  *
@@ -52,8 +52,11 @@
 #include <rte_errno.h>
 #include <rte_rwlock.h>
 #include <rte_spinlock.h>
+#include <rte_atomic.h>
+#include <rte_cpuflags.h>
 
 #include "rte_lpm.h"
+#include "rte_lpm_vec.h"
 
 TAILQ_HEAD(rte_lpm_list, rte_tailq_entry);
 
@@ -69,6 +72,27 @@ enum valid_flag {
 	VALID
 };
 
+/** Quiescent state counter of a reader, 0 while it is offline. */
+struct rte_lpm_reader {
+	volatile uint64_t cnt;
+} __rte_cache_aligned;
+
+/** tbl8 group waiting for the readers to pass a quiescent point. */
+struct rte_lpm_defer_entry {
+	uint32_t tbl8_group_start; /**< First entry of the group. */
+	uint64_t token;            /**< Token the readers have to reach. */
+};
+
+/** Deferred tbl8 reclamation state. */
+struct rte_lpm_defer {
+	volatile uint64_t token;   /**< Incremented on each deferred free. */
+	uint32_t head;             /**< Oldest group in the queue. */
+	uint32_t count;            /**< Number of groups in the queue. */
+	uint32_t size;             /**< Queue size (number of tbl8 groups). */
+	struct rte_lpm_reader readers[RTE_LPM_MAX_READERS];
+	struct rte_lpm_defer_entry queue[]; /**< Groups in free order. */
+};
+
 /* Macro to enable/disable run-time checks. */
 #if defined(RTE_LIBRTE_LPM_DEBUG)
 #include <rte_debug.h>
@@ -328,6 +352,29 @@ rte_lpm_create_v1604(const char *name, int socket_id,
 		goto exit;
 	}
 
+	if (config->flags & RTE_LPM_DEFER_TBL8_FREE) {
+		lpm->defer = (struct rte_lpm_defer *)rte_zmalloc_socket(NULL,
+				sizeof(struct rte_lpm_defer) +
+				sizeof(struct rte_lpm_defer_entry) *
+				config->number_tbl8s,
+				RTE_CACHE_LINE_SIZE, socket_id);
+
+		if (lpm->defer == NULL) {
+			RTE_LOG(ERR, LPM,
+				"LPM defer queue memory allocation failed\n");
+			rte_free(lpm->tbl8);
+			rte_free(lpm->rules_tbl);
+			rte_free(lpm);
+			lpm = NULL;
+			rte_free(te);
+			goto exit;
+		}
+
+		/* Tokens start at 1, so that 0 marks an offline reader. */
+		lpm->defer->token = 1;
+		lpm->defer->size = config->number_tbl8s;
+	}
+
 	/* Save user arguments. */
 	lpm->max_rules = config->max_rules;
 	lpm->number_tbl8s = config->number_tbl8s;
@@ -403,6 +450,7 @@ rte_lpm_free_v1604(struct rte_lpm *lpm)
 
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 
+	rte_free(lpm->defer);
 	rte_free(lpm->tbl8);
 	rte_free(lpm->rules_tbl);
 	rte_free(lpm);
@@ -692,11 +740,50 @@ tbl8_alloc_v20(struct rte_lpm_tbl_entry_v20 *tbl8)
 	return -ENOSPC;
 }
 
+/*
+ * Releases the deferred tbl8 groups that no registered reader can still
+ * be walking, i.e. those freed before every online reader last reported
+ * a quiescent state.
+ */
+static void
+tbl8_reclaim(struct rte_lpm *lpm)
+{
+	struct rte_lpm_defer *defer = lpm->defer;
+	struct rte_lpm_defer_entry *entry;
+	uint64_t min_cnt = UINT64_MAX, cnt;
+	unsigned int i;
+
+	if (defer->count == 0)
+		return;
+
+	for (i = 0; i < RTE_LPM_MAX_READERS; i++) {
+		cnt = defer->readers[i].cnt;
+		if (cnt != 0 && cnt < min_cnt)
+			min_cnt = cnt;
+	}
+
+	while (defer->count > 0) {
+		entry = &defer->queue[defer->head];
+		if (entry->token > min_cnt)
+			break;
+
+		lpm->tbl8[entry->tbl8_group_start].valid_group = INVALID;
+
+		defer->head = (defer->head + 1) % defer->size;
+		defer->count--;
+	}
+}
+
 static inline int32_t
-tbl8_alloc_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t number_tbl8s)
+tbl8_alloc_v1604(struct rte_lpm *lpm)
 {
 	uint32_t group_idx; /* tbl8 group index. */
 	struct rte_lpm_tbl_entry *tbl8_entry;
+	struct rte_lpm_tbl_entry *tbl8 = lpm->tbl8;
+	uint32_t number_tbl8s = lpm->number_tbl8s;
+
+	if (lpm->defer != NULL)
+		tbl8_reclaim(lpm);
 
 	/* Scan through tbl8 to find a free (i.e. INVALID) tbl8 group. */
 	for (group_idx = 0; group_idx < number_tbl8s; group_idx++) {
@@ -726,10 +813,27 @@ tbl8_free_v20(struct rte_lpm_tbl_entry_v20 *tbl8, uint32_t tbl8_group_start)
 }
 
 static inline void
-tbl8_free_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t tbl8_group_start)
+tbl8_free_v1604(struct rte_lpm *lpm, uint32_t tbl8_group_start)
 {
-	/* Set tbl8 group invalid*/
-	tbl8[tbl8_group_start].valid_group = INVALID;
+	struct rte_lpm_defer *defer = lpm->defer;
+	struct rte_lpm_defer_entry *entry;
+
+	if (defer == NULL) {
+		/* Set tbl8 group invalid*/
+		lpm->tbl8[tbl8_group_start].valid_group = INVALID;
+		return;
+	}
+
+	/*
+	 * Readers may still be walking the group through the tbl24 entry
+	 * that was just updated, so keep it allocated until all of them
+	 * report a quiescent state after this point.
+	 */
+	rte_smp_wmb();
+	entry = &defer->queue[(defer->head + defer->count) % defer->size];
+	entry->tbl8_group_start = tbl8_group_start;
+	entry->token = ++defer->token;
+	defer->count++;
 }
 
 static inline int32_t
@@ -1008,7 +1112,7 @@ add_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked, uint8_t depth,
 
 	if (!lpm->tbl24[tbl24_index].valid) {
 		/* Search for a free tbl8 group. */
-		tbl8_group_index = tbl8_alloc_v1604(lpm->tbl8, lpm->number_tbl8s);
+		tbl8_group_index = tbl8_alloc_v1604(lpm);
 
 		/* Check tbl8 allocation was successful. */
 		if (tbl8_group_index < 0) {
@@ -1045,7 +1149,7 @@ add_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked, uint8_t depth,
 	} /* If valid entry but not extended calculate the index into Table8. */
 	else if (lpm->tbl24[tbl24_index].valid_group == 0) {
 		/* Search for free tbl8 group. */
-		tbl8_group_index = tbl8_alloc_v1604(lpm->tbl8, lpm->number_tbl8s);
+		tbl8_group_index = tbl8_alloc_v1604(lpm);
 
 		if (tbl8_group_index < 0) {
 			return tbl8_group_index;
@@ -1738,7 +1842,7 @@ delete_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked,
 	if (tbl8_recycle_index == -EINVAL) {
 		/* Set tbl24 before freeing tbl8 to avoid race condition. */
 		lpm->tbl24[tbl24_index].valid = 0;
-		tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+		tbl8_free_v1604(lpm, tbl8_group_start);
 	} else if (tbl8_recycle_index > -1) {
 		/* Update tbl24 entry. */
 		struct rte_lpm_tbl_entry new_tbl24_entry = {
@@ -1750,7 +1854,7 @@ delete_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked,
 
 		/* Set tbl24 before freeing tbl8 to avoid race condition. */
 		lpm->tbl24[tbl24_index] = new_tbl24_entry;
-		tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+		tbl8_free_v1604(lpm, tbl8_group_start);
 	}
 #undef group_idx
 	return 0;
@@ -1904,7 +2008,159 @@ rte_lpm_delete_all_v1604(struct rte_lpm *lpm)
 
 	/* Delete all rules form the rules table. */
 	memset(lpm->rules_tbl, 0, sizeof(lpm->rules_tbl[0]) * lpm->max_rules);
+
+	/* Drop the deferred tbl8 groups, they were all zeroed above. */
+	if (lpm->defer != NULL) {
+		lpm->defer->head = 0;
+		lpm->defer->count = 0;
+	}
 }
 BIND_DEFAULT_SYMBOL(rte_lpm_delete_all, _v1604, 16.04);
 MAP_STATIC_SYMBOL(void rte_lpm_delete_all(struct rte_lpm *lpm),
 		rte_lpm_delete_all_v1604);
+
+/*
+ * Registers a reader for deferred tbl8 reclamation.
+ */
+int
+rte_lpm_reader_register(struct rte_lpm *lpm, unsigned int reader_id)
+{
+	if (lpm == NULL || lpm->defer == NULL ||
+			reader_id >= RTE_LPM_MAX_READERS)
+		return -EINVAL;
+
+	/* The reader holds no reference yet, so it starts quiescent. */
+	lpm->defer->readers[reader_id].cnt = lpm->defer->token;
+	rte_smp_mb();
+
+	return 0;
+}
+
+/*
+ * Unregisters a reader, it no longer holds back tbl8 reclamation.
+ */
+int
+rte_lpm_reader_unregister(struct rte_lpm *lpm, unsigned int reader_id)
+{
+	if (lpm == NULL || lpm->defer == NULL ||
+			reader_id >= RTE_LPM_MAX_READERS)
+		return -EINVAL;
+
+	rte_smp_mb();
+	lpm->defer->readers[reader_id].cnt = 0;
+
+	return 0;
+}
+
+/*
+ * Reports a quiescent state for a reader.
+ */
+void
+rte_lpm_quiescent(struct rte_lpm *lpm, unsigned int reader_id)
+{
+	uint64_t token;
+
+	if (lpm->defer == NULL)
+		return;
+
+	/* Lookups issued so far must be complete before reporting. */
+	rte_smp_mb();
+	token = lpm->defer->token;
+	/* Later lookups must see the tables as of this token. */
+	rte_smp_rmb();
+	lpm->defer->readers[reader_id].cnt = token;
+}
+
+/*
+ * Scalar lookups, used when the CPU has no suitable vector instructions.
+ */
+static void
+lookupx8_scalar(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv)
+{
+	uint32_t res[8];
+	unsigned int i;
+
+	rte_lpm_lookup_bulk_func(lpm, ips, res, RTE_DIM(res));
+	for (i = 0; i != RTE_DIM(res); i++)
+		hop[i] = (res[i] & RTE_LPM_LOOKUP_SUCCESS) ?
+			res[i] & 0x00FFFFFF : defv;
+}
+
+static void
+lookupx16_scalar(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv)
+{
+	lookupx8_scalar(lpm, ips, hop, defv);
+	lookupx8_scalar(lpm, ips + 8, hop + 8, defv);
+}
+
+static void
+lookup_bulk_scalar(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n)
+{
+	rte_lpm_lookup_bulk_func(lpm, ips, next_hops, n);
+}
+
+static rte_lpm_lookupx8_t lookupx8_vec = lookupx8_scalar;
+static rte_lpm_lookupx16_t lookupx16_vec = lookupx16_scalar;
+static rte_lpm_lookup_bulk_t lookup_bulk_vec = lookup_bulk_scalar;
+
+/*
+ * Selects the widest vector lookups supported by both the compiler and
+ * the CPU.
+ */
+RTE_INIT(rte_lpm_init_lookup_fns);
+static void
+rte_lpm_init_lookup_fns(void)
+{
+#if defined(RTE_ARCH_X86) && defined(CC_AVX2_SUPPORT)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2)) {
+		lookupx8_vec = rte_lpm_lookupx8_avx2;
+		lookupx16_vec = rte_lpm_lookupx16_avx2;
+		lookup_bulk_vec = rte_lpm_lookup_bulk_avx2;
+	}
+#endif
+#if defined(RTE_ARCH_X86) && defined(CC_AVX512_SUPPORT)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F)) {
+		lookupx16_vec = rte_lpm_lookupx16_avx512;
+		lookup_bulk_vec = rte_lpm_lookup_bulk_avx512;
+	}
+#endif
+}
+
+void
+rte_lpm_lookupx8(const struct rte_lpm *lpm, const uint32_t ips[8],
+		uint32_t hop[8], uint32_t defv)
+{
+	if (unlikely(lpm->number_tbl8s > RTE_LPM_VEC_MAX_TBL8_NUM_GROUPS))
+		lookupx8_scalar(lpm, ips, hop, defv);
+	else
+		lookupx8_vec(lpm, ips, hop, defv);
+}
+
+void
+rte_lpm_lookupx16(const struct rte_lpm *lpm, const uint32_t ips[16],
+		uint32_t hop[16], uint32_t defv)
+{
+	if (unlikely(lpm->number_tbl8s > RTE_LPM_VEC_MAX_TBL8_NUM_GROUPS))
+		lookupx16_scalar(lpm, ips, hop, defv);
+	else
+		lookupx16_vec(lpm, ips, hop, defv);
+}
+
+int
+rte_lpm_lookup_bulk_vec(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n)
+{
+	/* Check input parameters */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (ips == NULL) ||
+			(next_hops == NULL)), -EINVAL);
+
+	if (unlikely(lpm->number_tbl8s > RTE_LPM_VEC_MAX_TBL8_NUM_GROUPS))
+		lookup_bulk_scalar(lpm, ips, next_hops, n);
+	else
+		lookup_bulk_vec(lpm, ips, next_hops, n);
+
+	return 0;
+}
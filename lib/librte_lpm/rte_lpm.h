@@ -76,6 +76,15 @@ extern "C" {
 #define RTE_LPM_TBL8_NUM_ENTRIES        (RTE_LPM_TBL8_NUM_GROUPS * \
 					RTE_LPM_TBL8_GROUP_NUM_ENTRIES)
 
+/**
+ * Flag for rte_lpm_config: tbl8 groups released by rte_lpm_delete() are
+ * only reused once every registered reader has passed a quiescent point.
+ */
+#define RTE_LPM_DEFER_TBL8_FREE         0x1
+
+/** Max number of readers tracked by deferred tbl8 reclamation. */
+#define RTE_LPM_MAX_READERS             RTE_MAX_LCORE
+
 /** @internal Macro to enable/disable run-time checks. */
 #if defined(RTE_LIBRTE_LPM_DEBUG)
 #define RTE_LPM_RETURN_IF_TRUE(cond, retval) do { \
@@ -166,7 +175,7 @@ struct rte_lpm_tbl_entry {
 struct rte_lpm_config {
 	uint32_t max_rules;      /**< Max number of rules. */
 	uint32_t number_tbl8s;   /**< Number of tbl8s to allocate. */
-	int flags;               /**< This field is currently unused. */
+	int flags;               /**< RTE_LPM_DEFER_TBL8_FREE or 0. */
 };
 
 /** @internal Rule structure. */
@@ -202,6 +211,9 @@ struct rte_lpm_v20 {
 			__rte_cache_aligned; /**< LPM rules. */
 };
 
+/** @internal Deferred tbl8 reclamation state. */
+struct rte_lpm_defer;
+
 struct rte_lpm {
 	/* LPM metadata. */
 	char name[RTE_LPM_NAMESIZE];        /**< Name of the lpm. */
@@ -214,6 +226,7 @@ struct rte_lpm {
 			__rte_cache_aligned; /**< LPM tbl24 table. */
 	struct rte_lpm_tbl_entry *tbl8; /**< LPM tbl8 table. */
 	struct rte_lpm_rule *rules_tbl; /**< LPM rules. */
+	struct rte_lpm_defer *defer; /**< Deferred tbl8 reclamation. */
 };
 
 /**
@@ -356,6 +369,50 @@ rte_lpm_delete_all_v20(struct rte_lpm_v20 *lpm);
 void
 rte_lpm_delete_all_v1604(struct rte_lpm *lpm);
 
+/**
+ * Register a reader of an LPM object created with RTE_LPM_DEFER_TBL8_FREE.
+ * Until it is unregistered, tbl8 groups freed by rte_lpm_delete() are not
+ * reused before the reader calls rte_lpm_quiescent().
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader index, lower than RTE_LPM_MAX_READERS (e.g. the lcore id)
+ * @return
+ *   0 on success, -EINVAL if the LPM object does not defer tbl8 frees
+ *   or the reader index is out of range
+ */
+int
+rte_lpm_reader_register(struct rte_lpm *lpm, unsigned int reader_id);
+
+/**
+ * Unregister a reader, which must not call any lookup function on the
+ * LPM object afterwards.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader index passed to rte_lpm_reader_register()
+ * @return
+ *   0 on success, -EINVAL on invalid parameters
+ */
+int
+rte_lpm_reader_unregister(struct rte_lpm *lpm, unsigned int reader_id);
+
+/**
+ * Report that a registered reader holds no reference to the LPM tables,
+ * i.e. that all its earlier lookups have completed. It is typically called
+ * once per burst by each forwarding lcore. It does nothing for an LPM object
+ * created without RTE_LPM_DEFER_TBL8_FREE.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader index passed to rte_lpm_reader_register()
+ */
+void
+rte_lpm_quiescent(struct rte_lpm *lpm, unsigned int reader_id);
+
 /**
  * Lookup an IP into the LPM table.
  *
@@ -419,7 +476,7 @@ rte_lpm_lookup(struct rte_lpm *lpm, uint32_t ip, uint32_t *next_hop)
  *   -EINVAL for incorrect arguments, otherwise 0
  */
 #define rte_lpm_lookup_bulk(lpm, ips, next_hops, n) \
-		rte_lpm_lookup_bulk_func(lpm, ips, next_hops, n)
+		rte_lpm_lookup_bulk_vec(lpm, ips, next_hops, n)
 
 static inline int
 rte_lpm_lookup_bulk_func(const struct rte_lpm *lpm, const uint32_t *ips,
@@ -457,6 +514,66 @@ rte_lpm_lookup_bulk_func(const struct rte_lpm *lpm, const uint32_t *ips,
 	return 0;
 }
 
+/**
+ * Lookup multiple IP addresses in an LPM table, with the widest vector
+ * instructions supported by the CPU (AVX-512 or AVX2 gathers on x86),
+ * selected at runtime. Results are the same as rte_lpm_lookup_bulk_func().
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ips
+ *   Array of IPs to be looked up in the LPM table
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP (valid on lookup hit
+ *   only), RTE_LPM_LOOKUP_SUCCESS being set on lookup hit.
+ * @param n
+ *   Number of elements in ips (and next_hops) array to lookup, best a
+ *   multiple of 16.
+ * @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+int
+rte_lpm_lookup_bulk_vec(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n);
+
+/**
+ * Lookup eight IP addresses in an LPM table, with AVX2 gathers when the
+ * CPU supports them.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ips
+ *   Eight IPs to be looked up in the LPM table
+ * @param hop
+ *   Next hop of the most specific rule found for each IP, or defv if the
+ *   lookup failed.
+ * @param defv
+ *   Default value to populate into corresponding element of hop[] array,
+ *   if lookup would fail.
+ */
+void
+rte_lpm_lookupx8(const struct rte_lpm *lpm, const uint32_t ips[8],
+		uint32_t hop[8], uint32_t defv);
+
+/**
+ * Lookup sixteen IP addresses in an LPM table, with AVX-512 gathers when
+ * the CPU supports them, two AVX2 lookups of eight otherwise.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ips
+ *   Sixteen IPs to be looked up in the LPM table
+ * @param hop
+ *   Next hop of the most specific rule found for each IP, or defv if the
+ *   lookup failed.
+ * @param defv
+ *   Default value to populate into corresponding element of hop[] array,
+ *   if lookup would fail.
+ */
+void
+rte_lpm_lookupx16(const struct rte_lpm *lpm, const uint32_t ips[16],
+		uint32_t hop[16], uint32_t defv);
+
 /* Mask four results. */
 #define	 RTE_LPM_MASKX4_RES	UINT64_C(0x00ffffff00ffffff)
 
@@ -68,6 +68,9 @@
 #define BYTE_SIZE                                 8
 #define BYTES2_SIZE                              16
 
+#define RULE_HASH_MULTIPLIER             0x9E3779B1
+#define RULE_INDEX_NONE                  UINT32_MAX
+
 #define lpm6_tbl8_gindex next_hop
 
 /** Flags for setting an entry as valid/invalid. */
@@ -99,6 +102,7 @@ struct rte_lpm6_rule {
 	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE]; /**< Rule IP address. */
 	uint32_t next_hop; /**< Rule next hop. */
 	uint8_t depth; /**< Rule depth. */
+	uint32_t next; /**< Next rule in the same hash bucket. */
 };
 
 /** LPM6 structure. */
@@ -109,9 +113,13 @@ struct rte_lpm6 {
 	uint32_t used_rules;             /**< Used rules so far. */
 	uint32_t number_tbl8s;           /**< Number of tbl8s to allocate. */
 	uint32_t next_tbl8;              /**< Next tbl8 to be used. */
+	uint32_t nb_free_tbl8s;          /**< Number of recycled tbl8s. */
+	uint32_t rules_hash_mask;        /**< Rules hash bucket mask. */
 
 	/* LPM Tables. */
 	struct rte_lpm6_rule *rules_tbl; /**< LPM rules. */
+	uint32_t *rules_hash;            /**< First rule of each bucket. */
+	uint32_t *free_tbl8s;            /**< Stack of recycled tbl8s. */
 	struct rte_lpm6_tbl_entry tbl24[RTE_LPM6_TBL24_NUM_ENTRIES]
 			__rte_cache_aligned; /**< LPM tbl24 table. */
 	struct rte_lpm6_tbl_entry tbl8[0]
@@ -142,6 +150,24 @@ mask_ip(uint8_t *ip, uint8_t depth)
 		}
 }
 
+/*
+ * Hashes a masked rule prefix and its depth into the rules hash.
+ */
+static inline uint32_t
+rule_hash(const uint8_t *ip, uint8_t depth)
+{
+	const unaligned_uint32_t *words = (const unaligned_uint32_t *)ip;
+	uint32_t hash = depth;
+	unsigned int i;
+
+	for (i = 0; i < RTE_LPM6_IPV6_ADDR_SIZE / sizeof(uint32_t); i++) {
+		hash = (hash ^ words[i]) * RULE_HASH_MULTIPLIER;
+		hash ^= hash >> 15;
+	}
+
+	return hash;
+}
+
 /*
  * Allocates memory for LPM object
  */
@@ -152,7 +178,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	char mem_name[RTE_LPM6_NAMESIZE];
 	struct rte_lpm6 *lpm = NULL;
 	struct rte_tailq_entry *te;
-	uint64_t mem_size, rules_size;
+	uint64_t mem_size, rules_size, hash_size, free_tbl8s_size;
 	struct rte_lpm6_list *lpm_list;
 
 	lpm_list = RTE_TAILQ_CAST(rte_lpm6_tailq.head, rte_lpm6_list);
@@ -173,6 +199,8 @@ rte_lpm6_create(const char *name, int socket_id,
 	mem_size = sizeof(*lpm) + (sizeof(lpm->tbl8[0]) *
 			RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * config->number_tbl8s);
 	rules_size = sizeof(struct rte_lpm6_rule) * config->max_rules;
+	hash_size = sizeof(uint32_t) * rte_align32pow2(config->max_rules);
+	free_tbl8s_size = sizeof(uint32_t) * RTE_MAX(config->number_tbl8s, 1U);
 
 	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
 
@@ -216,6 +244,26 @@ rte_lpm6_create(const char *name, int socket_id,
 		goto exit;
 	}
 
+	lpm->rules_hash = (uint32_t *)rte_malloc_socket(NULL,
+			(size_t)hash_size, RTE_CACHE_LINE_SIZE, socket_id);
+	lpm->free_tbl8s = (uint32_t *)rte_malloc_socket(NULL,
+			(size_t)free_tbl8s_size, RTE_CACHE_LINE_SIZE, socket_id);
+
+	if (lpm->rules_hash == NULL || lpm->free_tbl8s == NULL) {
+		RTE_LOG(ERR, LPM, "LPM rules hash allocation failed\n");
+		rte_free(lpm->free_tbl8s);
+		rte_free(lpm->rules_hash);
+		rte_free(lpm->rules_tbl);
+		rte_free(lpm);
+		lpm = NULL;
+		rte_free(te);
+		goto exit;
+	}
+
+	/* All buckets of the rules hash start empty. */
+	memset(lpm->rules_hash, 0xff, (size_t)hash_size);
+	lpm->rules_hash_mask = rte_align32pow2(config->max_rules) - 1;
+
 	/* Save user arguments. */
 	lpm->max_rules = config->max_rules;
 	lpm->number_tbl8s = config->number_tbl8s;
@@ -287,11 +335,70 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 
+	rte_free(lpm->free_tbl8s);
+	rte_free(lpm->rules_hash);
 	rte_free(lpm->rules_tbl);
 	rte_free(lpm);
 	rte_free(te);
 }
 
+/*
+ * Finds a rule in rule table.
+ * NOTE: Valid range for depth parameter is 1 .. 128 inclusive.
+ */
+static inline int32_t
+rule_find(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
+{
+	uint32_t rule_index;
+
+	/* Walk the bucket chain of the rule's hash. */
+	rule_index = lpm->rules_hash[rule_hash(ip, depth) &
+			lpm->rules_hash_mask];
+	while (rule_index != RULE_INDEX_NONE) {
+		/* If rule is found return the rule index. */
+		if ((memcmp(lpm->rules_tbl[rule_index].ip, ip,
+				RTE_LPM6_IPV6_ADDR_SIZE) == 0) &&
+				lpm->rules_tbl[rule_index].depth == depth)
+			return rule_index;
+
+		rule_index = lpm->rules_tbl[rule_index].next;
+	}
+
+	/* If rule is not found return -ENOENT. */
+	return -ENOENT;
+}
+
+/*
+ * Links a rule at the head of its bucket in the rules hash.
+ */
+static inline void
+rule_hash_link(struct rte_lpm6 *lpm, uint32_t rule_index)
+{
+	struct rte_lpm6_rule *rule = &lpm->rules_tbl[rule_index];
+	uint32_t *head;
+
+	head = &lpm->rules_hash[rule_hash(rule->ip, rule->depth) &
+			lpm->rules_hash_mask];
+	rule->next = *head;
+	*head = rule_index;
+}
+
+/*
+ * Removes a rule from the bucket chain it is linked in.
+ */
+static inline void
+rule_hash_unlink(struct rte_lpm6 *lpm, uint32_t rule_index)
+{
+	struct rte_lpm6_rule *rule = &lpm->rules_tbl[rule_index];
+	uint32_t *prev;
+
+	prev = &lpm->rules_hash[rule_hash(rule->ip, rule->depth) &
+			lpm->rules_hash_mask];
+	while (*prev != rule_index)
+		prev = &lpm->rules_tbl[*prev].next;
+	*prev = rule->next;
+}
+
 /*
  * Checks if a rule already exists in the rules table and updates
  * the nexthop if so. Otherwise it adds a new rule if enough space is available.
@@ -299,19 +406,14 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 static inline int32_t
 rule_add(struct rte_lpm6 *lpm, uint8_t *ip, uint32_t next_hop, uint8_t depth)
 {
-	uint32_t rule_index;
-
-	/* Scan through rule list to see if rule already exists. */
-	for (rule_index = 0; rule_index < lpm->used_rules; rule_index++) {
+	int32_t rule_index;
 
-		/* If rule already exists update its next_hop and return. */
-		if ((memcmp (lpm->rules_tbl[rule_index].ip, ip,
-				RTE_LPM6_IPV6_ADDR_SIZE) == 0) &&
-				lpm->rules_tbl[rule_index].depth == depth) {
-			lpm->rules_tbl[rule_index].next_hop = next_hop;
+	/* If rule already exists update its next_hop and return. */
+	rule_index = rule_find(lpm, ip, depth);
+	if (rule_index >= 0) {
+		lpm->rules_tbl[rule_index].next_hop = next_hop;
 
-			return rule_index;
-		}
+		return rule_index;
 	}
 
 	/*
@@ -323,9 +425,11 @@ rule_add(struct rte_lpm6 *lpm, uint8_t *ip, uint32_t next_hop, uint8_t depth)
 	}
 
 	/* If there is space for the new rule add it. */
+	rule_index = lpm->used_rules;
 	rte_memcpy(lpm->rules_tbl[rule_index].ip, ip, RTE_LPM6_IPV6_ADDR_SIZE);
 	lpm->rules_tbl[rule_index].next_hop = next_hop;
 	lpm->rules_tbl[rule_index].depth = depth;
+	rule_hash_link(lpm, rule_index);
 
 	/* Increment the used rules counter for this rule group. */
 	lpm->used_rules++;
@@ -333,6 +437,97 @@ rule_add(struct rte_lpm6 *lpm, uint8_t *ip, uint32_t next_hop, uint8_t depth)
 	return rule_index;
 }
 
+/*
+ * Takes a tbl8 group from the recycled ones, or a never used one if none
+ * was recycled. Returns the group index or -ENOSPC.
+ */
+static inline int32_t
+tbl8_alloc(struct rte_lpm6 *lpm)
+{
+	uint32_t tbl8_gindex;
+
+	if (lpm->nb_free_tbl8s > 0) {
+		tbl8_gindex = lpm->free_tbl8s[--lpm->nb_free_tbl8s];
+
+		/* Recycled groups keep their old entries until reused. */
+		memset(&lpm->tbl8[tbl8_gindex * RTE_LPM6_TBL8_GROUP_NUM_ENTRIES],
+				0, sizeof(lpm->tbl8[0]) *
+				RTE_LPM6_TBL8_GROUP_NUM_ENTRIES);
+
+		return tbl8_gindex;
+	}
+
+	if (lpm->next_tbl8 < lpm->number_tbl8s)
+		return (lpm->next_tbl8)++;
+
+	return -ENOSPC;
+}
+
+/*
+ * Folds the tbl8 group an extended entry points to back into the entry,
+ * when every entry of the group holds the same rule and that rule is not
+ * more specific than the level of the extended entry. The group is then
+ * returned to the free stack.
+ */
+static void
+tbl8_recycle(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl_entry,
+		uint8_t bits_covered)
+{
+	struct rte_lpm6_tbl_entry *tbl8, first;
+	uint32_t tbl8_gindex, i;
+
+	tbl8_gindex = tbl_entry->lpm6_tbl8_gindex;
+	tbl8 = &lpm->tbl8[tbl8_gindex * RTE_LPM6_TBL8_GROUP_NUM_ENTRIES];
+	first = tbl8[0];
+
+	if (first.ext_entry == 1 || (first.valid && first.depth > bits_covered))
+		return;
+
+	for (i = 1; i < RTE_LPM6_TBL8_GROUP_NUM_ENTRIES; i++) {
+		if (tbl8[i].ext_entry == 1 || tbl8[i].valid != first.valid)
+			return;
+		if (first.valid && (tbl8[i].depth != first.depth ||
+				tbl8[i].next_hop != first.next_hop))
+			return;
+	}
+
+	struct rte_lpm6_tbl_entry new_tbl_entry = {
+		.next_hop = first.valid ? first.next_hop : 0,
+		.depth = first.valid ? first.depth : 0,
+		.valid = first.valid,
+		.valid_group = first.valid,
+		.ext_entry = 0,
+	};
+
+	/*
+	 * Lookups in flight may still walk the old group, so it is only
+	 * cleared when it gets allocated again.
+	 */
+	*tbl_entry = new_tbl_entry;
+	lpm->free_tbl8s[lpm->nb_free_tbl8s++] = tbl8_gindex;
+}
+
+/*
+ * Calculates the index into a table based on the number and position
+ * of the bytes being inspected in a step.
+ */
+static inline uint32_t
+tbl_index_get(const uint8_t *ip, uint8_t bytes, uint8_t first_byte)
+{
+	uint32_t tbl_index, i;
+	int8_t bitshift;
+
+	tbl_index = 0;
+	for (i = first_byte; i < (uint32_t)(first_byte + bytes); i++) {
+		bitshift = (int8_t)((bytes - i)*BYTE_SIZE);
+
+		if (bitshift < 0) bitshift = 0;
+		tbl_index = tbl_index | ip[i-1] << bitshift;
+	}
+
+	return tbl_index;
+}
+
 /*
  * Function that expands a rule across the data structure when a less-generic
  * one has been added before. It assures that every possible combination of bits
@@ -381,20 +576,13 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 {
 	uint32_t tbl_index, tbl_range, tbl8_group_start, tbl8_group_end, i;
 	int32_t tbl8_gindex;
-	int8_t bitshift;
 	uint8_t bits_covered;
 
 	/*
 	 * Calculate index to the table based on the number and position
 	 * of the bytes being inspected in this step.
 	 */
-	tbl_index = 0;
-	for (i = first_byte; i < (uint32_t)(first_byte + bytes); i++) {
-		bitshift = (int8_t)((bytes - i)*BYTE_SIZE);
-
-		if (bitshift < 0) bitshift = 0;
-		tbl_index = tbl_index | ip[i-1] << bitshift;
-	}
+	tbl_index = tbl_index_get(ip, bytes, first_byte);
 
 	/* Number of bits covered in this step */
 	bits_covered = (uint8_t)((bytes+first_byte-1)*BYTE_SIZE);
@@ -441,10 +629,9 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 	else {
 		/* If it's invalid a new tbl8 is needed */
 		if (!tbl[tbl_index].valid) {
-			if (lpm->next_tbl8 < lpm->number_tbl8s)
-				tbl8_gindex = (lpm->next_tbl8)++;
-			else
-				return -ENOSPC;
+			tbl8_gindex = tbl8_alloc(lpm);
+			if (tbl8_gindex < 0)
+				return tbl8_gindex;
 
 			struct rte_lpm6_tbl_entry new_tbl_entry = {
 				.lpm6_tbl8_gindex = tbl8_gindex,
@@ -462,10 +649,9 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 		 */
 		else if (tbl[tbl_index].ext_entry == 0) {
 			/* Search for free tbl8 group. */
-			if (lpm->next_tbl8 < lpm->number_tbl8s)
-				tbl8_gindex = (lpm->next_tbl8)++;
-			else
-				return -ENOSPC;
+			tbl8_gindex = tbl8_alloc(lpm);
+			if (tbl8_gindex < 0)
+				return tbl8_gindex;
 
 			tbl8_group_start = tbl8_gindex *
 					RTE_LPM6_TBL8_GROUP_NUM_ENTRIES;
@@ -752,30 +938,6 @@ MAP_STATIC_SYMBOL(int rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 				int32_t *next_hops, unsigned int n),
 		rte_lpm6_lookup_bulk_func_v1705);
 
-/*
- * Finds a rule in rule table.
- * NOTE: Valid range for depth parameter is 1 .. 128 inclusive.
- */
-static inline int32_t
-rule_find(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
-{
-	uint32_t rule_index;
-
-	/* Scan used rules at given depth to find rule. */
-	for (rule_index = 0; rule_index < lpm->used_rules; rule_index++) {
-		/* If rule is found return the rule index. */
-		if ((memcmp (lpm->rules_tbl[rule_index].ip, ip,
-				RTE_LPM6_IPV6_ADDR_SIZE) == 0) &&
-				lpm->rules_tbl[rule_index].depth == depth) {
-
-			return rule_index;
-		}
-	}
-
-	/* If rule is not found return -ENOENT. */
-	return -ENOENT;
-}
-
 /*
  * Look for a rule in the high-level rules table
  */
@@ -838,34 +1000,136 @@ MAP_STATIC_SYMBOL(int rte_lpm6_is_rule_present(struct rte_lpm6 *lpm,
 static inline void
 rule_delete(struct rte_lpm6 *lpm, int32_t rule_index)
 {
+	uint32_t last = lpm->used_rules - 1;
+
+	rule_hash_unlink(lpm, rule_index);
+
 	/*
 	 * Overwrite redundant rule with last rule in group and decrement rule
 	 * counter.
 	 */
-	lpm->rules_tbl[rule_index] = lpm->rules_tbl[lpm->used_rules-1];
+	if ((uint32_t)rule_index != last) {
+		rule_hash_unlink(lpm, last);
+		lpm->rules_tbl[rule_index] = lpm->rules_tbl[last];
+		rule_hash_link(lpm, rule_index);
+	}
 	lpm->used_rules--;
 }
 
 /*
- * Deletes a rule
+ * Finds the longest rule that is less specific than the given prefix and
+ * covers it. Returns the rule index or -ENOENT.
  */
-int
-rte_lpm6_delete(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
+static inline int32_t
+rule_find_parent(struct rte_lpm6 *lpm, const uint8_t *ip, uint8_t depth)
 {
-	int32_t rule_to_delete_index;
 	uint8_t ip_masked[RTE_LPM6_IPV6_ADDR_SIZE];
-	unsigned i;
+	int32_t rule_index;
+
+	memcpy(ip_masked, ip, RTE_LPM6_IPV6_ADDR_SIZE);
+
+	while (--depth > 0) {
+		mask_ip(ip_masked, depth);
+		rule_index = rule_find(lpm, ip_masked, depth);
+		if (rule_index >= 0)
+			return rule_index;
+	}
+
+	return -ENOENT;
+}
+
+/*
+ * Replaces every entry of a tbl8 group (and of the groups below it) that
+ * was set by a rule of the given depth. bits_covered is the number of bits
+ * resolved once the group has been inspected.
+ */
+static void
+delete_expand(struct rte_lpm6 *lpm, uint32_t tbl8_gindex, uint8_t bits_covered,
+		uint8_t depth, const struct rte_lpm6_tbl_entry *new_tbl_entry)
+{
+	uint32_t tbl8_group_end, tbl8_gindex_next, j;
+
+	tbl8_group_end = tbl8_gindex + RTE_LPM6_TBL8_GROUP_NUM_ENTRIES;
+
+	for (j = tbl8_gindex; j < tbl8_group_end; j++) {
+		if (lpm->tbl8[j].ext_entry == 0) {
+			if (lpm->tbl8[j].valid && lpm->tbl8[j].depth == depth)
+				lpm->tbl8[j] = *new_tbl_entry;
+		} else {
+			tbl8_gindex_next = lpm->tbl8[j].lpm6_tbl8_gindex
+					* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES;
+			delete_expand(lpm, tbl8_gindex_next,
+					bits_covered + BYTE_SIZE, depth,
+					new_tbl_entry);
+			tbl8_recycle(lpm, &lpm->tbl8[j], bits_covered);
+		}
+	}
+}
+
+/*
+ * Removes a deleted route from the data structure, one level per call,
+ * the same way add_step inserted it. Only the entries covered by the
+ * deleted prefix are visited: those the route had set are handed over to
+ * new_tbl_entry (its parent rule, or an invalid entry), and tbl8 groups
+ * left holding a single rule are folded back into their parent entry.
+ */
+static void
+delete_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
+		const uint8_t *ip, uint8_t bytes, uint8_t first_byte,
+		uint8_t depth, const struct rte_lpm6_tbl_entry *new_tbl_entry)
+{
+	uint32_t tbl_index, tbl_range, tbl8_gindex, i;
+	uint8_t bits_covered;
+
+	tbl_index = tbl_index_get(ip, bytes, first_byte);
+
+	/* Number of bits covered in this step */
+	bits_covered = (uint8_t)((bytes+first_byte-1)*BYTE_SIZE);
+
+	if (depth <= bits_covered) {
+		tbl_range = 1 << (bits_covered - depth);
+
+		for (i = tbl_index; i < (tbl_index + tbl_range); i++) {
+			if (tbl[i].ext_entry == 0) {
+				if (tbl[i].valid && tbl[i].depth == depth)
+					tbl[i] = *new_tbl_entry;
+			} else {
+				tbl8_gindex = tbl[i].lpm6_tbl8_gindex *
+						RTE_LPM6_TBL8_GROUP_NUM_ENTRIES;
+				delete_expand(lpm, tbl8_gindex,
+						bits_covered + BYTE_SIZE, depth,
+						new_tbl_entry);
+				tbl8_recycle(lpm, &tbl[i], bits_covered);
+			}
+		}
+
+		return;
+	}
 
 	/*
-	 * Check input arguments.
+	 * The route only reaches deeper levels through an extended entry. It
+	 * may be missing when an add failed half way through.
 	 */
-	if ((lpm == NULL) || (depth < 1) || (depth > RTE_LPM6_MAX_DEPTH)) {
-		return -EINVAL;
-	}
+	if (tbl[tbl_index].ext_entry == 0)
+		return;
 
-	/* Copy the IP and mask it to avoid modifying user's input data. */
-	memcpy(ip_masked, ip, RTE_LPM6_IPV6_ADDR_SIZE);
-	mask_ip(ip_masked, depth);
+	tbl8_gindex = tbl[tbl_index].lpm6_tbl8_gindex *
+			RTE_LPM6_TBL8_GROUP_NUM_ENTRIES;
+	delete_step(lpm, &lpm->tbl8[tbl8_gindex], ip, 1,
+			(uint8_t)(bits_covered / BYTE_SIZE + 1), depth,
+			new_tbl_entry);
+	tbl8_recycle(lpm, &tbl[tbl_index], bits_covered);
+}
+
+/*
+ * Deletes a rule from the rule table and from the data structure.
+ * ip_masked must already be masked to depth.
+ */
+static int
+delete_rule(struct rte_lpm6 *lpm, uint8_t *ip_masked, uint8_t depth)
+{
+	struct rte_lpm6_tbl_entry new_tbl_entry = { 0 };
+	int32_t rule_to_delete_index, parent_index;
 
 	/*
 	 * Find the index of the input rule, that needs to be deleted, in the
@@ -884,24 +1148,43 @@ rte_lpm6_delete(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
 	rule_delete(lpm, rule_to_delete_index);
 
 	/*
-	 * Set all the table entries to 0 (ie delete every rule
-	 * from the data structure.
+	 * The addresses the rule matched fall back to the longest rule that
+	 * covers it, if any.
 	 */
-	lpm->next_tbl8 = 0;
-	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
-	memset(lpm->tbl8, 0, sizeof(lpm->tbl8[0])
-			* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
+	parent_index = rule_find_parent(lpm, ip_masked, depth);
+	if (parent_index >= 0) {
+		new_tbl_entry.next_hop = lpm->rules_tbl[parent_index].next_hop;
+		new_tbl_entry.depth = lpm->rules_tbl[parent_index].depth;
+		new_tbl_entry.valid = VALID;
+		new_tbl_entry.valid_group = VALID;
+	}
+
+	delete_step(lpm, lpm->tbl24, ip_masked, ADD_FIRST_BYTE, 1, depth,
+			&new_tbl_entry);
+
+	return 0;
+}
+
+/*
+ * Deletes a rule
+ */
+int
+rte_lpm6_delete(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
+{
+	uint8_t ip_masked[RTE_LPM6_IPV6_ADDR_SIZE];
 
 	/*
-	 * Add every rule again (except for the one that was removed from
-	 * the rules table).
+	 * Check input arguments.
 	 */
-	for (i = 0; i < lpm->used_rules; i++) {
-		rte_lpm6_add(lpm, lpm->rules_tbl[i].ip, lpm->rules_tbl[i].depth,
-				lpm->rules_tbl[i].next_hop);
+	if ((lpm == NULL) || (depth < 1) || (depth > RTE_LPM6_MAX_DEPTH)) {
+		return -EINVAL;
 	}
 
-	return 0;
+	/* Copy the IP and mask it to avoid modifying user's input data. */
+	memcpy(ip_masked, ip, RTE_LPM6_IPV6_ADDR_SIZE);
+	mask_ip(ip_masked, depth);
+
+	return delete_rule(lpm, ip_masked, depth);
 }
 
 /*
@@ -911,7 +1194,6 @@ int
 rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], uint8_t *depths, unsigned n)
 {
-	int32_t rule_to_delete_index;
 	uint8_t ip_masked[RTE_LPM6_IPV6_ADDR_SIZE];
 	unsigned i;
 
@@ -923,43 +1205,15 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 	}
 
 	for (i = 0; i < n; i++) {
+		if ((depths[i] < 1) || (depths[i] > RTE_LPM6_MAX_DEPTH))
+			continue;
+
 		/* Copy the IP and mask it to avoid modifying user's input data. */
 		memcpy(ip_masked, ips[i], RTE_LPM6_IPV6_ADDR_SIZE);
 		mask_ip(ip_masked, depths[i]);
 
-		/*
-		 * Find the index of the input rule, that needs to be deleted, in the
-		 * rule table.
-		 */
-		rule_to_delete_index = rule_find(lpm, ip_masked, depths[i]);
-
-		/*
-		 * Check if rule_to_delete_index was found. If no rule was found the
-		 * function rule_find returns -ENOENT.
-		 */
-		if (rule_to_delete_index < 0)
-			continue;
-
-		/* Delete the rule from the rule table. */
-		rule_delete(lpm, rule_to_delete_index);
-	}
-
-	/*
-	 * Set all the table entries to 0 (ie delete every rule
-	 * from the data structure.
-	 */
-	lpm->next_tbl8 = 0;
-	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
-	memset(lpm->tbl8, 0, sizeof(lpm->tbl8[0])
-			* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
-
-	/*
-	 * Add every rule again (except for the ones that were removed from
-	 * the rules table).
-	 */
-	for (i = 0; i < lpm->used_rules; i++) {
-		rte_lpm6_add(lpm, lpm->rules_tbl[i].ip, lpm->rules_tbl[i].depth,
-				lpm->rules_tbl[i].next_hop);
+		/* Rules that are not present are skipped. */
+		delete_rule(lpm, ip_masked, depths[i]);
 	}
 
 	return 0;
@@ -974,8 +1228,9 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 	/* Zero used rules counter. */
 	lpm->used_rules = 0;
 
-	/* Zero next tbl8 index. */
+	/* Zero next tbl8 index and drop the recycled ones. */
 	lpm->next_tbl8 = 0;
+	lpm->nb_free_tbl8s = 0;
 
 	/* Zero tbl24. */
 	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
@@ -986,4 +1241,6 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 
 	/* Delete all rules form the rules table. */
 	memset(lpm->rules_tbl, 0, sizeof(struct rte_lpm6_rule) * lpm->max_rules);
+	memset(lpm->rules_hash, 0xff,
+			sizeof(uint32_t) * (lpm->rules_hash_mask + 1));
 }
@@ -0,0 +1,109 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_lpm.h"
+#include "rte_lpm_vec.h"
+
+/*
+ * Raw entries of eight addresses: the tbl24 entries are gathered, then
+ * the tbl8 entries of the lanes whose tbl24 entry points to a group.
+ */
+static inline __m256i
+lookup_x8(const struct rte_lpm *lpm, __m256i ips)
+{
+	const __m256i mask_xv = _mm256_set1_epi32(
+			RTE_LPM_VALID_EXT_ENTRY_BITMASK);
+	const __m256i mask24 = _mm256_set1_epi32(0x00FFFFFF);
+	const __m256i mask8 = _mm256_set1_epi32(UINT8_MAX);
+	__m256i res, ext, i8;
+
+	res = _mm256_i32gather_epi32((const int *)lpm->tbl24,
+			_mm256_srli_epi32(ips, CHAR_BIT), sizeof(uint32_t));
+
+	ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, mask_xv), mask_xv);
+	if (likely(_mm256_testz_si256(ext, ext)))
+		return res;
+
+	i8 = _mm256_add_epi32(
+			_mm256_slli_epi32(_mm256_and_si256(res, mask24),
+			CHAR_BIT), _mm256_and_si256(ips, mask8));
+
+	return _mm256_mask_i32gather_epi32(res, (const int *)lpm->tbl8, i8,
+			ext, sizeof(uint32_t));
+}
+
+void
+rte_lpm_lookupx8_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv)
+{
+	const __m256i mask_v = _mm256_set1_epi32(RTE_LPM_LOOKUP_SUCCESS);
+	const __m256i mask24 = _mm256_set1_epi32(0x00FFFFFF);
+	__m256i res, hit;
+
+	res = lookup_x8(lpm, _mm256_loadu_si256((const __m256i *)ips));
+
+	/* Next hop of the lanes that hit, defv for the others. */
+	hit = _mm256_cmpeq_epi32(_mm256_and_si256(res, mask_v), mask_v);
+	res = _mm256_blendv_epi8(_mm256_set1_epi32(defv),
+			_mm256_and_si256(res, mask24), hit);
+
+	_mm256_storeu_si256((__m256i *)hop, res);
+}
+
+void
+rte_lpm_lookupx16_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv)
+{
+	rte_lpm_lookupx8_avx2(lpm, ips, hop, defv);
+	rte_lpm_lookupx8_avx2(lpm, ips + 8, hop + 8, defv);
+}
+
+void
+rte_lpm_lookup_bulk_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+		_mm256_storeu_si256((__m256i *)&next_hops[i],
+				lookup_x8(lpm, _mm256_loadu_si256(
+				(const __m256i *)&ips[i])));
+
+	if (i < n)
+		rte_lpm_lookup_bulk_func(lpm, ips + i, next_hops + i, n - i);
+}
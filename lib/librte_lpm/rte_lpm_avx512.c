@@ -0,0 +1,103 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_lpm.h"
+#include "rte_lpm_vec.h"
+
+/*
+ * Raw entries of sixteen addresses: the tbl24 entries are gathered, then
+ * the tbl8 entries of the lanes whose tbl24 entry points to a group.
+ */
+static inline __m512i
+lookup_x16(const struct rte_lpm *lpm, __m512i ips)
+{
+	const __m512i mask_xv = _mm512_set1_epi32(
+			RTE_LPM_VALID_EXT_ENTRY_BITMASK);
+	const __m512i mask24 = _mm512_set1_epi32(0x00FFFFFF);
+	const __m512i mask8 = _mm512_set1_epi32(UINT8_MAX);
+	__m512i res, i8;
+	__mmask16 ext;
+
+	res = _mm512_i32gather_epi32(_mm512_srli_epi32(ips, CHAR_BIT),
+			(const void *)lpm->tbl24, sizeof(uint32_t));
+
+	ext = _mm512_cmpeq_epi32_mask(_mm512_and_epi32(res, mask_xv),
+			mask_xv);
+	if (likely(ext == 0))
+		return res;
+
+	i8 = _mm512_add_epi32(
+			_mm512_slli_epi32(_mm512_and_epi32(res, mask24),
+			CHAR_BIT), _mm512_and_epi32(ips, mask8));
+
+	return _mm512_mask_i32gather_epi32(res, ext, i8,
+			(const void *)lpm->tbl8, sizeof(uint32_t));
+}
+
+void
+rte_lpm_lookupx16_avx512(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv)
+{
+	const __m512i mask_v = _mm512_set1_epi32(RTE_LPM_LOOKUP_SUCCESS);
+	const __m512i mask24 = _mm512_set1_epi32(0x00FFFFFF);
+	__m512i res;
+	__mmask16 hit;
+
+	res = lookup_x16(lpm, _mm512_loadu_si512(ips));
+
+	/* Next hop of the lanes that hit, defv for the others. */
+	hit = _mm512_test_epi32_mask(res, mask_v);
+	res = _mm512_mask_blend_epi32(hit, _mm512_set1_epi32(defv),
+			_mm512_and_epi32(res, mask24));
+
+	_mm512_storeu_si512(hop, res);
+}
+
+void
+rte_lpm_lookup_bulk_avx512(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + 16 <= n; i += 16)
+		_mm512_storeu_si512(&next_hops[i],
+				lookup_x16(lpm, _mm512_loadu_si512(&ips[i])));
+
+	if (i < n)
+		rte_lpm_lookup_bulk_func(lpm, ips + i, next_hops + i, n - i);
+}
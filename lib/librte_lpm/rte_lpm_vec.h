@@ -0,0 +1,84 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_LPM_VEC_H_
+#define _RTE_LPM_VEC_H_
+
+/**
+ * @file
+ * Vector lookups of the LPM library, selected at runtime by rte_lpm.c.
+ * Internal, not installed.
+ */
+
+#include <stdint.h>
+
+#include "rte_lpm.h"
+
+/*
+ * The gathers take signed 32 bit indexes, tables with more tbl8 groups
+ * than this are looked up with the scalar functions.
+ */
+#define RTE_LPM_VEC_MAX_TBL8_NUM_GROUPS (1 << 23)
+
+typedef void (*rte_lpm_lookupx8_t)(const struct rte_lpm *lpm,
+		const uint32_t *ips, uint32_t *hop, uint32_t defv);
+
+typedef void (*rte_lpm_lookupx16_t)(const struct rte_lpm *lpm,
+		const uint32_t *ips, uint32_t *hop, uint32_t defv);
+
+typedef void (*rte_lpm_lookup_bulk_t)(const struct rte_lpm *lpm,
+		const uint32_t *ips, uint32_t *next_hops, unsigned int n);
+
+/* AVX2 lookups, only built when the compiler supports AVX2. */
+void
+rte_lpm_lookupx8_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv);
+
+void
+rte_lpm_lookupx16_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv);
+
+void
+rte_lpm_lookup_bulk_avx2(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n);
+
+/* AVX-512 lookups, only built when the compiler supports AVX-512F. */
+void
+rte_lpm_lookupx16_avx512(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *hop, uint32_t defv);
+
+void
+rte_lpm_lookup_bulk_avx512(const struct rte_lpm *lpm, const uint32_t *ips,
+		uint32_t *next_hops, unsigned int n);
+
+#endif /* _RTE_LPM_VEC_H_ */
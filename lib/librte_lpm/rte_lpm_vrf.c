@@ -0,0 +1,859 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <rte_log.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_atomic.h>
+#include <rte_string_fns.h>
+#include <rte_errno.h>
+#include <rte_rwlock.h>
+#include <rte_tailq.h>
+
+#include "rte_lpm_vrf.h"
+
+#define TBL16_BITS                               16
+#define BYTE_SIZE                                 8
+
+#define RULE_HASH_MULTIPLIER             0x9E3779B1
+#define RULE_INDEX_NONE                  UINT32_MAX
+
+#define group_idx next_hop
+
+/** Flags for setting an entry as valid/invalid. */
+enum valid_flag {
+	INVALID = 0,
+	VALID
+};
+
+TAILQ_HEAD(rte_lpm_vrf_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_lpm_vrf_tailq = {
+	.name = "RTE_LPM_VRF",
+};
+EAL_REGISTER_TAILQ(rte_lpm_vrf_tailq)
+
+/** Rules tbl entry structure. */
+struct rte_lpm_vrf_rule {
+	uint32_t ip;       /**< Rule IP address. */
+	uint32_t next_hop; /**< Rule next hop. */
+	uint32_t vrf_id;   /**< VRF of the rule. */
+	uint8_t depth;     /**< Rule depth. */
+	uint32_t next;     /**< Next rule in the same hash bucket. */
+};
+
+/*
+ * Converts a given depth value to its corresponding mask value.
+ */
+static inline uint32_t
+depth_to_mask(uint8_t depth)
+{
+	return (uint32_t)(~((1ULL << (RTE_LPM_MAX_DEPTH - depth)) - 1));
+}
+
+/*
+ * Hashes a VRF, a masked rule prefix and its depth into the rules hash.
+ */
+static inline uint32_t
+rule_hash(uint32_t vrf_id, uint32_t ip, uint8_t depth)
+{
+	uint32_t hash = depth;
+
+	hash = (hash ^ vrf_id) * RULE_HASH_MULTIPLIER;
+	hash ^= hash >> 15;
+	hash = (hash ^ ip) * RULE_HASH_MULTIPLIER;
+	hash ^= hash >> 15;
+
+	return hash;
+}
+
+/*
+ * Allocates memory for LPM object
+ */
+struct rte_lpm_vrf *
+rte_lpm_vrf_create(const char *name, int socket_id,
+		const struct rte_lpm_vrf_config *config)
+{
+	char mem_name[RTE_LPM_NAMESIZE];
+	struct rte_lpm_vrf *lpm = NULL;
+	struct rte_tailq_entry *te;
+	uint64_t mem_size, tbl8s_size, rules_size, hash_size, free_tbl8s_size;
+	struct rte_lpm_vrf_list *lpm_list;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm_vrf_tailq.head, rte_lpm_vrf_list);
+
+	RTE_BUILD_BUG_ON(sizeof(struct rte_lpm_tbl_entry) != sizeof(uint32_t));
+
+	/* Check user arguments. */
+	if ((name == NULL) || (socket_id < -1) || (config == NULL) ||
+			(config->max_vrfs == 0) ||
+			(config->max_vrfs > RTE_LPM_VRF_MAX_VRFS) ||
+			(config->max_rules == 0) ||
+			(config->number_tbl8s >
+			RTE_LPM_VRF_MAX_TBL8_NUM_GROUPS)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "LPM_VRF_%s", name);
+
+	/* Determine the amount of memory to allocate. */
+	mem_size = sizeof(*lpm) + sizeof(lpm->tbl16[0]) *
+			RTE_LPM_VRF_TBL16_NUM_ENTRIES * (uint64_t)config->max_vrfs;
+	tbl8s_size = sizeof(lpm->tbl8[0]) * RTE_LPM_TBL8_GROUP_NUM_ENTRIES *
+			(uint64_t)RTE_MAX(config->number_tbl8s, 1U);
+	rules_size = sizeof(struct rte_lpm_vrf_rule) * config->max_rules;
+	hash_size = sizeof(uint32_t) * rte_align32pow2(config->max_rules);
+	free_tbl8s_size = sizeof(uint32_t) * RTE_MAX(config->number_tbl8s, 1U);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* Guarantee there's no existing */
+	TAILQ_FOREACH(te, lpm_list, next) {
+		lpm = (struct rte_lpm_vrf *) te->data;
+		if (strncmp(name, lpm->name, RTE_LPM_NAMESIZE) == 0)
+			break;
+	}
+	lpm = NULL;
+	if (te != NULL) {
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("LPM_VRF_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, LPM, "Failed to allocate tailq entry!\n");
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	/* Allocate memory to store the LPM data structures. */
+	lpm = (struct rte_lpm_vrf *)rte_zmalloc_socket(mem_name,
+			(size_t)mem_size, RTE_CACHE_LINE_SIZE, socket_id);
+	if (lpm == NULL) {
+		RTE_LOG(ERR, LPM, "LPM memory allocation failed\n");
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	lpm->tbl8 = (struct rte_lpm_tbl_entry *)rte_zmalloc_socket(NULL,
+			(size_t)tbl8s_size, RTE_CACHE_LINE_SIZE, socket_id);
+	lpm->rules_tbl = (struct rte_lpm_vrf_rule *)rte_zmalloc_socket(NULL,
+			(size_t)rules_size, RTE_CACHE_LINE_SIZE, socket_id);
+	lpm->rules_hash = (uint32_t *)rte_malloc_socket(NULL,
+			(size_t)hash_size, RTE_CACHE_LINE_SIZE, socket_id);
+	lpm->free_tbl8s = (uint32_t *)rte_malloc_socket(NULL,
+			(size_t)free_tbl8s_size, RTE_CACHE_LINE_SIZE, socket_id);
+
+	if (lpm->tbl8 == NULL || lpm->rules_tbl == NULL ||
+			lpm->rules_hash == NULL || lpm->free_tbl8s == NULL) {
+		RTE_LOG(ERR, LPM, "LPM tables allocation failed\n");
+		rte_free(lpm->free_tbl8s);
+		rte_free(lpm->rules_hash);
+		rte_free(lpm->rules_tbl);
+		rte_free(lpm->tbl8);
+		rte_free(lpm);
+		lpm = NULL;
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	/* All buckets of the rules hash start empty. */
+	memset(lpm->rules_hash, 0xff, (size_t)hash_size);
+	lpm->rules_hash_mask = rte_align32pow2(config->max_rules) - 1;
+
+	/* Save user arguments. */
+	lpm->max_vrfs = config->max_vrfs;
+	lpm->max_rules = config->max_rules;
+	lpm->number_tbl8s = config->number_tbl8s;
+	snprintf(lpm->name, sizeof(lpm->name), "%s", name);
+
+	te->data = (void *) lpm;
+
+	TAILQ_INSERT_TAIL(lpm_list, te, next);
+
+exit:
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	return lpm;
+}
+
+/*
+ * Find an existing lpm table and return a pointer to it.
+ */
+struct rte_lpm_vrf *
+rte_lpm_vrf_find_existing(const char *name)
+{
+	struct rte_lpm_vrf *l = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_lpm_vrf_list *lpm_list;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm_vrf_tailq.head, rte_lpm_vrf_list);
+
+	rte_rwlock_read_lock(RTE_EAL_TAILQ_RWLOCK);
+	TAILQ_FOREACH(te, lpm_list, next) {
+		l = (struct rte_lpm_vrf *) te->data;
+		if (strncmp(name, l->name, RTE_LPM_NAMESIZE) == 0)
+			break;
+	}
+	rte_rwlock_read_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	if (te == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	return l;
+}
+
+/*
+ * Deallocates memory for given LPM table.
+ */
+void
+rte_lpm_vrf_free(struct rte_lpm_vrf *lpm)
+{
+	struct rte_lpm_vrf_list *lpm_list;
+	struct rte_tailq_entry *te;
+
+	/* Check user arguments. */
+	if (lpm == NULL)
+		return;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm_vrf_tailq.head, rte_lpm_vrf_list);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, lpm_list, next) {
+		if (te->data == (void *) lpm)
+			break;
+	}
+
+	if (te != NULL)
+		TAILQ_REMOVE(lpm_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	rte_free(lpm->free_tbl8s);
+	rte_free(lpm->rules_hash);
+	rte_free(lpm->rules_tbl);
+	rte_free(lpm->tbl8);
+	rte_free(lpm);
+	rte_free(te);
+}
+
+/*
+ * Finds a rule in rule table.
+ */
+static inline int32_t
+rule_find(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth)
+{
+	uint32_t rule_index;
+
+	/* Walk the bucket chain of the rule's hash. */
+	rule_index = lpm->rules_hash[rule_hash(vrf_id, ip, depth) &
+			lpm->rules_hash_mask];
+	while (rule_index != RULE_INDEX_NONE) {
+		const struct rte_lpm_vrf_rule *rule =
+				&lpm->rules_tbl[rule_index];
+
+		if (rule->ip == ip && rule->depth == depth &&
+				rule->vrf_id == vrf_id)
+			return rule_index;
+
+		rule_index = rule->next;
+	}
+
+	return -ENOENT;
+}
+
+/*
+ * Links a rule at the head of its bucket in the rules hash.
+ */
+static inline void
+rule_hash_link(struct rte_lpm_vrf *lpm, uint32_t rule_index)
+{
+	struct rte_lpm_vrf_rule *rule = &lpm->rules_tbl[rule_index];
+	uint32_t *head;
+
+	head = &lpm->rules_hash[rule_hash(rule->vrf_id, rule->ip,
+			rule->depth) & lpm->rules_hash_mask];
+	rule->next = *head;
+	*head = rule_index;
+}
+
+/*
+ * Removes a rule from the bucket chain it is linked in.
+ */
+static inline void
+rule_hash_unlink(struct rte_lpm_vrf *lpm, uint32_t rule_index)
+{
+	struct rte_lpm_vrf_rule *rule = &lpm->rules_tbl[rule_index];
+	uint32_t *prev;
+
+	prev = &lpm->rules_hash[rule_hash(rule->vrf_id, rule->ip,
+			rule->depth) & lpm->rules_hash_mask];
+	while (*prev != rule_index)
+		prev = &lpm->rules_tbl[*prev].next;
+	*prev = rule->next;
+}
+
+/*
+ * Checks if a rule already exists in the rules table and updates the
+ * next hop if so. Otherwise it adds a new rule if enough space is
+ * available.
+ */
+static inline int32_t
+rule_add(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth, uint32_t next_hop)
+{
+	int32_t rule_index;
+
+	/* If rule already exists update its next_hop and return. */
+	rule_index = rule_find(lpm, vrf_id, ip, depth);
+	if (rule_index >= 0) {
+		lpm->rules_tbl[rule_index].next_hop = next_hop;
+		return rule_index;
+	}
+
+	if (lpm->used_rules == lpm->max_rules)
+		return -ENOSPC;
+
+	rule_index = lpm->used_rules;
+	lpm->rules_tbl[rule_index].ip = ip;
+	lpm->rules_tbl[rule_index].next_hop = next_hop;
+	lpm->rules_tbl[rule_index].vrf_id = vrf_id;
+	lpm->rules_tbl[rule_index].depth = depth;
+	rule_hash_link(lpm, rule_index);
+
+	lpm->used_rules++;
+
+	return rule_index;
+}
+
+/*
+ * Removes a rule from the rule table, the last rule taking its place.
+ */
+static inline void
+rule_delete(struct rte_lpm_vrf *lpm, int32_t rule_index)
+{
+	uint32_t last = lpm->used_rules - 1;
+
+	rule_hash_unlink(lpm, rule_index);
+
+	if ((uint32_t)rule_index != last) {
+		rule_hash_unlink(lpm, last);
+		lpm->rules_tbl[rule_index] = lpm->rules_tbl[last];
+		rule_hash_link(lpm, rule_index);
+	}
+	lpm->used_rules--;
+}
+
+/*
+ * Finds the longest rule of the VRF that is less specific than the given
+ * prefix and covers it. Returns the rule index or -ENOENT.
+ */
+static inline int32_t
+rule_find_parent(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth)
+{
+	int32_t rule_index;
+
+	while (--depth > 0) {
+		rule_index = rule_find(lpm, vrf_id, ip & depth_to_mask(depth),
+				depth);
+		if (rule_index >= 0)
+			return rule_index;
+	}
+
+	return -ENOENT;
+}
+
+/*
+ * Takes a tbl8 group from the recycled ones, or a never used one if none
+ * was recycled. Returns the group index or -ENOSPC.
+ */
+static inline int32_t
+tbl8_alloc(struct rte_lpm_vrf *lpm)
+{
+	uint32_t tbl8_gindex;
+
+	if (lpm->nb_free_tbl8s > 0) {
+		tbl8_gindex = lpm->free_tbl8s[--lpm->nb_free_tbl8s];
+
+		/* Recycled groups keep their old entries until reused. */
+		memset(&lpm->tbl8[tbl8_gindex * RTE_LPM_TBL8_GROUP_NUM_ENTRIES],
+				0, sizeof(lpm->tbl8[0]) *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES);
+
+		return tbl8_gindex;
+	}
+
+	if (lpm->next_tbl8 < lpm->number_tbl8s)
+		return (lpm->next_tbl8)++;
+
+	return -ENOSPC;
+}
+
+/*
+ * Folds the tbl8 group an extended entry points to back into the entry,
+ * when every entry of the group holds the same rule and that rule is not
+ * more specific than the level of the extended entry. The group is then
+ * returned to the free stack.
+ */
+static void
+tbl8_recycle(struct rte_lpm_vrf *lpm, struct rte_lpm_tbl_entry *tbl_entry,
+		uint8_t bits_covered)
+{
+	struct rte_lpm_tbl_entry *tbl8, first;
+	uint32_t tbl8_gindex, i;
+
+	tbl8_gindex = tbl_entry->group_idx;
+	tbl8 = &lpm->tbl8[tbl8_gindex * RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+	first = tbl8[0];
+
+	if (first.valid_group == 1 ||
+			(first.valid && first.depth > bits_covered))
+		return;
+
+	for (i = 1; i < RTE_LPM_TBL8_GROUP_NUM_ENTRIES; i++) {
+		if (tbl8[i].valid_group == 1 || tbl8[i].valid != first.valid)
+			return;
+		if (first.valid && (tbl8[i].depth != first.depth ||
+				tbl8[i].next_hop != first.next_hop))
+			return;
+	}
+
+	struct rte_lpm_tbl_entry new_tbl_entry = {
+		.next_hop = first.valid ? first.next_hop : 0,
+		.valid = first.valid,
+		.valid_group = 0,
+		.depth = first.valid ? first.depth : 0,
+	};
+
+	/*
+	 * Lookups in flight may still walk the old group, so it is only
+	 * cleared when it gets allocated again.
+	 */
+	*tbl_entry = new_tbl_entry;
+	lpm->free_tbl8s[lpm->nb_free_tbl8s++] = tbl8_gindex;
+}
+
+/*
+ * Returns a tbl8 group and all the groups below it to the free stack.
+ */
+static void
+tbl8_free_all(struct rte_lpm_vrf *lpm, uint32_t tbl8_gindex)
+{
+	struct rte_lpm_tbl_entry *tbl8;
+	uint32_t i;
+
+	tbl8 = &lpm->tbl8[tbl8_gindex * RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+	for (i = 0; i < RTE_LPM_TBL8_GROUP_NUM_ENTRIES; i++)
+		if (tbl8[i].valid_group == 1)
+			tbl8_free_all(lpm, tbl8[i].group_idx);
+
+	lpm->free_tbl8s[lpm->nb_free_tbl8s++] = tbl8_gindex;
+}
+
+/*
+ * Index of the entry of ip in a table resolving the bits up to
+ * bits_covered, the table being stride bits wide.
+ */
+static inline uint32_t
+tbl_index_get(uint32_t ip, uint8_t bits_covered, uint8_t stride)
+{
+	return (ip >> (RTE_LPM_MAX_DEPTH - bits_covered)) &
+			((1U << stride) - 1);
+}
+
+/*
+ * Function that expands a rule across the data structure when a
+ * less-generic one has been added before. It assures that every possible
+ * combination of bits in the IP address returns a match.
+ */
+static void
+expand_rule(struct rte_lpm_vrf *lpm, uint32_t tbl8_gindex, uint8_t depth,
+		uint32_t next_hop)
+{
+	uint32_t tbl8_group_end, j;
+
+	tbl8_group_end = tbl8_gindex + RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+
+	struct rte_lpm_tbl_entry new_tbl8_entry = {
+		.next_hop = next_hop,
+		.valid = VALID,
+		.valid_group = 0,
+		.depth = depth,
+	};
+
+	for (j = tbl8_gindex; j < tbl8_group_end; j++) {
+		if (!lpm->tbl8[j].valid || (lpm->tbl8[j].valid_group == 0 &&
+				lpm->tbl8[j].depth <= depth))
+			lpm->tbl8[j] = new_tbl8_entry;
+		else if (lpm->tbl8[j].valid_group == 1)
+			expand_rule(lpm, lpm->tbl8[j].group_idx *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+					depth, next_hop);
+	}
+}
+
+/*
+ * Partially adds a new route to the data structure (tbl16+tbl8s).
+ * It returns 0 on success, a negative number on failure, or 1 if
+ * the process needs to be continued by calling the function again.
+ */
+static inline int
+add_step(struct rte_lpm_vrf *lpm, struct rte_lpm_tbl_entry *tbl,
+		struct rte_lpm_tbl_entry **tbl_next, uint32_t ip,
+		uint8_t bits_covered, uint8_t stride, uint8_t depth,
+		uint32_t next_hop)
+{
+	uint32_t tbl_index, tbl_range, tbl8_group_start, i;
+	int32_t tbl8_gindex;
+
+	tbl_index = tbl_index_get(ip, bits_covered, stride);
+
+	/*
+	 * If depth if smaller than this number (ie this is the last step)
+	 * expand the rule across the relevant positions in the table.
+	 */
+	if (depth <= bits_covered) {
+		tbl_range = 1 << (bits_covered - depth);
+
+		struct rte_lpm_tbl_entry new_tbl_entry = {
+			.next_hop = next_hop,
+			.valid = VALID,
+			.valid_group = 0,
+			.depth = depth,
+		};
+
+		for (i = tbl_index; i < (tbl_index + tbl_range); i++) {
+			if (!tbl[i].valid || (tbl[i].valid_group == 0 &&
+					tbl[i].depth <= depth))
+				tbl[i] = new_tbl_entry;
+			else if (tbl[i].valid_group == 1)
+				expand_rule(lpm, tbl[i].group_idx *
+						RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+						depth, next_hop);
+		}
+
+		return 0;
+	}
+
+	/* Not the last step: go through a tbl8 group, adding it if needed. */
+	if (tbl[tbl_index].valid_group == 0) {
+		tbl8_gindex = tbl8_alloc(lpm);
+		if (tbl8_gindex < 0)
+			return tbl8_gindex;
+
+		/* The new group inherits the rule stored here, if any. */
+		tbl8_group_start = tbl8_gindex * RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+		if (tbl[tbl_index].valid) {
+			for (i = tbl8_group_start; i < tbl8_group_start +
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES; i++)
+				lpm->tbl8[i] = tbl[tbl_index];
+		}
+
+		struct rte_lpm_tbl_entry new_tbl_entry = {
+			.group_idx = tbl8_gindex,
+			.valid = VALID,
+			.valid_group = 1,
+			.depth = 0,
+		};
+
+		/*
+		 * The group must be complete before lookups can reach it.
+		 * group_idx and the flags are updated in one go.
+		 */
+		rte_smp_wmb();
+		tbl[tbl_index] = new_tbl_entry;
+	}
+
+	*tbl_next = &lpm->tbl8[tbl[tbl_index].group_idx *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+
+	return 1;
+}
+
+/*
+ * Replaces every entry of a tbl8 group (and of the groups below it) that
+ * was set by a rule of the given depth. bits_covered is the number of bits
+ * resolved once the group has been inspected.
+ */
+static void
+delete_expand(struct rte_lpm_vrf *lpm, uint32_t tbl8_gindex,
+		uint8_t bits_covered, uint8_t depth,
+		const struct rte_lpm_tbl_entry *new_tbl_entry)
+{
+	uint32_t tbl8_group_end, j;
+
+	tbl8_group_end = tbl8_gindex + RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+
+	for (j = tbl8_gindex; j < tbl8_group_end; j++) {
+		if (lpm->tbl8[j].valid_group == 0) {
+			if (lpm->tbl8[j].valid && lpm->tbl8[j].depth == depth)
+				lpm->tbl8[j] = *new_tbl_entry;
+		} else {
+			delete_expand(lpm, lpm->tbl8[j].group_idx *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+					bits_covered + BYTE_SIZE, depth,
+					new_tbl_entry);
+			tbl8_recycle(lpm, &lpm->tbl8[j], bits_covered);
+		}
+	}
+}
+
+/*
+ * Removes a deleted route from the data structure, one level per call,
+ * the same way add_step inserted it. The entries the route had set are
+ * handed over to new_tbl_entry (its parent rule, or an invalid entry),
+ * and tbl8 groups left holding a single rule are folded back into their
+ * parent entry.
+ */
+static void
+delete_step(struct rte_lpm_vrf *lpm, struct rte_lpm_tbl_entry *tbl,
+		uint32_t ip, uint8_t bits_covered, uint8_t stride,
+		uint8_t depth, const struct rte_lpm_tbl_entry *new_tbl_entry)
+{
+	uint32_t tbl_index, tbl_range, i;
+
+	tbl_index = tbl_index_get(ip, bits_covered, stride);
+
+	if (depth <= bits_covered) {
+		tbl_range = 1 << (bits_covered - depth);
+
+		for (i = tbl_index; i < (tbl_index + tbl_range); i++) {
+			if (tbl[i].valid_group == 0) {
+				if (tbl[i].valid && tbl[i].depth == depth)
+					tbl[i] = *new_tbl_entry;
+			} else {
+				delete_expand(lpm, tbl[i].group_idx *
+						RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+						bits_covered + BYTE_SIZE, depth,
+						new_tbl_entry);
+				tbl8_recycle(lpm, &tbl[i], bits_covered);
+			}
+		}
+
+		return;
+	}
+
+	/*
+	 * The route only reaches deeper levels through an extended entry. It
+	 * may be missing when an add failed half way through.
+	 */
+	if (tbl[tbl_index].valid_group == 0)
+		return;
+
+	delete_step(lpm, &lpm->tbl8[tbl[tbl_index].group_idx *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES], ip,
+			bits_covered + BYTE_SIZE, BYTE_SIZE, depth,
+			new_tbl_entry);
+	tbl8_recycle(lpm, &tbl[tbl_index], bits_covered);
+}
+
+/* Returns the tbl16 of a VRF. */
+static inline struct rte_lpm_tbl_entry *
+vrf_tbl16(struct rte_lpm_vrf *lpm, uint32_t vrf_id)
+{
+	return &lpm->tbl16[(size_t)vrf_id * RTE_LPM_VRF_TBL16_NUM_ENTRIES];
+}
+
+/*
+ * Deletes a rule from the rule table and from the data structure.
+ * ip_masked must already be masked to depth.
+ */
+static int
+delete_rule(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip_masked,
+		uint8_t depth)
+{
+	struct rte_lpm_tbl_entry new_tbl_entry = { 0 };
+	int32_t rule_index, parent_index;
+
+	rule_index = rule_find(lpm, vrf_id, ip_masked, depth);
+	if (rule_index < 0)
+		return rule_index;
+
+	rule_delete(lpm, rule_index);
+
+	/*
+	 * The addresses the rule matched fall back to the longest rule of
+	 * the VRF that covers it, if any.
+	 */
+	parent_index = rule_find_parent(lpm, vrf_id, ip_masked, depth);
+	if (parent_index >= 0) {
+		new_tbl_entry.next_hop = lpm->rules_tbl[parent_index].next_hop;
+		new_tbl_entry.depth = lpm->rules_tbl[parent_index].depth;
+		new_tbl_entry.valid = VALID;
+	}
+
+	delete_step(lpm, vrf_tbl16(lpm, vrf_id), ip_masked, TBL16_BITS,
+			TBL16_BITS, depth, &new_tbl_entry);
+
+	return 0;
+}
+
+/*
+ * Add a route
+ */
+int
+rte_lpm_vrf_add(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth, uint32_t next_hop)
+{
+	struct rte_lpm_tbl_entry *tbl, *tbl_next = NULL;
+	uint32_t ip_masked, bits_covered;
+	int32_t rule_index;
+	int status;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (vrf_id >= lpm->max_vrfs) || (depth < 1) ||
+			(depth > RTE_LPM_MAX_DEPTH) || (next_hop > 0x00FFFFFF))
+		return -EINVAL;
+
+	ip_masked = ip & depth_to_mask(depth);
+
+	/* Add the rule to the rule table. */
+	rule_index = rule_add(lpm, vrf_id, ip_masked, depth, next_hop);
+	if (rule_index < 0)
+		return rule_index;
+
+	/* The tbl16 first, then one byte per tbl8 level. */
+	tbl = vrf_tbl16(lpm, vrf_id);
+	status = add_step(lpm, tbl, &tbl_next, ip_masked, TBL16_BITS,
+			TBL16_BITS, depth, next_hop);
+
+	for (bits_covered = TBL16_BITS + BYTE_SIZE; status == 1;
+			bits_covered += BYTE_SIZE) {
+		tbl = tbl_next;
+		status = add_step(lpm, tbl, &tbl_next, ip_masked,
+				bits_covered, BYTE_SIZE, depth, next_hop);
+	}
+
+	if (status < 0) {
+		delete_rule(lpm, vrf_id, ip_masked, depth);
+		return status;
+	}
+
+	return 0;
+}
+
+/*
+ * Look for a rule in the high-level rules table
+ */
+int
+rte_lpm_vrf_is_rule_present(struct rte_lpm_vrf *lpm, uint32_t vrf_id,
+		uint32_t ip, uint8_t depth, uint32_t *next_hop)
+{
+	int32_t rule_index;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (next_hop == NULL) ||
+			(vrf_id >= lpm->max_vrfs) || (depth < 1) ||
+			(depth > RTE_LPM_MAX_DEPTH))
+		return -EINVAL;
+
+	rule_index = rule_find(lpm, vrf_id, ip & depth_to_mask(depth), depth);
+	if (rule_index >= 0) {
+		*next_hop = lpm->rules_tbl[rule_index].next_hop;
+		return 1;
+	}
+
+	/* If rule is not found return 0. */
+	return 0;
+}
+
+/*
+ * Deletes a rule
+ */
+int
+rte_lpm_vrf_delete(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth)
+{
+	/* Check user arguments. */
+	if ((lpm == NULL) || (vrf_id >= lpm->max_vrfs) || (depth < 1) ||
+			(depth > RTE_LPM_MAX_DEPTH))
+		return -EINVAL;
+
+	return delete_rule(lpm, vrf_id, ip & depth_to_mask(depth), depth);
+}
+
+/*
+ * Delete all rules of a VRF.
+ */
+int
+rte_lpm_vrf_delete_all(struct rte_lpm_vrf *lpm, uint32_t vrf_id)
+{
+	struct rte_lpm_tbl_entry *tbl16;
+	uint32_t i;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (vrf_id >= lpm->max_vrfs))
+		return -EINVAL;
+
+	/* Detach the tbl8 groups of the VRF before giving them back. */
+	tbl16 = vrf_tbl16(lpm, vrf_id);
+	for (i = 0; i < RTE_LPM_VRF_TBL16_NUM_ENTRIES; i++) {
+		struct rte_lpm_tbl_entry entry = tbl16[i];
+
+		if (!entry.valid)
+			continue;
+		tbl16[i] = (struct rte_lpm_tbl_entry){ 0 };
+		if (entry.valid_group == 1)
+			tbl8_free_all(lpm, entry.group_idx);
+	}
+
+	/* The last rule takes the place of each deleted one. */
+	for (i = 0; i < lpm->used_rules; ) {
+		if (lpm->rules_tbl[i].vrf_id == vrf_id)
+			rule_delete(lpm, i);
+		else
+			i++;
+	}
+
+	return 0;
+}
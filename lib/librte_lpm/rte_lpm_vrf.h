@@ -0,0 +1,349 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_LPM_VRF_H_
+#define _RTE_LPM_VRF_H_
+
+/**
+ * @file
+ * RTE Longest Prefix Match for many routing instances (VRFs)
+ *
+ * A single table holds the IPv4 routes of up to max_vrfs routing
+ * instances. Each VRF has its own tbl16, indexed by the 16 most
+ * significant bits of the address, and all the VRFs share one pool of
+ * tbl8 groups for the following two bytes, so the memory needed grows
+ * with the number of long routes rather than with the number of VRFs.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <rte_branch_prediction.h>
+#include <rte_prefetch.h>
+#include <rte_common.h>
+#include <rte_lpm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max number of VRFs of a multi-VRF LPM object. */
+#define RTE_LPM_VRF_MAX_VRFS            (1 << 16)
+
+/** @internal Number of tbl16 entries of a VRF. */
+#define RTE_LPM_VRF_TBL16_NUM_ENTRIES   (1 << 16)
+
+/** @internal Max number of tbl8 groups shared by the VRFs. */
+#define RTE_LPM_VRF_MAX_TBL8_NUM_GROUPS (1 << 24)
+
+/** @internal Mask of the next hop and lookup success bits of an entry. */
+#define RTE_LPM_VRF_RES_MASK            (0x00FFFFFF | RTE_LPM_LOOKUP_SUCCESS)
+
+/** Multi-VRF LPM configuration structure. */
+struct rte_lpm_vrf_config {
+	uint32_t max_vrfs;       /**< Number of VRFs, ids 0 .. max_vrfs - 1. */
+	uint32_t max_rules;      /**< Max number of rules of all the VRFs. */
+	uint32_t number_tbl8s;   /**< Number of tbl8s shared by the VRFs. */
+	int flags;               /**< This field is currently unused. */
+};
+
+/** @internal Rule structure, defined in rte_lpm_vrf.c. */
+struct rte_lpm_vrf_rule;
+
+/**
+ * @internal Multi-VRF LPM structure.
+ *
+ * Entries use the layout of struct rte_lpm_tbl_entry, valid_group being
+ * set on the entries of any level that point to a tbl8 group.
+ */
+struct rte_lpm_vrf {
+	/* LPM metadata. */
+	char name[RTE_LPM_NAMESIZE];    /**< Name of the lpm. */
+	uint32_t max_vrfs;              /**< Number of VRFs. */
+	uint32_t max_rules;             /**< Max number of rules. */
+	uint32_t used_rules;            /**< Used rules so far. */
+	uint32_t number_tbl8s;          /**< Number of tbl8s. */
+	uint32_t next_tbl8;             /**< Next never used tbl8. */
+	uint32_t nb_free_tbl8s;         /**< Number of recycled tbl8s. */
+	uint32_t rules_hash_mask;       /**< Rules hash bucket mask. */
+
+	/* LPM Tables. */
+	struct rte_lpm_vrf_rule *rules_tbl; /**< LPM rules. */
+	uint32_t *rules_hash;           /**< First rule of each bucket. */
+	uint32_t *free_tbl8s;           /**< Stack of recycled tbl8s. */
+	struct rte_lpm_tbl_entry *tbl8; /**< LPM tbl8 table. */
+	struct rte_lpm_tbl_entry tbl16[0]
+			__rte_cache_aligned; /**< tbl16 of each VRF. */
+};
+
+/**
+ * Create a multi-VRF LPM object.
+ *
+ * @param name
+ *   LPM object name
+ * @param socket_id
+ *   NUMA socket ID for LPM table memory allocation
+ * @param config
+ *   Structure containing the configuration
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - EEXIST - an object with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_lpm_vrf *
+rte_lpm_vrf_create(const char *name, int socket_id,
+		const struct rte_lpm_vrf_config *config);
+
+/**
+ * Find an existing multi-VRF LPM object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the lpm object as passed to rte_lpm_vrf_create()
+ * @return
+ *   Pointer to lpm object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_lpm_vrf *
+rte_lpm_vrf_find_existing(const char *name);
+
+/**
+ * Free a multi-VRF LPM object.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @return
+ *   None
+ */
+void
+rte_lpm_vrf_free(struct rte_lpm_vrf *lpm);
+
+/**
+ * Add a rule to a VRF. Adding a rule that is already present updates
+ * its next hop.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_id
+ *   VRF of the rule
+ * @param ip
+ *   IP of the rule to be added to the LPM table
+ * @param depth
+ *   Depth of the rule to be added to the LPM table
+ * @param next_hop
+ *   Next hop of the rule to be added to the LPM table, up to 24 bits
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments, -ENOSPC when the rules
+ *   or the tbl8 groups are exhausted
+ */
+int
+rte_lpm_vrf_add(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth, uint32_t next_hop);
+
+/**
+ * Check if a rule is present in a VRF, and provide its next hop if it is.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_id
+ *   VRF of the rule
+ * @param ip
+ *   IP of the rule to be searched
+ * @param depth
+ *   Depth of the rule to searched
+ * @param next_hop
+ *   Next hop of the rule (valid only if it is found)
+ * @return
+ *   1 if the rule exists, 0 if it does not, a negative value on failure
+ */
+int
+rte_lpm_vrf_is_rule_present(struct rte_lpm_vrf *lpm, uint32_t vrf_id,
+		uint32_t ip, uint8_t depth, uint32_t *next_hop);
+
+/**
+ * Delete a rule from a VRF.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_id
+ *   VRF of the rule
+ * @param ip
+ *   IP of the rule to be deleted from the LPM table
+ * @param depth
+ *   Depth of the rule to be deleted from the LPM table
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments, -ENOENT if the rule is
+ *   not present
+ */
+int
+rte_lpm_vrf_delete(struct rte_lpm_vrf *lpm, uint32_t vrf_id, uint32_t ip,
+		uint8_t depth);
+
+/**
+ * Delete all the rules of a VRF and give its tbl8 groups back to the
+ * shared pool.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_id
+ *   VRF to empty
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments
+ */
+int
+rte_lpm_vrf_delete_all(struct rte_lpm_vrf *lpm, uint32_t vrf_id);
+
+/**
+ * Lookup an IP in the table of a VRF.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_id
+ *   VRF to look the IP up in
+ * @param ip
+ *   IP to be looked up in the LPM table
+ * @param next_hop
+ *   Next hop of the most specific rule found for IP (valid on lookup hit only)
+ * @return
+ *   -EINVAL for incorrect arguments, -ENOENT on lookup miss, 0 on lookup hit
+ */
+static inline int
+rte_lpm_vrf_lookup(const struct rte_lpm_vrf *lpm, uint32_t vrf_id,
+		uint32_t ip, uint32_t *next_hop)
+{
+	const uint32_t *ptbl;
+	uint32_t tbl_entry;
+
+	/* DEBUG: Check user input arguments. */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (next_hop == NULL) ||
+			(vrf_id >= lpm->max_vrfs)), -EINVAL);
+
+	ptbl = (const uint32_t *)&lpm->tbl16[(vrf_id << 16) | (ip >> 16)];
+	tbl_entry = *ptbl;
+
+	/* Second and third byte, through the tbl8 groups (only if needed). */
+	if (unlikely((tbl_entry & RTE_LPM_VALID_EXT_ENTRY_BITMASK) ==
+			RTE_LPM_VALID_EXT_ENTRY_BITMASK)) {
+		ptbl = (const uint32_t *)&lpm->tbl8[(uint8_t)(ip >> 8) +
+				((tbl_entry & 0x00FFFFFF) *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES)];
+		tbl_entry = *ptbl;
+
+		if (unlikely((tbl_entry & RTE_LPM_VALID_EXT_ENTRY_BITMASK) ==
+				RTE_LPM_VALID_EXT_ENTRY_BITMASK)) {
+			ptbl = (const uint32_t *)&lpm->tbl8[(uint8_t)ip +
+					((tbl_entry & 0x00FFFFFF) *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES)];
+			tbl_entry = *ptbl;
+		}
+	}
+
+	*next_hop = (tbl_entry & 0x00FFFFFF);
+	return (tbl_entry & RTE_LPM_LOOKUP_SUCCESS) ? 0 : -ENOENT;
+}
+
+/**
+ * Lookup multiple IPs, each in its own VRF. The tbl16 entries of all the
+ * IPs are prefetched before any is read, so that bursts mixing many VRFs
+ * keep their cache misses in flight together.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param vrf_ids
+ *   VRF of each IP
+ * @param ips
+ *   Array of IPs to be looked up in the LPM table
+ * @param next_hops
+ *   Next hop of the most specific rule found for each IP. The
+ *   RTE_LPM_LOOKUP_SUCCESS bit tells whether the lookup was successful, the
+ *   24 least significant bits hold the actual next hop.
+ * @param n
+ *   Number of elements in vrf_ids, ips and next_hops
+ * @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+static inline int
+rte_lpm_vrf_lookup_bulk(const struct rte_lpm_vrf *lpm,
+		const uint32_t *vrf_ids, const uint32_t *ips,
+		uint32_t *next_hops, const unsigned int n)
+{
+	unsigned int i;
+	uint32_t tbl16_indexes[n];
+	const uint32_t *ptbl;
+	uint32_t tbl_entry;
+
+	/* DEBUG: Check user input arguments. */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (vrf_ids == NULL) ||
+			(ips == NULL) || (next_hops == NULL)), -EINVAL);
+
+	for (i = 0; i < n; i++) {
+		RTE_LPM_RETURN_IF_TRUE(vrf_ids[i] >= lpm->max_vrfs, -EINVAL);
+		tbl16_indexes[i] = (vrf_ids[i] << 16) | (ips[i] >> 16);
+		rte_prefetch0(&lpm->tbl16[tbl16_indexes[i]]);
+	}
+
+	for (i = 0; i < n; i++) {
+		ptbl = (const uint32_t *)&lpm->tbl16[tbl16_indexes[i]];
+		tbl_entry = *ptbl;
+
+		if (unlikely((tbl_entry & RTE_LPM_VALID_EXT_ENTRY_BITMASK) ==
+				RTE_LPM_VALID_EXT_ENTRY_BITMASK)) {
+			ptbl = (const uint32_t *)&lpm->tbl8[
+					(uint8_t)(ips[i] >> 8) +
+					((tbl_entry & 0x00FFFFFF) *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES)];
+			tbl_entry = *ptbl;
+
+			if (unlikely((tbl_entry &
+					RTE_LPM_VALID_EXT_ENTRY_BITMASK) ==
+					RTE_LPM_VALID_EXT_ENTRY_BITMASK)) {
+				ptbl = (const uint32_t *)&lpm->tbl8[
+						(uint8_t)ips[i] +
+						((tbl_entry & 0x00FFFFFF) *
+						RTE_LPM_TBL8_GROUP_NUM_ENTRIES)];
+				tbl_entry = *ptbl;
+			}
+		}
+
+		next_hops[i] = tbl_entry & RTE_LPM_VRF_RES_MASK;
+	}
+
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LPM_VRF_H_ */
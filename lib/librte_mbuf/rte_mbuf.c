@@ -150,11 +150,10 @@ rte_pktmbuf_init(struct rte_mempool *mp,
 	m->next = NULL;
 }
 
-/* helper to create a mbuf pool */
-struct rte_mempool *
-rte_pktmbuf_pool_create(const char *name, unsigned n,
+static struct rte_mempool *
+pktmbuf_pool_create(const char *name, unsigned n,
 	unsigned cache_size, uint16_t priv_size, uint16_t data_room_size,
-	int socket_id)
+	int socket_id, int parallel)
 {
 	struct rte_mempool *mp;
 	struct rte_pktmbuf_pool_private mbp_priv;
@@ -194,11 +193,35 @@ rte_pktmbuf_pool_create(const char *name, unsigned n,
 		return NULL;
 	}
 
-	rte_mempool_obj_iter(mp, rte_pktmbuf_init, NULL);
+	/* the mbufs are independent, they can be initialized in parallel */
+	if (parallel)
+		rte_mempool_obj_iter_parallel(mp, rte_pktmbuf_init, NULL);
+	else
+		rte_mempool_obj_iter(mp, rte_pktmbuf_init, NULL);
 
 	return mp;
 }
 
+/* helper to create a mbuf pool */
+struct rte_mempool *
+rte_pktmbuf_pool_create(const char *name, unsigned n,
+	unsigned cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id)
+{
+	return pktmbuf_pool_create(name, n, cache_size, priv_size,
+		data_room_size, socket_id, 0);
+}
+
+/* helper to create a mbuf pool, initializing the mbufs on idle lcores */
+struct rte_mempool *
+rte_pktmbuf_pool_create_parallel(const char *name, unsigned n,
+	unsigned cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id)
+{
+	return pktmbuf_pool_create(name, n, cache_size, priv_size,
+		data_room_size, socket_id, 1);
+}
+
 /* do some sanity checks on a mbuf: panic if it fails */
 void
 rte_mbuf_sanity_check(const struct rte_mbuf *m, int is_header)
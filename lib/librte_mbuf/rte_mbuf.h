@@ -1023,6 +1023,37 @@ rte_pktmbuf_pool_create(const char *name, unsigned n,
 	unsigned cache_size, uint16_t priv_size, uint16_t data_room_size,
 	int socket_id);
 
+/**
+ * Create a mbuf pool, initializing the mbufs on several lcores.
+ *
+ * Same as rte_pktmbuf_pool_create(), except that when called from the
+ * master lcore, the initialization of the mbufs is split between the
+ * master and the slave lcores which are idle, see
+ * rte_mempool_obj_iter_parallel(). The slave lcores must not be launched
+ * with rte_eal_remote_launch() meanwhile.
+ *
+ * @param name
+ *   The name of the mbuf pool.
+ * @param n
+ *   The number of elements in the mbuf pool.
+ * @param cache_size
+ *   Size of the per-core object cache.
+ * @param priv_size
+ *   Size of application private area between the rte_mbuf structure
+ *   and the data buffer. This value must be aligned to RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated.
+ * @return
+ *   The pointer to the new allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately, see rte_pktmbuf_pool_create().
+ */
+struct rte_mempool *
+rte_pktmbuf_pool_create_parallel(const char *name, unsigned n,
+	unsigned cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id);
+
 /**
  * Get the data room size of mbufs stored in a pktmbuf_pool
  *
@@ -0,0 +1,355 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_MEMBER_H_
+#define _RTE_MEMBER_H_
+
+/**
+ * @file
+ *
+ * RTE Membership Library
+ *
+ * The membership library keeps a summary of one or several sets of keys,
+ * and tells for a key which set it belongs to, or that it belongs to none.
+ * The summary is much smaller than the sets themselves since it doesn't
+ * store the keys: a lookup may report a key that was never added
+ * (false positive). Two kinds of set summary are provided:
+ *
+ * - RTE_MEMBER_TYPE_HT: a cuckoo hash table storing a 16-bit signature
+ *   and a set id per key, with the bucket layout of the cuckoo hash
+ *   library. It supports deletes and any number of sets. In cache mode,
+ *   new keys evict old ones from full buckets instead of failing, which
+ *   may cause false negatives.
+ *
+ * - RTE_MEMBER_TYPE_VBF: a vector of Bloom filters, one per set, sized
+ *   from the requested false positive rate. It is the most compact
+ *   summary for few sets, but it doesn't support deletes.
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @internal Hash function used by the membership library. */
+#if defined(RTE_ARCH_X86) || defined(RTE_MACHINE_CPUFLAG_CRC32)
+#include <rte_hash_crc.h>
+#define MEMBER_HASH_FUNC	rte_hash_crc
+#else
+#include <rte_jhash.h>
+#define MEMBER_HASH_FUNC	rte_jhash
+#endif
+
+/** @internal Log type of the membership library. */
+extern int librte_member_logtype;
+
+/** @internal Log a message of the membership library. */
+#define RTE_MEMBER_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, librte_member_logtype, "%s(): " fmt, \
+		__func__, ## args)
+
+/** The set id type. Set ids are counted from 1, 0 means no match. */
+typedef uint16_t member_set_t;
+
+/** Set id returned when a key matched no set. */
+#define RTE_MEMBER_NO_MATCH 0
+
+/** Maximum number of keys in a bulk lookup. */
+#define RTE_MEMBER_LOOKUP_BULK_MAX 64
+
+/** Entries per bucket of the hash table set summary. */
+#define RTE_MEMBER_BUCKET_ENTRIES 16
+
+/** Maximum set id for the hash table set summary. */
+#define RTE_MEMBER_HT_MAX_SET_ID 0x7fff
+
+/** Maximum number of sets for the vector of Bloom filters set summary. */
+#define RTE_MEMBER_MAX_BF 32
+
+/** Maximum number of characters in a set summary name. */
+#define RTE_MEMBER_NAMESIZE 32
+
+/** Type of set summary. */
+enum rte_member_setsum_type {
+	RTE_MEMBER_TYPE_HT = 0,  /**< Hash table based set summary. */
+	RTE_MEMBER_TYPE_VBF,     /**< Vector of Bloom filters. */
+	RTE_MEMBER_NUM_TYPE
+};
+
+/** @internal Signature compare implementations of the hash table type. */
+enum rte_member_sig_compare_function {
+	RTE_MEMBER_COMPARE_SCALAR = 0,
+	RTE_MEMBER_COMPARE_AVX2,
+	RTE_MEMBER_COMPARE_NUM
+};
+
+/** @internal Set summary, common to all types. */
+struct rte_member_setsum {
+	enum rte_member_setsum_type type; /* Type of the set summary. */
+	uint32_t key_len;		/* Length of key. */
+	uint32_t prim_hash_seed;	/* Primary hash function seed. */
+	uint32_t sec_hash_seed;		/* Secondary hash function seed. */
+
+	/* Hash table based. */
+	uint32_t bucket_cnt;		/* Number of buckets. */
+	uint32_t bucket_mask;		/* Bit mask to get bucket index. */
+	/* Signature compare function, selected at creation. */
+	enum rte_member_sig_compare_function sig_cmp_fn;
+	uint8_t cache;			/* Keys may be evicted (cache mode). */
+
+	/* Vector of Bloom filters. */
+	uint32_t num_set;		/* Number of sets (filters). */
+	uint32_t bits;			/* Number of bits in each filter. */
+	uint32_t bit_mask;		/* Bit mask to get a bit position. */
+	uint32_t num_hashes;		/* Number of bits set per key. */
+	uint32_t mul_shift;		/* log2 of the bits per position. */
+
+	void *table;	/* Buckets or filter bits, depending on type. */
+
+	int socket_id;			/* NUMA socket of the table. */
+	char name[RTE_MEMBER_NAMESIZE];	/* Name of the set summary. */
+} __rte_cache_aligned;
+
+/** Parameters used when creating a set summary. */
+struct rte_member_parameters {
+	const char *name;		/**< Name of the set summary. */
+
+	/** Type of the set summary, RTE_MEMBER_TYPE_HT or _VBF. */
+	enum rte_member_setsum_type type;
+
+	/**
+	 * HT only: cache mode. When both buckets of a key are full,
+	 * an entry is evicted instead of the add failing, so lookups
+	 * of evicted keys return no match (false negative).
+	 */
+	uint8_t is_cache;
+
+	/**
+	 * Number of keys the summary is sized for. For VBF, it is the
+	 * total number of keys over all sets, assumed evenly spread.
+	 */
+	uint32_t num_keys;
+
+	uint32_t key_len;		/**< Length of the keys in bytes. */
+
+	/**
+	 * VBF only: number of sets, from 1 to RTE_MEMBER_MAX_BF.
+	 * HT set ids may be anything from 1 to RTE_MEMBER_HT_MAX_SET_ID.
+	 */
+	uint32_t num_set;
+
+	/**
+	 * VBF only: probability that a key which was not added matches
+	 * a set, or another set than its own, when the summary is full.
+	 * The HT false positive rate is set by its 16-bit signatures:
+	 * it is at most RTE_MEMBER_BUCKET_ENTRIES * 2 / 65536 for a full
+	 * table.
+	 */
+	float false_positive_rate;
+
+	uint32_t prim_hash_seed;	/**< Seed of the primary hash. */
+	uint32_t sec_hash_seed;		/**< Seed of the secondary hash. */
+	int socket_id;			/**< NUMA socket for the memory. */
+};
+
+/**
+ * Create a set summary.
+ *
+ * @param params
+ *   Parameters of the set summary.
+ * @return
+ *   Pointer to the set summary, or NULL with rte_errno set:
+ *    - EINVAL - invalid parameter
+ *    - EEXIST - a set summary with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_member_setsum *
+rte_member_create(const struct rte_member_parameters *params);
+
+/**
+ * Find an existing set summary and return a pointer to it.
+ *
+ * @param name
+ *   Name of the set summary, as passed to rte_member_create().
+ * @return
+ *   Pointer to the set summary, or NULL with rte_errno set to ENOENT.
+ */
+struct rte_member_setsum *
+rte_member_find_existing(const char *name);
+
+/**
+ * Free a set summary.
+ *
+ * @param setsum
+ *   Set summary to free, may be NULL.
+ */
+void
+rte_member_free(struct rte_member_setsum *setsum);
+
+/**
+ * Remove all the keys of a set summary.
+ *
+ * @param setsum
+ *   Set summary to reset.
+ */
+void
+rte_member_reset(const struct rte_member_setsum *setsum);
+
+/**
+ * Add a key to a set.
+ * This operation is not multi-thread safe and should only be called
+ * from one thread. Lookups running meanwhile may miss keys which are
+ * being moved between buckets.
+ *
+ * @param setsum
+ *   Set summary to update.
+ * @param key
+ *   Key to add.
+ * @param set_id
+ *   Set to add the key to, not RTE_MEMBER_NO_MATCH.
+ * @return
+ *   - 0 if the key was added,
+ *   - 1 if the key was added, evicting another key (HT cache mode),
+ *   - -EINVAL if the set id is invalid,
+ *   - -ENOSPC if the table is full (HT non-cache mode).
+ */
+int
+rte_member_add(const struct rte_member_setsum *setsum, const void *key,
+	member_set_t set_id);
+
+/**
+ * Delete a key from a set. VBF summaries don't support deletes.
+ * This operation is not multi-thread safe and should only be called
+ * from one thread.
+ *
+ * @param setsum
+ *   Set summary to update.
+ * @param key
+ *   Key to delete.
+ * @param set_id
+ *   Set the key was added to.
+ * @return
+ *   - 0 if the key was deleted,
+ *   - -ENOENT if the key was not found in the set,
+ *   - -ENOTSUP if the set summary doesn't support deletes.
+ */
+int
+rte_member_delete(const struct rte_member_setsum *setsum, const void *key,
+	member_set_t set_id);
+
+/**
+ * Look up a key.
+ *
+ * @param setsum
+ *   Set summary to look up.
+ * @param key
+ *   Key to look up.
+ * @param set_id
+ *   Set the key belongs to, or RTE_MEMBER_NO_MATCH. If the key matches
+ *   several sets, one of them.
+ * @return
+ *   1 if the key matched a set, 0 otherwise.
+ */
+int
+rte_member_lookup(const struct rte_member_setsum *setsum, const void *key,
+	member_set_t *set_id);
+
+/**
+ * Look up several keys.
+ *
+ * @param setsum
+ *   Set summary to look up.
+ * @param keys
+ *   Array of pointers to the keys to look up.
+ * @param num_keys
+ *   Number of keys, at most RTE_MEMBER_LOOKUP_BULK_MAX.
+ * @param set_ids
+ *   Array of num_keys set ids, set as by rte_member_lookup().
+ * @return
+ *   Number of keys that matched a set, or -EINVAL.
+ */
+int
+rte_member_lookup_bulk(const struct rte_member_setsum *setsum,
+	const void **keys, uint32_t num_keys, member_set_t *set_ids);
+
+/**
+ * Look up all the sets a key matches.
+ *
+ * @param setsum
+ *   Set summary to look up.
+ * @param key
+ *   Key to look up.
+ * @param max_match_per_key
+ *   Maximum number of sets to return.
+ * @param set_id
+ *   Array of max_match_per_key set ids, filled with the matched sets.
+ * @return
+ *   Number of matched sets.
+ */
+int
+rte_member_lookup_multi(const struct rte_member_setsum *setsum,
+	const void *key, uint32_t max_match_per_key, member_set_t *set_id);
+
+/**
+ * Look up all the sets several keys match.
+ *
+ * @param setsum
+ *   Set summary to look up.
+ * @param keys
+ *   Array of pointers to the keys to look up.
+ * @param num_keys
+ *   Number of keys, at most RTE_MEMBER_LOOKUP_BULK_MAX.
+ * @param max_match_per_key
+ *   Maximum number of sets to return for each key.
+ * @param match_count
+ *   Array of num_keys number of sets matched by each key.
+ * @param set_ids
+ *   Array of num_keys * max_match_per_key set ids: the sets matched by
+ *   key i start at set_ids[i * max_match_per_key].
+ * @return
+ *   Number of keys that matched at least one set, or -EINVAL.
+ */
+int
+rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
+	const void **keys, uint32_t num_keys, uint32_t max_match_per_key,
+	uint32_t *match_count, member_set_t *set_ids);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_H_ */
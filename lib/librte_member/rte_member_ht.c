@@ -0,0 +1,500 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_random.h>
+#include <rte_atomic.h>
+#include <rte_cpuflags.h>
+
+#include "rte_member.h"
+#include "rte_member_ht.h"
+
+#if defined(RTE_ARCH_X86)
+#include "rte_member_x86.h"
+#endif
+
+int
+rte_member_create_ht(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	uint32_t num_entries;
+	struct member_ht_bucket *buckets;
+
+	num_entries = rte_align32pow2(params->num_keys);
+	if (num_entries == 0) {
+		RTE_MEMBER_LOG(ERR, "Too many keys for the hash table\n");
+		rte_errno = EINVAL;
+		return -EINVAL;
+	}
+	if (num_entries < RTE_MEMBER_BUCKET_ENTRIES)
+		num_entries = RTE_MEMBER_BUCKET_ENTRIES;
+
+	ss->bucket_cnt = num_entries / RTE_MEMBER_BUCKET_ENTRIES;
+	ss->bucket_mask = ss->bucket_cnt - 1;
+	ss->cache = params->is_cache;
+
+	buckets = rte_zmalloc_socket(ss->name,
+			ss->bucket_cnt * sizeof(struct member_ht_bucket),
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (buckets == NULL) {
+		RTE_MEMBER_LOG(ERR, "Memory allocation failed for the hash "
+			"table of %s\n", ss->name);
+		rte_errno = ENOMEM;
+		return -ENOMEM;
+	}
+	ss->table = buckets;
+
+	ss->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+#if defined(RTE_MACHINE_CPUFLAG_AVX2)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+#endif
+
+	RTE_MEMBER_LOG(DEBUG, "Hash table based set summary %s created, "
+		"%u buckets, %s mode\n", ss->name, ss->bucket_cnt,
+		ss->cache ? "cache" : "non-cache");
+	return 0;
+}
+
+/*
+ * The signature comes from the first hash of the key, and the bucket
+ * locations from a second hash of the first one.
+ *
+ * In non-cache mode, the secondary bucket is the primary one xored with
+ * the signature (partial-key cuckoo hashing, as in cuckoo filters), so the
+ * other bucket of an entry is known without its key when it has to be
+ * pushed out of the way or deleted.
+ *
+ * In cache mode, entries are never moved, so both buckets are taken from
+ * independent bits of the second hash, which spreads the keys better.
+ */
+static inline void
+get_buckets_index(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *prim_bkt, uint32_t *sec_bkt, member_sig_t *sig)
+{
+	uint32_t first_hash, sec_hash;
+
+	first_hash = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	sec_hash = MEMBER_HASH_FUNC(&first_hash, sizeof(first_hash),
+			ss->sec_hash_seed);
+
+	*sig = first_hash;
+	*prim_bkt = sec_hash & ss->bucket_mask;
+	if (ss->cache)
+		*sec_bkt = (sec_hash >> 16) & ss->bucket_mask;
+	else
+		*sec_bkt = (*prim_bkt ^ *sig) & ss->bucket_mask;
+}
+
+/*
+ * Search a bucket for the non-empty entries with a signature.
+ * Each matching entry has 2 bits set in the result, as returned by
+ * the vector compare.
+ */
+static inline uint32_t
+search_bucket(const struct rte_member_setsum *ss,
+		const struct member_ht_bucket *bkt, member_sig_t sig)
+{
+	uint32_t i, hits = 0;
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX2)
+	if (ss->sig_cmp_fn == RTE_MEMBER_COMPARE_AVX2)
+		return search_bucket_avx(bkt, sig);
+#else
+	RTE_SET_USED(ss);
+#endif
+	for (i = 0; i < RTE_MEMBER_BUCKET_ENTRIES; i++) {
+		if (bkt->sigs[i] == sig && bkt->sets[i] != RTE_MEMBER_NO_MATCH)
+			hits |= 3U << (i * 2);
+	}
+	return hits;
+}
+
+/* Search a bucket for empty entries, 2 bits per entry. */
+static inline uint32_t
+search_empty(const struct rte_member_setsum *ss,
+		const struct member_ht_bucket *bkt)
+{
+	uint32_t i, empty = 0;
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX2)
+	if (ss->sig_cmp_fn == RTE_MEMBER_COMPARE_AVX2)
+		return search_empty_avx(bkt);
+#else
+	RTE_SET_USED(ss);
+#endif
+	for (i = 0; i < RTE_MEMBER_BUCKET_ENTRIES; i++) {
+		if (bkt->sets[i] == RTE_MEMBER_NO_MATCH)
+			empty |= 3U << (i * 2);
+	}
+	return empty;
+}
+
+/* Remove the first entry from a search result and return its index. */
+static inline uint32_t
+next_entry(uint32_t *hits)
+{
+	uint32_t i = rte_bsf32(*hits) / 2;
+
+	*hits &= ~(3U << (i * 2));
+	return i;
+}
+
+/* Set id of an entry, without the flag of the entries being pushed. */
+static inline member_set_t
+entry_set(const struct member_ht_bucket *bkt, uint32_t i)
+{
+	return bkt->sets[i] & ~MEMBER_PUSHED_FLAG;
+}
+
+/*
+ * Write an entry. The entry is emptied while its signature changes, so
+ * that concurrent lookups never see a signature with the wrong set.
+ */
+static inline void
+write_entry(struct member_ht_bucket *bkt, uint32_t i, member_sig_t sig,
+		member_set_t set_id)
+{
+	bkt->sets[i] = RTE_MEMBER_NO_MATCH;
+	rte_smp_wmb();
+	bkt->sigs[i] = sig;
+	rte_smp_wmb();
+	bkt->sets[i] = set_id;
+}
+
+static inline int
+search_single(const struct rte_member_setsum *ss,
+		const struct member_ht_bucket *bkt, member_sig_t sig,
+		member_set_t *set_id)
+{
+	uint32_t hits;
+
+	hits = search_bucket(ss, bkt, sig);
+	if (hits == 0)
+		return 0;
+
+	*set_id = entry_set(bkt, next_entry(&hits));
+	return 1;
+}
+
+static inline void
+search_multi(const struct rte_member_setsum *ss,
+		const struct member_ht_bucket *bkt, member_sig_t sig,
+		uint32_t *match_count, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	uint32_t hits;
+
+	hits = search_bucket(ss, bkt, sig);
+	while (hits != 0 && *match_count < match_per_key)
+		set_id[(*match_count)++] = entry_set(bkt, next_entry(&hits));
+}
+
+int
+rte_member_lookup_ht(const struct rte_member_setsum *ss,
+		const void *key, member_set_t *set_id)
+{
+	uint32_t prim_bkt, sec_bkt;
+	member_sig_t sig;
+	const struct member_ht_bucket *buckets = ss->table;
+
+	get_buckets_index(ss, key, &prim_bkt, &sec_bkt, &sig);
+
+	if (search_single(ss, &buckets[prim_bkt], sig, set_id) ||
+			search_single(ss, &buckets[sec_bkt], sig, set_id))
+		return 1;
+
+	*set_id = RTE_MEMBER_NO_MATCH;
+	return 0;
+}
+
+int
+rte_member_lookup_bulk_ht(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i, num_matches = 0;
+	uint32_t prim_bkts[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_bkts[RTE_MEMBER_LOOKUP_BULK_MAX];
+	member_sig_t sigs[RTE_MEMBER_LOOKUP_BULK_MAX];
+	const struct member_ht_bucket *buckets = ss->table;
+
+	/* Hash all the keys first, prefetching their buckets. */
+	for (i = 0; i < num_keys; i++) {
+		get_buckets_index(ss, keys[i], &prim_bkts[i], &sec_bkts[i],
+				&sigs[i]);
+		rte_prefetch0(&buckets[prim_bkts[i]]);
+		rte_prefetch0(&buckets[sec_bkts[i]]);
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		if (search_single(ss, &buckets[prim_bkts[i]], sigs[i],
+					&set_ids[i]) ||
+				search_single(ss, &buckets[sec_bkts[i]],
+					sigs[i], &set_ids[i]))
+			num_matches++;
+		else
+			set_ids[i] = RTE_MEMBER_NO_MATCH;
+	}
+	return num_matches;
+}
+
+int
+rte_member_lookup_multi_ht(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	uint32_t num_matches = 0;
+	uint32_t prim_bkt, sec_bkt;
+	member_sig_t sig;
+	const struct member_ht_bucket *buckets = ss->table;
+
+	get_buckets_index(ss, key, &prim_bkt, &sec_bkt, &sig);
+
+	search_multi(ss, &buckets[prim_bkt], sig, &num_matches,
+			match_per_key, set_id);
+	if (sec_bkt != prim_bkt)
+		search_multi(ss, &buckets[sec_bkt], sig, &num_matches,
+				match_per_key, set_id);
+	return num_matches;
+}
+
+int
+rte_member_lookup_multi_bulk_ht(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count, member_set_t *set_ids)
+{
+	uint32_t i, num_matches = 0;
+	uint32_t prim_bkts[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_bkts[RTE_MEMBER_LOOKUP_BULK_MAX];
+	member_sig_t sigs[RTE_MEMBER_LOOKUP_BULK_MAX];
+	const struct member_ht_bucket *buckets = ss->table;
+
+	for (i = 0; i < num_keys; i++) {
+		get_buckets_index(ss, keys[i], &prim_bkts[i], &sec_bkts[i],
+				&sigs[i]);
+		rte_prefetch0(&buckets[prim_bkts[i]]);
+		rte_prefetch0(&buckets[sec_bkts[i]]);
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		match_count[i] = 0;
+		search_multi(ss, &buckets[prim_bkts[i]], sigs[i],
+				&match_count[i], match_per_key,
+				&set_ids[i * match_per_key]);
+		if (sec_bkts[i] != prim_bkts[i])
+			search_multi(ss, &buckets[sec_bkts[i]], sigs[i],
+					&match_count[i], match_per_key,
+					&set_ids[i * match_per_key]);
+		if (match_count[i] != 0)
+			num_matches++;
+	}
+	return num_matches;
+}
+
+/* Cache mode: give the entry with the same signature the new set id. */
+static inline int
+try_update(const struct rte_member_setsum *ss, struct member_ht_bucket *bkt,
+		member_sig_t sig, member_set_t set_id)
+{
+	uint32_t hits;
+
+	hits = search_bucket(ss, bkt, sig);
+	if (hits == 0)
+		return 0;
+
+	bkt->sets[next_entry(&hits)] = set_id;
+	return 1;
+}
+
+static inline int
+try_insert(const struct rte_member_setsum *ss, struct member_ht_bucket *bkt,
+		member_sig_t sig, member_set_t set_id)
+{
+	uint32_t empty;
+
+	empty = search_empty(ss, bkt);
+	if (empty == 0)
+		return 0;
+
+	write_entry(bkt, next_entry(&empty), sig, set_id);
+	return 1;
+}
+
+/*
+ * Make room in a full bucket by moving one of its entries to its other
+ * bucket, recursively if that one is full too. The entries on the
+ * current path are flagged so that they are not pushed back.
+ * The moved entry is copied before being overwritten by the caller,
+ * so concurrent lookups always find it in one of its buckets.
+ * Returns the index of the freed entry, or -ENOSPC.
+ */
+static int
+make_space_bucket(const struct rte_member_setsum *ss, uint32_t bkt_idx,
+		unsigned int *nr_pushes)
+{
+	unsigned int i;
+	int ret;
+	uint32_t empty, alt_idx;
+	struct member_ht_bucket *buckets = ss->table;
+	struct member_ht_bucket *bkt = &buckets[bkt_idx];
+	struct member_ht_bucket *alt;
+
+	/* Look for an entry whose other bucket has room. */
+	for (i = 0; i < RTE_MEMBER_BUCKET_ENTRIES; i++) {
+		if (bkt->sets[i] & MEMBER_PUSHED_FLAG)
+			continue;
+
+		alt = &buckets[(bkt->sigs[i] ^ bkt_idx) & ss->bucket_mask];
+		empty = search_empty(ss, alt);
+		if (empty != 0) {
+			write_entry(alt, next_entry(&empty), bkt->sigs[i],
+					bkt->sets[i]);
+			return i;
+		}
+	}
+
+	/* Pick an entry that is not on the path yet, and push it. */
+	for (i = 0; i < RTE_MEMBER_BUCKET_ENTRIES; i++) {
+		if ((bkt->sets[i] & MEMBER_PUSHED_FLAG) == 0)
+			break;
+	}
+
+	if (i == RTE_MEMBER_BUCKET_ENTRIES ||
+			++(*nr_pushes) > RTE_MEMBER_MAX_PUSHES)
+		return -ENOSPC;
+
+	alt_idx = (bkt->sigs[i] ^ bkt_idx) & ss->bucket_mask;
+
+	bkt->sets[i] |= MEMBER_PUSHED_FLAG;
+	ret = make_space_bucket(ss, alt_idx, nr_pushes);
+	bkt->sets[i] &= ~MEMBER_PUSHED_FLAG;
+
+	if (ret < 0)
+		return ret;
+
+	write_entry(&buckets[alt_idx], ret, bkt->sigs[i], bkt->sets[i]);
+	return i;
+}
+
+int
+rte_member_add_ht(const struct rte_member_setsum *ss,
+		const void *key, member_set_t set_id)
+{
+	int ret;
+	unsigned int nr_pushes = 0;
+	uint32_t prim_bkt, sec_bkt, bkt_idx;
+	member_sig_t sig;
+	struct member_ht_bucket *buckets = ss->table;
+
+	if (set_id == RTE_MEMBER_NO_MATCH || set_id > RTE_MEMBER_HT_MAX_SET_ID)
+		return -EINVAL;
+
+	get_buckets_index(ss, key, &prim_bkt, &sec_bkt, &sig);
+
+	/*
+	 * In cache mode, the entry of a key with the same signature is
+	 * reused: the summary only has to remember the most recent keys.
+	 * In non-cache mode, this would turn the other key into a false
+	 * negative, so a new entry is always added and a key may belong
+	 * to several sets.
+	 */
+	if (ss->cache &&
+			(try_update(ss, &buckets[prim_bkt], sig, set_id) ||
+			try_update(ss, &buckets[sec_bkt], sig, set_id)))
+		return 0;
+
+	if (try_insert(ss, &buckets[prim_bkt], sig, set_id) ||
+			try_insert(ss, &buckets[sec_bkt], sig, set_id))
+		return 0;
+
+	/* Both buckets are full, pick one of them from the signature. */
+	bkt_idx = (sig & 1) ? prim_bkt : sec_bkt;
+
+	if (ss->cache) {
+		write_entry(&buckets[bkt_idx],
+			rte_rand() & (RTE_MEMBER_BUCKET_ENTRIES - 1),
+			sig, set_id);
+		return 1;
+	}
+
+	ret = make_space_bucket(ss, bkt_idx, &nr_pushes);
+	if (ret < 0)
+		return ret;
+
+	write_entry(&buckets[bkt_idx], ret, sig, set_id);
+	return 0;
+}
+
+int
+rte_member_delete_ht(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id)
+{
+	uint32_t i, hits;
+	uint32_t bkt_idx[2];
+	member_sig_t sig;
+	struct member_ht_bucket *buckets = ss->table;
+	struct member_ht_bucket *bkt;
+
+	get_buckets_index(ss, key, &bkt_idx[0], &bkt_idx[1], &sig);
+
+	for (i = 0; i < RTE_DIM(bkt_idx); i++) {
+		bkt = &buckets[bkt_idx[i]];
+		hits = search_bucket(ss, bkt, sig);
+		while (hits != 0) {
+			uint32_t n = next_entry(&hits);
+
+			if (bkt->sets[n] == set_id) {
+				bkt->sets[n] = RTE_MEMBER_NO_MATCH;
+				return 0;
+			}
+		}
+	}
+	return -ENOENT;
+}
+
+void
+rte_member_reset_ht(const struct rte_member_setsum *ss)
+{
+	memset(ss->table, 0, ss->bucket_cnt * sizeof(struct member_ht_bucket));
+}
+
+void
+rte_member_free_ht(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
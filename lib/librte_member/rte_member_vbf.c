@@ -0,0 +1,291 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <errno.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+
+#include "rte_member.h"
+#include "rte_member_vbf.h"
+
+/*
+ * The filters are interleaved: the bits of all the sets for a same
+ * position are next to each other, so that one 32-bit read tests a
+ * position for all the sets at once. Each position takes the number of
+ * sets rounded up to a power of 2 bits.
+ */
+
+int
+rte_member_create_vbf(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	uint32_t lane, num_keys_per_bf, k;
+	double fp_one_bf, num_bits, fp;
+
+	if (params->num_set == 0 || params->num_set > RTE_MEMBER_MAX_BF ||
+			!(params->false_positive_rate > 0) ||
+			!(params->false_positive_rate < 1)) {
+		RTE_MEMBER_LOG(ERR, "vBF needs 1 to %u sets and a false "
+			"positive rate between 0 and 1\n", RTE_MEMBER_MAX_BF);
+		rte_errno = EINVAL;
+		return -EINVAL;
+	}
+
+	ss->num_set = params->num_set;
+	lane = rte_align32pow2(ss->num_set);
+	ss->mul_shift = rte_bsf32(lane);
+
+	num_keys_per_bf = 1 + (params->num_keys - 1) / ss->num_set;
+
+	/*
+	 * A key which was not added matches none of the filters with the
+	 * probability (1 - p)^num_set, p being the false positive rate of
+	 * each filter.
+	 */
+	fp_one_bf = 1 - pow(1 - params->false_positive_rate,
+			1.0 / ss->num_set);
+
+	/*
+	 * The best size of a filter of n keys for a rate p is
+	 * -n * ln(p) / ln(2)^2 bits, rounded up here to a power of 2
+	 * so that a bit position is a hash value masked.
+	 */
+	num_bits = ceil(-(double)num_keys_per_bf * log(fp_one_bf) /
+			(M_LN2 * M_LN2));
+	if (num_bits > (double)(1U << 31) / lane) {
+		RTE_MEMBER_LOG(ERR, "vBF %s would be too large\n", ss->name);
+		rte_errno = EINVAL;
+		return -EINVAL;
+	}
+	ss->bits = rte_align32pow2(RTE_MAX((uint32_t)num_bits, 32U));
+	ss->bit_mask = ss->bits - 1;
+
+	/*
+	 * The rounding leaves some room: take the fewest hash functions
+	 * meeting the rate, which is the number of reads per lookup.
+	 */
+	for (k = 1; k < RTE_MEMBER_VBF_MAX_HASHES; k++) {
+		fp = pow(1 - exp(-(double)k * num_keys_per_bf / ss->bits), k);
+		if (fp <= fp_one_bf)
+			break;
+	}
+	ss->num_hashes = k;
+
+	ss->table = rte_zmalloc_socket(ss->name,
+			(size_t)ss->bits * lane / CHAR_BIT,
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (ss->table == NULL) {
+		RTE_MEMBER_LOG(ERR, "Memory allocation failed for the vBF "
+			"of %s\n", ss->name);
+		rte_errno = ENOMEM;
+		return -ENOMEM;
+	}
+
+	RTE_MEMBER_LOG(DEBUG, "vBF %s created, %u sets, %u bits and "
+		"%u hashes per set\n", ss->name, ss->num_set, ss->bits,
+		ss->num_hashes);
+	return 0;
+}
+
+/*
+ * The bit positions of a key are h1 + i * h2 (double hashing), h2 being
+ * odd so that the positions don't repeat before going around the filter.
+ */
+static inline void
+get_hashes(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *h1, uint32_t *h2)
+{
+	*h1 = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	*h2 = MEMBER_HASH_FUNC(h1, sizeof(*h1), ss->sec_hash_seed) | 1;
+}
+
+/* Bits of all the sets at a position, in the low bits of the result. */
+static inline uint32_t
+test_bits(const struct rte_member_setsum *ss, uint32_t bit_loc)
+{
+	const uint32_t *vbf = ss->table;
+	uint32_t ofs = bit_loc << ss->mul_shift;
+
+	return vbf[ofs / 32] >> (ofs % 32);
+}
+
+static inline uint32_t
+all_sets_mask(const struct rte_member_setsum *ss)
+{
+	return (uint32_t)((1ULL << ss->num_set) - 1);
+}
+
+/* Mask of the sets a key matches. */
+static inline uint32_t
+lookup_sets(const struct rte_member_setsum *ss, const void *key)
+{
+	uint32_t i, h1, h2;
+	uint32_t mask = all_sets_mask(ss);
+
+	get_hashes(ss, key, &h1, &h2);
+
+	for (i = 0; i < ss->num_hashes && mask != 0; i++)
+		mask &= test_bits(ss, (h1 + i * h2) & ss->bit_mask);
+
+	return mask;
+}
+
+/* Same as lookup_sets() for several keys, reading their bits together. */
+static inline void
+lookup_sets_bulk(const struct rte_member_setsum *ss, const void **keys,
+		uint32_t num_keys, uint32_t *mask)
+{
+	uint32_t i, j;
+	uint32_t h1[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t h2[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (j = 0; j < num_keys; j++) {
+		get_hashes(ss, keys[j], &h1[j], &h2[j]);
+		mask[j] = all_sets_mask(ss);
+	}
+
+	for (i = 0; i < ss->num_hashes; i++) {
+		for (j = 0; j < num_keys; j++)
+			mask[j] &= test_bits(ss,
+					(h1[j] + i * h2[j]) & ss->bit_mask);
+	}
+}
+
+static inline uint32_t
+mask_to_sets(uint32_t mask, uint32_t match_per_key, member_set_t *set_id)
+{
+	uint32_t num_matches = 0;
+
+	while (mask != 0 && num_matches < match_per_key) {
+		set_id[num_matches++] = rte_bsf32(mask) + 1;
+		mask &= mask - 1;
+	}
+	return num_matches;
+}
+
+int
+rte_member_lookup_vbf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t *set_id)
+{
+	uint32_t mask;
+
+	mask = lookup_sets(ss, key);
+	if (mask == 0) {
+		*set_id = RTE_MEMBER_NO_MATCH;
+		return 0;
+	}
+
+	*set_id = rte_bsf32(mask) + 1;
+	return 1;
+}
+
+int
+rte_member_lookup_bulk_vbf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i, num_matches = 0;
+	uint32_t mask[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	lookup_sets_bulk(ss, keys, num_keys, mask);
+
+	for (i = 0; i < num_keys; i++) {
+		if (mask[i] != 0) {
+			set_ids[i] = rte_bsf32(mask[i]) + 1;
+			num_matches++;
+		} else
+			set_ids[i] = RTE_MEMBER_NO_MATCH;
+	}
+	return num_matches;
+}
+
+int
+rte_member_lookup_multi_vbf(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	return mask_to_sets(lookup_sets(ss, key), match_per_key, set_id);
+}
+
+int
+rte_member_lookup_multi_bulk_vbf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count, member_set_t *set_ids)
+{
+	uint32_t i, num_matches = 0;
+	uint32_t mask[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	lookup_sets_bulk(ss, keys, num_keys, mask);
+
+	for (i = 0; i < num_keys; i++) {
+		match_count[i] = mask_to_sets(mask[i], match_per_key,
+				&set_ids[i * match_per_key]);
+		if (match_count[i] != 0)
+			num_matches++;
+	}
+	return num_matches;
+}
+
+int
+rte_member_add_vbf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id)
+{
+	uint32_t i, h1, h2, ofs;
+	uint32_t *vbf = ss->table;
+
+	if (set_id == RTE_MEMBER_NO_MATCH || set_id > ss->num_set)
+		return -EINVAL;
+
+	get_hashes(ss, key, &h1, &h2);
+
+	for (i = 0; i < ss->num_hashes; i++) {
+		ofs = (((h1 + i * h2) & ss->bit_mask) << ss->mul_shift) +
+			set_id - 1;
+		vbf[ofs / 32] |= 1U << (ofs % 32);
+	}
+	return 0;
+}
+
+void
+rte_member_reset_vbf(const struct rte_member_setsum *ss)
+{
+	memset(ss->table, 0, ((size_t)ss->bits << ss->mul_shift) / CHAR_BIT);
+}
+
+void
+rte_member_free_vbf(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
@@ -0,0 +1,81 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_MEMBER_X86_H_
+#define _RTE_MEMBER_X86_H_
+
+#include <x86intrin.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX2)
+
+/*
+ * Compare the 16 signatures of a bucket at once, like the cuckoo hash
+ * bulk lookup does. Returns 2 bits per non-empty entry with the signature.
+ */
+static inline uint32_t
+search_bucket_avx(const struct member_ht_bucket *bkt, member_sig_t sig)
+{
+	__m256i sigs, sets, hit, empty;
+
+	sigs = _mm256_load_si256((const __m256i *)bkt->sigs);
+	sets = _mm256_load_si256((const __m256i *)bkt->sets);
+
+	hit = _mm256_cmpeq_epi16(sigs, _mm256_set1_epi16(sig));
+	empty = _mm256_cmpeq_epi16(sets, _mm256_setzero_si256());
+
+	return _mm256_movemask_epi8(_mm256_andnot_si256(empty, hit));
+}
+
+/* Returns 2 bits per empty entry of a bucket. */
+static inline uint32_t
+search_empty_avx(const struct member_ht_bucket *bkt)
+{
+	__m256i sets;
+
+	sets = _mm256_load_si256((const __m256i *)bkt->sets);
+
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi16(sets,
+		_mm256_setzero_si256()));
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_X86_H_ */
@@ -128,7 +128,8 @@ static unsigned optimize_object_size(unsigned obj_size)
 }
 
 static void
-mempool_add_elem(struct rte_mempool *mp, void *obj, phys_addr_t physaddr)
+mempool_add_elem(struct rte_mempool *mp, __rte_unused void *opaque,
+		 void *obj, phys_addr_t physaddr)
 {
 	struct rte_mempool_objhdr *hdr;
 	struct rte_mempool_objtlr *tlr __rte_unused;
@@ -168,6 +169,189 @@ rte_mempool_obj_iter(struct rte_mempool *mp,
 	return n;
 }
 
+/* minimum number of objects to split the iteration between lcores */
+#define MEMPOOL_OBJ_ITER_PARALLEL_MIN 4096
+/* number of jobs per lcore, to balance the work */
+#define MEMPOOL_OBJ_ITER_JOBS_PER_LCORE 4
+
+/* a set of consecutive objects, processed by one lcore */
+struct mempool_obj_iter_job {
+	struct rte_mempool_objhdr *first; /* header of the first object */
+	uint32_t n;                       /* number of objects */
+	uint32_t idx;                     /* index of the first object */
+	int socket_id;                    /* socket of the objects memory */
+	rte_atomic32_t taken;             /* set by the lcore processing it */
+};
+
+struct mempool_obj_iter_ctx {
+	struct rte_mempool *mp;
+	rte_mempool_obj_cb_t *obj_cb;
+	void *obj_cb_arg;
+	struct mempool_obj_iter_job *jobs;
+	uint32_t n_jobs;
+};
+
+/* return the socket of a memory chunk, or SOCKET_ID_ANY if unknown */
+static int
+mempool_memchunk_socket(const struct rte_mempool_memhdr *memhdr)
+{
+	const struct rte_memseg *ms = rte_eal_get_physmem_layout();
+	const char *addr = memhdr->addr;
+	unsigned int i;
+
+	for (i = 0; i < RTE_MAX_MEMSEG && ms[i].addr != NULL; i++) {
+		if (addr >= (const char *)ms[i].addr &&
+				addr < (const char *)ms[i].addr + ms[i].len)
+			return ms[i].socket_id;
+	}
+
+	return SOCKET_ID_ANY;
+}
+
+/* take a job on the given socket (any job if SOCKET_ID_ANY) */
+static struct mempool_obj_iter_job *
+mempool_obj_iter_take_job(struct mempool_obj_iter_ctx *ctx, int socket_id)
+{
+	struct mempool_obj_iter_job *job;
+	uint32_t i;
+
+	for (i = 0; i < ctx->n_jobs; i++) {
+		job = &ctx->jobs[i];
+		if (socket_id != SOCKET_ID_ANY && job->socket_id != socket_id)
+			continue;
+		if (rte_atomic32_test_and_set(&job->taken))
+			return job;
+	}
+
+	return NULL;
+}
+
+/* process the jobs of the local socket first, then help the other ones */
+static int
+mempool_obj_iter_worker(void *arg)
+{
+	struct mempool_obj_iter_ctx *ctx = arg;
+	int socket_id = rte_socket_id();
+	struct mempool_obj_iter_job *job;
+	struct rte_mempool_objhdr *hdr;
+	uint32_t i;
+
+	for (;;) {
+		job = mempool_obj_iter_take_job(ctx, socket_id);
+		if (job == NULL)
+			job = mempool_obj_iter_take_job(ctx, SOCKET_ID_ANY);
+		if (job == NULL)
+			break;
+
+		hdr = job->first;
+		for (i = 0; i < job->n; i++) {
+			ctx->obj_cb(ctx->mp, ctx->obj_cb_arg,
+				(char *)hdr + sizeof(*hdr), job->idx + i);
+			hdr = STAILQ_NEXT(hdr, next);
+		}
+	}
+
+	return 0;
+}
+
+/* call obj_cb() for each mempool element, using the idle lcores */
+uint32_t
+rte_mempool_obj_iter_parallel(struct rte_mempool *mp,
+	rte_mempool_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct mempool_obj_iter_ctx ctx;
+	struct mempool_obj_iter_job *job;
+	struct rte_mempool_memhdr *memhdr;
+	struct rte_mempool_objhdr *hdr;
+	uint8_t launched[RTE_MAX_LCORE];
+	unsigned int lcore_id, n_lcores = 1;
+	uint32_t job_size, max_jobs, n = 0;
+	int socket_id;
+
+	/* only the master lcore can launch functions on the other ones */
+	if (rte_lcore_id() != rte_get_master_lcore() ||
+			mp->populated_size < MEMPOOL_OBJ_ITER_PARALLEL_MIN)
+		return rte_mempool_obj_iter(mp, obj_cb, obj_cb_arg);
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (rte_eal_get_lcore_state(lcore_id) == WAIT)
+			n_lcores++;
+	}
+	if (n_lcores == 1)
+		return rte_mempool_obj_iter(mp, obj_cb, obj_cb_arg);
+
+	/*
+	 * Split the object list into jobs. A job does not span memory
+	 * chunks of different sockets, so that it is processed by an lcore
+	 * close to the memory when possible.
+	 */
+	job_size = mp->populated_size /
+		(n_lcores * MEMPOOL_OBJ_ITER_JOBS_PER_LCORE) + 1;
+	max_jobs = mp->populated_size / job_size + mp->nb_mem_chunks + 1;
+	ctx.jobs = rte_zmalloc("MEMPOOL_ITER_JOBS",
+		max_jobs * sizeof(*ctx.jobs), 0);
+	if (ctx.jobs == NULL)
+		return rte_mempool_obj_iter(mp, obj_cb, obj_cb_arg);
+
+	ctx.mp = mp;
+	ctx.obj_cb = obj_cb;
+	ctx.obj_cb_arg = obj_cb_arg;
+	ctx.n_jobs = 0;
+
+	/* the objects are listed in the order of their memory chunks */
+	memhdr = STAILQ_FIRST(&mp->mem_list);
+	socket_id = memhdr != NULL ? mempool_memchunk_socket(memhdr) :
+		SOCKET_ID_ANY;
+	job = NULL;
+	STAILQ_FOREACH(hdr, &mp->elt_list, next) {
+		while (memhdr != NULL &&
+				((char *)hdr < (char *)memhdr->addr ||
+				 (char *)hdr >= (char *)memhdr->addr +
+					memhdr->len)) {
+			memhdr = STAILQ_NEXT(memhdr, next);
+			socket_id = memhdr != NULL ?
+				mempool_memchunk_socket(memhdr) :
+				SOCKET_ID_ANY;
+		}
+
+		if (job == NULL || job->n == job_size ||
+				job->socket_id != socket_id) {
+			if (ctx.n_jobs == max_jobs)
+				break;
+			job = &ctx.jobs[ctx.n_jobs++];
+			job->first = hdr;
+			job->idx = n;
+			job->socket_id = socket_id;
+			rte_atomic32_init(&job->taken);
+		}
+		job->n++;
+		n++;
+	}
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		launched[lcore_id] = 0;
+		if (rte_eal_get_lcore_state(lcore_id) == WAIT &&
+				rte_eal_remote_launch(mempool_obj_iter_worker,
+					&ctx, lcore_id) == 0)
+			launched[lcore_id] = 1;
+	}
+	mempool_obj_iter_worker(&ctx);
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (launched[lcore_id])
+			rte_eal_wait_lcore(lcore_id);
+	}
+
+	/* objects left if the jobs table was too small (should not happen) */
+	for (; hdr != NULL; hdr = STAILQ_NEXT(hdr, next)) {
+		obj_cb(mp, obj_cb_arg, (char *)hdr + sizeof(*hdr), n);
+		n++;
+	}
+
+	rte_free(ctx.jobs);
+
+	return n;
+}
+
 /* call mem_cb() for each mempool memory chunk */
 uint32_t
 rte_mempool_mem_iter(struct rte_mempool *mp,
@@ -339,6 +523,21 @@ rte_mempool_free_memchunks(struct rte_mempool *mp)
 	}
 }
 
+/* create the internal ring if not already done */
+static int
+mempool_ops_alloc_once(struct rte_mempool *mp)
+{
+	int ret;
+
+	if ((mp->flags & MEMPOOL_F_POOL_CREATED) == 0) {
+		ret = rte_mempool_ops_alloc(mp);
+		if (ret != 0)
+			return ret;
+		mp->flags |= MEMPOOL_F_POOL_CREATED;
+	}
+	return 0;
+}
+
 /* Add objects in the pool, using a physically contiguous memory
  * zone. Return the number of objects added, or a negative value
  * on error.
@@ -348,26 +547,17 @@ rte_mempool_populate_phys(struct rte_mempool *mp, char *vaddr,
 	phys_addr_t paddr, size_t len, rte_mempool_memchunk_free_cb_t *free_cb,
 	void *opaque)
 {
-	unsigned total_elt_sz;
-	unsigned i = 0;
-	size_t off;
 	struct rte_mempool_memhdr *memhdr;
 	int ret;
 
-	/* create the internal ring if not already done */
-	if ((mp->flags & MEMPOOL_F_POOL_CREATED) == 0) {
-		ret = rte_mempool_ops_alloc(mp);
-		if (ret != 0)
-			return ret;
-		mp->flags |= MEMPOOL_F_POOL_CREATED;
-	}
+	ret = mempool_ops_alloc_once(mp);
+	if (ret != 0)
+		return ret;
 
 	/* mempool is already populated */
 	if (mp->populated_size >= mp->size)
 		return -ENOSPC;
 
-	total_elt_sz = mp->header_size + mp->elt_size + mp->trailer_size;
-
 	memhdr = rte_zmalloc("MEMPOOL_MEMHDR", sizeof(*memhdr), 0);
 	if (memhdr == NULL)
 		return -ENOMEM;
@@ -379,29 +569,20 @@ rte_mempool_populate_phys(struct rte_mempool *mp, char *vaddr,
 	memhdr->free_cb = free_cb;
 	memhdr->opaque = opaque;
 
-	if (mp->flags & MEMPOOL_F_NO_CACHE_ALIGN)
-		off = RTE_PTR_ALIGN_CEIL(vaddr, 8) - vaddr;
-	else
-		off = RTE_PTR_ALIGN_CEIL(vaddr, RTE_CACHE_LINE_SIZE) - vaddr;
-
-	while (off + total_elt_sz <= len && mp->populated_size < mp->size) {
-		off += mp->header_size;
-		if (paddr == RTE_BAD_PHYS_ADDR)
-			mempool_add_elem(mp, (char *)vaddr + off,
-				RTE_BAD_PHYS_ADDR);
-		else
-			mempool_add_elem(mp, (char *)vaddr + off, paddr + off);
-		off += mp->elt_size + mp->trailer_size;
-		i++;
-	}
+	ret = rte_mempool_ops_populate(mp, mp->size - mp->populated_size,
+		vaddr, paddr, len, mempool_add_elem, NULL);
 
 	/* not enough room to store one object */
-	if (i == 0)
-		return -EINVAL;
+	if (ret == 0)
+		ret = -EINVAL;
+	if (ret < 0) {
+		rte_free(memhdr);
+		return ret;
+	}
 
 	STAILQ_INSERT_TAIL(&mp->mem_list, memhdr, next);
 	mp->nb_mem_chunks++;
-	return i;
+	return ret;
 }
 
 /* Add objects in the pool, using a table of physical pages. Return the
@@ -518,7 +699,8 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	int mz_flags = RTE_MEMZONE_1GB|RTE_MEMZONE_SIZE_HINT_ONLY;
 	char mz_name[RTE_MEMZONE_NAMESIZE];
 	const struct rte_memzone *mz;
-	size_t size, total_elt_sz, align, pg_sz, pg_shift;
+	size_t align, pg_sz, pg_shift;
+	ssize_t size;
 	phys_addr_t paddr;
 	unsigned mz_id, n;
 	int ret;
@@ -527,6 +709,11 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	if (mp->nb_mem_chunks != 0)
 		return -EEXIST;
 
+	/* the handler may need its private data to compute the size */
+	ret = mempool_ops_alloc_once(mp);
+	if (ret != 0)
+		return ret;
+
 	if (rte_xen_dom0_supported()) {
 		pg_sz = RTE_PGSIZE_2M;
 		pg_shift = rte_bsf32(pg_sz);
@@ -541,9 +728,12 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 		align = pg_sz;
 	}
 
-	total_elt_sz = mp->header_size + mp->elt_size + mp->trailer_size;
 	for (mz_id = 0, n = mp->size; n > 0; mz_id++, n -= ret) {
-		size = rte_mempool_xmem_size(n, total_elt_sz, pg_shift);
+		size = rte_mempool_ops_calc_mem_size(mp, n, pg_shift, &align);
+		if (size < 0) {
+			ret = size;
+			goto fail;
+		}
 
 		ret = snprintf(mz_name, sizeof(mz_name),
 			RTE_MEMPOOL_MZ_FORMAT "_%d", mp->name, mz_id);
@@ -644,6 +834,10 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 
 	ret = rte_mempool_populate_virt(mp, addr, size, getpagesize(),
 		rte_mempool_memchunk_anon_free, addr);
+	if (ret < 0) {
+		rte_errno = -ret;
+		goto fail;
+	}
 	if (ret == 0)
 		goto fail;
 
@@ -1098,6 +1292,39 @@ void rte_mempool_check_cookies(const struct rte_mempool *mp,
 #endif
 }
 
+/* check and update cookies of contiguous blocks or panic (internal) */
+void rte_mempool_contig_blocks_check_cookies(const struct rte_mempool *mp,
+	void * const *first_obj_table_const, unsigned int n, int free)
+{
+#ifdef RTE_LIBRTE_MEMPOOL_DEBUG
+	struct rte_mempool_info info;
+	const size_t total_elt_sz =
+		mp->header_size + mp->elt_size + mp->trailer_size;
+	unsigned int i, j;
+
+	if (rte_mempool_ops_get_info(mp, &info) != 0 ||
+			info.contig_block_size == 0)
+		rte_panic("MEMPOOL: contiguous blocks are not supported\n");
+
+	for (i = 0; i < n; ++i) {
+		void *first_obj = first_obj_table_const[i];
+
+		for (j = 0; j < info.contig_block_size; ++j) {
+			void *obj;
+
+			obj = (void *)((uintptr_t)first_obj +
+				j * total_elt_sz);
+			rte_mempool_check_cookies(mp, &obj, 1, free);
+		}
+	}
+#else
+	RTE_SET_USED(mp);
+	RTE_SET_USED(first_obj_table_const);
+	RTE_SET_USED(n);
+	RTE_SET_USED(free);
+#endif
+}
+
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 static void
 mempool_obj_audit(struct rte_mempool *mp, __rte_unused void *opaque,
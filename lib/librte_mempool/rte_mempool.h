@@ -67,6 +67,7 @@
 #include <stdint.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <sys/types.h>
 #include <sys/queue.h>
 
 #include <rte_spinlock.h>
@@ -346,11 +347,33 @@ static inline struct rte_mempool_objtlr *__mempool_get_trailer(void *obj)
 void rte_mempool_check_cookies(const struct rte_mempool *mp,
 	void * const *obj_table_const, unsigned n, int free);
 
+/**
+ * @internal Check and update cookies of contiguous object blocks or panic.
+ *
+ * @param mp
+ *   Pointer to the memory pool.
+ * @param first_obj_table_const
+ *   Pointer to a table of void * pointers (first objects of the blocks).
+ * @param n
+ *   Number of blocks in the table.
+ * @param free
+ *   Same meaning as in rte_mempool_check_cookies().
+ */
+void rte_mempool_contig_blocks_check_cookies(const struct rte_mempool *mp,
+	void * const *first_obj_table_const, unsigned int n, int free);
+
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 #define __mempool_check_cookies(mp, obj_table_const, n, free) \
 	rte_mempool_check_cookies(mp, obj_table_const, n, free)
+#define __mempool_contig_blocks_check_cookies(mp, first_obj_table_const, n, \
+					      free) \
+	rte_mempool_contig_blocks_check_cookies(mp, first_obj_table_const, n, \
+						free)
 #else
 #define __mempool_check_cookies(mp, obj_table_const, n, free) do {} while(0)
+#define __mempool_contig_blocks_check_cookies(mp, first_obj_table_const, n, \
+					      free) \
+	do {} while (0)
 #endif /* RTE_LIBRTE_MEMPOOL_DEBUG */
 
 #define RTE_MEMPOOL_OPS_NAMESIZE 32 /**< Max length of ops struct name. */
@@ -389,6 +412,96 @@ typedef int (*rte_mempool_dequeue_t)(struct rte_mempool *mp,
  */
 typedef unsigned (*rte_mempool_get_count)(const struct rte_mempool *mp);
 
+/**
+ * Calculate the memory size required to store the given number of objects.
+ *
+ * The pool memory is allocated in chunks of at least this size. The
+ * function may also increase the alignment required for the start of a
+ * chunk, for instance when the handler needs to find some metadata from
+ * the address of an object.
+ *
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ * @param[in] obj_num
+ *   Number of objects.
+ * @param[in] pg_shift
+ *   LOG2 of the physical pages size. If set to 0, ignore page boundaries.
+ * @param[in,out] align
+ *   Alignment of the memory chunks. Initialized with the default
+ *   alignment, which may only be increased.
+ * @return
+ *   Required memory size, or a negative errno value on error.
+ */
+typedef ssize_t (*rte_mempool_calc_mem_size_t)(const struct rte_mempool *mp,
+		uint32_t obj_num, uint32_t pg_shift, size_t *align);
+
+/**
+ * Function to be called for each populated object.
+ *
+ * @param[in] mp
+ *   A pointer to the mempool structure.
+ * @param[in] opaque
+ *   An opaque pointer passed to the populate function.
+ * @param[in] vaddr
+ *   Object virtual address.
+ * @param[in] paddr
+ *   Object physical address, or RTE_BAD_PHYS_ADDR.
+ */
+typedef void (rte_mempool_populate_obj_cb_t)(struct rte_mempool *mp,
+		void *opaque, void *vaddr, phys_addr_t paddr);
+
+/**
+ * Populate the memory pool objects using the provided memory chunk.
+ *
+ * The function places the objects in the chunk and calls obj_cb() for
+ * each of them, which adds it to the pool.
+ *
+ * @param[in] mp
+ *   A pointer to the mempool structure.
+ * @param[in] max_objs
+ *   Maximum number of objects to be populated.
+ * @param[in] vaddr
+ *   The virtual address of the memory chunk.
+ * @param[in] paddr
+ *   The physical address of the memory chunk, or RTE_BAD_PHYS_ADDR.
+ * @param[in] len
+ *   The length of the memory chunk.
+ * @param[in] obj_cb
+ *   Callback function to be executed for each populated object.
+ * @param[in] obj_cb_arg
+ *   An opaque pointer passed to the callback function.
+ * @return
+ *   The number of objects added on success, or a negative errno value.
+ */
+typedef int (*rte_mempool_populate_t)(struct rte_mempool *mp,
+		unsigned int max_objs, char *vaddr, phys_addr_t paddr,
+		size_t len, rte_mempool_populate_obj_cb_t *obj_cb,
+		void *obj_cb_arg);
+
+/**
+ * Additional information about the mempool, provided by its handler.
+ */
+struct rte_mempool_info {
+	/** Number of objects in a contiguous block, 0 if not supported. */
+	unsigned int contig_block_size;
+};
+
+/**
+ * Get some additional information about a mempool.
+ */
+typedef int (*rte_mempool_get_info_t)(const struct rte_mempool *mp,
+		struct rte_mempool_info *info);
+
+/**
+ * Dequeue a number of contiguous object blocks from the external pool.
+ *
+ * The first object of each block is stored in first_obj_table. The other
+ * objects of a block follow it in memory, each one total_elt_size bytes
+ * after the previous one.
+ */
+typedef int (*rte_mempool_dequeue_contig_blocks_t)(struct rte_mempool *mp,
+		void **first_obj_table, unsigned int n);
+
 /** Structure defining mempool operations structure */
 struct rte_mempool_ops {
 	char name[RTE_MEMPOOL_OPS_NAMESIZE]; /**< Name of mempool ops struct. */
@@ -397,6 +510,14 @@ struct rte_mempool_ops {
 	rte_mempool_enqueue_t enqueue;   /**< Enqueue an object. */
 	rte_mempool_dequeue_t dequeue;   /**< Dequeue an object. */
 	rte_mempool_get_count get_count; /**< Get qty of available objs. */
+	/** Optional callback to calculate the memory size of the objects. */
+	rte_mempool_calc_mem_size_t calc_mem_size;
+	/** Optional callback to place the objects in a memory chunk. */
+	rte_mempool_populate_t populate;
+	/** Optional callback to get mempool information. */
+	rte_mempool_get_info_t get_info;
+	/** Optional callback to dequeue contiguous object blocks. */
+	rte_mempool_dequeue_contig_blocks_t dequeue_contig_blocks;
 } __rte_cache_aligned;
 
 #define RTE_MEMPOOL_MAX_OPS_IDX 16  /**< Max registered ops structs */
@@ -474,6 +595,32 @@ rte_mempool_ops_dequeue_bulk(struct rte_mempool *mp,
 	return ops->dequeue(mp, obj_table, n);
 }
 
+/**
+ * @internal Wrapper for mempool_ops dequeue_contig_blocks callback.
+ *
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ * @param[out] first_obj_table
+ *   Pointer to a table of void * pointers (first objects).
+ * @param[in] n
+ *   Number of blocks to get.
+ * @return
+ *   - 0: Success; got n blocks.
+ *   - -ENOTSUP: The mempool handler does not support contiguous blocks.
+ *   - <0: Error; code of dequeue function.
+ */
+static inline int
+rte_mempool_ops_dequeue_contig_blocks(struct rte_mempool *mp,
+		void **first_obj_table, unsigned int n)
+{
+	struct rte_mempool_ops *ops;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+	if (ops->dequeue_contig_blocks == NULL)
+		return -ENOTSUP;
+	return ops->dequeue_contig_blocks(mp, first_obj_table, n);
+}
+
 /**
  * @internal wrapper for mempool_ops enqueue callback.
  *
@@ -508,6 +655,92 @@ rte_mempool_ops_enqueue_bulk(struct rte_mempool *mp, void * const *obj_table,
 unsigned
 rte_mempool_ops_get_count(const struct rte_mempool *mp);
 
+/**
+ * @internal wrapper for mempool_ops calc_mem_size callback.
+ *
+ * Use rte_mempool_op_calc_mem_size_default() if the handler does not
+ * provide the callback.
+ *
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ * @param[in] obj_num
+ *   Number of objects.
+ * @param[in] pg_shift
+ *   LOG2 of the physical pages size. If set to 0, ignore page boundaries.
+ * @param[in,out] align
+ *   Alignment of the memory chunks.
+ * @return
+ *   Required memory size, or a negative errno value on error.
+ */
+ssize_t
+rte_mempool_ops_calc_mem_size(const struct rte_mempool *mp,
+		uint32_t obj_num, uint32_t pg_shift, size_t *align);
+
+/**
+ * @internal wrapper for mempool_ops populate callback.
+ *
+ * Use rte_mempool_op_populate_default() if the handler does not provide
+ * the callback.
+ *
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ * @param[in] max_objs
+ *   Maximum number of objects to be populated.
+ * @param[in] vaddr
+ *   The virtual address of the memory chunk.
+ * @param[in] paddr
+ *   The physical address of the memory chunk, or RTE_BAD_PHYS_ADDR.
+ * @param[in] len
+ *   The length of the memory chunk.
+ * @param[in] obj_cb
+ *   Callback function to be executed for each populated object.
+ * @param[in] obj_cb_arg
+ *   An opaque pointer passed to the callback function.
+ * @return
+ *   The number of objects added on success, or a negative errno value.
+ */
+int
+rte_mempool_ops_populate(struct rte_mempool *mp, unsigned int max_objs,
+		char *vaddr, phys_addr_t paddr, size_t len,
+		rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg);
+
+/**
+ * Default way to calculate the memory size required to store objects.
+ *
+ * The size is the one returned by rte_mempool_xmem_size(), and the
+ * alignment is not modified.
+ */
+ssize_t
+rte_mempool_op_calc_mem_size_default(const struct rte_mempool *mp,
+		uint32_t obj_num, uint32_t pg_shift, size_t *align);
+
+/**
+ * Default way to populate a memory chunk with objects.
+ *
+ * The objects are placed one after the other, starting at the first
+ * cache-aligned address of the chunk.
+ */
+int
+rte_mempool_op_populate_default(struct rte_mempool *mp,
+		unsigned int max_objs, char *vaddr, phys_addr_t paddr,
+		size_t len, rte_mempool_populate_obj_cb_t *obj_cb,
+		void *obj_cb_arg);
+
+/**
+ * Get some additional information about a mempool.
+ *
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ * @param[out] info
+ *   Pointer to the rte_mempool_info structure to fill.
+ * @return
+ *   - 0: Success; the information is filled.
+ *   - -ENOTSUP: The mempool handler does not provide any information.
+ */
+int
+rte_mempool_ops_get_info(const struct rte_mempool *mp,
+		struct rte_mempool_info *info);
+
 /**
  * @internal wrapper for mempool_ops free callback.
  *
@@ -931,6 +1164,36 @@ int rte_mempool_populate_anon(struct rte_mempool *mp);
 uint32_t rte_mempool_obj_iter(struct rte_mempool *mp,
 	rte_mempool_obj_cb_t *obj_cb, void *obj_cb_arg);
 
+/**
+ * Call a function for each mempool element, using several lcores
+ *
+ * Same as rte_mempool_obj_iter(), except that the work is split between
+ * the calling lcore and the slave lcores which are idle (in WAIT state).
+ * The objects are processed in slices, each one in a single memory chunk:
+ * an lcore processes the slices located on its own socket first, then
+ * helps with the other ones. The function returns once all objects are
+ * processed, the slave lcores being back in WAIT state.
+ *
+ * The callback may be called concurrently on different objects, and in
+ * any order. The index of an object is the same as with
+ * rte_mempool_obj_iter().
+ *
+ * The work is only split when the function is called from the master lcore
+ * and the mempool is big enough; otherwise it behaves like
+ * rte_mempool_obj_iter().
+ *
+ * @param mp
+ *   A pointer to an initialized mempool.
+ * @param obj_cb
+ *   A function pointer that is called for each object.
+ * @param obj_cb_arg
+ *   An opaque pointer passed to the callback function.
+ * @return
+ *   Number of objects iterated.
+ */
+uint32_t rte_mempool_obj_iter_parallel(struct rte_mempool *mp,
+	rte_mempool_obj_cb_t *obj_cb, void *obj_cb_arg);
+
 /**
  * Call a function for each mempool memory chunk
  *
@@ -1315,6 +1578,50 @@ rte_mempool_get(struct rte_mempool *mp, void **obj_p)
 	return rte_mempool_get_bulk(mp, obj_p, 1);
 }
 
+/**
+ * Get contiguous blocks of objects from the mempool.
+ *
+ * A block is a set of objects stored one after the other in memory, so
+ * that walking through them touches neighbouring cache lines and pages.
+ * The number of objects in a block is given by the contig_block_size field
+ * returned by rte_mempool_ops_get_info(). The address of the i-th object
+ * of a block is the address of its first object plus i times the total
+ * object size (header, element and trailer).
+ *
+ * The blocks are always taken from the common pool, bypassing the
+ * per-lcore cache. The objects can be freed individually using
+ * rte_mempool_put() or rte_mempool_put_bulk().
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param first_obj_table
+ *   A pointer to a table of void * pointers, filled with the first object
+ *   of each block.
+ * @param n
+ *   The number of blocks to get from the mempool.
+ * @return
+ *   - 0: Success; blocks taken.
+ *   - -ENOBUFS: Not enough entries in the mempool; no block is retrieved.
+ *   - -ENOTSUP: The mempool handler does not support contiguous blocks.
+ */
+static __rte_always_inline int
+rte_mempool_get_contig_blocks(struct rte_mempool *mp,
+			      void **first_obj_table, unsigned int n)
+{
+	int ret;
+
+	ret = rte_mempool_ops_dequeue_contig_blocks(mp, first_obj_table, n);
+	if (ret == 0) {
+		__MEMPOOL_STAT_ADD(mp, get_success, n);
+		__mempool_contig_blocks_check_cookies(mp, first_obj_table,
+						      n, 1);
+	} else {
+		__MEMPOOL_STAT_ADD(mp, get_fail, n);
+	}
+
+	return ret;
+}
+
 /**
  * Return the number of entries in the mempool.
  *
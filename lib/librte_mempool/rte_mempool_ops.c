@@ -85,6 +85,10 @@ rte_mempool_register_ops(const struct rte_mempool_ops *h)
 	ops->enqueue = h->enqueue;
 	ops->dequeue = h->dequeue;
 	ops->get_count = h->get_count;
+	ops->calc_mem_size = h->calc_mem_size;
+	ops->populate = h->populate;
+	ops->get_info = h->get_info;
+	ops->dequeue_contig_blocks = h->dequeue_contig_blocks;
 
 	rte_spinlock_unlock(&rte_mempool_ops_table.sl);
 
@@ -123,6 +127,52 @@ rte_mempool_ops_get_count(const struct rte_mempool *mp)
 	return ops->get_count(mp);
 }
 
+/* wrapper to calculate the memory size required to store the objects. */
+ssize_t
+rte_mempool_ops_calc_mem_size(const struct rte_mempool *mp,
+	uint32_t obj_num, uint32_t pg_shift, size_t *align)
+{
+	struct rte_mempool_ops *ops;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+	if (ops->calc_mem_size == NULL)
+		return rte_mempool_op_calc_mem_size_default(mp, obj_num,
+			pg_shift, align);
+
+	return ops->calc_mem_size(mp, obj_num, pg_shift, align);
+}
+
+/* wrapper to populate a memory chunk with objects. */
+int
+rte_mempool_ops_populate(struct rte_mempool *mp, unsigned int max_objs,
+	char *vaddr, phys_addr_t paddr, size_t len,
+	rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct rte_mempool_ops *ops;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+	if (ops->populate == NULL)
+		return rte_mempool_op_populate_default(mp, max_objs, vaddr,
+			paddr, len, obj_cb, obj_cb_arg);
+
+	return ops->populate(mp, max_objs, vaddr, paddr, len, obj_cb,
+		obj_cb_arg);
+}
+
+/* wrapper to get additional mempool info */
+int
+rte_mempool_ops_get_info(const struct rte_mempool *mp,
+	struct rte_mempool_info *info)
+{
+	struct rte_mempool_ops *ops;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+	if (ops->get_info == NULL)
+		return -ENOTSUP;
+
+	return ops->get_info(mp, info);
+}
+
 /* sets mempool ops previously registered by rte_mempool_register_ops. */
 int
 rte_mempool_set_ops_byname(struct rte_mempool *mp, const char *name,
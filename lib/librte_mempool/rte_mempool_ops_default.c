@@ -0,0 +1,76 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rte_mempool.h>
+
+/* default way to calculate the memory size of the objects */
+ssize_t
+rte_mempool_op_calc_mem_size_default(const struct rte_mempool *mp,
+	uint32_t obj_num, uint32_t pg_shift, __rte_unused size_t *align)
+{
+	size_t total_elt_sz;
+
+	total_elt_sz = mp->header_size + mp->elt_size + mp->trailer_size;
+
+	return rte_mempool_xmem_size(obj_num, total_elt_sz, pg_shift);
+}
+
+/* default way to place the objects in a memory chunk */
+int
+rte_mempool_op_populate_default(struct rte_mempool *mp,
+	unsigned int max_objs, char *vaddr, phys_addr_t paddr, size_t len,
+	rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	size_t total_elt_sz;
+	size_t off;
+	unsigned int i;
+
+	total_elt_sz = mp->header_size + mp->elt_size + mp->trailer_size;
+
+	if (mp->flags & MEMPOOL_F_NO_CACHE_ALIGN)
+		off = RTE_PTR_ALIGN_CEIL(vaddr, 8) - vaddr;
+	else
+		off = RTE_PTR_ALIGN_CEIL(vaddr, RTE_CACHE_LINE_SIZE) - vaddr;
+
+	for (i = 0; off + total_elt_sz <= len && i < max_objs; i++) {
+		off += mp->header_size;
+		if (paddr == RTE_BAD_PHYS_ADDR)
+			obj_cb(mp, obj_cb_arg, vaddr + off,
+				RTE_BAD_PHYS_ADDR);
+		else
+			obj_cb(mp, obj_cb_arg, vaddr + off, paddr + off);
+		off += mp->elt_size + mp->trailer_size;
+	}
+
+	return i;
+}
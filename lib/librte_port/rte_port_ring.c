@@ -73,8 +73,8 @@ rte_port_ring_reader_create_internal(void *params, int socket_id,
 	/* Check input parameters */
 	if ((conf == NULL) ||
 		(conf->ring == NULL) ||
-		(conf->ring->cons.single && is_multi) ||
-		(!(conf->ring->cons.single) && !is_multi)) {
+		(conf->ring->cons.sync_type == RTE_RING_SYNC_ST && is_multi) ||
+		(conf->ring->cons.sync_type != RTE_RING_SYNC_ST && !is_multi)) {
 		RTE_LOG(ERR, PORT, "%s: Invalid Parameters\n", __func__);
 		return NULL;
 	}
@@ -125,7 +125,7 @@ rte_port_ring_multi_reader_rx(void *port, struct rte_mbuf **pkts,
 	struct rte_port_ring_reader *p = port;
 	uint32_t nb_rx;
 
-	nb_rx = rte_ring_mc_dequeue_burst(p->ring, (void **) pkts,
+	nb_rx = rte_ring_dequeue_burst(p->ring, (void **) pkts,
 			n_pkts, NULL);
 	RTE_PORT_RING_READER_STATS_PKTS_IN_ADD(p, nb_rx);
 
@@ -200,8 +200,8 @@ rte_port_ring_writer_create_internal(void *params, int socket_id,
 	/* Check input parameters */
 	if ((conf == NULL) ||
 		(conf->ring == NULL) ||
-		(conf->ring->prod.single && is_multi) ||
-		(!(conf->ring->prod.single) && !is_multi) ||
+		(conf->ring->prod.sync_type == RTE_RING_SYNC_ST && is_multi) ||
+		(conf->ring->prod.sync_type != RTE_RING_SYNC_ST && !is_multi) ||
 		(conf->tx_burst_sz > RTE_PORT_IN_BURST_SIZE_MAX)) {
 		RTE_LOG(ERR, PORT, "%s: Invalid Parameters\n", __func__);
 		return NULL;
@@ -257,7 +257,7 @@ send_burst_mp(struct rte_port_ring_writer *p)
 {
 	uint32_t nb_tx;
 
-	nb_tx = rte_ring_mp_enqueue_burst(p->ring, (void **)p->tx_buf,
+	nb_tx = rte_ring_enqueue_burst(p->ring, (void **)p->tx_buf,
 			p->tx_buf_count, NULL);
 
 	RTE_PORT_RING_WRITER_STATS_PKTS_DROP_ADD(p, p->tx_buf_count - nb_tx);
@@ -320,7 +320,7 @@ rte_port_ring_writer_tx_bulk_internal(void *port,
 
 		RTE_PORT_RING_WRITER_STATS_PKTS_IN_ADD(p, n_pkts);
 		if (is_multi)
-			n_pkts_ok = rte_ring_mp_enqueue_burst(p->ring,
+			n_pkts_ok = rte_ring_enqueue_burst(p->ring,
 					(void **)pkts, n_pkts, NULL);
 		else
 			n_pkts_ok = rte_ring_sp_enqueue_burst(p->ring,
@@ -469,8 +469,8 @@ rte_port_ring_writer_nodrop_create_internal(void *params, int socket_id,
 	/* Check input parameters */
 	if ((conf == NULL) ||
 		(conf->ring == NULL) ||
-		(conf->ring->prod.single && is_multi) ||
-		(!(conf->ring->prod.single) && !is_multi) ||
+		(conf->ring->prod.sync_type == RTE_RING_SYNC_ST && is_multi) ||
+		(conf->ring->prod.sync_type != RTE_RING_SYNC_ST && !is_multi) ||
 		(conf->tx_burst_sz > RTE_PORT_IN_BURST_SIZE_MAX)) {
 		RTE_LOG(ERR, PORT, "%s: Invalid Parameters\n", __func__);
 		return NULL;
@@ -552,7 +552,7 @@ send_burst_mp_nodrop(struct rte_port_ring_writer_nodrop *p)
 {
 	uint32_t nb_tx = 0, i;
 
-	nb_tx = rte_ring_mp_enqueue_burst(p->ring, (void **)p->tx_buf,
+	nb_tx = rte_ring_enqueue_burst(p->ring, (void **)p->tx_buf,
 				p->tx_buf_count, NULL);
 
 	/* We sent all the packets in a first try */
@@ -562,7 +562,7 @@ send_burst_mp_nodrop(struct rte_port_ring_writer_nodrop *p)
 	}
 
 	for (i = 0; i < p->n_retries; i++) {
-		nb_tx += rte_ring_mp_enqueue_burst(p->ring,
+		nb_tx += rte_ring_enqueue_burst(p->ring,
 				(void **) (p->tx_buf + nb_tx),
 				p->tx_buf_count - nb_tx, NULL);
 
@@ -637,7 +637,7 @@ rte_port_ring_writer_nodrop_tx_bulk_internal(void *port,
 		RTE_PORT_RING_WRITER_NODROP_STATS_PKTS_IN_ADD(p, n_pkts);
 		if (is_multi)
 			n_pkts_ok =
-				rte_ring_mp_enqueue_burst(p->ring,
+				rte_ring_enqueue_burst(p->ring,
 						(void **)pkts, n_pkts, NULL);
 		else
 			n_pkts_ok =
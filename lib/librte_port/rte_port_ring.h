@@ -51,6 +51,9 @@ extern "C" {
  * ring_multi_writer:
  *      output port built on top of pre-initialized multi producers ring
  *
+ * The multi ports use the sync mode the ring was created with (MT, RTS or
+ * HTS).
+ *
  ***/
 
 #include <stdint.h>
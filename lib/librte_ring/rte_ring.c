@@ -88,6 +88,7 @@
 #include <rte_spinlock.h>
 
 #include "rte_ring.h"
+#include "rte_ring_elem.h"
 
 TAILQ_HEAD(rte_ring_list, rte_tailq_entry);
 
@@ -99,12 +100,20 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
 
-/* return the size of memory occupied by a ring */
+/* return the size of memory occupied by a ring of esize-byte elements */
 ssize_t
-rte_ring_get_memsize(unsigned count)
+rte_ring_get_memsize_elem(unsigned int esize, unsigned int count)
 {
 	ssize_t sz;
 
+	/* element size must be a non-zero multiple of 4 bytes */
+	if (esize == 0 || (esize & 3) != 0) {
+		RTE_LOG(ERR, RING,
+			"Requested element size is invalid, must be a multiple "
+			"of 4 bytes\n");
+		return -EINVAL;
+	}
+
 	/* count must be a power of 2 */
 	if ((!POWEROF2(count)) || (count > RTE_RING_SZ_MASK )) {
 		RTE_LOG(ERR, RING,
@@ -113,11 +122,51 @@ rte_ring_get_memsize(unsigned count)
 		return -EINVAL;
 	}
 
-	sz = sizeof(struct rte_ring) + count * sizeof(void *);
+	sz = sizeof(struct rte_ring) + (ssize_t)count * esize;
 	sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
 	return sz;
 }
 
+/* return the size of memory occupied by a ring */
+ssize_t
+rte_ring_get_memsize(unsigned count)
+{
+	return rte_ring_get_memsize_elem(sizeof(void *), count);
+}
+
+/* default ratio of ring size to max RTS head-tail distance */
+#define HTD_MAX_DEF	8
+
+/* get the sync type of a ring side from the creation flags */
+static int
+get_sync_type(unsigned int flags, unsigned int st_flag,
+	unsigned int rts_flag, unsigned int hts_flag,
+	enum rte_ring_sync_type *sync_type)
+{
+	switch (flags & (st_flag | rts_flag | hts_flag)) {
+	case 0:
+		*sync_type = RTE_RING_SYNC_MT;
+		break;
+	case RING_F_SP_ENQ:
+	case RING_F_SC_DEQ:
+		*sync_type = RTE_RING_SYNC_ST;
+		break;
+	case RING_F_MP_RTS_ENQ:
+	case RING_F_MC_RTS_DEQ:
+		*sync_type = RTE_RING_SYNC_MT_RTS;
+		break;
+	case RING_F_MP_HTS_ENQ:
+	case RING_F_MC_HTS_DEQ:
+		*sync_type = RTE_RING_SYNC_MT_HTS;
+		break;
+	default:
+		RTE_LOG(ERR, RING, "Requested sync mode flags 0x%x are "
+			"exclusive\n", flags & (st_flag | rts_flag | hts_flag));
+		return -EINVAL;
+	}
+	return 0;
+}
+
 int
 rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	unsigned flags)
@@ -132,26 +181,68 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	RTE_BUILD_BUG_ON((offsetof(struct rte_ring, prod) &
 			  RTE_CACHE_LINE_MASK) != 0);
 
+	/* the RTS/HTS head-tail structures alias the default one */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_rts_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_rts_headtail, tail.val.pos));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_hts_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_hts_headtail, ht.pos.tail));
+
 	/* init the ring structure */
 	memset(r, 0, sizeof(*r));
 	ret = snprintf(r->name, sizeof(r->name), "%s", name);
 	if (ret < 0 || ret >= (int)sizeof(r->name))
 		return -ENAMETOOLONG;
 	r->flags = flags;
-	r->prod.single = (flags & RING_F_SP_ENQ) ? __IS_SP : __IS_MP;
-	r->cons.single = (flags & RING_F_SC_DEQ) ? __IS_SC : __IS_MC;
+	ret = get_sync_type(flags, RING_F_SP_ENQ, RING_F_MP_RTS_ENQ,
+			RING_F_MP_HTS_ENQ, &r->prod.sync_type);
+	if (ret != 0)
+		return ret;
+	ret = get_sync_type(flags, RING_F_SC_DEQ, RING_F_MC_RTS_DEQ,
+			RING_F_MC_HTS_DEQ, &r->cons.sync_type);
+	if (ret != 0)
+		return ret;
 	r->size = count;
 	r->mask = count - 1;
 	r->prod.head = r->cons.head = 0;
 	r->prod.tail = r->cons.tail = 0;
 
+	/* set default values for head-tail distance */
+	if (flags & RING_F_MP_RTS_ENQ)
+		rte_ring_set_prod_htd_max(r, count / HTD_MAX_DEF);
+	if (flags & RING_F_MC_RTS_DEQ)
+		rte_ring_set_cons_htd_max(r, count / HTD_MAX_DEF);
+
 	return 0;
 }
 
-/* create the ring */
+int
+rte_ring_set_prod_htd_max(struct rte_ring *r, uint32_t v)
+{
+	if (r->prod.sync_type != RTE_RING_SYNC_MT_RTS)
+		return -ENOTSUP;
+
+	r->rts_prod.htd_max = v;
+	return 0;
+}
+
+int
+rte_ring_set_cons_htd_max(struct rte_ring *r, uint32_t v)
+{
+	if (r->cons.sync_type != RTE_RING_SYNC_MT_RTS)
+		return -ENOTSUP;
+
+	r->rts_cons.htd_max = v;
+	return 0;
+}
+
+/* create the ring for esize-byte elements */
 struct rte_ring *
-rte_ring_create(const char *name, unsigned count, int socket_id,
-		unsigned flags)
+rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
+		int socket_id, unsigned int flags)
 {
 	char mz_name[RTE_MEMZONE_NAMESIZE];
 	struct rte_ring *r;
@@ -164,7 +255,7 @@ rte_ring_create(const char *name, unsigned count, int socket_id,
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
 
-	ring_size = rte_ring_get_memsize(count);
+	ring_size = rte_ring_get_memsize_elem(esize, count);
 	if (ring_size < 0) {
 		rte_errno = ring_size;
 		return NULL;
@@ -192,9 +283,15 @@ rte_ring_create(const char *name, unsigned count, int socket_id,
 	mz = rte_memzone_reserve(mz_name, ring_size, socket_id, mz_flags);
 	if (mz != NULL) {
 		r = mz->addr;
-		/* no need to check return value here, we already checked the
-		 * arguments above */
-		rte_ring_init(r, name, count, flags);
+		ret = rte_ring_init(r, name, count, flags);
+		if (ret != 0) {
+			/* only the sync mode flags were not checked above */
+			rte_memzone_free(mz);
+			rte_free(te);
+			rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+			rte_errno = -ret;
+			return NULL;
+		}
 
 		te->data = (void *) r;
 		r->memzone = mz;
@@ -210,6 +307,15 @@ rte_ring_create(const char *name, unsigned count, int socket_id,
 	return r;
 }
 
+/* create the ring */
+struct rte_ring *
+rte_ring_create(const char *name, unsigned count, int socket_id,
+		unsigned flags)
+{
+	return rte_ring_create_elem(name, sizeof(void *), count, socket_id,
+		flags);
+}
+
 /* free the ring */
 void
 rte_ring_free(struct rte_ring *r)
@@ -262,6 +368,8 @@ rte_ring_dump(FILE *f, const struct rte_ring *r)
 	fprintf(f, "ring <%s>@%p\n", r->name, r);
 	fprintf(f, "  flags=%x\n", r->flags);
 	fprintf(f, "  size=%"PRIu32"\n", r->size);
+	fprintf(f, "  prod sync=%u\n", r->prod.sync_type);
+	fprintf(f, "  cons sync=%u\n", r->cons.sync_type);
 	fprintf(f, "  ct=%"PRIu32"\n", r->cons.tail);
 	fprintf(f, "  ch=%"PRIu32"\n", r->cons.head);
 	fprintf(f, "  pt=%"PRIu32"\n", r->prod.tail);
@@ -85,6 +85,13 @@
  * Note: the ring implementation is not preemptable. A lcore must not
  * be interrupted by another task that uses the same ring.
  *
+ * In the default multi-producer/consumer mode, a thread preempted between
+ * its head and tail updates also stalls all the threads which moved the
+ * head after it. When lcores do not run on dedicated cores (e.g. vCPUs on
+ * an overcommitted host), the ring can be created with the relaxed tail
+ * sync (RTS) or head/tail sync (HTS) mode for producers and/or consumers,
+ * see RING_F_MP_RTS_ENQ and RING_F_MP_HTS_ENQ.
+ *
  */
 
 #ifdef __cplusplus
@@ -124,11 +131,68 @@ struct rte_memzone; /* forward declaration, so as not to require memzone.h */
 #define CONS_ALIGN RTE_CACHE_LINE_SIZE
 #endif
 
+/** prod/cons sync types */
+enum rte_ring_sync_type {
+	RTE_RING_SYNC_MT,     /**< multi-thread safe (default mode) */
+	RTE_RING_SYNC_ST,     /**< single thread only */
+	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
+	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+};
+
 /* structure to hold a pair of head/tail values and other metadata */
 struct rte_ring_headtail {
 	volatile uint32_t head;  /**< Prod/consumer head. */
 	volatile uint32_t tail;  /**< Prod/consumer tail. */
-	uint32_t single;         /**< True if single prod/cons */
+	RTE_STD_C11
+	union {
+		/** sync type of prod/cons */
+		enum rte_ring_sync_type sync_type;
+		/** deprecated - True if single prod/cons */
+		uint32_t single;
+	};
+};
+
+/* position and update counter of the RTS head or tail */
+union __rte_ring_rts_poscnt {
+	/** raw 8B value to read/write *cnt* and *pos* as one atomic op */
+	uint64_t raw;
+	struct {
+		uint32_t cnt; /**< head/tail reference counter */
+		uint32_t pos; /**< head/tail position */
+	} val;
+};
+
+/*
+ * structure to hold head/tail values and other metadata of a ring side in
+ * relaxed tail sync (RTS) mode. Its layout is compatible with
+ * struct rte_ring_headtail: *tail.val.pos* overlaps *tail* and *sync_type*
+ * is at the same place.
+ */
+struct rte_ring_rts_headtail {
+	volatile union __rte_ring_rts_poscnt tail;
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
+	uint32_t htd_max;   /**< max allowed distance between head/tail */
+	volatile union __rte_ring_rts_poscnt head;
+};
+
+/* head and tail positions of a ring side in head/tail sync (HTS) mode */
+union __rte_ring_hts_pos {
+	/** raw 8B value to read/write *head* and *tail* as one atomic op */
+	uint64_t raw;
+	struct {
+		uint32_t head; /**< head position */
+		uint32_t tail; /**< tail position */
+	} pos;
+};
+
+/*
+ * structure to hold head/tail values and other metadata of a ring side in
+ * head/tail sync (HTS) mode. Its layout is compatible with
+ * struct rte_ring_headtail.
+ */
+struct rte_ring_hts_headtail {
+	volatile union __rte_ring_hts_pos ht;
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
 /**
@@ -155,14 +219,41 @@ struct rte_ring {
 	uint32_t mask;           /**< Mask (size-1) of ring. */
 
 	/** Ring producer status. */
-	struct rte_ring_headtail prod __rte_aligned(PROD_ALIGN);
+	RTE_STD_C11
+	union {
+		struct rte_ring_headtail prod;
+		struct rte_ring_hts_headtail hts_prod;
+		struct rte_ring_rts_headtail rts_prod;
+	}  __rte_aligned(PROD_ALIGN);
 
 	/** Ring consumer status. */
-	struct rte_ring_headtail cons __rte_aligned(CONS_ALIGN);
+	RTE_STD_C11
+	union {
+		struct rte_ring_headtail cons;
+		struct rte_ring_hts_headtail hts_cons;
+		struct rte_ring_rts_headtail rts_cons;
+	}  __rte_aligned(CONS_ALIGN);
 };
 
 #define RING_F_SP_ENQ 0x0001 /**< The default enqueue is "single-producer". */
 #define RING_F_SC_DEQ 0x0002 /**< The default dequeue is "single-consumer". */
+/**
+ * The default enqueue is "multi-producer relaxed tail sync" (RTS).
+ * Producers may update the tail in any order: the tail only moves when the
+ * last producer in progress completes, so no producer waits for a
+ * specific, possibly preempted, one.
+ */
+#define RING_F_MP_RTS_ENQ 0x0008
+/** The default dequeue is "multi-consumer relaxed tail sync" (RTS). */
+#define RING_F_MC_RTS_DEQ 0x0010
+/**
+ * The default enqueue is "multi-producer head/tail sync" (HTS).
+ * Only one producer at a time can be between its head and tail update, so
+ * a producer never waits for the tail to be moved by other ones.
+ */
+#define RING_F_MP_HTS_ENQ 0x0020
+/** The default dequeue is "multi-consumer head/tail sync" (HTS). */
+#define RING_F_MC_HTS_DEQ 0x0040
 #define RTE_RING_SZ_MASK  (unsigned)(0x0fffffff) /**< Ring size mask */
 
 /* @internal defines for passing to the enqueue dequeue worker functions */
@@ -218,8 +309,27 @@ ssize_t rte_ring_get_memsize(unsigned count);
  *    - RING_F_SC_DEQ: If this flag is set, the default behavior when
  *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
+ *    - RING_F_MP_RTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer RTS mode".
+ *    - RING_F_MP_HTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer HTS mode".
+ *    - RING_F_MC_RTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer RTS mode".
+ *    - RING_F_MC_HTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer HTS mode".
+ *    At most one of RING_F_SP_ENQ, RING_F_MP_RTS_ENQ and RING_F_MP_HTS_ENQ,
+ *    and one of RING_F_SC_DEQ, RING_F_MC_RTS_DEQ and RING_F_MC_HTS_DEQ can
+ *    be set. On a ring side in RTS or HTS mode, only the default
+ *    enqueue/dequeue functions (the ones without sp/mp/sc/mc in their
+ *    name) must be used.
  * @return
- *   0 on success, or a negative value on error.
+ *   0 on success, or a negative value on error:
+ *    - -EINVAL - invalid combination of flags
+ *    - -ENAMETOOLONG - name is too long
  */
 int rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	unsigned flags);
@@ -253,12 +363,30 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
  *    - RING_F_SC_DEQ: If this flag is set, the default behavior when
  *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
+ *    - RING_F_MP_RTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer RTS mode".
+ *    - RING_F_MP_HTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer HTS mode".
+ *    - RING_F_MC_RTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer RTS mode".
+ *    - RING_F_MC_HTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer HTS mode".
+ *    At most one of RING_F_SP_ENQ, RING_F_MP_RTS_ENQ and RING_F_MP_HTS_ENQ,
+ *    and one of RING_F_SC_DEQ, RING_F_MC_RTS_DEQ and RING_F_MC_HTS_DEQ can
+ *    be set. On a ring side in RTS or HTS mode, only the default
+ *    enqueue/dequeue functions (the ones without sp/mp/sc/mc in their
+ *    name) must be used.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
  *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
  *    - E_RTE_SECONDARY - function was called from a secondary process instance
- *    - EINVAL - count provided is not a power of 2
+ *    - EINVAL - count provided is not a power of 2, or invalid combination
+ *		 of flags
  *    - ENOSPC - the maximum number of memzones has already been allocated
  *    - EEXIST - a memzone with the same name already exists
  *    - ENOMEM - no appropriate memory area found in which to create memzone
@@ -273,6 +401,37 @@ struct rte_ring *rte_ring_create(const char *name, unsigned count,
  */
 void rte_ring_free(struct rte_ring *r);
 
+/**
+ * Set the maximum distance between the producer head and tail of a ring
+ * in RTS mode.
+ *
+ * A producer that finds its head further than *v* positions ahead of the
+ * tail waits for the tail to catch up before moving the head, which bounds
+ * the number of objects that are reserved but not yet visible to
+ * consumers. The default is one eighth of the ring size.
+ *
+ * @param r
+ *   A pointer to the ring structure, with producers in RTS mode.
+ * @param v
+ *   The new maximum head/tail distance.
+ * @return
+ *   0 on success, or -ENOTSUP if the producers are not in RTS mode.
+ */
+int rte_ring_set_prod_htd_max(struct rte_ring *r, uint32_t v);
+
+/**
+ * Set the maximum distance between the consumer head and tail of a ring
+ * in RTS mode.
+ *
+ * @param r
+ *   A pointer to the ring structure, with consumers in RTS mode.
+ * @param v
+ *   The new maximum head/tail distance.
+ * @return
+ *   0 on success, or -ENOTSUP if the consumers are not in RTS mode.
+ */
+int rte_ring_set_cons_htd_max(struct rte_ring *r, uint32_t v);
+
 /**
  * Dump the status of the ring to a file.
  *
@@ -423,6 +582,77 @@ __rte_ring_move_prod_head(struct rte_ring *r, int is_sp,
 	return n;
 }
 
+#include "rte_ring_rts.h"
+#include "rte_ring_hts.h"
+
+/**
+ * @internal This function updates the producer head for enqueue, according
+ * to the producer sync type
+ *
+ * @param r
+ *   A pointer to the ring structure
+ * @param sync
+ *   The producer sync type, __IS_SP, __IS_MP or one of the
+ *   RTE_RING_SYNC_MT_* modes
+ * @param n
+ *   The number of elements we will want to enqueue
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
+ * @param old_head
+ *   Returns head value as it was before the move, i.e. where enqueue starts
+ * @param new_head
+ *   Returns the current/new head value i.e. where enqueue finishes
+ * @param free_entries
+ *   Returns the amount of free space in the ring BEFORE head was moved
+ * @return
+ *   Actual number of objects enqueued.
+ *   If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_sync_move_prod_head(struct rte_ring *r, int sync,
+		unsigned int n, enum rte_ring_queue_behavior behavior,
+		uint32_t *old_head, uint32_t *new_head,
+		uint32_t *free_entries)
+{
+	switch (sync) {
+	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_prod_head(r, n, behavior, old_head,
+				free_entries);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		n = __rte_ring_hts_move_prod_head(r, n, behavior, old_head,
+				free_entries);
+		break;
+	default:
+		return __rte_ring_move_prod_head(r, sync, n, behavior,
+				old_head, new_head, free_entries);
+	}
+	*new_head = *old_head + n;
+	return n;
+}
+
+/**
+ * @internal This function updates the producer tail after an enqueue,
+ * according to the producer sync type
+ */
+static __rte_always_inline void
+__rte_ring_sync_update_prod_tail(struct rte_ring *r, int sync,
+		uint32_t old_head, uint32_t new_head)
+{
+	switch (sync) {
+	case RTE_RING_SYNC_MT_RTS:
+		__rte_ring_rts_update_tail(&r->rts_prod);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		__rte_ring_hts_update_tail(&r->hts_prod, old_head,
+				new_head - old_head);
+		break;
+	default:
+		update_tail(&r->prod, old_head, new_head, sync);
+	}
+}
+
 /**
  * @internal Enqueue several objects on the ring
  *
@@ -436,7 +666,8 @@ __rte_ring_move_prod_head(struct rte_ring *r, int is_sp,
  *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
  *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
  * @param is_sp
- *   Indicates whether to use single producer or multi-producer head update
+ *   Indicates whether to use single producer or multi-producer head update,
+ *   or the RTE_RING_SYNC_MT_* mode of the producers
  * @param free_space
  *   returns the amount of space after the enqueue operation has finished
  * @return
@@ -451,7 +682,7 @@ __rte_ring_do_enqueue(struct rte_ring *r, void * const *obj_table,
 	uint32_t prod_head, prod_next;
 	uint32_t free_entries;
 
-	n = __rte_ring_move_prod_head(r, is_sp, n, behavior,
+	n = __rte_ring_sync_move_prod_head(r, is_sp, n, behavior,
 			&prod_head, &prod_next, &free_entries);
 	if (n == 0)
 		goto end;
@@ -459,7 +690,7 @@ __rte_ring_do_enqueue(struct rte_ring *r, void * const *obj_table,
 	ENQUEUE_PTRS(r, &r[1], prod_head, obj_table, n, void *);
 	rte_smp_wmb();
 
-	update_tail(&r->prod, prod_head, prod_next, is_sp);
+	__rte_ring_sync_update_prod_tail(r, is_sp, prod_head, prod_next);
 end:
 	if (free_space != NULL)
 		*free_space = free_entries - n;
@@ -528,6 +759,74 @@ __rte_ring_move_cons_head(struct rte_ring *r, int is_sc,
 	return n;
 }
 
+/**
+ * @internal This function updates the consumer head for dequeue, according
+ * to the consumer sync type
+ *
+ * @param r
+ *   A pointer to the ring structure
+ * @param sync
+ *   The consumer sync type, __IS_SC, __IS_MC or one of the
+ *   RTE_RING_SYNC_MT_* modes
+ * @param n
+ *   The number of elements we will want to dequeue
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Dequeue as many items as possible from ring
+ * @param old_head
+ *   Returns head value as it was before the move, i.e. where dequeue starts
+ * @param new_head
+ *   Returns the current/new head value i.e. where dequeue finishes
+ * @param entries
+ *   Returns the number of entries in the ring BEFORE head was moved
+ * @return
+ *   - Actual number of objects dequeued.
+ *     If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_sync_move_cons_head(struct rte_ring *r, int sync,
+		unsigned int n, enum rte_ring_queue_behavior behavior,
+		uint32_t *old_head, uint32_t *new_head,
+		uint32_t *entries)
+{
+	switch (sync) {
+	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_cons_head(r, n, behavior, old_head,
+				entries);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		n = __rte_ring_hts_move_cons_head(r, n, behavior, old_head,
+				entries);
+		break;
+	default:
+		return __rte_ring_move_cons_head(r, sync, n, behavior,
+				old_head, new_head, entries);
+	}
+	*new_head = *old_head + n;
+	return n;
+}
+
+/**
+ * @internal This function updates the consumer tail after a dequeue,
+ * according to the consumer sync type
+ */
+static __rte_always_inline void
+__rte_ring_sync_update_cons_tail(struct rte_ring *r, int sync,
+		uint32_t old_head, uint32_t new_head)
+{
+	switch (sync) {
+	case RTE_RING_SYNC_MT_RTS:
+		__rte_ring_rts_update_tail(&r->rts_cons);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		__rte_ring_hts_update_tail(&r->hts_cons, old_head,
+				new_head - old_head);
+		break;
+	default:
+		update_tail(&r->cons, old_head, new_head, sync);
+	}
+}
+
 /**
  * @internal Dequeue several objects from the ring
  *
@@ -541,7 +840,8 @@ __rte_ring_move_cons_head(struct rte_ring *r, int is_sc,
  *   RTE_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
  *   RTE_RING_QUEUE_VARIABLE: Dequeue as many items as possible from ring
  * @param is_sc
- *   Indicates whether to use single consumer or multi-consumer head update
+ *   Indicates whether to use single consumer or multi-consumer head update,
+ *   or the RTE_RING_SYNC_MT_* mode of the consumers
  * @param available
  *   returns the number of remaining ring entries after the dequeue has finished
  * @return
@@ -556,7 +856,7 @@ __rte_ring_do_dequeue(struct rte_ring *r, void **obj_table,
 	uint32_t cons_head, cons_next;
 	uint32_t entries;
 
-	n = __rte_ring_move_cons_head(r, is_sc, n, behavior,
+	n = __rte_ring_sync_move_cons_head(r, is_sc, n, behavior,
 			&cons_head, &cons_next, &entries);
 	if (n == 0)
 		goto end;
@@ -564,7 +864,7 @@ __rte_ring_do_dequeue(struct rte_ring *r, void **obj_table,
 	DEQUEUE_PTRS(r, &r[1], cons_head, obj_table, n, void *);
 	rte_smp_rmb();
 
-	update_tail(&r->cons, cons_head, cons_next, is_sc);
+	__rte_ring_sync_update_cons_tail(r, is_sc, cons_head, cons_next);
 
 end:
 	if (available != NULL)
@@ -645,7 +945,7 @@ rte_ring_enqueue_bulk(struct rte_ring *r, void * const *obj_table,
 		      unsigned int n, unsigned int *free_space)
 {
 	return __rte_ring_do_enqueue(r, obj_table, n, RTE_RING_QUEUE_FIXED,
-			r->prod.single, free_space);
+			r->prod.sync_type, free_space);
 }
 
 /**
@@ -780,7 +1080,7 @@ rte_ring_dequeue_bulk(struct rte_ring *r, void **obj_table, unsigned int n,
 		unsigned int *available)
 {
 	return __rte_ring_do_dequeue(r, obj_table, n, RTE_RING_QUEUE_FIXED,
-				r->cons.single, available);
+				r->cons.sync_type, available);
 }
 
 /**
@@ -1017,7 +1317,7 @@ rte_ring_enqueue_burst(struct rte_ring *r, void * const *obj_table,
 		      unsigned int n, unsigned int *free_space)
 {
 	return __rte_ring_do_enqueue(r, obj_table, n, RTE_RING_QUEUE_VARIABLE,
-			r->prod.single, free_space);
+			r->prod.sync_type, free_space);
 }
 
 /**
@@ -1098,7 +1398,7 @@ rte_ring_dequeue_burst(struct rte_ring *r, void **obj_table,
 {
 	return __rte_ring_do_dequeue(r, obj_table, n,
 				RTE_RING_QUEUE_VARIABLE,
-				r->cons.single, available);
+				r->cons.sync_type, available);
 }
 
 #ifdef __cplusplus
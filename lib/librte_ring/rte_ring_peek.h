@@ -0,0 +1,671 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_RING_PEEK_H_
+#define _RTE_RING_PEEK_H_
+
+/**
+ * @file
+ * RTE Ring peek and zero-copy API
+ *
+ * This API splits enqueue and dequeue operations into two phases:
+ * - enqueue/dequeue start
+ * - enqueue/dequeue finish
+ *
+ * It allows the user to inspect objects in the ring without removing them
+ * from it (aka MT safe peek), or to read/write objects directly in the ring
+ * slots without copying them to/from an intermediate table (aka zero-copy).
+ *
+ * For the producer, the start functions reserve room for up to *n* objects
+ * and the finish function publishes how many of them were actually
+ * written. For the consumer, the start functions give access to up to *n*
+ * objects and the finish function releases how many of them were actually
+ * consumed; the others are left at the head of the ring.
+ *
+ * Note that between the start and the finish, the ring head is moved but the
+ * tail is not, so other threads see the ring as it was before the start.
+ * That is why this API is only available for single-producer enqueue and
+ * single-consumer dequeue: the ring must have been created with the
+ * RING_F_SP_ENQ flag to use the enqueue functions, and with the
+ * RING_F_SC_DEQ flag to use the dequeue functions. Only one start/finish
+ * sequence may be in progress at a time on each side of the ring.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_debug.h>
+#include <rte_ring_elem.h>
+
+/**
+ * Ring zero-copy information structure.
+ *
+ * This structure contains the pointers and length of the space
+ * reserved on the ring storage. As the reserved area can wrap around the
+ * end of the ring storage, it is described by up to two contiguous areas.
+ */
+struct rte_ring_zc_data {
+	/* Pointer to the first space in the ring */
+	void *ptr1;
+	/* Pointer to the second space in the ring if there is wrap-around.
+	 * It contains valid value only if wrap-around happens.
+	 */
+	void *ptr2;
+	/* Number of elements in the first pointer. If this is equal to
+	 * the number of elements requested, then ptr2 is NULL.
+	 * Otherwise, subtracting n1 from number of elements requested
+	 * will give the number of elements available at ptr2.
+	 */
+	unsigned int n1;
+};
+
+/**
+ * @internal Fill the zero-copy information for n elements starting at head.
+ */
+static __rte_always_inline void
+__rte_ring_get_elem_addr(struct rte_ring *r, uint32_t head,
+	uint32_t esize, uint32_t num, struct rte_ring_zc_data *zcd)
+{
+	uint32_t idx, scale, nr_idx;
+	uint32_t *ring = (uint32_t *)&r[1];
+
+	/* Normalize to uint32_t */
+	scale = esize / sizeof(uint32_t);
+	idx = head & r->mask;
+	nr_idx = idx * scale;
+
+	zcd->ptr1 = ring + nr_idx;
+	zcd->n1 = num;
+	zcd->ptr2 = NULL;
+	if (idx + num > r->size) {
+		zcd->n1 = r->size - idx;
+		zcd->ptr2 = ring;
+	}
+}
+
+/**
+ * @internal Publish n objects on a single-producer ring, starting from the
+ * current producer tail, and give back any unused reserved room.
+ */
+static __rte_always_inline void
+__rte_ring_sp_enqueue_finish(struct rte_ring *r, unsigned int n)
+{
+	uint32_t tail;
+
+	RTE_ASSERT(r->prod.sync_type == RTE_RING_SYNC_ST);
+
+	tail = r->prod.tail;
+	RTE_ASSERT(r->prod.head - tail >= n);
+
+	tail += n;
+	r->prod.head = tail;
+	rte_smp_wmb();
+	r->prod.tail = tail;
+}
+
+/**
+ * @internal Release n objects on a single-consumer ring, starting from the
+ * current consumer tail, and leave the other peeked objects in the ring.
+ */
+static __rte_always_inline void
+__rte_ring_sc_dequeue_finish(struct rte_ring *r, unsigned int n)
+{
+	uint32_t tail;
+
+	RTE_ASSERT(r->cons.sync_type == RTE_RING_SYNC_ST);
+
+	tail = r->cons.tail;
+	RTE_ASSERT(r->cons.head - tail >= n);
+
+	tail += n;
+	r->cons.head = tail;
+	rte_smp_rmb();
+	r->cons.tail = tail;
+}
+
+/**
+ * @internal Reserve room for up to n objects on a single-producer ring
+ * and return the zero-copy information for it.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_enqueue_zc_elem_start(struct rte_ring *r, unsigned int esize,
+	uint32_t n, enum rte_ring_queue_behavior behavior,
+	struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	uint32_t prod_head, prod_next;
+	uint32_t free_entries;
+
+	RTE_ASSERT(r->prod.sync_type == RTE_RING_SYNC_ST);
+
+	n = __rte_ring_move_prod_head(r, __IS_SP, n, behavior,
+			&prod_head, &prod_next, &free_entries);
+	if (n != 0)
+		__rte_ring_get_elem_addr(r, prod_head, esize, n, zcd);
+
+	if (free_space != NULL)
+		*free_space = free_entries - n;
+	return n;
+}
+
+/**
+ * @internal Give access to up to n objects of a single-consumer ring and
+ * return the zero-copy information for them.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_dequeue_zc_elem_start(struct rte_ring *r, unsigned int esize,
+	uint32_t n, enum rte_ring_queue_behavior behavior,
+	struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	uint32_t cons_head, cons_next;
+	uint32_t entries;
+
+	RTE_ASSERT(r->cons.sync_type == RTE_RING_SYNC_ST);
+
+	n = __rte_ring_move_cons_head(r, __IS_SC, n, behavior,
+			&cons_head, &cons_next, &entries);
+	if (n != 0) {
+		__rte_ring_get_elem_addr(r, cons_head, esize, n, zcd);
+		/* read the objects only after the producer tail */
+		rte_smp_rmb();
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+/**
+ * @internal Copy up to n objects from the head of a single-consumer ring
+ * into obj_table, without releasing them.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_dequeue_elem_start(struct rte_ring *r, void *obj_table,
+	unsigned int esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	unsigned int *available)
+{
+	uint32_t cons_head, cons_next;
+	uint32_t entries;
+
+	RTE_ASSERT(r->cons.sync_type == RTE_RING_SYNC_ST);
+
+	n = __rte_ring_move_cons_head(r, __IS_SC, n, behavior,
+			&cons_head, &cons_next, &entries);
+	if (n != 0) {
+		rte_smp_rmb();
+		__rte_ring_dequeue_elems(r, cons_head, obj_table, esize, n);
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+/**
+ * Start to enqueue several objects on a single-producer ring, in place.
+ *
+ * Reserve room for exactly *n* objects and return pointers to it in *zcd*.
+ * The user has to write the objects in the reserved room and then call
+ * rte_ring_enqueue_zc_elem_finish() to make them visible to consumers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SP_ENQ.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to reserve room for.
+ * @param zcd
+ *   Structure containing the pointers and length of the reserved space.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   reservation operation has finished.
+ * @return
+ *   The number of objects that can be enqueued, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_enqueue_zc_bulk_elem_start(struct rte_ring *r, unsigned int esize,
+	unsigned int n, struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return __rte_ring_do_enqueue_zc_elem_start(r, esize, n,
+			RTE_RING_QUEUE_FIXED, zcd, free_space);
+}
+
+/**
+ * Start to enqueue several pointers on a single-producer ring, in place.
+ *
+ * Same as rte_ring_enqueue_zc_bulk_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SP_ENQ.
+ * @param n
+ *   The number of objects to reserve room for.
+ * @param zcd
+ *   Structure containing the pointers and length of the reserved space.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   reservation operation has finished.
+ * @return
+ *   The number of objects that can be enqueued, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_enqueue_zc_bulk_start(struct rte_ring *r, unsigned int n,
+	struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return rte_ring_enqueue_zc_bulk_elem_start(r, sizeof(uintptr_t), n,
+			zcd, free_space);
+}
+
+/**
+ * Start to enqueue several objects on a single-producer ring, in place.
+ *
+ * Same as rte_ring_enqueue_zc_bulk_elem_start(), but reserve room for as
+ * many objects as possible, up to *n*.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SP_ENQ.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The maximum number of objects to reserve room for.
+ * @param zcd
+ *   Structure containing the pointers and length of the reserved space.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   reservation operation has finished.
+ * @return
+ *   The number of objects that can be enqueued.
+ */
+static __rte_always_inline unsigned int
+rte_ring_enqueue_zc_burst_elem_start(struct rte_ring *r, unsigned int esize,
+	unsigned int n, struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return __rte_ring_do_enqueue_zc_elem_start(r, esize, n,
+			RTE_RING_QUEUE_VARIABLE, zcd, free_space);
+}
+
+/**
+ * Start to enqueue several pointers on a single-producer ring, in place.
+ *
+ * Same as rte_ring_enqueue_zc_burst_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SP_ENQ.
+ * @param n
+ *   The maximum number of objects to reserve room for.
+ * @param zcd
+ *   Structure containing the pointers and length of the reserved space.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   reservation operation has finished.
+ * @return
+ *   The number of objects that can be enqueued.
+ */
+static __rte_always_inline unsigned int
+rte_ring_enqueue_zc_burst_start(struct rte_ring *r, unsigned int n,
+	struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return rte_ring_enqueue_zc_burst_elem_start(r, sizeof(uintptr_t), n,
+			zcd, free_space);
+}
+
+/**
+ * Complete an in place enqueue on a single-producer ring.
+ *
+ * Publish the first *n* objects written in the room reserved by the
+ * previous enqueue start call. Any remaining reserved room is given back
+ * to the ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of objects that were written, at most the number returned
+ *   by the start function.
+ */
+static __rte_always_inline void
+rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sp_enqueue_finish(r, n);
+}
+
+/**
+ * Complete an in place enqueue of pointers on a single-producer ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of pointers that were written, at most the number returned
+ *   by the start function.
+ */
+static __rte_always_inline void
+rte_ring_enqueue_zc_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sp_enqueue_finish(r, n);
+}
+
+/**
+ * Start to dequeue several objects from a single-consumer ring, in place.
+ *
+ * Give access to exactly *n* objects at the head of the ring through
+ * *zcd*. The objects remain owned by the ring until
+ * rte_ring_dequeue_zc_elem_finish() is called.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to access.
+ * @param zcd
+ *   Structure containing the pointers and length of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects that can be dequeued, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_zc_bulk_elem_start(struct rte_ring *r, unsigned int esize,
+	unsigned int n, struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_zc_elem_start(r, esize, n,
+			RTE_RING_QUEUE_FIXED, zcd, available);
+}
+
+/**
+ * Start to dequeue several pointers from a single-consumer ring, in place.
+ *
+ * Same as rte_ring_dequeue_zc_bulk_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param n
+ *   The number of objects to access.
+ * @param zcd
+ *   Structure containing the pointers and length of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects that can be dequeued, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_zc_bulk_start(struct rte_ring *r, unsigned int n,
+	struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return rte_ring_dequeue_zc_bulk_elem_start(r, sizeof(uintptr_t), n,
+			zcd, available);
+}
+
+/**
+ * Start to dequeue several objects from a single-consumer ring, in place.
+ *
+ * Same as rte_ring_dequeue_zc_bulk_elem_start(), but give access to as
+ * many objects as possible, up to *n*.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The maximum number of objects to access.
+ * @param zcd
+ *   Structure containing the pointers and length of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects that can be dequeued.
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_zc_burst_elem_start(struct rte_ring *r, unsigned int esize,
+	unsigned int n, struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_zc_elem_start(r, esize, n,
+			RTE_RING_QUEUE_VARIABLE, zcd, available);
+}
+
+/**
+ * Start to dequeue several pointers from a single-consumer ring, in place.
+ *
+ * Same as rte_ring_dequeue_zc_burst_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param n
+ *   The maximum number of objects to access.
+ * @param zcd
+ *   Structure containing the pointers and length of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects that can be dequeued.
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_zc_burst_start(struct rte_ring *r, unsigned int n,
+	struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return rte_ring_dequeue_zc_burst_elem_start(r, sizeof(uintptr_t), n,
+			zcd, available);
+}
+
+/**
+ * Complete an in place dequeue from a single-consumer ring.
+ *
+ * Release the first *n* objects accessed by the previous dequeue start
+ * call. The other objects stay at the head of the ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of objects consumed, at most the number returned by the
+ *   start function.
+ */
+static __rte_always_inline void
+rte_ring_dequeue_zc_elem_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sc_dequeue_finish(r, n);
+}
+
+/**
+ * Complete an in place dequeue of pointers from a single-consumer ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of pointers consumed, at most the number returned by the
+ *   start function.
+ */
+static __rte_always_inline void
+rte_ring_dequeue_zc_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sc_dequeue_finish(r, n);
+}
+
+/**
+ * Start to dequeue several objects from a single-consumer ring (peek).
+ *
+ * Copy exactly *n* objects from the head of the ring into *obj_table*,
+ * without removing them from the ring. The user has to call
+ * rte_ring_dequeue_elem_finish() to remove some or all of them.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to copy from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects copied, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_bulk_elem_start(struct rte_ring *r, void *obj_table,
+	unsigned int esize, unsigned int n, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_elem_start(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, available);
+}
+
+/**
+ * Start to dequeue several pointers from a single-consumer ring (peek).
+ *
+ * Same as rte_ring_dequeue_bulk_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to copy from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects copied, either 0 or n
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_bulk_start(struct rte_ring *r, void **obj_table,
+	unsigned int n, unsigned int *available)
+{
+	return rte_ring_dequeue_bulk_elem_start(r, obj_table,
+			sizeof(uintptr_t), n, available);
+}
+
+/**
+ * Start to dequeue several objects from a single-consumer ring (peek).
+ *
+ * Same as rte_ring_dequeue_bulk_elem_start(), but copy as many objects
+ * as possible, up to *n*.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The maximum number of objects to copy from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects copied, 0 if ring is empty
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_burst_elem_start(struct rte_ring *r, void *obj_table,
+	unsigned int esize, unsigned int n, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_elem_start(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, available);
+}
+
+/**
+ * Start to dequeue several pointers from a single-consumer ring (peek).
+ *
+ * Same as rte_ring_dequeue_burst_elem_start() for a ring of pointers.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with RING_F_SC_DEQ.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The maximum number of objects to copy from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished.
+ * @return
+ *   The number of objects copied, 0 if ring is empty
+ */
+static __rte_always_inline unsigned int
+rte_ring_dequeue_burst_start(struct rte_ring *r, void **obj_table,
+	unsigned int n, unsigned int *available)
+{
+	return rte_ring_dequeue_burst_elem_start(r, obj_table,
+			sizeof(uintptr_t), n, available);
+}
+
+/**
+ * Complete a peek dequeue from a single-consumer ring.
+ *
+ * Remove the first *n* objects copied by the previous dequeue start call
+ * from the ring. The other objects stay at the head of the ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of objects to remove from the ring, at most the number
+ *   returned by the start function.
+ */
+static __rte_always_inline void
+rte_ring_dequeue_elem_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sc_dequeue_finish(r, n);
+}
+
+/**
+ * Complete a peek dequeue of pointers from a single-consumer ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of pointers to remove from the ring, at most the number
+ *   returned by the start function.
+ */
+static __rte_always_inline void
+rte_ring_dequeue_finish(struct rte_ring *r, unsigned int n)
+{
+	__rte_ring_sc_dequeue_finish(r, n);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_PEEK_H_ */
@@ -363,6 +363,84 @@ struct rte_table_hash_key32_ext_params {
 /** Extendible bucket hash table operations */
 extern struct rte_table_ops rte_table_hash_key32_ext_ops;
 
+/**
+ * Up to 64-byte key hash tables
+ *
+ */
+/** LRU hash table parameters */
+struct rte_table_hash_key64_lru_params {
+	/** Key size (number of bytes). Needs to be a multiple of 8, between 8
+	and 64. */
+	uint32_t key_size;
+
+	/** Maximum number of entries (and keys) in the table */
+	uint32_t n_entries;
+
+	/** Hash function */
+	rte_table_hash_op_hash f_hash;
+
+	/** Seed for the hash function */
+	uint64_t seed;
+
+	/** Byte offset within packet meta-data where the 4-byte key signature
+	is located. Valid for pre-computed key signature tables, ignored for
+	do-sig tables. */
+	uint32_t signature_offset;
+
+	/** Byte offset within packet meta-data where the key is located */
+	uint32_t key_offset;
+
+	/** Bit-mask of key_size bytes to be AND-ed to the key on lookup. NULL
+	when the full key is used. */
+	uint8_t *key_mask;
+};
+
+/** LRU hash table operations for pre-computed key signature */
+extern struct rte_table_ops rte_table_hash_key64_lru_ops;
+
+/** LRU hash table operations for key signature computed on lookup
+    ("do-sig") */
+extern struct rte_table_ops rte_table_hash_key64_lru_dosig_ops;
+
+/** Extendible bucket hash table parameters */
+struct rte_table_hash_key64_ext_params {
+	/** Key size (number of bytes). Needs to be a multiple of 8, between 8
+	and 64. */
+	uint32_t key_size;
+
+	/** Maximum number of entries (and keys) in the table */
+	uint32_t n_entries;
+
+	/** Number of entries (and keys) for hash table bucket extensions. Each
+		bucket is extended in increments of 4 keys. */
+	uint32_t n_entries_ext;
+
+	/** Hash function */
+	rte_table_hash_op_hash f_hash;
+
+	/** Seed for the hash function */
+	uint64_t seed;
+
+	/** Byte offset within packet meta-data where the 4-byte key signature
+	is located. Valid for pre-computed key signature tables, ignored for
+	do-sig tables. */
+	uint32_t signature_offset;
+
+	/** Byte offset within packet meta-data where the key is located */
+	uint32_t key_offset;
+
+	/** Bit-mask of key_size bytes to be AND-ed to the key on lookup. NULL
+	when the full key is used. */
+	uint8_t *key_mask;
+};
+
+/** Extendible bucket hash table operations for pre-computed key signature */
+extern struct rte_table_ops rte_table_hash_key64_ext_ops;
+
+/** Extendible bucket hash table operations for key signature computed on
+    lookup ("do-sig") */
+extern struct rte_table_ops rte_table_hash_key64_ext_dosig_ops;
+
 /** Cuckoo hash table parameters */
 struct rte_table_hash_cuckoo_params {
     /** Key size (number of bytes */
@@ -0,0 +1,1125 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_mbuf.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_log.h>
+#if defined(RTE_ARCH_X86)
+#include <rte_vect.h>
+#endif
+
+#include "rte_table_hash.h"
+#include "rte_lru.h"
+
+#define RTE_TABLE_HASH_KEY_SIZE_MAX					64
+
+#define RTE_BUCKET_ENTRY_VALID						0x1LLU
+
+#ifdef RTE_TABLE_STATS_COLLECT
+
+#define RTE_TABLE_HASH_KEY64_STATS_PKTS_IN_ADD(table, val) \
+	table->stats.n_pkts_in += val
+#define RTE_TABLE_HASH_KEY64_STATS_PKTS_LOOKUP_MISS(table, val) \
+	table->stats.n_pkts_lookup_miss += val
+
+#else
+
+#define RTE_TABLE_HASH_KEY64_STATS_PKTS_IN_ADD(table, val)
+#define RTE_TABLE_HASH_KEY64_STATS_PKTS_LOOKUP_MISS(table, val)
+
+#endif
+
+struct rte_bucket_4_64 {
+	/* Cache line 0 */
+	uint64_t signature[4 + 1];
+	uint64_t lru_list;
+	struct rte_bucket_4_64 *next;
+	uint64_t next_valid;
+
+	/* Cache lines 1 to 4: 4 keys, each zero padded to key_stride bytes */
+	uint64_t key[0];
+};
+
+struct grinder {
+	/* Lookup key, with the key mask applied and zero padded */
+	uint64_t key[RTE_TABLE_HASH_KEY_SIZE_MAX / 8];
+	struct rte_bucket_4_64 *bkt;
+	uint64_t sig;
+	uint64_t match;
+	uint32_t key_pos;
+} __rte_aligned(16);
+
+struct rte_table_hash {
+	struct rte_table_stats stats;
+
+	/* Input parameters */
+	uint32_t n_buckets;
+	uint32_t n_entries_per_bucket;
+	uint32_t key_size;
+	uint32_t entry_size;
+	uint32_t bucket_size;
+	uint32_t signature_offset;
+	uint32_t key_offset;
+	uint64_t key_mask[RTE_TABLE_HASH_KEY_SIZE_MAX / 8];
+	rte_table_hash_op_hash f_hash;
+	uint64_t seed;
+
+	/* Internal */
+	uint32_t key_stride;
+	uint32_t data_offset;
+
+	/* Extendible buckets */
+	uint32_t n_buckets_ext;
+	uint32_t stack_pos;
+	uint32_t *stack;
+
+	/* Grinder */
+	struct grinder grinders[RTE_PORT_IN_BURST_SIZE_MAX];
+
+	/* Lookup table */
+	uint8_t memory[0] __rte_cache_aligned;
+};
+
+#define BUCKET_KEY(f, bucket, pos)					\
+	((uint64_t *) &((uint8_t *) (bucket)->key)[(pos) * (f)->key_stride])
+
+#define BUCKET_DATA(f, bucket, pos)					\
+	(&((uint8_t *) (bucket))[(f)->data_offset + (pos) * (f)->entry_size])
+
+/*
+ * Copy the key into a key_stride sized buffer, applying the key mask and
+ * zeroing the padding, so that it can be compared to the bucket keys with
+ * full 16-byte loads.
+ */
+static inline void
+keycpy_masked(uint64_t *dst, const uint64_t *key, const struct rte_table_hash *f)
+{
+	uint32_t i;
+
+	for (i = 0; i < f->key_size / 8; i++)
+		dst[i] = key[i] & f->key_mask[i];
+	for ( ; i < f->key_stride / 8; i++)
+		dst[i] = 0;
+}
+
+/*
+ * Return 0 when the two key_stride sized keys are equal. Both keys have to
+ * be 16-byte aligned.
+ */
+static inline uint64_t
+keycmp(const uint64_t *bkt_key, const uint64_t *key, uint32_t key_stride)
+{
+#if defined(RTE_ARCH_X86)
+	__m128i xor = _mm_setzero_si128();
+	uint32_t i;
+
+	for (i = 0; i < key_stride / 16; i++)
+		xor = _mm_or_si128(xor, _mm_xor_si128(
+			_mm_load_si128((const __m128i *) &bkt_key[2 * i]),
+			_mm_load_si128((const __m128i *) &key[2 * i])));
+
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(xor, _mm_setzero_si128())) !=
+		0xFFFF;
+#else
+	uint64_t xor = 0;
+	uint32_t i;
+
+	for (i = 0; i < key_stride / 8; i++)
+		xor |= bkt_key[i] ^ key[i];
+
+	return xor;
+#endif
+}
+
+static int
+check_params_create(uint32_t key_size, uint32_t n_entries,
+	rte_table_hash_op_hash f_hash)
+{
+	/* key_size */
+	if ((key_size == 0) || (key_size % 8) ||
+		(key_size > RTE_TABLE_HASH_KEY_SIZE_MAX)) {
+		RTE_LOG(ERR, TABLE, "%s: key_size invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	/* n_entries */
+	if (n_entries == 0) {
+		RTE_LOG(ERR, TABLE, "%s: n_entries is zero\n", __func__);
+		return -EINVAL;
+	}
+
+	/* f_hash */
+	if (f_hash == NULL) {
+		RTE_LOG(ERR, TABLE, "%s: f_hash function pointer is NULL\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static struct rte_table_hash *
+rte_table_hash_create_key64(uint32_t key_size, uint32_t n_entries,
+	uint32_t n_entries_ext, rte_table_hash_op_hash f_hash, uint64_t seed,
+	uint32_t signature_offset, uint32_t key_offset, uint8_t *key_mask,
+	int socket_id, uint32_t entry_size)
+{
+	struct rte_table_hash *f;
+	uint32_t n_buckets, n_buckets_ext, n_entries_per_bucket;
+	uint32_t key_stride, data_offset, bucket_size_cl, stack_size_cl;
+	uint32_t total_size, i;
+
+	/* Check input parameters */
+	if ((check_params_create(key_size, n_entries, f_hash) != 0) ||
+		((sizeof(struct rte_table_hash) % RTE_CACHE_LINE_SIZE) != 0) ||
+		((sizeof(struct rte_bucket_4_64) % 64) != 0))
+		return NULL;
+
+	n_entries_per_bucket = 4;
+	key_stride = RTE_ALIGN(key_size, 16);
+	data_offset = sizeof(struct rte_bucket_4_64) +
+		RTE_ALIGN(n_entries_per_bucket * key_stride, RTE_CACHE_LINE_SIZE);
+
+	/* Memory allocation */
+	n_buckets = rte_align32pow2((n_entries + n_entries_per_bucket - 1) /
+		n_entries_per_bucket);
+	n_buckets_ext = (n_entries_ext + n_entries_per_bucket - 1) /
+		n_entries_per_bucket;
+	bucket_size_cl = (data_offset + n_entries_per_bucket * entry_size +
+		RTE_CACHE_LINE_SIZE - 1) / RTE_CACHE_LINE_SIZE;
+	stack_size_cl = (n_buckets_ext * sizeof(uint32_t) +
+		RTE_CACHE_LINE_SIZE - 1) / RTE_CACHE_LINE_SIZE;
+	total_size = sizeof(struct rte_table_hash) +
+		((n_buckets + n_buckets_ext) * bucket_size_cl + stack_size_cl) *
+		RTE_CACHE_LINE_SIZE;
+
+	f = rte_zmalloc_socket("TABLE", total_size, RTE_CACHE_LINE_SIZE, socket_id);
+	if (f == NULL) {
+		RTE_LOG(ERR, TABLE,
+			"%s: Cannot allocate %u bytes for hash table\n",
+			__func__, total_size);
+		return NULL;
+	}
+	RTE_LOG(INFO, TABLE,
+		"%s: Hash table memory footprint is %u bytes\n", __func__,
+		total_size);
+
+	/* Memory initialization */
+	f->n_buckets = n_buckets;
+	f->n_entries_per_bucket = n_entries_per_bucket;
+	f->key_size = key_size;
+	f->entry_size = entry_size;
+	f->bucket_size = bucket_size_cl * RTE_CACHE_LINE_SIZE;
+	f->signature_offset = signature_offset;
+	f->key_offset = key_offset;
+	f->f_hash = f_hash;
+	f->seed = seed;
+	f->key_stride = key_stride;
+	f->data_offset = data_offset;
+
+	for (i = 0; i < key_size / 8; i++) {
+		if (key_mask != NULL)
+			f->key_mask[i] = ((uint64_t *)key_mask)[i];
+		else
+			f->key_mask[i] = 0xFFFFFFFFFFFFFFFFLLU;
+	}
+
+	f->n_buckets_ext = n_buckets_ext;
+	f->stack_pos = n_buckets_ext;
+	f->stack = (uint32_t *)
+		&f->memory[(n_buckets + n_buckets_ext) * f->bucket_size];
+
+	for (i = 0; i < n_buckets_ext; i++)
+		f->stack[i] = i;
+
+	for (i = 0; i < n_buckets; i++) {
+		struct rte_bucket_4_64 *bucket;
+
+		bucket = (struct rte_bucket_4_64 *) &f->memory[i *
+			f->bucket_size];
+		lru_init(bucket);
+	}
+
+	return f;
+}
+
+static void *
+rte_table_hash_create_key64_lru(void *params,
+		int socket_id,
+		uint32_t entry_size)
+{
+	struct rte_table_hash_key64_lru_params *p = params;
+
+	return rte_table_hash_create_key64(p->key_size, p->n_entries, 0,
+		p->f_hash, p->seed, p->signature_offset, p->key_offset,
+		p->key_mask, socket_id, entry_size);
+}
+
+static void *
+rte_table_hash_create_key64_ext(void *params,
+		int socket_id,
+		uint32_t entry_size)
+{
+	struct rte_table_hash_key64_ext_params *p = params;
+
+	/* n_entries_ext */
+	if (p->n_entries_ext == 0) {
+		RTE_LOG(ERR, TABLE, "%s: n_entries_ext is zero\n", __func__);
+		return NULL;
+	}
+
+	return rte_table_hash_create_key64(p->key_size, p->n_entries,
+		p->n_entries_ext, p->f_hash, p->seed, p->signature_offset,
+		p->key_offset, p->key_mask, socket_id, entry_size);
+}
+
+static int
+rte_table_hash_free_key64(void *table)
+{
+	struct rte_table_hash *f = table;
+
+	/* Check input parameters */
+	if (f == NULL) {
+		RTE_LOG(ERR, TABLE, "%s: table parameter is NULL\n", __func__);
+		return -EINVAL;
+	}
+
+	rte_free(f);
+	return 0;
+}
+
+static int
+rte_table_hash_entry_add_key64_lru(
+	void *table,
+	void *key,
+	void *entry,
+	int *key_found,
+	void **entry_ptr)
+{
+	struct rte_table_hash *f = table;
+	struct rte_bucket_4_64 *bucket;
+	uint64_t signature, pos;
+	uint64_t key_masked[RTE_TABLE_HASH_KEY_SIZE_MAX / 8] __rte_aligned(16);
+	uint32_t bucket_index, i;
+
+	/* Keys are masked on lookup, so they are stored masked */
+	keycpy_masked(key_masked, key, f);
+	key = key_masked;
+
+	signature = f->f_hash(key, f->key_size, f->seed);
+	bucket_index = signature & (f->n_buckets - 1);
+	bucket = (struct rte_bucket_4_64 *)
+		&f->memory[bucket_index * f->bucket_size];
+	signature |= RTE_BUCKET_ENTRY_VALID;
+
+	/* Key is present in the bucket */
+	for (i = 0; i < 4; i++) {
+		uint64_t bucket_signature = bucket->signature[i];
+		uint8_t *bucket_key = (uint8_t *) BUCKET_KEY(f, bucket, i);
+
+		if ((bucket_signature == signature) &&
+			(memcmp(key, bucket_key, f->key_size) == 0)) {
+			uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+			memcpy(bucket_data, entry, f->entry_size);
+			lru_update(bucket, i);
+			*key_found = 1;
+			*entry_ptr = (void *) bucket_data;
+			return 0;
+		}
+	}
+
+	/* Key is not present in the bucket */
+	for (i = 0; i < 4; i++) {
+		uint64_t bucket_signature = bucket->signature[i];
+		uint8_t *bucket_key = (uint8_t *) BUCKET_KEY(f, bucket, i);
+
+		if (bucket_signature == 0) {
+			uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+			bucket->signature[i] = signature;
+			memcpy(bucket_key, key, f->key_size);
+			memcpy(bucket_data, entry, f->entry_size);
+			lru_update(bucket, i);
+			*key_found = 0;
+			*entry_ptr = (void *) bucket_data;
+
+			return 0;
+		}
+	}
+
+	/* Bucket full: replace LRU entry */
+	pos = lru_pos(bucket);
+	bucket->signature[pos] = signature;
+	memcpy(BUCKET_KEY(f, bucket, pos), key, f->key_size);
+	memcpy(BUCKET_DATA(f, bucket, pos), entry, f->entry_size);
+	lru_update(bucket, pos);
+	*key_found = 0;
+	*entry_ptr = (void *) BUCKET_DATA(f, bucket, pos);
+
+	return 0;
+}
+
+static int
+rte_table_hash_entry_delete_key64_lru(
+	void *table,
+	void *key,
+	int *key_found,
+	void *entry)
+{
+	struct rte_table_hash *f = table;
+	struct rte_bucket_4_64 *bucket;
+	uint64_t signature;
+	uint64_t key_masked[RTE_TABLE_HASH_KEY_SIZE_MAX / 8] __rte_aligned(16);
+	uint32_t bucket_index, i;
+
+	/* Keys are masked on lookup, so they are stored masked */
+	keycpy_masked(key_masked, key, f);
+	key = key_masked;
+
+	signature = f->f_hash(key, f->key_size, f->seed);
+	bucket_index = signature & (f->n_buckets - 1);
+	bucket = (struct rte_bucket_4_64 *)
+		&f->memory[bucket_index * f->bucket_size];
+	signature |= RTE_BUCKET_ENTRY_VALID;
+
+	/* Key is present in the bucket */
+	for (i = 0; i < 4; i++) {
+		uint64_t bucket_signature = bucket->signature[i];
+		uint8_t *bucket_key = (uint8_t *) BUCKET_KEY(f, bucket, i);
+
+		if ((bucket_signature == signature) &&
+			(memcmp(key, bucket_key, f->key_size) == 0)) {
+			uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+			bucket->signature[i] = 0;
+			*key_found = 1;
+			if (entry)
+				memcpy(entry, bucket_data, f->entry_size);
+
+			return 0;
+		}
+	}
+
+	/* Key is not present in the bucket */
+	*key_found = 0;
+	return 0;
+}
+
+static int
+rte_table_hash_entry_add_key64_ext(
+	void *table,
+	void *key,
+	void *entry,
+	int *key_found,
+	void **entry_ptr)
+{
+	struct rte_table_hash *f = table;
+	struct rte_bucket_4_64 *bucket0, *bucket, *bucket_prev;
+	uint64_t signature;
+	uint64_t key_masked[RTE_TABLE_HASH_KEY_SIZE_MAX / 8] __rte_aligned(16);
+	uint32_t bucket_index, i;
+
+	/* Keys are masked on lookup, so they are stored masked */
+	keycpy_masked(key_masked, key, f);
+	key = key_masked;
+
+	signature = f->f_hash(key, f->key_size, f->seed);
+	bucket_index = signature & (f->n_buckets - 1);
+	bucket0 = (struct rte_bucket_4_64 *)
+		&f->memory[bucket_index * f->bucket_size];
+	signature |= RTE_BUCKET_ENTRY_VALID;
+
+	/* Key is present in the bucket */
+	for (bucket = bucket0; bucket != NULL; bucket = bucket->next)
+		for (i = 0; i < 4; i++) {
+			uint64_t bucket_signature = bucket->signature[i];
+			uint8_t *bucket_key = (uint8_t *)
+				BUCKET_KEY(f, bucket, i);
+
+			if ((bucket_signature == signature) &&
+				(memcmp(key, bucket_key, f->key_size) == 0)) {
+				uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+				memcpy(bucket_data, entry, f->entry_size);
+				*key_found = 1;
+				*entry_ptr = (void *) bucket_data;
+				return 0;
+			}
+		}
+
+	/* Key is not present in the bucket */
+	for (bucket_prev = NULL, bucket = bucket0; bucket != NULL;
+		bucket_prev = bucket, bucket = bucket->next)
+		for (i = 0; i < 4; i++) {
+			uint64_t bucket_signature = bucket->signature[i];
+			uint8_t *bucket_key = (uint8_t *)
+				BUCKET_KEY(f, bucket, i);
+
+			if (bucket_signature == 0) {
+				uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+				bucket->signature[i] = signature;
+				memcpy(bucket_key, key, f->key_size);
+				memcpy(bucket_data, entry, f->entry_size);
+				*key_found = 0;
+				*entry_ptr = (void *) bucket_data;
+
+				return 0;
+			}
+		}
+
+	/* Bucket full: extend bucket */
+	if (f->stack_pos > 0) {
+		bucket_index = f->stack[--f->stack_pos];
+
+		bucket = (struct rte_bucket_4_64 *)
+			&f->memory[(f->n_buckets + bucket_index) *
+			f->bucket_size];
+		bucket_prev->next = bucket;
+		bucket_prev->next_valid = 1;
+
+		bucket->signature[0] = signature;
+		memcpy(BUCKET_KEY(f, bucket, 0), key, f->key_size);
+		memcpy(BUCKET_DATA(f, bucket, 0), entry, f->entry_size);
+		*key_found = 0;
+		*entry_ptr = (void *) BUCKET_DATA(f, bucket, 0);
+		return 0;
+	}
+
+	return -ENOSPC;
+}
+
+static int
+rte_table_hash_entry_delete_key64_ext(
+	void *table,
+	void *key,
+	int *key_found,
+	void *entry)
+{
+	struct rte_table_hash *f = table;
+	struct rte_bucket_4_64 *bucket0, *bucket, *bucket_prev;
+	uint64_t signature;
+	uint64_t key_masked[RTE_TABLE_HASH_KEY_SIZE_MAX / 8] __rte_aligned(16);
+	uint32_t bucket_index, i;
+
+	/* Keys are masked on lookup, so they are stored masked */
+	keycpy_masked(key_masked, key, f);
+	key = key_masked;
+
+	signature = f->f_hash(key, f->key_size, f->seed);
+	bucket_index = signature & (f->n_buckets - 1);
+	bucket0 = (struct rte_bucket_4_64 *)
+		&f->memory[bucket_index * f->bucket_size];
+	signature |= RTE_BUCKET_ENTRY_VALID;
+
+	/* Key is present in the bucket */
+	for (bucket_prev = NULL, bucket = bucket0; bucket != NULL;
+		bucket_prev = bucket, bucket = bucket->next)
+		for (i = 0; i < 4; i++) {
+			uint64_t bucket_signature = bucket->signature[i];
+			uint8_t *bucket_key = (uint8_t *)
+				BUCKET_KEY(f, bucket, i);
+
+			if ((bucket_signature == signature) &&
+				(memcmp(key, bucket_key, f->key_size) == 0)) {
+				uint8_t *bucket_data = BUCKET_DATA(f, bucket, i);
+
+				bucket->signature[i] = 0;
+				*key_found = 1;
+				if (entry)
+					memcpy(entry, bucket_data,
+						f->entry_size);
+
+				if ((bucket->signature[0] == 0) &&
+						(bucket->signature[1] == 0) &&
+						(bucket->signature[2] == 0) &&
+						(bucket->signature[3] == 0) &&
+						(bucket_prev != NULL)) {
+					bucket_prev->next = bucket->next;
+					bucket_prev->next_valid =
+						bucket->next_valid;
+
+					/* Keep the key padding zeroed */
+					memset(bucket, 0, f->data_offset);
+					bucket_index = (((uint8_t *)bucket -
+						(uint8_t *)f->memory)/f->bucket_size) - f->n_buckets;
+					f->stack[f->stack_pos++] = bucket_index;
+				}
+
+				return 0;
+			}
+		}
+
+	/* Key is not present in the bucket */
+	*key_found = 0;
+	return 0;
+}
+
+/*
+ * Search the bucket chain for the key. Return the bucket holding the key,
+ * with its position in *pos, or NULL when the key is not found.
+ */
+static inline struct rte_bucket_4_64 *
+lookup_chain(struct rte_table_hash *f, struct rte_bucket_4_64 *bucket,
+	const uint64_t *key, uint32_t signature, uint32_t *pos)
+{
+	uint32_t i;
+
+	for ( ; bucket != NULL; bucket = bucket->next)
+		for (i = 0; i < 4; i++) {
+			if (((uint32_t) bucket->signature[i] == signature) &&
+				(keycmp(BUCKET_KEY(f, bucket, i), key,
+					f->key_stride) == 0)) {
+				*pos = i;
+				return bucket;
+			}
+		}
+
+	return NULL;
+}
+
+static inline void
+rte_table_hash_lookup_key64_unoptimized(
+	struct rte_table_hash *f,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *pkts_mask_out,
+	void **entries,
+	int dosig,
+	int lru)
+{
+	for ( ; pkts_mask; ) {
+		struct rte_bucket_4_64 *bucket;
+		struct rte_mbuf *mbuf;
+		uint64_t key[RTE_TABLE_HASH_KEY_SIZE_MAX / 8] __rte_aligned(16);
+		uint64_t pkt_mask, signature;
+		uint32_t pkt_index, bucket_index, pos;
+
+		pkt_index = __builtin_ctzll(pkts_mask);
+		pkt_mask = 1LLU << pkt_index;
+		pkts_mask &= ~pkt_mask;
+
+		mbuf = pkts[pkt_index];
+		keycpy_masked(key,
+			RTE_MBUF_METADATA_UINT64_PTR(mbuf, f->key_offset), f);
+		if (dosig)
+			signature = f->f_hash(key, f->key_size, f->seed);
+		else
+			signature = RTE_MBUF_METADATA_UINT32(mbuf,
+				f->signature_offset);
+
+		bucket_index = signature & (f->n_buckets - 1);
+		bucket = (struct rte_bucket_4_64 *)
+			&f->memory[bucket_index * f->bucket_size];
+
+		bucket = lookup_chain(f, bucket, key,
+			(uint32_t) (signature | RTE_BUCKET_ENTRY_VALID), &pos);
+		if (bucket == NULL)
+			continue;
+
+		entries[pkt_index] = BUCKET_DATA(f, bucket, pos);
+		*pkts_mask_out |= pkt_mask;
+		if (lru)
+			lru_update(bucket, pos);
+	}
+}
+
+/*
+ * Same match LUTs as the configurable key size extendible bucket table:
+ * mask is the bitmask of the bucket entries whose signature matches.
+ */
+#define LUT_MATCH						0xFFFELLU
+#define LUT_MATCH_MANY						0xFEE8LLU
+#define LUT_MATCH_POS						0x12131210LLU
+
+#define lookup_cmp_sig(mbuf_sig, bucket, match, match_many, match_pos)	\
+{									\
+	uint64_t mask[4], mask_all;					\
+									\
+	mask[0] = 0;							\
+	mask[1] = 0;							\
+	mask[2] = 0;							\
+	mask[3] = 0;							\
+									\
+	if ((uint32_t) bucket->signature[0] == mbuf_sig)		\
+		mask[0] = 1;						\
+	if ((uint32_t) bucket->signature[1] == mbuf_sig)		\
+		mask[1] = 2;						\
+	if ((uint32_t) bucket->signature[2] == mbuf_sig)		\
+		mask[2] = 4;						\
+	if ((uint32_t) bucket->signature[3] == mbuf_sig)		\
+		mask[3] = 8;						\
+									\
+	mask_all = (mask[0] | mask[1]) | (mask[2] | mask[3]);		\
+									\
+	match = (LUT_MATCH >> mask_all) & 1;				\
+	match_many = (LUT_MATCH_MANY >> mask_all) & 1;			\
+	match_pos = (LUT_MATCH_POS >> (mask_all << 1)) & 3;		\
+}
+
+#define lookup2_stage0(f, pkts, pkts_mask, pkt00_index, pkt01_index)	\
+{									\
+	uint64_t pkt00_mask, pkt01_mask;				\
+	struct rte_mbuf *mbuf00, *mbuf01;				\
+	uint32_t key_offset = f->key_offset;				\
+									\
+	pkt00_index = __builtin_ctzll(pkts_mask);			\
+	pkt00_mask = 1LLU << pkt00_index;				\
+	pkts_mask &= ~pkt00_mask;					\
+	mbuf00 = pkts[pkt00_index];					\
+									\
+	pkt01_index = __builtin_ctzll(pkts_mask);			\
+	pkt01_mask = 1LLU << pkt01_index;				\
+	pkts_mask &= ~pkt01_mask;					\
+	mbuf01 = pkts[pkt01_index];					\
+									\
+	rte_prefetch0(RTE_MBUF_METADATA_UINT8_PTR(mbuf00, key_offset));\
+	rte_prefetch0(RTE_MBUF_METADATA_UINT8_PTR(mbuf01, key_offset));\
+}
+
+#define lookup2_stage0_with_odd_support(f, pkts, pkts_mask, pkt00_index,\
+	pkt01_index)							\
+{									\
+	uint64_t pkt00_mask, pkt01_mask;				\
+	struct rte_mbuf *mbuf00, *mbuf01;				\
+	uint32_t key_offset = f->key_offset;				\
+									\
+	pkt00_index = __builtin_ctzll(pkts_mask);			\
+	pkt00_mask = 1LLU << pkt00_index;				\
+	pkts_mask &= ~pkt00_mask;					\
+	mbuf00 = pkts[pkt00_index];					\
+									\
+	pkt01_index = __builtin_ctzll(pkts_mask);			\
+	if (pkts_mask == 0)						\
+		pkt01_index = pkt00_index;				\
+	pkt01_mask = 1LLU << pkt01_index;				\
+	pkts_mask &= ~pkt01_mask;					\
+	mbuf01 = pkts[pkt01_index];					\
+									\
+	rte_prefetch0(RTE_MBUF_METADATA_UINT8_PTR(mbuf00, key_offset));\
+	rte_prefetch0(RTE_MBUF_METADATA_UINT8_PTR(mbuf01, key_offset));\
+}
+
+#define lookup2_stage1(f, g, pkts, pkt10_index, pkt11_index, dosig)	\
+{									\
+	struct grinder *g10, *g11;					\
+	uint64_t sig10, sig11;						\
+	struct rte_mbuf *mbuf10, *mbuf11;				\
+	struct rte_bucket_4_64 *bkt10, *bkt11;				\
+	uint32_t key_offset = f->key_offset;				\
+	uint32_t signature_offset = f->signature_offset;		\
+	uint64_t bucket_mask = f->n_buckets - 1;			\
+									\
+	mbuf10 = pkts[pkt10_index];					\
+	g10 = &g[pkt10_index];						\
+	keycpy_masked(g10->key,						\
+		RTE_MBUF_METADATA_UINT64_PTR(mbuf10, key_offset), f);	\
+	if (dosig)							\
+		sig10 = f->f_hash(g10->key, f->key_size, f->seed);	\
+	else								\
+		sig10 = RTE_MBUF_METADATA_UINT32(mbuf10, signature_offset);\
+	bkt10 = (struct rte_bucket_4_64 *)				\
+		&f->memory[(sig10 & bucket_mask) * f->bucket_size];	\
+									\
+	mbuf11 = pkts[pkt11_index];					\
+	g11 = &g[pkt11_index];						\
+	keycpy_masked(g11->key,						\
+		RTE_MBUF_METADATA_UINT64_PTR(mbuf11, key_offset), f);	\
+	if (dosig)							\
+		sig11 = f->f_hash(g11->key, f->key_size, f->seed);	\
+	else								\
+		sig11 = RTE_MBUF_METADATA_UINT32(mbuf11, signature_offset);\
+	bkt11 = (struct rte_bucket_4_64 *)				\
+		&f->memory[(sig11 & bucket_mask) * f->bucket_size];	\
+									\
+	rte_prefetch0(bkt10);						\
+	rte_prefetch0(bkt11);						\
+									\
+	g10->sig = sig10;						\
+	g10->bkt = bkt10;						\
+									\
+	g11->sig = sig11;						\
+	g11->bkt = bkt11;						\
+}
+
+#define lookup2_stage2(f, g, pkt20_index, pkt21_index, pkts_mask_match_many)\
+{									\
+	struct grinder *g20, *g21;					\
+	uint32_t sig20, sig21;						\
+	struct rte_bucket_4_64 *bkt20, *bkt21;				\
+	uint8_t *key20, *key21;						\
+	uint64_t match20, match21, match_many20, match_many21;		\
+	uint64_t match_pos20, match_pos21;				\
+	uint32_t key_stride = f->key_stride;				\
+									\
+	g20 = &g[pkt20_index];						\
+	sig20 = (uint32_t) (g20->sig | RTE_BUCKET_ENTRY_VALID);		\
+	bkt20 = g20->bkt;						\
+	lookup_cmp_sig(sig20, bkt20, match20, match_many20, match_pos20);\
+	match20 <<= pkt20_index;					\
+	match_many20 |= bkt20->next_valid;				\
+	match_many20 <<= pkt20_index;					\
+	key20 = (uint8_t *) BUCKET_KEY(f, bkt20, match_pos20);		\
+									\
+	g21 = &g[pkt21_index];						\
+	sig21 = (uint32_t) (g21->sig | RTE_BUCKET_ENTRY_VALID);		\
+	bkt21 = g21->bkt;						\
+	lookup_cmp_sig(sig21, bkt21, match21, match_many21, match_pos21);\
+	match21 <<= pkt21_index;					\
+	match_many21 |= bkt21->next_valid;				\
+	match_many21 <<= pkt21_index;					\
+	key21 = (uint8_t *) BUCKET_KEY(f, bkt21, match_pos21);		\
+									\
+	rte_prefetch0(key20);						\
+	rte_prefetch0(key20 + key_stride - 1);				\
+	rte_prefetch0(key21);						\
+	rte_prefetch0(key21 + key_stride - 1);				\
+									\
+	pkts_mask_match_many |= match_many20 | match_many21;		\
+									\
+	g20->match = match20;						\
+	g20->key_pos = match_pos20;					\
+									\
+	g21->match = match21;						\
+	g21->key_pos = match_pos21;					\
+}
+
+#define lookup2_stage3(f, g, pkt30_index, pkt31_index, pkts_mask_out,	\
+	entries, lru)							\
+{									\
+	struct grinder *g30, *g31;					\
+	struct rte_bucket_4_64 *bkt30, *bkt31;				\
+	uint8_t *data30, *data31;					\
+	uint64_t match_key30, match_key31;				\
+	uint32_t pos30, pos31;						\
+	uint32_t key_stride = f->key_stride;				\
+									\
+	g30 = &g[pkt30_index];						\
+	bkt30 = g30->bkt;						\
+	pos30 = g30->key_pos;						\
+	match_key30 = (keycmp(BUCKET_KEY(f, bkt30, pos30), g30->key,	\
+		key_stride) == 0);					\
+	match_key30 = (match_key30 << pkt30_index) & g30->match;	\
+	data30 = BUCKET_DATA(f, bkt30, pos30);				\
+	entries[pkt30_index] = data30;					\
+									\
+	g31 = &g[pkt31_index];						\
+	bkt31 = g31->bkt;						\
+	pos31 = g31->key_pos;						\
+	match_key31 = (keycmp(BUCKET_KEY(f, bkt31, pos31), g31->key,	\
+		key_stride) == 0);					\
+	match_key31 = (match_key31 << pkt31_index) & g31->match;	\
+	data31 = BUCKET_DATA(f, bkt31, pos31);				\
+	entries[pkt31_index] = data31;					\
+									\
+	rte_prefetch0(data30);						\
+	rte_prefetch0(data31);						\
+									\
+	if (lru && match_key30)						\
+		lru_update(bkt30, pos30);				\
+	if (lru && match_key31)						\
+		lru_update(bkt31, pos31);				\
+									\
+	pkts_mask_out |= match_key30 | match_key31;			\
+}
+
+/***
+* The lookup function implements a 4-stage pipeline, with each stage processing
+* two different packets:
+*    stage 0: prefetch the packet key;
+*    stage 1: copy and mask the key, get the signature, prefetch the bucket;
+*    stage 2: compare the bucket signatures, prefetch the matching bucket key;
+*    stage 3: compare the keys with 16-byte vector loads, prefetch the data.
+* Only the cache lines of the one candidate key are brought in, so the cost
+* of a lookup does not grow with the key size. Packets whose bucket has
+* several matching signatures or extension buckets, and that stage 3 did not
+* resolve, go through a slower per-packet search of the whole bucket chain.
+*
+*  p00  _______   p10  _______   p20  _______   p30  _______
+*----->|       |----->|       |----->|       |----->|       |----->
+*      |   0   |      |   1   |      |   2   |      |   3   |
+*----->|_______|----->|_______|----->|_______|----->|_______|----->
+*  p01            p11            p21            p31
+*
+* The naming convention is:
+*    pXY = packet Y of stage X, X = 0 .. 3, Y = 0 .. 1
+*
+***/
+static __rte_always_inline int
+rte_table_hash_lookup_key64(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries,
+	int dosig,
+	int lru)
+{
+	struct rte_table_hash *f = (struct rte_table_hash *) table;
+	struct grinder *g = f->grinders;
+	uint64_t pkt00_index, pkt01_index, pkt10_index, pkt11_index;
+	uint64_t pkt20_index, pkt21_index, pkt30_index, pkt31_index;
+	uint64_t pkts_mask_out = 0, pkts_mask_match_many = 0;
+
+	__rte_unused uint32_t n_pkts_in = __builtin_popcountll(pkts_mask);
+	RTE_TABLE_HASH_KEY64_STATS_PKTS_IN_ADD(f, n_pkts_in);
+
+	/* Cannot run the pipeline with less than 7 packets */
+	if (__builtin_popcountll(pkts_mask) < 7) {
+		rte_table_hash_lookup_key64_unoptimized(f, pkts, pkts_mask,
+			&pkts_mask_out, entries, dosig, lru);
+		*lookup_hit_mask = pkts_mask_out;
+		RTE_TABLE_HASH_KEY64_STATS_PKTS_LOOKUP_MISS(f, n_pkts_in -
+			__builtin_popcountll(pkts_mask_out));
+		return 0;
+	}
+
+	/* Pipeline stage 0 */
+	lookup2_stage0(f, pkts, pkts_mask, pkt00_index, pkt01_index);
+
+	/* Pipeline feed */
+	pkt10_index = pkt00_index;
+	pkt11_index = pkt01_index;
+
+	/* Pipeline stage 0 */
+	lookup2_stage0(f, pkts, pkts_mask, pkt00_index, pkt01_index);
+
+	/* Pipeline stage 1 */
+	lookup2_stage1(f, g, pkts, pkt10_index, pkt11_index, dosig);
+
+	/* Pipeline feed */
+	pkt20_index = pkt10_index;
+	pkt21_index = pkt11_index;
+	pkt10_index = pkt00_index;
+	pkt11_index = pkt01_index;
+
+	/* Pipeline stage 0 */
+	lookup2_stage0(f, pkts, pkts_mask, pkt00_index, pkt01_index);
+
+	/* Pipeline stage 1 */
+	lookup2_stage1(f, g, pkts, pkt10_index, pkt11_index, dosig);
+
+	/* Pipeline stage 2 */
+	lookup2_stage2(f, g, pkt20_index, pkt21_index, pkts_mask_match_many);
+
+	/*
+	* Pipeline run
+	*
+	*/
+	for ( ; pkts_mask; ) {
+		/* Pipeline feed */
+		pkt30_index = pkt20_index;
+		pkt31_index = pkt21_index;
+		pkt20_index = pkt10_index;
+		pkt21_index = pkt11_index;
+		pkt10_index = pkt00_index;
+		pkt11_index = pkt01_index;
+
+		/* Pipeline stage 0 */
+		lookup2_stage0_with_odd_support(f, pkts, pkts_mask,
+			pkt00_index, pkt01_index);
+
+		/* Pipeline stage 1 */
+		lookup2_stage1(f, g, pkts, pkt10_index, pkt11_index, dosig);
+
+		/* Pipeline stage 2 */
+		lookup2_stage2(f, g, pkt20_index, pkt21_index,
+			pkts_mask_match_many);
+
+		/* Pipeline stage 3 */
+		lookup2_stage3(f, g, pkt30_index, pkt31_index, pkts_mask_out,
+			entries, lru);
+	}
+
+	/* Pipeline feed */
+	pkt30_index = pkt20_index;
+	pkt31_index = pkt21_index;
+	pkt20_index = pkt10_index;
+	pkt21_index = pkt11_index;
+	pkt10_index = pkt00_index;
+	pkt11_index = pkt01_index;
+
+	/* Pipeline stage 1 */
+	lookup2_stage1(f, g, pkts, pkt10_index, pkt11_index, dosig);
+
+	/* Pipeline stage 2 */
+	lookup2_stage2(f, g, pkt20_index, pkt21_index, pkts_mask_match_many);
+
+	/* Pipeline stage 3 */
+	lookup2_stage3(f, g, pkt30_index, pkt31_index, pkts_mask_out,
+		entries, lru);
+
+	/* Pipeline feed */
+	pkt30_index = pkt20_index;
+	pkt31_index = pkt21_index;
+	pkt20_index = pkt10_index;
+	pkt21_index = pkt11_index;
+
+	/* Pipeline stage 2 */
+	lookup2_stage2(f, g, pkt20_index, pkt21_index, pkts_mask_match_many);
+
+	/* Pipeline stage 3 */
+	lookup2_stage3(f, g, pkt30_index, pkt31_index, pkts_mask_out,
+		entries, lru);
+
+	/* Pipeline feed */
+	pkt30_index = pkt20_index;
+	pkt31_index = pkt21_index;
+
+	/* Pipeline stage 3 */
+	lookup2_stage3(f, g, pkt30_index, pkt31_index, pkts_mask_out,
+		entries, lru);
+
+	/* Slow path */
+	pkts_mask_match_many &= ~pkts_mask_out;
+	if (pkts_mask_match_many)
+		rte_table_hash_lookup_key64_unoptimized(f, pkts,
+			pkts_mask_match_many, &pkts_mask_out, entries, dosig,
+			lru);
+
+	*lookup_hit_mask = pkts_mask_out;
+	RTE_TABLE_HASH_KEY64_STATS_PKTS_LOOKUP_MISS(f, n_pkts_in -
+		__builtin_popcountll(pkts_mask_out));
+	return 0;
+}
+
+static int
+rte_table_hash_lookup_key64_lru(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries)
+{
+	return rte_table_hash_lookup_key64(table, pkts, pkts_mask,
+		lookup_hit_mask, entries, 0, 1);
+}
+
+static int
+rte_table_hash_lookup_key64_lru_dosig(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries)
+{
+	return rte_table_hash_lookup_key64(table, pkts, pkts_mask,
+		lookup_hit_mask, entries, 1, 1);
+}
+
+static int
+rte_table_hash_lookup_key64_ext(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries)
+{
+	return rte_table_hash_lookup_key64(table, pkts, pkts_mask,
+		lookup_hit_mask, entries, 0, 0);
+}
+
+static int
+rte_table_hash_lookup_key64_ext_dosig(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries)
+{
+	return rte_table_hash_lookup_key64(table, pkts, pkts_mask,
+		lookup_hit_mask, entries, 1, 0);
+}
+
+static int
+rte_table_hash_key64_stats_read(void *table, struct rte_table_stats *stats, int clear)
+{
+	struct rte_table_hash *t = table;
+
+	if (stats != NULL)
+		memcpy(stats, &t->stats, sizeof(t->stats));
+
+	if (clear)
+		memset(&t->stats, 0, sizeof(t->stats));
+
+	return 0;
+}
+
+struct rte_table_ops rte_table_hash_key64_lru_ops = {
+	.f_create = rte_table_hash_create_key64_lru,
+	.f_free = rte_table_hash_free_key64,
+	.f_add = rte_table_hash_entry_add_key64_lru,
+	.f_delete = rte_table_hash_entry_delete_key64_lru,
+	.f_add_bulk = NULL,
+	.f_delete_bulk = NULL,
+	.f_lookup = rte_table_hash_lookup_key64_lru,
+	.f_stats = rte_table_hash_key64_stats_read,
+};
+
+struct rte_table_ops rte_table_hash_key64_lru_dosig_ops = {
+	.f_create = rte_table_hash_create_key64_lru,
+	.f_free = rte_table_hash_free_key64,
+	.f_add = rte_table_hash_entry_add_key64_lru,
+	.f_delete = rte_table_hash_entry_delete_key64_lru,
+	.f_add_bulk = NULL,
+	.f_delete_bulk = NULL,
+	.f_lookup = rte_table_hash_lookup_key64_lru_dosig,
+	.f_stats = rte_table_hash_key64_stats_read,
+};
+
+struct rte_table_ops rte_table_hash_key64_ext_ops = {
+	.f_create = rte_table_hash_create_key64_ext,
+	.f_free = rte_table_hash_free_key64,
+	.f_add = rte_table_hash_entry_add_key64_ext,
+	.f_delete = rte_table_hash_entry_delete_key64_ext,
+	.f_add_bulk = NULL,
+	.f_delete_bulk = NULL,
+	.f_lookup = rte_table_hash_lookup_key64_ext,
+	.f_stats = rte_table_hash_key64_stats_read,
+};
+
+struct rte_table_ops rte_table_hash_key64_ext_dosig_ops = {
+	.f_create = rte_table_hash_create_key64_ext,
+	.f_free = rte_table_hash_free_key64,
+	.f_add = rte_table_hash_entry_add_key64_ext,
+	.f_delete = rte_table_hash_entry_delete_key64_ext,
+	.f_add_bulk = NULL,
+	.f_delete_bulk = NULL,
+	.f_lookup = rte_table_hash_lookup_key64_ext_dosig,
+	.f_stats = rte_table_hash_key64_stats_read,
+};
@@ -66,6 +66,7 @@
 #define	OPT_BLD_CATEGORIES	"bldcat"
 #define	OPT_RUN_CATEGORIES	"runcat"
 #define	OPT_MAX_SIZE		"maxsize"
+#define	OPT_BLD_THREADS		"bldthreads"
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
@@ -109,6 +110,10 @@ static const struct acl_alg acl_alg[] = {
 		.name = "altivec",
 		.alg = RTE_ACL_CLASSIFY_ALTIVEC,
 	},
+	{
+		.name = "avx512",
+		.alg = RTE_ACL_CLASSIFY_AVX512,
+	},
 };
 
 static struct {
@@ -116,6 +121,7 @@ static struct {
 	const char         *rule_file;
 	const char         *trace_file;
 	size_t              max_size;
+	uint32_t            bld_threads;
 	uint32_t            bld_categories;
 	uint32_t            run_categories;
 	uint32_t            nb_rules;
@@ -800,6 +806,7 @@ acx_init(void)
 	}
 	cfg.num_categories = config.bld_categories;
 	cfg.max_size = config.max_size;
+	cfg.num_threads = config.bld_threads;
 
 	/* setup ACL creation parameters. */
 	prm.rule_size = RTE_ACL_RULE_SZ(cfg.num_fields);
@@ -978,6 +985,8 @@ print_usage(const char *prgname)
 		"[--" OPT_MAX_SIZE
 			"=<size limit (in bytes) for runtime ACL strucutures> "
 			"leave 0 for default behaviour]\n"
+		"[--" OPT_BLD_THREADS
+			"=<number of threads to build with>]\n"
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
@@ -999,6 +1008,7 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u\n", OPT_BLD_CATEGORIES, config.bld_categories);
 	fprintf(f, "%s:%u\n", OPT_RUN_CATEGORIES, config.run_categories);
 	fprintf(f, "%s:%zu\n", OPT_MAX_SIZE, config.max_size);
+	fprintf(f, "%s:%u\n", OPT_BLD_THREADS, config.bld_threads);
 	fprintf(f, "%s:%u\n", OPT_ITER_NUM, config.iter_num);
 	fprintf(f, "%s:%u\n", OPT_VERBOSE, config.verbose);
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
@@ -1026,6 +1036,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_TRACE_NUM, 1, 0, 0},
 		{OPT_RULE_NUM, 1, 0, 0},
 		{OPT_MAX_SIZE, 1, 0, 0},
+		{OPT_BLD_THREADS, 1, 0, 0},
 		{OPT_TRACE_STEP, 1, 0, 0},
 		{OPT_BLD_CATEGORIES, 1, 0, 0},
 		{OPT_RUN_CATEGORIES, 1, 0, 0},
@@ -1055,6 +1066,9 @@ get_input_opts(int argc, char **argv)
 		} else if (strcmp(lgopts[opt_idx].name, OPT_MAX_SIZE) == 0) {
 			config.max_size = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 0, SIZE_MAX);
+		} else if (strcmp(lgopts[opt_idx].name, OPT_BLD_THREADS) == 0) {
+			config.bld_threads = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, UINT32_MAX);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_TRACE_NUM) == 0) {
 			config.nb_traces = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 1, UINT32_MAX);
@@ -41,7 +41,13 @@
 #include <rte_byteorder.h>
 #include <rte_ip.h>
 #include <rte_acl.h>
+#include <rte_atomic.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
 
 #include "test_acl.h"
 
@@ -1626,6 +1632,766 @@ test_misc(void)
 	return 0;
 }
 
+/*
+ * Test incremental updates: classify must return the same results as a
+ * context built with the whole rule set, after additions, deletions and
+ * compaction.
+ */
+static int
+test_update(void)
+{
+	struct rte_acl_ctx *acx;
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+	const uint32_t num = RTE_DIM(acl_test_rules);
+	const uint32_t half = num / 2;
+	uint32_t i;
+	int ret;
+
+	memset(rules, 0, sizeof(rules));
+	for (i = 0; i != num; i++)
+		acl_ipv4vlan_convert_rule(&acl_test_rules[i], &rules[i]);
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	/* updates need a built context. */
+	ret = rte_acl_update_add(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret != -EINVAL) {
+		printf("Line %i: Update of an unbuilt context "
+			"should have failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules, half);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* add the second half one by one. */
+	for (i = half; i != num; i++) {
+		ret = rte_acl_update_add(acx,
+			(struct rte_acl_rule *)&rules[i], 1);
+		if (ret != 0) {
+			printf("Line %i: Adding rule %u failed!\n",
+				__LINE__, i);
+			goto err;
+		}
+	}
+
+	ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: %s failed after additions!\n",
+			__LINE__, __func__);
+		goto err;
+	}
+
+	/* delete and add back the second half. */
+	ret = rte_acl_update_del(acx, (struct rte_acl_rule *)&rules[half],
+		num - half);
+	if (ret == 0)
+		ret = rte_acl_update_del(acx,
+			(struct rte_acl_rule *)&rules[half], 1);
+	if (ret != -ENOENT) {
+		printf("Line %i: Deleting a missing rule "
+			"should have failed!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_update_add(acx, (struct rte_acl_rule *)&rules[half],
+		num - half);
+	if (ret == 0)
+		ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: %s failed after deletions!\n",
+			__LINE__, __func__);
+		goto err;
+	}
+
+	/* compact without the first half, then add it back. */
+	ret = rte_acl_update_del(acx, (struct rte_acl_rule *)rules, half);
+	if (ret == 0)
+		ret = rte_acl_update_compact(acx);
+	if (ret == 0)
+		ret = rte_acl_update_add(acx, (struct rte_acl_rule *)rules,
+			half);
+	if (ret == 0)
+		ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: %s failed after compaction!\n",
+			__LINE__, __func__);
+		goto err;
+	}
+
+	/* a full build drops the updates. */
+	ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret == 0)
+		ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: %s failed after rebuild!\n",
+			__LINE__, __func__);
+		goto err;
+	}
+
+err:
+	rte_acl_free(acx);
+	return ret;
+}
+
+#define	TEST_UPDATE_PERF_RULES		10000
+#define	TEST_UPDATE_PERF_UPDATES	64
+#define	TEST_UPDATE_PERF_INPUTS		4096
+#define	TEST_UPDATE_PERF_CATEGORIES	4
+
+/* Random 5-tuple rule, priorities are unique. */
+static void
+update_perf_rule(struct acl_ipv4vlan_rule *rule, uint32_t id)
+{
+	struct rte_acl_ipv4vlan_rule r;
+	uint16_t port;
+
+	memset(&r, 0, sizeof(r));
+	r.data.priority = id + 1;
+	r.data.userdata = id + 1;
+	r.data.category_mask = 1 + rte_rand() %
+		RTE_LEN2MASK(TEST_UPDATE_PERF_CATEGORIES, uint32_t);
+
+	if (rte_rand() % 4 != 0) {
+		r.proto = (rte_rand() & 1) ? IPPROTO_TCP : IPPROTO_UDP;
+		r.proto_mask = UINT8_MAX;
+	}
+	r.src_mask_len = 8 + rte_rand() % 25;
+	r.src_addr = (uint32_t)rte_rand() &
+		RTE_ACL_MASKLEN_TO_BITMASK(r.src_mask_len, sizeof(uint32_t));
+	r.dst_mask_len = 16 + rte_rand() % 17;
+	r.dst_addr = (uint32_t)rte_rand() &
+		RTE_ACL_MASKLEN_TO_BITMASK(r.dst_mask_len, sizeof(uint32_t));
+	r.src_port_high = UINT16_MAX;
+	r.dst_port_high = UINT16_MAX;
+	if (rte_rand() & 1) {
+		port = rte_rand() % 1024;
+		r.dst_port_low = port;
+		r.dst_port_high = port + rte_rand() % 16;
+	}
+
+	memset(rule, 0, sizeof(*rule));
+	acl_ipv4vlan_convert_rule(&r, rule);
+}
+
+/* Random input within a rule, in network byte order. */
+static void
+update_perf_input(struct ipv4_7tuple *in, const struct acl_ipv4vlan_rule *rule)
+{
+	const struct rte_acl_field *f = rule->field;
+	uint32_t msk;
+
+	memset(in, 0, sizeof(*in));
+	in->proto = f[RTE_ACL_IPV4VLAN_PROTO_FIELD].value.u8;
+	msk = RTE_ACL_MASKLEN_TO_BITMASK(
+		f[RTE_ACL_IPV4VLAN_SRC_FIELD].mask_range.u32, sizeof(uint32_t));
+	in->ip_src = rte_cpu_to_be_32((f[RTE_ACL_IPV4VLAN_SRC_FIELD].value.u32 &
+		msk) | ((uint32_t)rte_rand() & ~msk));
+	msk = RTE_ACL_MASKLEN_TO_BITMASK(
+		f[RTE_ACL_IPV4VLAN_DST_FIELD].mask_range.u32, sizeof(uint32_t));
+	in->ip_dst = rte_cpu_to_be_32((f[RTE_ACL_IPV4VLAN_DST_FIELD].value.u32 &
+		msk) | ((uint32_t)rte_rand() & ~msk));
+	in->port_src = rte_cpu_to_be_16(rte_rand());
+	in->port_dst = rte_cpu_to_be_16(
+		f[RTE_ACL_IPV4VLAN_DSTP_FIELD].value.u16);
+}
+
+static int
+update_perf_build(struct rte_acl_ctx *acx, const struct acl_ipv4vlan_rule *rules,
+	uint32_t num)
+{
+	int ret;
+
+	rte_acl_reset(acx);
+	ret = rte_acl_add_rules(acx, (const struct rte_acl_rule *)rules, num);
+	if (ret != 0)
+		return ret;
+	return rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+		TEST_UPDATE_PERF_CATEGORIES);
+}
+
+/*
+ * Measure the latency of incremental updates against a full build, and
+ * check the results against a context built from the final rule set.
+ */
+static int
+test_update_perf(void)
+{
+	struct rte_acl_param param;
+	struct rte_acl_ctx *acx, *ref;
+	struct acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *inputs;
+	const uint8_t **data;
+	uint32_t *res, *ref_res;
+	const uint32_t num = TEST_UPDATE_PERF_RULES;
+	const uint32_t upd = TEST_UPDATE_PERF_UPDATES;
+	uint64_t begin, tadd, tdel, tbuild, tcompact;
+	double us;
+	uint32_t i;
+	int ret;
+
+	rules = rte_zmalloc(NULL, (num + upd) * sizeof(rules[0]), 0);
+	inputs = rte_zmalloc(NULL,
+		TEST_UPDATE_PERF_INPUTS * sizeof(inputs[0]), 0);
+	data = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS * sizeof(data[0]), 0);
+	res = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS *
+		TEST_UPDATE_PERF_CATEGORIES * sizeof(res[0]), 0);
+	ref_res = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS *
+		TEST_UPDATE_PERF_CATEGORIES * sizeof(ref_res[0]), 0);
+
+	memcpy(&param, &acl_param, sizeof(param));
+	acx = rte_acl_create(&param);
+	param.name = "acl_ref";
+	ref = rte_acl_create(&param);
+
+	if (rules == NULL || inputs == NULL || data == NULL || res == NULL ||
+			ref_res == NULL || acx == NULL || ref == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	for (i = 0; i != num + upd; i++)
+		update_perf_rule(&rules[i], i);
+
+	begin = rte_rdtsc();
+	ret = update_perf_build(acx, rules, num);
+	tbuild = rte_rdtsc() - begin;
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* add rules one by one, then delete as many. */
+	begin = rte_rdtsc();
+	for (i = 0; i != upd && ret == 0; i++)
+		ret = rte_acl_update_add(acx,
+			(struct rte_acl_rule *)&rules[num + i], 1);
+	tadd = rte_rdtsc() - begin;
+
+	begin = rte_rdtsc();
+	for (i = 0; i != upd && ret == 0; i++)
+		ret = rte_acl_update_del(acx,
+			(struct rte_acl_rule *)&rules[i * 2], 1);
+	tdel = rte_rdtsc() - begin;
+	if (ret != 0) {
+		printf("Line %i: Updating ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* final rule set: odd rules below 2 * upd, then the rest. */
+	for (i = 0; i != upd; i++)
+		rules[i * 2] = rules[num + i];
+	ret = update_perf_build(ref, rules, num);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	for (i = 0; i != TEST_UPDATE_PERF_INPUTS; i++) {
+		update_perf_input(&inputs[i], &rules[rte_rand() % num]);
+		data[i] = (const uint8_t *)&inputs[i];
+	}
+
+	ret = rte_acl_classify(ref, data, ref_res, TEST_UPDATE_PERF_INPUTS,
+		TEST_UPDATE_PERF_CATEGORIES);
+	if (ret == 0)
+		ret = rte_acl_classify(acx, data, res, TEST_UPDATE_PERF_INPUTS,
+			TEST_UPDATE_PERF_CATEGORIES);
+	if (ret != 0 || memcmp(res, ref_res, TEST_UPDATE_PERF_INPUTS *
+			TEST_UPDATE_PERF_CATEGORIES * sizeof(res[0])) != 0) {
+		printf("Line %i: Updated context results differ!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	begin = rte_rdtsc();
+	ret = rte_acl_update_compact(acx);
+	tcompact = rte_rdtsc() - begin;
+	if (ret == 0)
+		ret = rte_acl_classify(acx, data, res, TEST_UPDATE_PERF_INPUTS,
+			TEST_UPDATE_PERF_CATEGORIES);
+	if (ret != 0 || memcmp(res, ref_res, TEST_UPDATE_PERF_INPUTS *
+			TEST_UPDATE_PERF_CATEGORIES * sizeof(res[0])) != 0) {
+		printf("Line %i: Compacted context results differ!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	us = 1E6 / rte_get_tsc_hz();
+	printf("ACL update latency, %u rules:\n", num);
+	printf("  full build: %.0f us\n", tbuild * us);
+	printf("  add one rule (average of %u): %.0f us\n", upd,
+		tadd * us / upd);
+	printf("  delete one rule (average of %u): %.0f us\n", upd,
+		tdel * us / upd);
+	printf("  compaction: %.0f us\n", tcompact * us);
+
+err:
+	rte_acl_free(ref);
+	rte_acl_free(acx);
+	rte_free(ref_res);
+	rte_free(res);
+	rte_free(data);
+	rte_free(inputs);
+	rte_free(rules);
+	return ret;
+}
+
+#define	TEST_UPDATE_READERS_RULES	1000
+#define	TEST_UPDATE_READERS_CHURN	64
+#define	TEST_UPDATE_READERS_UPDATES	512
+#define	TEST_UPDATE_READERS_INPUTS	256
+
+static struct {
+	struct rte_acl_ctx *acx;
+	const uint8_t *data[TEST_UPDATE_READERS_INPUTS];
+	uint32_t ref_res[TEST_UPDATE_READERS_INPUTS];
+	volatile int writer_done;
+	rte_atomic64_t bursts;
+	rte_atomic64_t errors;
+} update_readers;
+
+/*
+ * Classify the inputs of the stable rules, whose results the updates
+ * don't change, reporting a quiescent state after each burst.
+ */
+static int
+update_readers_classify(__attribute__((unused)) void *arg)
+{
+	struct rte_acl_ctx *acx = update_readers.acx;
+	uint32_t res[TEST_UPDATE_READERS_INPUTS];
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t bursts = 0, errors = 0;
+	uint32_t i;
+
+	if (rte_acl_reader_register(acx, lcore_id) != 0) {
+		rte_atomic64_inc(&update_readers.errors);
+		return -1;
+	}
+
+	while (!update_readers.writer_done) {
+		if (rte_acl_classify(acx, update_readers.data, res,
+				TEST_UPDATE_READERS_INPUTS, 1) != 0)
+			errors++;
+		for (i = 0; i != TEST_UPDATE_READERS_INPUTS; i++)
+			if (res[i] != update_readers.ref_res[i])
+				errors++;
+		bursts++;
+		rte_acl_quiescent(acx, lcore_id);
+	}
+
+	rte_acl_reader_unregister(acx, lcore_id);
+	rte_atomic64_add(&update_readers.bursts, bursts);
+	rte_atomic64_add(&update_readers.errors, errors);
+	return 0;
+}
+
+/*
+ * Classify on all the slave lcores while back-to-back updates and
+ * compactions replace the tries: the replaced ones must not be freed
+ * while a registered reader may still walk them.
+ */
+static int
+test_update_readers(void)
+{
+	struct acl_ipv4vlan_rule *rules, *stable;
+	struct ipv4_7tuple *inputs;
+	struct rte_acl_ctx *acx;
+	const uint32_t num = TEST_UPDATE_READERS_RULES;
+	uint64_t bursts, errors;
+	uint32_t i;
+	int ret;
+
+	if (rte_lcore_count() == 1) {
+		printf("More than one lcore is required "
+			"to classify during ACL updates\n");
+		return 0;
+	}
+
+	rules = rte_zmalloc(NULL, (TEST_UPDATE_READERS_CHURN + num) *
+		sizeof(rules[0]), 0);
+	inputs = rte_zmalloc(NULL,
+		TEST_UPDATE_READERS_INPUTS * sizeof(inputs[0]), 0);
+	acx = rte_acl_create(&acl_param);
+	if (rules == NULL || inputs == NULL || acx == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	if (rte_acl_reader_register(acx, RTE_ACL_MAX_READERS) != -EINVAL) {
+		printf("Line %i: Registering an out of range reader "
+			"should have failed!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	/*
+	 * the updated rules have the lowest priorities, so they don't change
+	 * the result of inputs within the stable rules.
+	 */
+	for (i = 0; i != TEST_UPDATE_READERS_CHURN + num; i++) {
+		update_perf_rule(&rules[i], i);
+		rules[i].data.category_mask = 1;
+	}
+	stable = rules + TEST_UPDATE_READERS_CHURN;
+
+	for (i = 0; i != TEST_UPDATE_READERS_INPUTS; i++) {
+		update_perf_input(&inputs[i], &stable[rte_rand() % num]);
+		update_readers.data[i] = (const uint8_t *)&inputs[i];
+	}
+
+	ret = update_perf_build(acx, stable, num);
+	if (ret == 0)
+		ret = rte_acl_classify(acx, update_readers.data,
+			update_readers.ref_res, TEST_UPDATE_READERS_INPUTS, 1);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	update_readers.acx = acx;
+	update_readers.writer_done = 0;
+	rte_atomic64_init(&update_readers.bursts);
+	rte_atomic64_init(&update_readers.errors);
+	rte_eal_mp_remote_launch(update_readers_classify, NULL, SKIP_MASTER);
+
+	for (i = 0; i != TEST_UPDATE_READERS_UPDATES && ret == 0; i++) {
+		ret = rte_acl_update_add(acx, (struct rte_acl_rule *)
+			&rules[i % TEST_UPDATE_READERS_CHURN], 1);
+		if (ret == 0)
+			ret = rte_acl_update_del(acx, (struct rte_acl_rule *)
+				&rules[i % TEST_UPDATE_READERS_CHURN], 1);
+		if (ret == 0 && i % TEST_UPDATE_READERS_CHURN ==
+				TEST_UPDATE_READERS_CHURN - 1)
+			ret = rte_acl_update_compact(acx);
+	}
+
+	update_readers.writer_done = 1;
+	rte_eal_mp_wait_lcore();
+	if (ret != 0) {
+		printf("Line %i: Update %u failed!\n", __LINE__, i - 1);
+		goto err;
+	}
+
+	bursts = rte_atomic64_read(&update_readers.bursts);
+	errors = rte_atomic64_read(&update_readers.errors);
+	printf("ACL classify during %u updates: %"PRIu64" bursts, "
+		"%"PRIu64" wrong results\n", 2 * TEST_UPDATE_READERS_UPDATES,
+		bursts, errors);
+	if (errors != 0) {
+		printf("Line %i: Classify results changed during updates!\n",
+			__LINE__);
+		ret = -1;
+	}
+
+err:
+	rte_acl_free(acx);
+	rte_free(inputs);
+	rte_free(rules);
+	return ret;
+}
+
+#define	TEST_BUILD_THREADS_RULES	3000
+
+/*
+ * Random rule, with the source or the destination address or both wild,
+ * so that rules overlap a lot and get split into several tries.
+ */
+static void
+build_threads_rule(struct acl_ipv4vlan_rule *rule, uint32_t id)
+{
+	struct rte_acl_ipv4vlan_rule r;
+	uint16_t port;
+
+	memset(&r, 0, sizeof(r));
+	r.data.priority = id + 1;
+	r.data.userdata = id + 1;
+	r.data.category_mask = 1 + rte_rand() %
+		RTE_LEN2MASK(TEST_UPDATE_PERF_CATEGORIES, uint32_t);
+
+	r.proto = (rte_rand() & 1) ? IPPROTO_TCP : IPPROTO_UDP;
+	r.proto_mask = UINT8_MAX;
+	if (id % 3 == 1) {
+		r.src_mask_len = 8 + rte_rand() % 17;
+		r.src_addr = (uint32_t)rte_rand() & RTE_ACL_MASKLEN_TO_BITMASK(
+			r.src_mask_len, sizeof(uint32_t));
+	} else if (id % 3 == 2) {
+		r.dst_mask_len = 8 + rte_rand() % 17;
+		r.dst_addr = (uint32_t)rte_rand() & RTE_ACL_MASKLEN_TO_BITMASK(
+			r.dst_mask_len, sizeof(uint32_t));
+	}
+	port = rte_rand();
+	r.src_port_low = port;
+	r.src_port_high = port + RTE_MIN(rte_rand() % 1024,
+		(uint64_t)(UINT16_MAX - port));
+	port = rte_rand();
+	r.dst_port_low = port;
+	r.dst_port_high = port + RTE_MIN(rte_rand() % 1024,
+		(uint64_t)(UINT16_MAX - port));
+
+	memset(rule, 0, sizeof(*rule));
+	acl_ipv4vlan_convert_rule(&r, rule);
+}
+
+static int
+build_threads_build(struct rte_acl_ctx *acx, uint32_t num_threads)
+{
+	struct rte_acl_config cfg;
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout,
+		TEST_UPDATE_PERF_CATEGORIES);
+	cfg.num_threads = num_threads;
+	return rte_acl_build(acx, &cfg);
+}
+
+/*
+ * Build the same rule set with a growing number of build threads,
+ * and check that results don't depend on it.
+ */
+static int
+test_build_threads(void)
+{
+	static const uint32_t num_threads[] = {1, 2, 4, 8, 64};
+
+	struct rte_acl_ctx *acx;
+	struct acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *inputs;
+	const uint8_t **data;
+	uint32_t *res, *ref_res;
+	const uint32_t num = TEST_BUILD_THREADS_RULES;
+	uint64_t begin, tbuild;
+	uint32_t i, j;
+	int ret;
+
+	rules = rte_zmalloc(NULL, num * sizeof(rules[0]), 0);
+	inputs = rte_zmalloc(NULL,
+		TEST_UPDATE_PERF_INPUTS * sizeof(inputs[0]), 0);
+	data = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS * sizeof(data[0]), 0);
+	res = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS *
+		TEST_UPDATE_PERF_CATEGORIES * sizeof(res[0]), 0);
+	ref_res = rte_zmalloc(NULL, TEST_UPDATE_PERF_INPUTS *
+		TEST_UPDATE_PERF_CATEGORIES * sizeof(ref_res[0]), 0);
+	acx = rte_acl_create(&acl_param);
+
+	if (rules == NULL || inputs == NULL || data == NULL || res == NULL ||
+			ref_res == NULL || acx == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	for (i = 0; i != num; i++)
+		build_threads_rule(&rules[i], i);
+
+	for (i = 0; i != TEST_UPDATE_PERF_INPUTS; i++) {
+		update_perf_input(&inputs[i], &rules[rte_rand() % num]);
+		data[i] = (const uint8_t *)&inputs[i];
+	}
+
+	ret = rte_acl_add_rules(acx, (const struct rte_acl_rule *)rules, num);
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	printf("ACL build time, %u rules:\n", num);
+
+	for (i = 0; i != RTE_DIM(num_threads); i++) {
+
+		begin = rte_rdtsc();
+		ret = build_threads_build(acx, num_threads[i]);
+		tbuild = rte_rdtsc() - begin;
+		if (ret != 0) {
+			printf("Line %i: Building ACL context with %u threads "
+				"failed!\n", __LINE__, num_threads[i]);
+			goto err;
+		}
+
+		ret = rte_acl_classify(acx, data, res, TEST_UPDATE_PERF_INPUTS,
+			TEST_UPDATE_PERF_CATEGORIES);
+		if (ret != 0) {
+			printf("Line %i: Classify failed!\n", __LINE__);
+			goto err;
+		}
+
+		/* first build, with one thread, gives the reference results. */
+		if (i == 0)
+			memcpy(ref_res, res, TEST_UPDATE_PERF_INPUTS *
+				TEST_UPDATE_PERF_CATEGORIES * sizeof(res[0]));
+
+		for (j = 0; j != TEST_UPDATE_PERF_INPUTS *
+				TEST_UPDATE_PERF_CATEGORIES; j++) {
+			if (res[j] != ref_res[j]) {
+				printf("Line %i: Results with %u build threads "
+					"differ for input %u: %u instead of "
+					"%u!\n", __LINE__, num_threads[i],
+					j / TEST_UPDATE_PERF_CATEGORIES,
+					res[j], ref_res[j]);
+				ret = -1;
+				goto err;
+			}
+		}
+
+		printf("  %u thread(s): %.0f us\n", num_threads[i],
+			tbuild * 1E6 / rte_get_tsc_hz());
+	}
+
+err:
+	rte_acl_free(acx);
+	rte_free(ref_res);
+	rte_free(res);
+	rte_free(data);
+	rte_free(inputs);
+	rte_free(rules);
+	return ret;
+}
+
+#define	TEST_CLASSIFY_ALG_BURST	64
+
+/*
+ * Check that all classify methods supported on that machine give the same
+ * results as the scalar one, with bursts of any size up to
+ * TEST_CLASSIFY_ALG_BURST, and measure the classify cost of each one.
+ */
+static int
+test_classify_alg(void)
+{
+	static const struct {
+		const char *name;
+		enum rte_acl_classify_alg alg;
+	} algs[] = {
+		{"scalar", RTE_ACL_CLASSIFY_SCALAR},
+		{"sse", RTE_ACL_CLASSIFY_SSE},
+		{"avx2", RTE_ACL_CLASSIFY_AVX2},
+		{"neon", RTE_ACL_CLASSIFY_NEON},
+		{"altivec", RTE_ACL_CLASSIFY_ALTIVEC},
+		{"avx512", RTE_ACL_CLASSIFY_AVX512},
+	};
+
+	struct rte_acl_ctx *acx;
+	struct acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *inputs;
+	const uint8_t **data;
+	uint32_t *res, *ref_res;
+	const uint32_t num = TEST_UPDATE_PERF_RULES;
+	const uint32_t num_inputs = TEST_UPDATE_PERF_INPUTS;
+	const uint32_t cat = TEST_UPDATE_PERF_CATEGORIES;
+	uint64_t begin, tclassify;
+	uint32_t i, j, k, n;
+	int ret;
+
+	rules = rte_zmalloc(NULL, num * sizeof(rules[0]), 0);
+	inputs = rte_zmalloc(NULL, num_inputs * sizeof(inputs[0]), 0);
+	data = rte_zmalloc(NULL, num_inputs * sizeof(data[0]), 0);
+	res = rte_zmalloc(NULL, num_inputs * cat * sizeof(res[0]), 0);
+	ref_res = rte_zmalloc(NULL, num_inputs * cat * sizeof(ref_res[0]), 0);
+	acx = rte_acl_create(&acl_param);
+
+	if (rules == NULL || inputs == NULL || data == NULL || res == NULL ||
+			ref_res == NULL || acx == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	for (i = 0; i != num; i++)
+		update_perf_rule(&rules[i], i);
+
+	/* some inputs within the rules, others random. */
+	for (i = 0; i != num_inputs; i++) {
+		update_perf_input(&inputs[i], &rules[rte_rand() % num]);
+		if (i % 4 == 0)
+			inputs[i].ip_src = rte_rand();
+		data[i] = (const uint8_t *)&inputs[i];
+	}
+
+	ret = update_perf_build(acx, rules, num);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_classify_alg(acx, data, ref_res, num_inputs, cat,
+		RTE_ACL_CLASSIFY_SCALAR);
+	if (ret != 0) {
+		printf("Line %i: Scalar classify failed!\n", __LINE__);
+		goto err;
+	}
+
+	printf("ACL classify cost, %u rules, bursts of %u:\n", num,
+		TEST_CLASSIFY_ALG_BURST);
+
+	for (i = 0; i != RTE_DIM(algs); i++) {
+
+		/* burst sizes from 1 to TEST_CLASSIFY_ALG_BURST. */
+		memset(res, 0, num_inputs * cat * sizeof(res[0]));
+		for (j = 0, n = 1; j != num_inputs; j += n,
+				n = n % TEST_CLASSIFY_ALG_BURST + 1) {
+			n = RTE_MIN(n, num_inputs - j);
+			ret = rte_acl_classify_alg(acx, data + j,
+				res + j * cat, n, cat, algs[i].alg);
+			if (ret != 0)
+				break;
+		}
+
+		/* method not supported on that machine. */
+		if (ret == -ENOTSUP)
+			continue;
+
+		for (k = 0; ret == 0 && k != num_inputs * cat; k++) {
+			if (res[k] != ref_res[k]) {
+				printf("Line %i: %s classify result differs for "
+					"input %u: %u instead of %u!\n",
+					__LINE__, algs[i].name, k / cat,
+					res[k], ref_res[k]);
+				ret = -1;
+			}
+		}
+		if (ret != 0) {
+			printf("Line %i: %s classify failed!\n", __LINE__,
+				algs[i].name);
+			goto err;
+		}
+
+		begin = rte_rdtsc();
+		for (j = 0; j != num_inputs; j += TEST_CLASSIFY_ALG_BURST)
+			rte_acl_classify_alg(acx, data + j, res + j * cat,
+				TEST_CLASSIFY_ALG_BURST, cat, algs[i].alg);
+		tclassify = rte_rdtsc() - begin;
+
+		printf("  %s: %.1f cycles per packet\n", algs[i].name,
+			(double)tclassify / num_inputs);
+	}
+
+	ret = 0;
+
+err:
+	rte_acl_free(acx);
+	rte_free(ref_res);
+	rte_free(res);
+	rte_free(data);
+	rte_free(inputs);
+	rte_free(rules);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1645,6 +2411,16 @@ test_acl(void)
 		return -1;
 	if (test_convert() < 0)
 		return -1;
+	if (test_update() < 0)
+		return -1;
+	if (test_update_perf() < 0)
+		return -1;
+	if (test_update_readers() < 0)
+		return -1;
+	if (test_build_threads() < 0)
+		return -1;
+	if (test_classify_alg() < 0)
+		return -1;
 
 	return 0;
 }
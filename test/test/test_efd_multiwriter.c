@@ -0,0 +1,284 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_atomic.h>
+#include <rte_spinlock.h>
+#include <rte_efd.h>
+
+#include "test.h"
+
+#define NUM_KEYS (1 << 18)
+#define NUM_STABLE_KEYS 4096
+#define TABLE_SIZE (NUM_KEYS * 2)
+#define BURST_SIZE 32
+
+#if RTE_EFD_VALUE_NUM_BITS == 32
+#define VALUE_BITMASK 0xffffffff
+#else
+#define VALUE_BITMASK ((1 << RTE_EFD_VALUE_NUM_BITS) - 1)
+#endif
+
+/*
+ * Writers insert NUM_KEYS keys, split evenly between them, while the
+ * master lcore keeps looking up NUM_STABLE_KEYS keys inserted beforehand.
+ * Each run is done twice: once with a single-writer table where the writers
+ * and the reader serialize behind one lock, as applications had to, and once
+ * with a multi-writer table, where only the writers of a chunk serialize.
+ */
+static struct {
+	struct rte_efd_table *table;
+	uint32_t *keys;
+	efd_value_t *values;
+	uint32_t keys_per_writer;
+	int global_lock;
+} params;
+
+static rte_spinlock_t writer_lock = RTE_SPINLOCK_INITIALIZER;
+static rte_atomic32_t writers_done;
+static rte_atomic32_t update_failures;
+
+static int
+test_efd_multiwriter_worker(void *arg)
+{
+	uint32_t writer_id = (uint32_t)(uintptr_t) arg;
+	unsigned int socket_id = rte_socket_id();
+	uint32_t i, begin, end;
+	int ret;
+
+	begin = NUM_STABLE_KEYS + writer_id * params.keys_per_writer;
+	end = begin + params.keys_per_writer;
+
+	for (i = begin; i < end; i++) {
+		if (params.global_lock) {
+			rte_spinlock_lock(&writer_lock);
+			ret = rte_efd_update(params.table, socket_id,
+					&params.keys[i], params.values[i]);
+			rte_spinlock_unlock(&writer_lock);
+		} else
+			ret = rte_efd_update(params.table, socket_id,
+					&params.keys[i], params.values[i]);
+
+		if (ret == RTE_EFD_UPDATE_FAILED)
+			rte_atomic32_inc(&update_failures);
+	}
+
+	rte_atomic32_inc(&writers_done);
+	return 0;
+}
+
+/*
+ * Look up the stable keys until all writers are done,
+ * counting values that came back wrong. A single-writer table gives readers
+ * no protection against concurrent updates, so in that case the lookups take
+ * the writer lock too.
+ */
+static uint32_t
+test_efd_multiwriter_reader(uint32_t num_writers)
+{
+	const void *key_list[BURST_SIZE];
+	efd_value_t value_list[BURST_SIZE];
+	unsigned int socket_id = rte_socket_id();
+	uint32_t i, j, errors = 0;
+
+	while ((uint32_t) rte_atomic32_read(&writers_done) < num_writers) {
+		for (i = 0; i < NUM_STABLE_KEYS; i += BURST_SIZE) {
+			for (j = 0; j < BURST_SIZE; j++)
+				key_list[j] = &params.keys[i + j];
+
+			if (params.global_lock) {
+				rte_spinlock_lock(&writer_lock);
+				rte_efd_lookup_bulk(params.table, socket_id,
+						BURST_SIZE, key_list, value_list);
+				rte_spinlock_unlock(&writer_lock);
+			} else
+				rte_efd_lookup_bulk(params.table, socket_id,
+						BURST_SIZE, key_list, value_list);
+
+			for (j = 0; j < BURST_SIZE; j++)
+				if (value_list[j] != params.values[i + j])
+					errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int
+test_efd_multiwriter_run(uint32_t num_writers, int multi_writer,
+		uint64_t *cycles)
+{
+	unsigned int socket_id = rte_socket_id();
+	uint32_t i, lcore_id, writer_id, num_keys, read_errors;
+	uint64_t begin;
+	char name[RTE_EFD_NAMESIZE];
+
+	snprintf(name, sizeof(name), "efd_mw_%u_%d", num_writers,
+			multi_writer);
+	params.table = rte_efd_create_with_flags(name, TABLE_SIZE,
+			sizeof(uint32_t), 1 << socket_id, socket_id,
+			multi_writer ? RTE_EFD_EXTRA_FLAGS_MULTI_WRITER : 0);
+	if (params.table == NULL) {
+		printf("Error creating the EFD table\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_STABLE_KEYS; i++) {
+		if (rte_efd_update(params.table, socket_id, &params.keys[i],
+				params.values[i]) == RTE_EFD_UPDATE_FAILED) {
+			printf("Error inserting stable key %u\n", i);
+			rte_efd_free(params.table);
+			return -1;
+		}
+	}
+
+	params.keys_per_writer = (NUM_KEYS - NUM_STABLE_KEYS) / num_writers;
+	params.global_lock = !multi_writer;
+	rte_atomic32_clear(&writers_done);
+	rte_atomic32_clear(&update_failures);
+
+	begin = rte_rdtsc_precise();
+
+	writer_id = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (writer_id == num_writers)
+			break;
+		rte_eal_remote_launch(test_efd_multiwriter_worker,
+				(void *)(uintptr_t) writer_id, lcore_id);
+		writer_id++;
+	}
+
+	read_errors = test_efd_multiwriter_reader(num_writers);
+	rte_eal_mp_wait_lcore();
+
+	*cycles = rte_rdtsc_precise() - begin;
+
+	if (rte_atomic32_read(&update_failures) != 0) {
+		printf("%d updates failed\n",
+				rte_atomic32_read(&update_failures));
+		goto error;
+	}
+
+	if (read_errors != 0) {
+		printf("%u lookups returned a wrong value during updates\n",
+				read_errors);
+		goto error;
+	}
+
+	num_keys = NUM_STABLE_KEYS + params.keys_per_writer * num_writers;
+	for (i = 0; i < num_keys; i++) {
+		if (rte_efd_lookup(params.table, socket_id, &params.keys[i]) !=
+				params.values[i]) {
+			printf("Key %u has a wrong value after updates\n", i);
+			goto error;
+		}
+	}
+
+	rte_efd_free(params.table);
+	return 0;
+
+error:
+	rte_efd_free(params.table);
+	return -1;
+}
+
+static int
+test_efd_multiwriter(void)
+{
+	uint32_t i, num_writers, max_writers;
+	uint64_t cycles[2], base_cycles[2] = {0, 0};
+	uint32_t num_updates;
+	int multi_writer;
+
+	if (rte_lcore_count() < 2) {
+		printf("More than one lcore is required to do multiwriter test\n");
+		return 0;
+	}
+
+	params.keys = rte_malloc(NULL, NUM_KEYS * sizeof(uint32_t), 0);
+	params.values = rte_malloc(NULL, NUM_KEYS * sizeof(efd_value_t), 0);
+	if (params.keys == NULL || params.values == NULL) {
+		printf("RTE_MALLOC failed\n");
+		goto error;
+	}
+
+	rte_srand(rte_rdtsc());
+	for (i = 0; i < NUM_KEYS; i++) {
+		params.keys[i] = i + 1;
+		params.values[i] = rte_rand() & VALUE_BITMASK;
+	}
+
+	max_writers = rte_lcore_count() - 1;
+
+	printf("\nWriters   Locked table (cycles/update)   "
+			"Multi-writer table (cycles/update)\n");
+	for (num_writers = 1; num_writers <= max_writers; num_writers++) {
+		for (multi_writer = 0; multi_writer < 2; multi_writer++) {
+			if (test_efd_multiwriter_run(num_writers, multi_writer,
+					&cycles[multi_writer]) < 0)
+				goto error;
+		}
+
+		num_updates = (NUM_KEYS - NUM_STABLE_KEYS) /
+				num_writers * num_writers;
+		if (num_writers == 1) {
+			base_cycles[0] = cycles[0];
+			base_cycles[1] = cycles[1];
+		}
+
+		printf("%-9u %-10"PRIu64" (x%.2f)%-14s %-10"PRIu64" (x%.2f)\n",
+				num_writers,
+				cycles[0] / num_updates,
+				(double) base_cycles[0] / cycles[0], "",
+				cycles[1] / num_updates,
+				(double) base_cycles[1] / cycles[1]);
+	}
+
+	rte_free(params.keys);
+	rte_free(params.values);
+	return 0;
+
+error:
+	rte_free(params.keys);
+	rte_free(params.values);
+	return -1;
+}
+
+REGISTER_TEST_COMMAND(efd_multiwriter_autotest, test_efd_multiwriter);
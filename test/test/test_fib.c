@@ -0,0 +1,582 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_ip.h>
+#include <rte_random.h>
+#include <rte_errno.h>
+#include <rte_fib.h>
+#include <rte_rib.h>
+
+#include "test.h"
+
+#define TEST_FIB_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+typedef int32_t (*rte_fib_test)(void);
+
+static int32_t test0(void);
+static int32_t test1(void);
+static int32_t test2(void);
+static int32_t test3(void);
+static int32_t test4(void);
+static int32_t test5(void);
+
+static rte_fib_test tests[] = {
+/* Test Cases */
+	test0,
+	test1,
+	test2,
+	test3,
+	test4,
+	test5
+};
+
+#define NUM_FIB_TESTS (sizeof(tests)/sizeof(tests[0]))
+#define MAX_ROUTES 1024
+#define NUMBER_TBL8S 64
+#define DEF_NH 3
+#define PASS 0
+
+static const enum rte_fib_dir24_8_nh_sz nh_sizes[] = {
+	RTE_FIB_DIR24_8_1B,
+	RTE_FIB_DIR24_8_2B,
+	RTE_FIB_DIR24_8_4B,
+	RTE_FIB_DIR24_8_8B
+};
+
+static const enum rte_fib_lookup_type lookup_types[] = {
+	RTE_FIB_LOOKUP_SCALAR,
+	RTE_FIB_LOOKUP_VECTOR_AVX2
+};
+
+static void
+fib_conf_init(struct rte_fib_conf *conf, enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	conf->type = RTE_FIB_DIR24_8;
+	conf->default_nh = DEF_NH;
+	conf->max_routes = MAX_ROUTES;
+	conf->dir24_8.nh_sz = nh_sz;
+	conf->dir24_8.num_tbl8 = NUMBER_TBL8S;
+}
+
+/*
+ * Look up ips with every available lookup function and check that all of
+ * them return next_hops.
+ */
+static int32_t
+check_lookup(struct rte_fib *fib, uint32_t *ips, uint64_t *next_hops,
+		unsigned int n)
+{
+	uint64_t ret_nh[n];
+	unsigned int i, j;
+
+	for (i = 0; i < RTE_DIM(lookup_types); i++) {
+		/* The vector lookup may not be supported by this CPU. */
+		if (rte_fib_set_lookup_fn(fib, lookup_types[i]) != 0)
+			continue;
+		memset(ret_nh, 0xff, sizeof(ret_nh));
+		TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, ips, ret_nh, n) == 0);
+		for (j = 0; j < n; j++) {
+			if (ret_nh[j] != next_hops[j]) {
+				printf("Lookup type %u, ip 0x%08x: got %" PRIu64
+					" expected %" PRIu64 "\n",
+					lookup_types[i], ips[j], ret_nh[j],
+					next_hops[j]);
+				return -1;
+			}
+		}
+	}
+	TEST_FIB_ASSERT(rte_fib_set_lookup_fn(fib,
+			RTE_FIB_LOOKUP_DEFAULT) == 0);
+
+	return PASS;
+}
+
+/*
+ * Check that rte_fib_create fails gracefully for incorrect user input
+ * arguments, and that a FIB can be found by name.
+ */
+int32_t
+test0(void)
+{
+	struct rte_fib *fib = NULL, *fib2;
+	struct rte_fib_conf config;
+
+	fib_conf_init(&config, RTE_FIB_DIR24_8_4B);
+
+	/* rte_fib_create: fib name == NULL */
+	fib = rte_fib_create(NULL, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib_create: config == NULL */
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, NULL);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib_create: socket_id < -1 */
+	fib = rte_fib_create(__func__, -2, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib_create: max_routes = 0 */
+	config.max_routes = 0;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.max_routes = MAX_ROUTES;
+
+	/* rte_fib_create: invalid next hop size */
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_8B + 1;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+
+	/* rte_fib_create: num_tbl8 = 0 */
+	config.dir24_8.num_tbl8 = 0;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib_create: more tbl8s than 1 byte entries can index */
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_1B;
+	config.dir24_8.num_tbl8 = 129;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.dir24_8.num_tbl8 = 128;
+
+	/* rte_fib_create: default next hop too large for 1 byte entries */
+	config.default_nh = 128;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.default_nh = 127;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+
+	/* rte_fib_create: name already in use */
+	fib2 = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib2 == NULL && rte_errno == EEXIST);
+
+	fib2 = rte_fib_find_existing(__func__);
+	TEST_FIB_ASSERT(fib2 == fib);
+	TEST_FIB_ASSERT(rte_fib_get_rib(fib) != NULL);
+
+	rte_fib_free(fib);
+
+	fib2 = rte_fib_find_existing(__func__);
+	TEST_FIB_ASSERT(fib2 == NULL && rte_errno == ENOENT);
+
+	/* Freeing NULL is a no-op. */
+	rte_fib_free(NULL);
+
+	return PASS;
+}
+
+/*
+ * Check that add, delete and lookup fail gracefully for incorrect user
+ * input arguments.
+ */
+int32_t
+test1(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint32_t ip = IPv4(10, 0, 0, 0);
+	uint64_t next_hop;
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		TEST_FIB_ASSERT(rte_fib_add(NULL, ip, 8, 1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib_add(fib, ip, RTE_FIB_MAXDEPTH + 1,
+				1) == -EINVAL);
+
+		/* Next hop one bit too large for the entry size. */
+		if (nh_sizes[i] != RTE_FIB_DIR24_8_8B) {
+			next_hop = 1ULL << ((8 << nh_sizes[i]) - 1);
+			TEST_FIB_ASSERT(rte_fib_add(fib, ip, 8, next_hop) ==
+					-EINVAL);
+		}
+		next_hop = UINT64_MAX >> (65 - (8 << nh_sizes[i]));
+		TEST_FIB_ASSERT(rte_fib_add(fib, ip, 8, next_hop) == 0);
+
+		TEST_FIB_ASSERT(rte_fib_delete(NULL, ip, 8) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip,
+				RTE_FIB_MAXDEPTH + 1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip, 16) == -ENOENT);
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip, 8) == 0);
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip, 8) == -ENOENT);
+
+		TEST_FIB_ASSERT(rte_fib_lookup_bulk(NULL, &ip, &next_hop,
+				1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, NULL, &next_hop,
+				1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, &ip, NULL,
+				1) == -EINVAL);
+
+		rte_fib_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Add nested routes of every depth class, for every next hop size, and
+ * check that lookups return the longest match and that deleted routes
+ * fall back to the covering route or to the default next hop.
+ */
+int32_t
+test2(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	static const uint8_t depths[] = {0, 8, 16, 20, 24, 25, 28, 32};
+	uint32_t ips[RTE_DIM(depths) + 2];
+	uint64_t next_hops[RTE_DIM(depths) + 2];
+	uint32_t ip = IPv4(192, 168, 100, 100);
+	unsigned int i, j, k, n = RTE_DIM(depths);
+
+	/*
+	 * ips[j] is covered by the routes of depth up to depths[j] only,
+	 * the last two ips by the /0 route and by nothing once it is gone.
+	 */
+	for (j = 0; j < n; j++)
+		ips[j] = ip ^ ((j + 1 < n) ? (1U << (32 - depths[j + 1])) : 0);
+	ips[n] = IPv4(1, 2, 3, 4);
+	ips[n + 1] = IPv4(255, 255, 255, 255);
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		/* Empty table: everything goes to the default next hop. */
+		for (j = 0; j < n + 2; j++)
+			next_hops[j] = DEF_NH;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 2) ==
+				PASS);
+
+		/* Add from the least to the most specific route. */
+		for (j = 0; j < n; j++) {
+			TEST_FIB_ASSERT(rte_fib_add(fib, ip, depths[j],
+					10 + j) == 0);
+			for (k = 0; k < n + 2; k++)
+				next_hops[k] = 10 + RTE_MIN(j,
+					(k < n) ? k : 0);
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					n + 2) == PASS);
+		}
+
+		/* Changing a next hop only affects the route itself. */
+		TEST_FIB_ASSERT(rte_fib_add(fib, ip, 24, 100) == 0);
+		next_hops[4] = 100;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 2) ==
+				PASS);
+		TEST_FIB_ASSERT(rte_fib_add(fib, ip, 24, 14) == 0);
+		next_hops[4] = 14;
+
+		/* Delete the routes in the middle, one at a time. */
+		for (j = 1; j < n - 1; j++) {
+			TEST_FIB_ASSERT(rte_fib_delete(fib, ip,
+					depths[j]) == 0);
+			for (k = 1; k <= j; k++)
+				next_hops[k] = 10;
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					n + 2) == PASS);
+		}
+
+		/* Then the /32 and the default route. */
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip, 32) == 0);
+		next_hops[n - 1] = 10;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 2) ==
+				PASS);
+		TEST_FIB_ASSERT(rte_fib_delete(fib, ip, 0) == 0);
+		for (j = 0; j < n + 2; j++)
+			next_hops[j] = DEF_NH;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 2) ==
+				PASS);
+
+		rte_fib_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Check that a tbl8 is taken per /24 holding longer routes, that adds
+ * fail cleanly once they are all used, and that deleting the long routes
+ * of a /24 gives its tbl8 back.
+ */
+int32_t
+test3(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint32_t ip;
+	uint64_t next_hop;
+	unsigned int i;
+
+	fib_conf_init(&config, RTE_FIB_DIR24_8_2B);
+	config.dir24_8.num_tbl8 = 4;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+
+	for (i = 0; i < 4; i++)
+		TEST_FIB_ASSERT(rte_fib_add(fib, IPv4(10, 0, i, 0), 25,
+				i + 10) == 0);
+
+	/* More long routes in a /24 that has its tbl8 already. */
+	TEST_FIB_ASSERT(rte_fib_add(fib, IPv4(10, 0, 0, 128), 25, 20) == 0);
+	TEST_FIB_ASSERT(rte_fib_add(fib, IPv4(10, 0, 1, 1), 32, 21) == 0);
+
+	/* No tbl8 left for a fifth /24, the table must be unchanged. */
+	ip = IPv4(10, 0, 4, 0);
+	TEST_FIB_ASSERT(rte_fib_add(fib, ip, 25, 30) == -ENOSPC);
+	next_hop = 0;
+	TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, &ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == DEF_NH);
+	TEST_FIB_ASSERT(rte_rib_lookup_exact(rte_fib_get_rib(fib), ip,
+			25) == NULL);
+
+	/* Routes up to /24 never need a tbl8. */
+	TEST_FIB_ASSERT(rte_fib_add(fib, IPv4(10, 0, 4, 0), 24, 31) == 0);
+	TEST_FIB_ASSERT(rte_fib_add(fib, IPv4(11, 0, 0, 0), 8, 32) == 0);
+
+	/* Free the tbl8 of 10.0.0.0/24. */
+	TEST_FIB_ASSERT(rte_fib_delete(fib, IPv4(10, 0, 0, 0), 25) == 0);
+	TEST_FIB_ASSERT(rte_fib_add(fib, ip, 25, 30) == -ENOSPC);
+	TEST_FIB_ASSERT(rte_fib_delete(fib, IPv4(10, 0, 0, 128), 25) == 0);
+	TEST_FIB_ASSERT(rte_fib_add(fib, ip, 25, 30) == 0);
+
+	ip = IPv4(10, 0, 4, 1);
+	TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, &ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == 30);
+	ip = IPv4(10, 0, 4, 200);
+	TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, &ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == 31);
+	ip = IPv4(10, 0, 0, 200);
+	TEST_FIB_ASSERT(rte_fib_lookup_bulk(fib, &ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == DEF_NH);
+
+	rte_fib_free(fib);
+
+	return PASS;
+}
+
+/*
+ * Walk the RIB of a FIB: parent lookups and iteration over the more
+ * specific routes of a prefix.
+ */
+int32_t
+test4(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_rib *rib;
+	struct rte_rib_node *node, *parent;
+	static const struct {
+		uint32_t ip;
+		uint8_t depth;
+	} routes[] = {
+		{IPv4(10, 0, 0, 0), 8},
+		{IPv4(10, 1, 0, 0), 16},
+		{IPv4(10, 1, 2, 0), 24},
+		{IPv4(10, 2, 0, 0), 16},
+		{IPv4(10, 128, 0, 0), 9},
+		{IPv4(10, 200, 0, 1), 32},
+		{IPv4(11, 0, 0, 0), 8},
+	};
+	unsigned int i;
+
+	fib_conf_init(&config, RTE_FIB_DIR24_8_4B);
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+	rib = rte_fib_get_rib(fib);
+
+	for (i = 0; i < RTE_DIM(routes); i++)
+		TEST_FIB_ASSERT(rte_fib_add(fib, routes[i].ip,
+				routes[i].depth, i) == 0);
+
+	node = rte_rib_lookup(rib, IPv4(10, 1, 2, 3));
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_depth(node) == 24);
+	TEST_FIB_ASSERT(rte_rib_get_nh(node) == 2);
+	parent = rte_rib_lookup_parent(node);
+	TEST_FIB_ASSERT(parent != NULL && rte_rib_get_depth(parent) == 16);
+	parent = rte_rib_lookup_parent(parent);
+	TEST_FIB_ASSERT(parent != NULL && rte_rib_get_ip(parent) ==
+			IPv4(10, 0, 0, 0));
+	TEST_FIB_ASSERT(rte_rib_lookup_parent(parent) == NULL);
+	TEST_FIB_ASSERT(rte_rib_lookup(rib, IPv4(12, 0, 0, 0)) == NULL);
+
+	/* The top level more specific routes of 10/8, in address order. */
+	node = rte_rib_get_nxt(rib, IPv4(10, 0, 0, 0), 8, NULL);
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_nh(node) == 1);
+	node = rte_rib_get_nxt(rib, IPv4(10, 0, 0, 0), 8, node);
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_nh(node) == 3);
+	node = rte_rib_get_nxt(rib, IPv4(10, 0, 0, 0), 8, node);
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_nh(node) == 4);
+	node = rte_rib_get_nxt(rib, IPv4(10, 0, 0, 0), 8, node);
+	TEST_FIB_ASSERT(node == NULL);
+
+	/* The whole table is below 0/0. */
+	node = rte_rib_get_nxt(rib, 0, 0, NULL);
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_nh(node) == 0);
+	node = rte_rib_get_nxt(rib, 0, 0, node);
+	TEST_FIB_ASSERT(node != NULL && rte_rib_get_nh(node) == 6);
+	TEST_FIB_ASSERT(rte_rib_get_nxt(rib, 0, 0, node) == NULL);
+
+	rte_fib_free(fib);
+
+	return PASS;
+}
+
+/*
+ * Add and delete random routes, checking lookups of random addresses
+ * against a linear search of the routes after each step.
+ */
+#define RND_ROUTES 256
+#define RND_IPS 256
+
+int32_t
+test5(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct {
+		uint32_t ip;
+		uint8_t depth;
+		uint64_t nh;
+	} routes[RND_ROUTES];
+	uint32_t ips[RND_IPS];
+	uint64_t next_hops[RND_IPS];
+	unsigned int i, j, k, n, step;
+	uint32_t mask;
+	int best, ret;
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		n = 0;
+		for (step = 0; step < 2 * RND_ROUTES; step++) {
+			if (n == RND_ROUTES ||
+					(n > 0 && (rte_rand() % 4) == 0)) {
+				/* Delete a random route. */
+				j = rte_rand() % n;
+				TEST_FIB_ASSERT(rte_fib_delete(fib,
+					routes[j].ip, routes[j].depth) == 0);
+				routes[j] = routes[--n];
+			} else {
+				/* Add a route within 10/8, mostly long. */
+				routes[n].depth = 8 + rte_rand() % 25;
+				mask = (uint32_t)(UINT64_MAX <<
+						(32 - routes[n].depth));
+				routes[n].ip = (IPv4(10, 0, 0, 0) |
+					(rte_rand() & 0xffffff)) & mask;
+				routes[n].nh = rte_rand() % 100;
+				for (j = 0; j < n; j++)
+					if (routes[j].ip == routes[n].ip &&
+						routes[j].depth ==
+						routes[n].depth)
+						break;
+				ret = rte_fib_add(fib, routes[n].ip,
+						routes[n].depth, routes[n].nh);
+				if (ret == -ENOSPC)
+					continue;
+				TEST_FIB_ASSERT(ret == 0);
+				if (j < n)
+					routes[j].nh = routes[n].nh;
+				else
+					n++;
+			}
+
+			/* Addresses close to the routes. */
+			for (k = 0; k < RND_IPS; k++) {
+				ips[k] = (n > 0) ? routes[rte_rand() % n].ip : 0;
+				ips[k] ^= rte_rand() & ((1 << (rte_rand() % 12)) -
+						1);
+				best = -1;
+				for (j = 0; j < n; j++) {
+					mask = (uint32_t)(UINT64_MAX <<
+						(32 - routes[j].depth));
+					if ((ips[k] & mask) == routes[j].ip &&
+						(best < 0 || routes[j].depth >
+						routes[best].depth))
+						best = j;
+				}
+				next_hops[k] = (best < 0) ? DEF_NH :
+						routes[best].nh;
+			}
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					RND_IPS) == PASS);
+		}
+
+		rte_fib_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Do all unit tests.
+ */
+
+static int
+test_fib(void)
+{
+	unsigned i;
+	int status, global_status = 0;
+
+	for (i = 0; i < NUM_FIB_TESTS; i++) {
+		status = tests[i]();
+		if (status < 0) {
+			printf("ERROR: FIB Test %u: FAIL\n", i);
+			global_status = status;
+		}
+	}
+
+	return global_status;
+}
+
+REGISTER_TEST_COMMAND(fib_autotest, test_fib);
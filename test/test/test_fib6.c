@@ -0,0 +1,579 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_memory.h>
+#include <rte_random.h>
+#include <rte_errno.h>
+#include <rte_fib6.h>
+#include <rte_rib6.h>
+
+#include "test.h"
+
+#define TEST_FIB_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+typedef int32_t (*rte_fib6_test)(void);
+
+static int32_t test0(void);
+static int32_t test1(void);
+static int32_t test2(void);
+static int32_t test3(void);
+static int32_t test4(void);
+
+static rte_fib6_test tests6[] = {
+/* Test Cases */
+	test0,
+	test1,
+	test2,
+	test3,
+	test4
+};
+
+#define NUM_FIB6_TESTS (sizeof(tests6)/sizeof(tests6[0]))
+#define MAX_ROUTES 1024
+#define NUMBER_TBL8S (1 << 12)
+#define DEF_NH 3
+#define PASS 0
+
+static const enum rte_fib6_trie_nh_sz nh_sizes[] = {
+	RTE_FIB6_TRIE_2B,
+	RTE_FIB6_TRIE_4B,
+	RTE_FIB6_TRIE_8B
+};
+
+static const enum rte_fib6_lookup_type lookup_types[] = {
+	RTE_FIB6_LOOKUP_SCALAR,
+	RTE_FIB6_LOOKUP_VECTOR_AVX2
+};
+
+static void
+fib6_conf_init(struct rte_fib6_conf *conf, enum rte_fib6_trie_nh_sz nh_sz)
+{
+	conf->type = RTE_FIB6_TRIE;
+	conf->default_nh = DEF_NH;
+	conf->max_routes = MAX_ROUTES;
+	conf->trie.nh_sz = nh_sz;
+	conf->trie.num_tbl8 = NUMBER_TBL8S;
+}
+
+/* Copy ip to dst with the bit at position pos, 0 being the MSB, flipped. */
+static void
+flip_bit(uint8_t *dst, const uint8_t *ip, unsigned int pos)
+{
+	memcpy(dst, ip, RTE_FIB6_IPV6_ADDR_SIZE);
+	if (pos < 128)
+		dst[pos / 8] ^= 0x80 >> (pos % 8);
+}
+
+/*
+ * Look up ips with every available lookup function and check that all of
+ * them return next_hops.
+ */
+static int32_t
+check_lookup(struct rte_fib6 *fib, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+		uint64_t *next_hops, unsigned int n)
+{
+	uint64_t ret_nh[n];
+	unsigned int i, j;
+
+	for (i = 0; i < RTE_DIM(lookup_types); i++) {
+		/* The vector lookup may not be supported by this CPU. */
+		if (rte_fib6_set_lookup_fn(fib, lookup_types[i]) != 0)
+			continue;
+		memset(ret_nh, 0xff, sizeof(ret_nh));
+		TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, ips, ret_nh, n) == 0);
+		for (j = 0; j < n; j++) {
+			if (ret_nh[j] != next_hops[j]) {
+				printf("Lookup type %u, ip %u: got %" PRIu64
+					" expected %" PRIu64 "\n",
+					lookup_types[i], j, ret_nh[j],
+					next_hops[j]);
+				return -1;
+			}
+		}
+	}
+	TEST_FIB_ASSERT(rte_fib6_set_lookup_fn(fib,
+			RTE_FIB6_LOOKUP_DEFAULT) == 0);
+
+	return PASS;
+}
+
+/*
+ * Check that rte_fib6_create fails gracefully for incorrect user input
+ * arguments, and that a FIB can be found by name.
+ */
+int32_t
+test0(void)
+{
+	struct rte_fib6 *fib = NULL, *fib2;
+	struct rte_fib6_conf config;
+
+	fib6_conf_init(&config, RTE_FIB6_TRIE_4B);
+
+	/* rte_fib6_create: fib name == NULL */
+	fib = rte_fib6_create(NULL, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib6_create: config == NULL */
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, NULL);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib6_create: socket_id < -1 */
+	fib = rte_fib6_create(__func__, -2, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib6_create: max_routes = 0 */
+	config.max_routes = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.max_routes = MAX_ROUTES;
+
+	/* rte_fib6_create: invalid next hop sizes */
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B - 1;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.trie.nh_sz = RTE_FIB6_TRIE_8B + 1;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+
+	/* rte_fib6_create: num_tbl8 = 0 */
+	config.trie.num_tbl8 = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+
+	/* rte_fib6_create: more tbl8s than 2 byte entries can index */
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.trie.num_tbl8 = 32769;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.trie.num_tbl8 = NUMBER_TBL8S;
+
+	/* rte_fib6_create: default next hop too large for 2 byte entries */
+	config.default_nh = 32768;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib == NULL);
+	config.default_nh = 32767;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+
+	/* rte_fib6_create: name already in use */
+	fib2 = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib2 == NULL && rte_errno == EEXIST);
+
+	fib2 = rte_fib6_find_existing(__func__);
+	TEST_FIB_ASSERT(fib2 == fib);
+	TEST_FIB_ASSERT(rte_fib6_get_rib(fib) != NULL);
+
+	rte_fib6_free(fib);
+
+	fib2 = rte_fib6_find_existing(__func__);
+	TEST_FIB_ASSERT(fib2 == NULL && rte_errno == ENOENT);
+
+	/* Freeing NULL is a no-op. */
+	rte_fib6_free(NULL);
+
+	return PASS;
+}
+
+/*
+ * Check that add, delete and lookup fail gracefully for incorrect user
+ * input arguments.
+ */
+int32_t
+test1(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint8_t ip[1][RTE_FIB6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb8}
+	};
+	uint64_t next_hop;
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib6_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		TEST_FIB_ASSERT(rte_fib6_add(NULL, ip[0], 32, 1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_add(fib, NULL, 32, 1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_add(fib, ip[0], RTE_FIB6_MAXDEPTH + 1,
+				1) == -EINVAL);
+
+		/* Next hop one bit too large for the entry size. */
+		if (nh_sizes[i] != RTE_FIB6_TRIE_8B) {
+			next_hop = 1ULL << ((8 << nh_sizes[i]) - 1);
+			TEST_FIB_ASSERT(rte_fib6_add(fib, ip[0], 32,
+					next_hop) == -EINVAL);
+		}
+		next_hop = UINT64_MAX >> (65 - (8 << nh_sizes[i]));
+		TEST_FIB_ASSERT(rte_fib6_add(fib, ip[0], 32, next_hop) == 0);
+
+		TEST_FIB_ASSERT(rte_fib6_delete(NULL, ip[0], 32) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip[0],
+				RTE_FIB6_MAXDEPTH + 1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip[0], 48) == -ENOENT);
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip[0], 32) == 0);
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip[0], 32) == -ENOENT);
+
+		TEST_FIB_ASSERT(rte_fib6_lookup_bulk(NULL, ip, &next_hop,
+				1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, NULL, &next_hop,
+				1) == -EINVAL);
+		TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, ip, NULL,
+				1) == -EINVAL);
+
+		rte_fib6_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Add nested routes ending in the tbl24 and in several tbl8 levels, for
+ * every next hop size, and check that lookups return the longest match
+ * and that deleted routes fall back to the covering route or to the
+ * default next hop.
+ */
+int32_t
+test2(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	static const uint8_t depths[] = {
+		0, 16, 24, 29, 32, 48, 64, 100, 120, 127, 128
+	};
+	static const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {
+		0x20, 0x01, 0x0d, 0xb8, 0x12, 0x34, 0x56, 0x78,
+		0x9a, 0xbc, 0xde, 0xf0, 0x11, 0x22, 0x33, 0x44
+	};
+	uint8_t ips[RTE_DIM(depths) + 1][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t next_hops[RTE_DIM(depths) + 1];
+	unsigned int i, j, k, n = RTE_DIM(depths);
+
+	/*
+	 * ips[j] is covered by the routes of depth up to depths[j] only,
+	 * the last ip by the /0 route and by nothing once it is gone.
+	 */
+	for (j = 0; j < n; j++)
+		flip_bit(ips[j], ip, (j + 1 < n) ? depths[j + 1] - 1 : 128);
+	flip_bit(ips[n], ip, 0);
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib6_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		/* Empty table: everything goes to the default next hop. */
+		for (j = 0; j < n + 1; j++)
+			next_hops[j] = DEF_NH;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 1) ==
+				PASS);
+
+		/* Add from the least to the most specific route. */
+		for (j = 0; j < n; j++) {
+			TEST_FIB_ASSERT(rte_fib6_add(fib, ip, depths[j],
+					10 + j) == 0);
+			for (k = 0; k < n + 1; k++)
+				next_hops[k] = 10 + RTE_MIN(j,
+					(k < n) ? k : 0);
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					n + 1) == PASS);
+		}
+
+		/* Changing a next hop only affects the route itself. */
+		TEST_FIB_ASSERT(rte_fib6_add(fib, ip, 64, 100) == 0);
+		next_hops[6] = 100;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 1) ==
+				PASS);
+		TEST_FIB_ASSERT(rte_fib6_add(fib, ip, 64, 16) == 0);
+		next_hops[6] = 16;
+
+		/* Delete the routes in the middle, one at a time. */
+		for (j = 1; j < n - 1; j++) {
+			TEST_FIB_ASSERT(rte_fib6_delete(fib, ip,
+					depths[j]) == 0);
+			for (k = 1; k <= j; k++)
+				next_hops[k] = 10;
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					n + 1) == PASS);
+		}
+
+		/* Then the /128 and the default route. */
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip, 128) == 0);
+		next_hops[n - 1] = 10;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 1) ==
+				PASS);
+		TEST_FIB_ASSERT(rte_fib6_delete(fib, ip, 0) == 0);
+		for (j = 0; j < n + 1; j++)
+			next_hops[j] = DEF_NH;
+		TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops, n + 1) ==
+				PASS);
+
+		rte_fib6_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Check that routes sharing a prefix share its tbl8s, that adds fail
+ * cleanly once all the tbl8s are needed and that deleting routes gives
+ * them back.
+ */
+int32_t
+test3(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint8_t ip[1][RTE_FIB6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb8}
+	};
+	uint8_t ip2[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t next_hop;
+
+	/* A /48 needs a tbl8 at the /24, /32 and /40 levels. */
+	fib6_conf_init(&config, RTE_FIB6_TRIE_4B);
+	config.trie.num_tbl8 = 4;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip[0], 48, 1) == 0);
+
+	/* Another /48 of the same /40 needs no new tbl8. */
+	flip_bit(ip2, ip[0], 47);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 2) == 0);
+
+	/* A /48 of another /32 takes the last tbl8. */
+	flip_bit(ip2, ip[0], 38);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 3) == 0);
+
+	/* No tbl8 left for a /48 of another /24, nothing must change. */
+	flip_bit(ip2, ip[0], 20);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 4) == -ENOSPC);
+	TEST_FIB_ASSERT(rte_rib6_lookup_exact(rte_fib6_get_rib(fib), ip2,
+			48) == NULL);
+	memcpy(ip[0], ip2, RTE_FIB6_IPV6_ADDR_SIZE);
+	TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == DEF_NH);
+
+	/* Routes up to /24 never need a tbl8. */
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 24, 5) == 0);
+
+	/* Free the tbl8 of the /40 of the third route. */
+	flip_bit(ip[0], ip2, 20);
+	flip_bit(ip2, ip[0], 38);
+	TEST_FIB_ASSERT(rte_fib6_delete(fib, ip2, 48) == 0);
+	flip_bit(ip2, ip[0], 20);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 4) == -ENOSPC);
+
+	/* The tbl8s of the first /24 are still needed by two routes. */
+	TEST_FIB_ASSERT(rte_fib6_delete(fib, ip[0], 48) == 0);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 4) == -ENOSPC);
+	flip_bit(ip2, ip[0], 47);
+	TEST_FIB_ASSERT(rte_fib6_delete(fib, ip2, 48) == 0);
+	flip_bit(ip2, ip[0], 20);
+	TEST_FIB_ASSERT(rte_fib6_add(fib, ip2, 48, 4) == 0);
+
+	memcpy(ip[0], ip2, RTE_FIB6_IPV6_ADDR_SIZE);
+	TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == 4);
+	ip[0][15] ^= 1;
+	ip[0][4] ^= 1;
+	TEST_FIB_ASSERT(rte_fib6_lookup_bulk(fib, ip, &next_hop, 1) == 0);
+	TEST_FIB_ASSERT(next_hop == 5);
+
+	rte_fib6_free(fib);
+
+	return PASS;
+}
+
+/*
+ * Add and delete random routes, checking lookups of random addresses
+ * against a linear search of the routes after each step.
+ */
+#define RND_ROUTES 256
+#define RND_IPS 256
+
+static int
+is_covered(const uint8_t *ip, const uint8_t *prefix, uint8_t depth)
+{
+	unsigned int i;
+
+	for (i = 0; i < depth; i++)
+		if (((ip[i / 8] ^ prefix[i / 8]) & (0x80 >> (i % 8))) != 0)
+			return 0;
+
+	return 1;
+}
+
+int32_t
+test4(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	struct {
+		uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+		uint8_t depth;
+		uint64_t nh;
+	} routes[RND_ROUTES];
+	static uint8_t ips[RND_IPS][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t next_hops[RND_IPS];
+	unsigned int i, j, k, n, step, bit;
+	int best, ret;
+
+	for (i = 0; i < RTE_DIM(nh_sizes); i++) {
+		fib6_conf_init(&config, nh_sizes[i]);
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(fib != NULL);
+
+		n = 0;
+		for (step = 0; step < 2 * RND_ROUTES; step++) {
+			if (n == RND_ROUTES ||
+					(n > 0 && (rte_rand() % 4) == 0)) {
+				/* Delete a random route. */
+				j = rte_rand() % n;
+				TEST_FIB_ASSERT(rte_fib6_delete(fib,
+					routes[j].ip, routes[j].depth) == 0);
+				routes[j] = routes[--n];
+			} else {
+				/*
+				 * Add a route within 2001:db8::/32, close to
+				 * another one so that routes nest.
+				 */
+				if (n > 0)
+					memcpy(routes[n].ip,
+						routes[rte_rand() % n].ip,
+						RTE_FIB6_IPV6_ADDR_SIZE);
+				else
+					memset(routes[n].ip, 0,
+						RTE_FIB6_IPV6_ADDR_SIZE);
+				routes[n].ip[0] = 0x20;
+				routes[n].ip[1] = 0x01;
+				routes[n].ip[2] = 0x0d;
+				routes[n].ip[3] = 0xb8;
+				for (k = 0; k < 4; k++) {
+					bit = 32 + rte_rand() % 96;
+					routes[n].ip[bit / 8] ^=
+						0x80 >> (bit % 8);
+				}
+				routes[n].depth = 32 + rte_rand() % 97;
+				for (k = routes[n].depth; k < 128; k++)
+					routes[n].ip[k / 8] &=
+						~(0x80 >> (k % 8));
+				routes[n].nh = rte_rand() % 100;
+				for (j = 0; j < n; j++)
+					if (routes[j].depth ==
+						routes[n].depth &&
+						memcmp(routes[j].ip,
+						routes[n].ip,
+						RTE_FIB6_IPV6_ADDR_SIZE) == 0)
+						break;
+				ret = rte_fib6_add(fib, routes[n].ip,
+						routes[n].depth, routes[n].nh);
+				if (ret == -ENOSPC)
+					continue;
+				TEST_FIB_ASSERT(ret == 0);
+				if (j < n)
+					routes[j].nh = routes[n].nh;
+				else
+					n++;
+			}
+
+			/* Addresses close to the routes. */
+			for (k = 0; k < RND_IPS; k++) {
+				if (n > 0)
+					memcpy(ips[k], routes[rte_rand() % n].ip,
+						RTE_FIB6_IPV6_ADDR_SIZE);
+				else
+					memset(ips[k], 0,
+						RTE_FIB6_IPV6_ADDR_SIZE);
+				bit = rte_rand() % 160;
+				if (bit < 128)
+					ips[k][bit / 8] ^= 0x80 >> (bit % 8);
+				best = -1;
+				for (j = 0; j < n; j++) {
+					if (is_covered(ips[k], routes[j].ip,
+						routes[j].depth) &&
+						(best < 0 || routes[j].depth >
+						routes[best].depth))
+						best = j;
+				}
+				next_hops[k] = (best < 0) ? DEF_NH :
+						routes[best].nh;
+			}
+			TEST_FIB_ASSERT(check_lookup(fib, ips, next_hops,
+					RND_IPS) == PASS);
+		}
+
+		rte_fib6_free(fib);
+	}
+
+	return PASS;
+}
+
+/*
+ * Do all unit tests.
+ */
+
+static int
+test_fib6(void)
+{
+	unsigned i;
+	int status, global_status = 0;
+
+	for (i = 0; i < NUM_FIB6_TESTS; i++) {
+		status = tests6[i]();
+		if (status < 0) {
+			printf("ERROR: FIB6 Test %u: FAIL\n", i);
+			global_status = status;
+		}
+	}
+
+	return global_status;
+}
+
+REGISTER_TEST_COMMAND(fib6_autotest, test_fib6);
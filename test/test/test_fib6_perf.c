@@ -0,0 +1,292 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_random.h>
+#include <rte_memory.h>
+#include <rte_branch_prediction.h>
+#include <rte_fib6.h>
+#include <rte_lpm6.h>
+
+#include "test.h"
+
+#define TEST_FIB_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define ITERATIONS (1 << 8)
+#define BATCH_SIZE (1 << 12)
+#define BULK_SIZE 32
+
+#define NUM_ROUTES (1 << 14)
+#define NUMBER_TBL8S (1 << 16)
+#define DEF_NH 0
+
+struct route_rule {
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t depth;
+};
+
+static struct route_rule route_table[NUM_ROUTES];
+
+/*
+ * Percentage of the routes per depth range, roughly the shape of an IPv6
+ * backbone routing table: mostly /32 to /48, a few host routes.
+ */
+static const struct {
+	uint8_t min_depth;
+	uint8_t max_depth;
+	unsigned int percent;
+} route_depths[] = {
+	{16, 31, 5},
+	{32, 47, 40},
+	{48, 48, 45},
+	{49, 64, 8},
+	{128, 128, 2},
+};
+
+static uint8_t ip_batch[BATCH_SIZE][RTE_FIB6_IPV6_ADDR_SIZE];
+
+static void
+mask_ip(uint8_t *ip, uint8_t depth)
+{
+	unsigned int i;
+
+	for (i = depth; i < 128; i++)
+		ip[i / 8] &= ~(0x80 >> (i % 8));
+}
+
+static void
+generate_route_table(void)
+{
+	unsigned int i, j, r;
+	uint8_t depth;
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		r = rte_rand() % 100;
+		for (j = 0; r >= route_depths[j].percent; j++)
+			r -= route_depths[j].percent;
+		depth = route_depths[j].min_depth + rte_rand() %
+			(route_depths[j].max_depth -
+			route_depths[j].min_depth + 1);
+		route_table[i].depth = depth;
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			route_table[i].ip[j] = rte_rand();
+		/* Global unicast space, 2000::/3 */
+		route_table[i].ip[0] = 0x20 | (route_table[i].ip[0] & 0x1f);
+		mask_ip(route_table[i].ip, depth);
+	}
+}
+
+/*
+ * Destination addresses fall in a random route with random host bits, so
+ * most lookups walk the tbl8 levels instead of stopping in the tbl24.
+ */
+static void
+generate_ip_batch(void)
+{
+	unsigned int i, j;
+	const struct route_rule *r;
+
+	for (i = 0; i < BATCH_SIZE; i++) {
+		r = &route_table[rte_rand() % NUM_ROUTES];
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			ip_batch[i][j] = rte_rand();
+		for (j = 0; j < r->depth; j++) {
+			ip_batch[i][j / 8] &= ~(0x80 >> (j % 8));
+			ip_batch[i][j / 8] |= r->ip[j / 8] & (0x80 >> (j % 8));
+		}
+	}
+}
+
+static void
+measure_lookup(struct rte_fib6 *fib, const char *name)
+{
+	uint64_t begin, total_time = 0, count = 0;
+	uint64_t next_hops[BULK_SIZE];
+	unsigned int i, j, k;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		generate_ip_batch();
+
+		/* Lookup per batch */
+		begin = rte_rdtsc();
+		for (j = 0; j < BATCH_SIZE; j += BULK_SIZE) {
+			rte_fib6_lookup_bulk(fib, &ip_batch[j], next_hops,
+					BULK_SIZE);
+			for (k = 0; k < BULK_SIZE; k++)
+				if (unlikely(next_hops[k] == DEF_NH))
+					count++;
+		}
+
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("%s bulk lookup: %.1f cycles (fails = %.1f%%)\n", name,
+			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
+			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
+}
+
+static int
+test_fib6_perf_nh_sz(enum rte_fib6_trie_nh_sz nh_sz)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint64_t begin, total_time;
+	uint64_t next_hop_max = UINT64_MAX >> (65 - (8 << nh_sz));
+	unsigned int i;
+	int status = 0;
+
+	config.type = RTE_FIB6_TRIE;
+	config.default_nh = DEF_NH;
+	config.max_routes = NUM_ROUTES;
+	config.trie.nh_sz = nh_sz;
+	config.trie.num_tbl8 = RTE_MIN((uint64_t)NUMBER_TBL8S,
+			next_hop_max + 1);
+
+	printf("\n%u byte next hops, tbl24 size = %u bytes\n", 1 << nh_sz,
+			(1 << 24) << nh_sz);
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(fib != NULL);
+
+	/* Measure add. */
+	begin = rte_rdtsc();
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		if (rte_fib6_add(fib, route_table[i].ip, route_table[i].depth,
+				1 + i % next_hop_max) == 0)
+			status++;
+	}
+	/* End Timer. */
+	total_time = rte_rdtsc() - begin;
+
+	printf("Unique added entries = %d\n", status);
+	printf("Average FIB6 Add: %g cycles\n",
+			(double)total_time / NUM_ROUTES);
+
+	if (rte_fib6_set_lookup_fn(fib, RTE_FIB6_LOOKUP_SCALAR) == 0)
+		measure_lookup(fib, "Scalar");
+	if (rte_fib6_set_lookup_fn(fib, RTE_FIB6_LOOKUP_VECTOR_AVX2) == 0)
+		measure_lookup(fib, "AVX2");
+	else
+		printf("AVX2 bulk lookup not supported\n");
+
+	/* Delete */
+	begin = rte_rdtsc();
+
+	for (i = 0; i < NUM_ROUTES; i++)
+		rte_fib6_delete(fib, route_table[i].ip, route_table[i].depth);
+
+	total_time = rte_rdtsc() - begin;
+
+	printf("Average FIB6 Delete: %g cycles\n",
+			(double)total_time / NUM_ROUTES);
+
+	rte_fib6_free(fib);
+
+	return 0;
+}
+
+/* The same routes and lookups through LPM6, for comparison. */
+static int
+test_lpm6_reference(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint64_t begin, total_time = 0, count = 0;
+	int32_t next_hops[BULK_SIZE];
+	unsigned int i, j, k;
+
+	config.max_rules = NUM_ROUTES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	printf("\nLPM6 reference\n");
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_FIB_ASSERT(lpm != NULL);
+
+	for (i = 0; i < NUM_ROUTES; i++)
+		rte_lpm6_add(lpm, route_table[i].ip, route_table[i].depth,
+				1 + i);
+
+	for (i = 0; i < ITERATIONS; i++) {
+		generate_ip_batch();
+
+		begin = rte_rdtsc();
+		for (j = 0; j < BATCH_SIZE; j += BULK_SIZE) {
+			rte_lpm6_lookup_bulk_func(lpm, &ip_batch[j], next_hops,
+					BULK_SIZE);
+			for (k = 0; k < BULK_SIZE; k++)
+				if (unlikely(next_hops[k] < 0))
+					count++;
+		}
+
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("LPM6 bulk lookup: %.1f cycles (fails = %.1f%%)\n",
+			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
+			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
+
+	rte_lpm6_free(lpm);
+
+	return 0;
+}
+
+static int
+test_fib6_perf(void)
+{
+	rte_srand(rte_rdtsc());
+
+	generate_route_table();
+
+	printf("No. routes = %u\n", NUM_ROUTES);
+
+	if (test_fib6_perf_nh_sz(RTE_FIB6_TRIE_2B) < 0 ||
+			test_fib6_perf_nh_sz(RTE_FIB6_TRIE_4B) < 0 ||
+			test_fib6_perf_nh_sz(RTE_FIB6_TRIE_8B) < 0 ||
+			test_lpm6_reference() < 0)
+		return -1;
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(fib6_perf_autotest, test_fib6_perf);
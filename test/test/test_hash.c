@@ -31,6 +31,7 @@
  *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
@@ -39,6 +40,7 @@
 #include <errno.h>
 #include <sys/queue.h>
 
+#include <rte_atomic.h>
 #include <rte_common.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
@@ -48,6 +50,9 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_rwlock.h>
 
 #include "test.h"
 
@@ -580,6 +585,139 @@ static int test_five_keys(void)
 	return 0;
 }
 
+/*
+ * Bulk add and delete of the five keys:
+ *	- bulk add the 5 keys: 5 OK, then again: same positions
+ *	- bulk add with data: data updated
+ *	- bulk delete the 5 keys: 5 OK, then again: 5 misses
+ */
+static int test_five_keys_bulk(void)
+{
+	struct rte_hash *handle;
+	const void *key_array[5];
+	void *data_array[5];
+	void *data;
+	int32_t pos[5];
+	int32_t expected_pos[5];
+	unsigned i;
+	int ret;
+
+	ut_params.name = "test3_bulk";
+	handle = rte_hash_create(&ut_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < 5; i++) {
+		key_array[i] = &keys[i];
+		data_array[i] = (void *)(uintptr_t)(i + 1);
+	}
+
+	/* Add multi */
+	ret = rte_hash_add_key_bulk(handle, key_array, 5, expected_pos);
+	RETURN_IF_ERROR(ret != 5, "bulk add returned %d", ret);
+	for (i = 0; i < 5; i++) {
+		print_key_info("Add", key_array[i], expected_pos[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add key (pos[%u]=%d)",
+				i, expected_pos[i]);
+		RETURN_IF_ERROR(rte_hash_lookup(handle, &keys[i]) !=
+				expected_pos[i], "failed to find key %u", i);
+	}
+
+	/* Add multi - update */
+	ret = rte_hash_add_key_data_bulk(handle, key_array, data_array, 5,
+					pos);
+	RETURN_IF_ERROR(ret != 5, "bulk add with data returned %d", ret);
+	for (i = 0; i < 5; i++) {
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to update key (pos[%u]=%d)", i, pos[i]);
+		RETURN_IF_ERROR(rte_hash_lookup_data(handle, &keys[i],
+				&data) < 0 || data != data_array[i],
+				"wrong data for key %u", i);
+	}
+
+	/* Add multi - a key repeated in the burst is found, not added twice */
+	key_array[1] = &keys[0];
+	ret = rte_hash_add_key_bulk(handle, key_array, 2, pos);
+	key_array[1] = &keys[1];
+	RETURN_IF_ERROR(ret != 2 || pos[0] != expected_pos[0] ||
+			pos[1] != expected_pos[0],
+			"repeated key added twice (pos=%d,%d)", pos[0], pos[1]);
+
+	/* Delete multi */
+	ret = rte_hash_del_key_bulk(handle, key_array, 5, pos);
+	RETURN_IF_ERROR(ret != 5, "bulk delete returned %d", ret);
+	for (i = 0; i < 5; i++) {
+		print_key_info("Del", key_array[i], pos[i]);
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to delete key (pos[%u]=%d)", i, pos[i]);
+		RETURN_IF_ERROR(rte_hash_lookup(handle, &keys[i]) != -ENOENT,
+				"found deleted key %u", i);
+	}
+
+	ret = rte_hash_del_key_bulk(handle, key_array, 5, pos);
+	RETURN_IF_ERROR(ret != 0, "bulk delete of missing keys returned %d",
+			ret);
+	for (i = 0; i < 5; i++)
+		RETURN_IF_ERROR(pos[i] != -ENOENT,
+				"deleted non-existent key (pos[%u]=%d)",
+				i, pos[i]);
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+/*
+ * Bulk lookup of the five keys with each signature compare method
+ * supported, half of the keys being deleted.
+ */
+static int test_five_keys_sig_cmp_fn(void)
+{
+	struct rte_hash *handle;
+	const void *key_array[5];
+	int32_t pos[5];
+	int32_t expected_pos[5];
+	unsigned i, fn, nb_fn = 0;
+
+	ut_params.name = "test3_sig_cmp";
+	handle = rte_hash_create(&ut_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < 5; i++) {
+		key_array[i] = &keys[i];
+		expected_pos[i] = rte_hash_add_key(handle, &keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add key (pos[%u]=%d)",
+				i, expected_pos[i]);
+	}
+	for (i = 0; i < 5; i += 2) {
+		RETURN_IF_ERROR(rte_hash_del_key(handle, &keys[i]) < 0,
+				"failed to delete key %u", i);
+		expected_pos[i] = -ENOENT;
+	}
+
+	for (fn = 0; fn < RTE_HASH_COMPARE_NUM; fn++) {
+		if (rte_hash_set_sig_cmp_fn(handle, fn) != 0)
+			continue;
+		nb_fn++;
+
+		RETURN_IF_ERROR(rte_hash_lookup_bulk(handle, key_array, 5,
+				pos) != 0, "bulk lookup failed");
+		for (i = 0; i < 5; i++)
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"wrong position for key %u with method %u "
+				"(pos=%d)", i, fn, pos[i]);
+	}
+	RETURN_IF_ERROR(nb_fn == 0, "no signature compare method supported");
+	RETURN_IF_ERROR(rte_hash_set_sig_cmp_fn(handle,
+			RTE_HASH_COMPARE_NUM) != -EINVAL,
+			"invalid signature compare method accepted");
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /*
  * Add keys to the same bucket until bucket full.
  *	- add 5 keys to the same bucket (hash created with 4 keys per bucket):
@@ -690,6 +828,431 @@ static int test_full_bucket(void)
 	return 0;
 }
 
+#define EXT_KEYS 40
+/*
+ * Add more keys to the same bucket pair than it can hold,
+ * using extendable buckets:
+ *	- add 40 keys with the same hash: the 16 entries of the primary and
+ *	  secondary buckets are used, then the extendable buckets
+ *	- lookup (single and bulk) and iterate the 40 keys
+ *	- delete keys in the middle of the chain, check the others
+ *	  are still found, and add them back
+ *	- delete all the keys, and check the extendable buckets were released
+ *	  by adding all the keys again
+ */
+static int test_extendable_bucket(void)
+{
+	struct rte_hash_parameters params_pseudo_hash = {
+		.name = "test_ext",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = pseudo_hash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+	};
+	struct rte_hash *handle;
+	struct flow_key ext_keys[EXT_KEYS];
+	const void *key_ptrs[EXT_KEYS];
+	int32_t pos[EXT_KEYS];
+	int32_t expected_pos[EXT_KEYS];
+	const void *next_key;
+	void *next_data;
+	uint32_t iter = 0;
+	unsigned i, round, nb_iterated = 0;
+
+	handle = rte_hash_create(&params_pseudo_hash);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	memset(ext_keys, 0, sizeof(ext_keys));
+	for (i = 0; i < EXT_KEYS; i++) {
+		ext_keys[i].ip_src = i;
+		key_ptrs[i] = &ext_keys[i];
+	}
+
+	for (round = 0; round < 2; round++) {
+		for (i = 0; i < EXT_KEYS; i++) {
+			expected_pos[i] = rte_hash_add_key(handle,
+							&ext_keys[i]);
+			RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add key %u (round %u)", i, round);
+		}
+
+		for (i = 0; i < EXT_KEYS; i++) {
+			pos[i] = rte_hash_lookup(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to find key %u (pos=%d)", i, pos[i]);
+		}
+
+		memset(pos, 0, sizeof(pos));
+		RETURN_IF_ERROR(rte_hash_lookup_bulk(handle, key_ptrs,
+				EXT_KEYS, pos) != 0, "bulk lookup failed");
+		for (i = 0; i < EXT_KEYS; i++)
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to bulk find key %u (pos=%d)",
+				i, pos[i]);
+
+		/* Delete from the middle of the chain */
+		for (i = 20; i < 30; i++) {
+			pos[i] = rte_hash_del_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to delete key %u (pos=%d)", i, pos[i]);
+		}
+		for (i = 0; i < EXT_KEYS; i++) {
+			pos[i] = rte_hash_lookup(handle, &ext_keys[i]);
+			if (i >= 20 && i < 30)
+				RETURN_IF_ERROR(pos[i] != -ENOENT,
+					"deleted key %u found", i);
+			else
+				RETURN_IF_ERROR(pos[i] != expected_pos[i],
+					"failed to find key %u after deletes "
+					"(pos=%d)", i, pos[i]);
+		}
+		for (i = 20; i < 30; i++) {
+			expected_pos[i] = rte_hash_add_key(handle,
+							&ext_keys[i]);
+			RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add back key %u", i);
+		}
+
+		iter = 0;
+		nb_iterated = 0;
+		while (rte_hash_iterate(handle, &next_key, &next_data,
+					&iter) >= 0)
+			nb_iterated++;
+		RETURN_IF_ERROR(nb_iterated != EXT_KEYS,
+				"%u keys iterated instead of %u",
+				nb_iterated, EXT_KEYS);
+
+		for (i = 0; i < EXT_KEYS; i++) {
+			pos[i] = rte_hash_del_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to delete key %u (pos=%d)", i, pos[i]);
+		}
+		for (i = 0; i < EXT_KEYS; i++)
+			RETURN_IF_ERROR(rte_hash_lookup(handle,
+					&ext_keys[i]) != -ENOENT,
+					"deleted key %u found", i);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+#define AGING_KEYS 200
+#define AGING_SWEEP_BUCKETS 4
+#define AGING_SWEEP_KEYS 8
+
+/*
+ * Age a table in small slices:
+ *	- add keys at time 0
+ *	- at time 10, look up the even keys, half of them in bulk
+ *	- at time 20, sweep the keys older than 15: only the odd keys expire
+ */
+static int test_hash_aging(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_aging",
+		.entries = 256,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING,
+	};
+	static struct flow_key aging_keys[AGING_KEYS];
+	static int32_t expected_pos[AGING_KEYS];
+	static uint8_t expired[AGING_KEYS];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *exp_keys[AGING_SWEEP_KEYS];
+	int32_t exp_pos[AGING_SWEEP_KEYS];
+	struct rte_hash *handle;
+	uint32_t next = 0;
+	unsigned i, j, nb_keys, nb_expired = 0, nb_calls = 0;
+	int ret;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	memset(aging_keys, 0, sizeof(aging_keys));
+	memset(expired, 0, sizeof(expired));
+	rte_hash_set_age_time(handle, 0);
+	for (i = 0; i < AGING_KEYS; i++) {
+		aging_keys[i].ip_src = i;
+		expected_pos[i] = rte_hash_add_key(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add key %u", i);
+	}
+
+	rte_hash_set_age_time(handle, 10);
+	for (i = 0; i < AGING_KEYS / 2; i += 2)
+		RETURN_IF_ERROR(rte_hash_lookup(handle, &aging_keys[i]) !=
+				expected_pos[i], "failed to find key %u", i);
+	nb_keys = 0;
+	for (; i < AGING_KEYS; i += 2)
+		key_ptrs[nb_keys++] = &aging_keys[i];
+	RETURN_IF_ERROR(rte_hash_lookup_bulk(handle, key_ptrs, nb_keys,
+			pos) != 0, "bulk lookup failed");
+
+	rte_hash_set_age_time(handle, 20);
+	do {
+		ret = rte_hash_age_sweep(handle, &next, AGING_SWEEP_BUCKETS,
+				15, exp_keys, exp_pos, AGING_SWEEP_KEYS);
+		RETURN_IF_ERROR(ret < 0 || ret > AGING_SWEEP_KEYS,
+				"sweep failed (ret=%d)", ret);
+		for (j = 0; j < (unsigned)ret; j++) {
+			i = ((const struct flow_key *)exp_keys[j])->ip_src;
+			RETURN_IF_ERROR(i >= AGING_KEYS || i % 2 == 0 ||
+					expired[i] ||
+					exp_pos[j] != expected_pos[i],
+					"wrong expired key %u (pos=%d)",
+					i, exp_pos[j]);
+			expired[i] = 1;
+			nb_expired++;
+		}
+		RETURN_IF_ERROR(++nb_calls > AGING_KEYS,
+				"sweep does not end");
+	} while (next != 0);
+
+	RETURN_IF_ERROR(nb_expired != AGING_KEYS / 2,
+			"%u keys expired instead of %u",
+			nb_expired, AGING_KEYS / 2);
+	/* Table of 32 buckets swept 4 at a time */
+	RETURN_IF_ERROR(nb_calls < 8, "sweep not done in slices");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+#define RESIZE_KEYS 4096
+#define RESIZE_CHECK_PERIOD 256
+
+/*
+ * Grow a resizable table from 64 entries, checking that the keys already
+ * added are still found at the same position while being migrated.
+ */
+static int test_hash_resize(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	static uint32_t keys[RESIZE_KEYS];
+	static int32_t expected_pos[RESIZE_KEYS];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle;
+	const void *next_key;
+	void *next_data;
+	uint32_t iter = 0;
+	unsigned i, j, nb_iterated = 0;
+	int32_t ret;
+
+	/* A resizable table only supports a single writer */
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle != NULL,
+			"resizable table with ext buckets should fail");
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		keys[i] = i;
+		expected_pos[i] = rte_hash_add_key(handle, &keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to add key %u (ret=%d)",
+				i, expected_pos[i]);
+
+		if ((i + 1) % RESIZE_CHECK_PERIOD != 0)
+			continue;
+		for (j = 0; j <= i; j++) {
+			ret = rte_hash_lookup(handle, &keys[j]);
+			RETURN_IF_ERROR(ret != expected_pos[j],
+				"key %u moved from %d to %d after %u adds",
+				j, expected_pos[j], ret, i + 1);
+		}
+		/* Adding an existing key returns its position */
+		ret = rte_hash_add_key(handle, &keys[i / 2]);
+		RETURN_IF_ERROR(ret != expected_pos[i / 2],
+				"key %u added twice", i / 2);
+	}
+
+	for (i = 0; i < RESIZE_KEYS; i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			key_ptrs[j] = &keys[i + j];
+		RETURN_IF_ERROR(rte_hash_lookup_bulk(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, pos) != 0,
+				"bulk lookup failed");
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			RETURN_IF_ERROR(pos[j] != expected_pos[i + j],
+				"failed to bulk find key %u (pos=%d)",
+				i + j, pos[j]);
+	}
+
+	for (i = 0; i < RESIZE_KEYS; i += 2) {
+		ret = rte_hash_del_key(handle, &keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+				"failed to delete key %u (ret=%d)", i, ret);
+	}
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR(ret != (i % 2 ? expected_pos[i] : -ENOENT),
+				"wrong lookup of key %u after deletes (ret=%d)",
+				i, ret);
+	}
+
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0)
+		nb_iterated++;
+	RETURN_IF_ERROR(nb_iterated != RESIZE_KEYS / 2,
+			"%u keys iterated instead of %u",
+			nb_iterated, RESIZE_KEYS / 2);
+
+	/* Positions of deleted keys are reused */
+	for (i = 0; i < RESIZE_KEYS; i += 2) {
+		expected_pos[i] = rte_hash_add_key(handle, &keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0 ||
+				expected_pos[i] >= RESIZE_KEYS,
+				"failed to add back key %u (ret=%d)",
+				i, expected_pos[i]);
+	}
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+				"failed to find key %u after adding back "
+				"(ret=%d)", i, ret);
+	}
+
+	rte_hash_reset(handle);
+	RETURN_IF_ERROR(rte_hash_lookup(handle, &keys[0]) != -ENOENT,
+			"key found after reset");
+	RETURN_IF_ERROR(rte_hash_add_key(handle, &keys[0]) != 0,
+			"failed to add key after reset");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+#define RESIZE_READERS_KEYS (16 * 1024)
+
+static struct {
+	struct rte_hash *h;
+	rte_rwlock_t lock;
+	uint32_t keys[RESIZE_READERS_KEYS];
+	int32_t pos[RESIZE_READERS_KEYS];
+	volatile uint32_t nb_added;
+	volatile int writer_done;
+	rte_atomic64_t lookups;
+	rte_atomic64_t misses;
+} resize_readers_params;
+
+/*
+ * Look up the keys already added, the lookups being serialized with the
+ * additions by the reader/writer lock but running in between them, while
+ * the table is growing.
+ */
+static int
+test_hash_resize_reader(__attribute__((unused)) void *arg)
+{
+	uint64_t lookups = 0, misses = 0;
+	uint32_t i, nb_added;
+	int32_t ret;
+
+	while (!resize_readers_params.writer_done) {
+		nb_added = resize_readers_params.nb_added;
+		rte_smp_rmb();
+		for (i = 0; i < nb_added; i++) {
+			rte_rwlock_read_lock(&resize_readers_params.lock);
+			ret = rte_hash_lookup(resize_readers_params.h,
+					&resize_readers_params.keys[i]);
+			rte_rwlock_read_unlock(&resize_readers_params.lock);
+			lookups++;
+			if (ret != resize_readers_params.pos[i])
+				misses++;
+		}
+	}
+
+	rte_atomic64_add(&resize_readers_params.lookups, lookups);
+	rte_atomic64_add(&resize_readers_params.misses, misses);
+	return 0;
+}
+
+/*
+ * Grow a resizable table while other lcores look it up: each addition
+ * only holds the lock for a bounded migration work, and no key added
+ * before is missed by the readers.
+ */
+static int test_hash_resize_readers(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize_readers",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash *handle;
+	uint64_t lookups, misses;
+	unsigned i, nb_again = 0;
+	int32_t ret = 0;
+
+	if (rte_lcore_count() == 1) {
+		printf("More than one lcore is required "
+			"to test readers of a resizable table\n");
+		return 0;
+	}
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	resize_readers_params.h = handle;
+	rte_rwlock_init(&resize_readers_params.lock);
+	resize_readers_params.nb_added = 0;
+	resize_readers_params.writer_done = 0;
+	rte_atomic64_init(&resize_readers_params.lookups);
+	rte_atomic64_init(&resize_readers_params.misses);
+
+	rte_eal_mp_remote_launch(test_hash_resize_reader, NULL, SKIP_MASTER);
+
+	for (i = 0; i < RESIZE_READERS_KEYS; i++) {
+		resize_readers_params.keys[i] = i;
+		do {
+			rte_rwlock_write_lock(&resize_readers_params.lock);
+			ret = rte_hash_add_key(handle,
+					&resize_readers_params.keys[i]);
+			rte_rwlock_write_unlock(&resize_readers_params.lock);
+			if (ret == -EAGAIN)
+				nb_again++;
+		} while (ret == -EAGAIN);
+		if (ret < 0)
+			break;
+		resize_readers_params.pos[i] = ret;
+		rte_smp_wmb();
+		resize_readers_params.nb_added = i + 1;
+	}
+
+	resize_readers_params.writer_done = 1;
+	rte_eal_mp_wait_lcore();
+	RETURN_IF_ERROR(ret < 0, "failed to add key %u (ret=%d)", i, ret);
+
+	lookups = rte_atomic64_read(&resize_readers_params.lookups);
+	misses = rte_atomic64_read(&resize_readers_params.misses);
+	printf("%"PRIu64" lookups during growth, %"PRIu64" missed, "
+		"%u additions deferred\n", lookups, misses, nb_again);
+	RETURN_IF_ERROR(misses != 0, "readers missed keys during growth");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1126,7 +1689,7 @@ test_hash_creation_with_good_parameters(void)
  * Test to see the average table utilization (entries added/max entries)
  * before hitting a random entry that cannot be added
  */
-static int test_average_table_utilization(void)
+static int test_average_table_utilization(uint32_t ext_table)
 {
 	struct rte_hash *handle;
 	uint8_t simple_key[MAX_KEYSIZE];
@@ -1135,12 +1698,17 @@ static int test_average_table_utilization(void)
 	int ret;
 
 	printf("\n# Running test to determine average utilization"
-	       "\n  before adding elements begins to fail\n");
+	       "\n  before adding elements begins to fail%s\n",
+	       ext_table ? " (with extendable buckets)" : "");
 	printf("Measuring performance, please wait");
 	fflush(stdout);
 	ut_params.entries = 1 << 16;
 	ut_params.name = "test_average_utilization";
 	ut_params.hash_func = rte_jhash;
+	if (ext_table)
+		ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	else
+		ut_params.extra_flag = 0;
 	handle = rte_hash_create(&ut_params);
 	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
 
@@ -1157,6 +1725,14 @@ static int test_average_table_utilization(void)
 			rte_hash_free(handle);
 			return -1;
 		}
+		/* Do not count the failed addition */
+		added_keys--;
+		if (ext_table && added_keys != ut_params.entries) {
+			printf("Table not full (%u/%u) with extendable "
+			       "buckets\n", added_keys, ut_params.entries);
+			rte_hash_free(handle);
+			return -1;
+		}
 
 		average_keys_added += added_keys;
 
@@ -1173,6 +1749,7 @@ static int test_average_table_utilization(void)
 	printf("\nAverage table utilization = %.2f%% (%u/%u)\n",
 		((double) average_keys_added / ut_params.entries * 100),
 		average_keys_added, ut_params.entries);
+	ut_params.extra_flag = 0;
 	rte_hash_free(handle);
 
 	return 0;
@@ -1490,8 +2067,20 @@ test_hash(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_five_keys_bulk() < 0)
+		return -1;
+	if (test_five_keys_sig_cmp_fn() < 0)
+		return -1;
 	if (test_full_bucket() < 0)
 		return -1;
+	if (test_extendable_bucket() < 0)
+		return -1;
+	if (test_hash_resize() < 0)
+		return -1;
+	if (test_hash_resize_readers() < 0)
+		return -1;
+	if (test_hash_aging() < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
@@ -1501,7 +2090,9 @@ test_hash(void)
 		return -1;
 	if (test_hash_creation_with_good_parameters() < 0)
 		return -1;
-	if (test_average_table_utilization() < 0)
+	if (test_average_table_utilization(0) < 0)
+		return -1;
+	if (test_average_table_utilization(1) < 0)
 		return -1;
 	if (test_hash_iteration() < 0)
 		return -1;
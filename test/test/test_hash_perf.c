@@ -32,6 +32,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include <rte_lcore.h>
@@ -58,9 +59,11 @@
 
 enum operations {
 	ADD = 0,
+	ADD_MULTI,
 	LOOKUP,
 	LOOKUP_MULTI,
 	DELETE,
+	DELETE_MULTI,
 	NUM_OPERATIONS
 };
 
@@ -475,6 +478,83 @@ timed_deletes(unsigned with_hash, unsigned with_data, unsigned table_index)
 	return 0;
 }
 
+static int
+timed_adds_multi(unsigned with_data, unsigned table_index)
+{
+	unsigned j, k;
+	const void *keys_burst[BURST_SIZE];
+	void *data_burst[BURST_SIZE];
+	int ret;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (j = 0; j < KEYS_TO_ADD/BURST_SIZE; j++) {
+		for (k = 0; k < BURST_SIZE; k++) {
+			keys_burst[k] = keys[j * BURST_SIZE + k];
+			data_burst[k] = (void *) ((uintptr_t) signatures[j * BURST_SIZE + k]);
+		}
+		if (with_data)
+			ret = rte_hash_add_key_data_bulk(h[table_index],
+					(const void **) keys_burst, data_burst,
+					BURST_SIZE, &positions[j * BURST_SIZE]);
+		else
+			ret = rte_hash_add_key_bulk(h[table_index],
+					(const void **) keys_burst,
+					BURST_SIZE, &positions[j * BURST_SIZE]);
+		if (ret != BURST_SIZE) {
+			printf("Expect to add %u keys, but added %d\n",
+				BURST_SIZE, ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][ADD_MULTI][0][with_data] = time_taken/KEYS_TO_ADD;
+
+	return 0;
+}
+
+static int
+timed_deletes_multi(unsigned with_data, unsigned table_index)
+{
+	unsigned j, k;
+	int32_t positions_burst[BURST_SIZE];
+	const void *keys_burst[BURST_SIZE];
+	int ret;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (j = 0; j < KEYS_TO_ADD/BURST_SIZE; j++) {
+		for (k = 0; k < BURST_SIZE; k++)
+			keys_burst[k] = keys[j * BURST_SIZE + k];
+		ret = rte_hash_del_key_bulk(h[table_index],
+				(const void **) keys_burst,
+				BURST_SIZE, positions_burst);
+		if (ret != BURST_SIZE) {
+			printf("Expect to delete %u keys, but deleted %d\n",
+				BURST_SIZE, ret);
+			return -1;
+		}
+		for (k = 0; k < BURST_SIZE; k++) {
+			if (positions_burst[k] != positions[j * BURST_SIZE + k]) {
+				printf("Key deleted from %d, should be in %d\n",
+					positions_burst[k],
+					positions[j * BURST_SIZE + k]);
+				return -1;
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][DELETE_MULTI][0][with_data] = time_taken/KEYS_TO_ADD;
+
+	return 0;
+}
+
 static void
 free_table(unsigned table_index)
 {
@@ -518,6 +598,16 @@ run_all_tbl_perf_tests(unsigned with_pushes)
 				if (timed_deletes(with_hash, with_data, i) < 0)
 					return -1;
 
+				/* Bulk operations compute the hash values */
+				if (!with_hash) {
+					reset_table(i);
+					if (timed_adds_multi(with_data, i) < 0)
+						return -1;
+
+					if (timed_deletes_multi(with_data, i) < 0)
+						return -1;
+				}
+
 				/* Print a dot to show progress on operations */
 				printf(".");
 				fflush(stdout);
@@ -541,8 +631,9 @@ run_all_tbl_perf_tests(unsigned with_pushes)
 			else
 				printf("\nWithout pre-computed hash values\n");
 
-			printf("\n%-18s%-18s%-18s%-18s%-18s\n",
-			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+			printf("\n%-18s%-18s%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Add_bulk", "Lookup", "Lookup_bulk",
+			"Delete", "Delete_bulk");
 			for (i = 0; i < NUM_KEYSIZES; i++) {
 				printf("%-18d", hashtest_key_lens[i]);
 				for (j = 0; j < NUM_OPERATIONS; j++)
@@ -554,6 +645,168 @@ run_all_tbl_perf_tests(unsigned with_pushes)
 	return 0;
 }
 
+/* Control operation of fill-up performance testing. */
+#define FILL_ENTRIES (1 << 16)	/* How many entries. */
+#define FILL_KEY_LEN 16		/* Size of the keys. */
+#define FILL_STEPS 10		/* How many load ranges to measure. */
+
+/* Array to store the keys used to fill up the table */
+uint8_t fill_keys[FILL_ENTRIES][FILL_KEY_LEN];
+
+/*
+ * Measure the average insertion cost in each tenth of the table capacity,
+ * adding keys until the table is full or an addition fails,
+ * with and without extendable buckets.
+ */
+static int
+fill_table_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_fill",
+		.entries = FILL_ENTRIES,
+		.key_len = FILL_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	uint64_t fill_cycles[2][FILL_STEPS];
+	unsigned nb_added[2];
+	unsigned ext, step, i, j, start, end;
+	struct rte_hash *handle;
+	uint64_t begin;
+
+	for (i = 0; i < FILL_ENTRIES; i++)
+		for (j = 0; j < FILL_KEY_LEN; j++)
+			fill_keys[i][j] = rte_rand() & 0xff;
+
+	for (ext = 0; ext <= 1; ext++) {
+		params.extra_flag = ext ? RTE_HASH_EXTRA_FLAGS_EXT_TABLE : 0;
+		handle = rte_hash_create(&params);
+		if (handle == NULL) {
+			printf("Error creating table\n");
+			return -1;
+		}
+
+		nb_added[ext] = 0;
+		memset(fill_cycles[ext], 0, sizeof(fill_cycles[ext]));
+		for (step = 0; step < FILL_STEPS; step++) {
+			start = FILL_ENTRIES / FILL_STEPS * step;
+			end = (step == FILL_STEPS - 1) ? FILL_ENTRIES :
+				FILL_ENTRIES / FILL_STEPS * (step + 1);
+
+			begin = rte_rdtsc();
+			for (i = start; i < end; i++)
+				if (rte_hash_add_key(handle, fill_keys[i]) < 0)
+					break;
+			if (i != start)
+				fill_cycles[ext][step] =
+					(rte_rdtsc() - begin) / (i - start);
+			nb_added[ext] += i - start;
+			if (i != end)
+				break;
+		}
+		rte_hash_free(handle);
+	}
+
+	printf("\nFill-up results (in CPU cycles/add, key size %u)\n",
+		FILL_KEY_LEN);
+	printf("-----------------------------------\n");
+	printf("%-18s%-18s%-18s\n", "Table load", "Add", "Add (ext bkt)");
+	for (step = 0; step < FILL_STEPS; step++) {
+		printf("%3u%% - %3u%%       ", step * 100 / FILL_STEPS,
+			(step + 1) * 100 / FILL_STEPS);
+		for (ext = 0; ext <= 1; ext++)
+			printf("%-18"PRIu64, fill_cycles[ext][step]);
+		printf("\n");
+	}
+	printf("%-18s%-18u%-18u\n", "Keys added", nb_added[0], nb_added[1]);
+
+	if (nb_added[1] != FILL_ENTRIES) {
+		printf("Table with extendable buckets not full\n");
+		return -1;
+	}
+	return 0;
+}
+
+/* Control operation of signature compare performance testing. */
+#define SIG_CMP_KEYS (FILL_ENTRIES * 3 / 4)	/* How many keys to look up. */
+#define SIG_CMP_ROUNDS 20	/* How many times to look up all the keys. */
+
+/*
+ * Measure the bulk lookup cost with each signature compare method
+ * supported by the CPU, reusing the keys of the fill-up test.
+ */
+static int
+sig_cmp_perf_test(void)
+{
+	static const char * const sig_cmp_names[RTE_HASH_COMPARE_NUM] = {
+		"Scalar", "SSE", "AVX2", "AVX512"
+	};
+	struct rte_hash_parameters params = {
+		.name = "test_hash_sig_cmp",
+		.entries = FILL_ENTRIES,
+		.key_len = FILL_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	const void *keys_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle;
+	unsigned fn, round, i, j;
+	uint64_t begin, time_taken;
+
+	handle = rte_hash_create(&params);
+	if (handle == NULL) {
+		printf("Error creating table\n");
+		return -1;
+	}
+	for (i = 0; i < SIG_CMP_KEYS; i++) {
+		if (rte_hash_add_key(handle, fill_keys[i]) < 0) {
+			printf("Failed to add key number %u\n", i);
+			rte_hash_free(handle);
+			return -1;
+		}
+	}
+
+	printf("\nBulk lookup results (in CPU cycles/lookup, key size %u)\n",
+		FILL_KEY_LEN);
+	printf("-----------------------------------\n");
+	printf("%-18s%-18s\n", "Signature compare", "Lookup_bulk");
+	for (fn = 0; fn < RTE_HASH_COMPARE_NUM; fn++) {
+		printf("%-18s", sig_cmp_names[fn]);
+		if (rte_hash_set_sig_cmp_fn(handle, fn) != 0) {
+			printf("%-18s\n", "n/a");
+			continue;
+		}
+
+		begin = rte_rdtsc();
+		for (round = 0; round < SIG_CMP_ROUNDS; round++) {
+			for (i = 0; i < SIG_CMP_KEYS;
+					i += RTE_HASH_LOOKUP_BULK_MAX) {
+				for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+					keys_burst[j] = fill_keys[i + j];
+				rte_hash_lookup_bulk(handle, keys_burst,
+						RTE_HASH_LOOKUP_BULK_MAX,
+						positions_burst);
+				for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+					if (positions_burst[j] < 0) {
+						printf("Key number %u not "
+							"found\n", i + j);
+						rte_hash_free(handle);
+						return -1;
+					}
+			}
+		}
+		time_taken = rte_rdtsc() - begin;
+		printf("%-18"PRIu64"\n",
+			time_taken / (SIG_CMP_KEYS * SIG_CMP_ROUNDS));
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /* Control operation of performance testing of fbk hash. */
 #define LOAD_FACTOR 0.667	/* How full to make the hash table. */
 #define TEST_SIZE 1000000	/* How many operations to time. */
@@ -650,6 +903,10 @@ test_hash_perf(void)
 		if (run_all_tbl_perf_tests(with_pushes) < 0)
 			return -1;
 	}
+	if (fill_table_perf_test() < 0)
+		return -1;
+	if (sig_cmp_perf_test() < 0)
+		return -1;
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
@@ -0,0 +1,316 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
+#include <rte_hash_crc.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+
+#include "test.h"
+
+/*
+ * Check condition and return an error if true. Assumes that "handle" is the
+ * name of the hash structure pointer to be freed.
+ */
+#define RETURN_IF_ERROR(cond, str, ...) do {                            \
+	if (cond) {                                                     \
+		printf("ERROR line %d: " str "\n", __LINE__,            \
+							##__VA_ARGS__);	\
+		if (handle)                                             \
+			rte_hash_free(handle);                          \
+		return -1;                                              \
+	}                                                               \
+} while (0)
+
+#define TOTAL_ENTRIES (8 * 1024)
+/* Keys always present in the table, looked up by the readers */
+#define NB_STABLE_KEYS (4 * 1024)
+/* Keys added and deleted by the writer, filling the table up */
+#define NB_EXTRA_KEYS (TOTAL_ENTRIES - NB_STABLE_KEYS)
+#define NB_WRITER_ROUNDS 20
+#define BURST_SIZE 64
+
+static struct {
+	struct rte_hash *h;
+	uint32_t keys[TOTAL_ENTRIES];
+	int32_t extra_pos[NB_EXTRA_KEYS];
+	volatile uint32_t reader_qs[RTE_MAX_LCORE];
+	volatile int writer_done;
+	rte_atomic64_t lookups;
+	rte_atomic64_t misses;
+} tbl_rwlf_test_params;
+
+static int
+test_rwlf_reader(__attribute__((unused)) void *arg)
+{
+	const void *key_ptrs[BURST_SIZE];
+	void *data[BURST_SIZE];
+	uint64_t hit_mask, lookups = 0, misses = 0;
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t i, j;
+	int ret;
+
+	while (!tbl_rwlf_test_params.writer_done) {
+		for (i = 0; i < NB_STABLE_KEYS; i += BURST_SIZE) {
+			for (j = 0; j < BURST_SIZE; j++)
+				key_ptrs[j] = &tbl_rwlf_test_params.keys[i + j];
+
+			ret = rte_hash_lookup_bulk_data(tbl_rwlf_test_params.h,
+					key_ptrs, BURST_SIZE, &hit_mask, data);
+			lookups += BURST_SIZE;
+			misses += BURST_SIZE - ret;
+			for (j = 0; j < BURST_SIZE; j++) {
+				if ((hit_mask & (1ULL << j)) &&
+						(uintptr_t)data[j] !=
+						tbl_rwlf_test_params.keys[i + j])
+					misses++;
+			}
+
+			ret = rte_hash_lookup_data(tbl_rwlf_test_params.h,
+					key_ptrs[0], &data[0]);
+			lookups++;
+			if (ret < 0 || (uintptr_t)data[0] !=
+					tbl_rwlf_test_params.keys[i])
+				misses++;
+
+			/* Nothing is referenced past this point */
+			tbl_rwlf_test_params.reader_qs[lcore_id]++;
+		}
+	}
+
+	rte_atomic64_add(&tbl_rwlf_test_params.lookups, lookups);
+	rte_atomic64_add(&tbl_rwlf_test_params.misses, misses);
+	return 0;
+}
+
+/* Wait until every reader went through a quiescent state */
+static void
+test_rwlf_wait_readers(void)
+{
+	uint32_t qs[RTE_MAX_LCORE];
+	unsigned int lcore_id;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id)
+		qs[lcore_id] = tbl_rwlf_test_params.reader_qs[lcore_id];
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		while (qs[lcore_id] ==
+				tbl_rwlf_test_params.reader_qs[lcore_id])
+			rte_pause();
+	}
+}
+
+static int
+test_rwlf_writer(void)
+{
+	struct rte_hash *h = tbl_rwlf_test_params.h;
+	uint32_t *extra_keys = &tbl_rwlf_test_params.keys[NB_STABLE_KEYS];
+	int32_t *pos = tbl_rwlf_test_params.extra_pos;
+	uint32_t round, i, nb_added, max_added = 0;
+	int32_t ret;
+
+	for (round = 0; round < NB_WRITER_ROUNDS; round++) {
+		/* Fill the table until the cuckoo search gives up */
+		for (nb_added = 0; nb_added < NB_EXTRA_KEYS; nb_added++) {
+			if (rte_hash_add_key_data(h, &extra_keys[nb_added],
+					(void *)(uintptr_t)
+					extra_keys[nb_added]) != 0)
+				break;
+		}
+		if (nb_added > max_added)
+			max_added = nb_added;
+
+		for (i = 0; i < nb_added; i++) {
+			pos[i] = rte_hash_del_key(h, &extra_keys[i]);
+			if (pos[i] < 0) {
+				printf("Failed to delete extra key %u\n", i);
+				return -1;
+			}
+		}
+
+		/* Recycle the key slots once no reader can use them */
+		test_rwlf_wait_readers();
+		for (i = 0; i < nb_added; i++) {
+			ret = rte_hash_free_key_with_position(h, pos[i]);
+			if (ret != 0) {
+				printf("Failed to free position %d\n", pos[i]);
+				return -1;
+			}
+		}
+	}
+
+	printf("Up to %u extra keys added per round, table load %u%%\n",
+		max_added, (NB_STABLE_KEYS + max_added) * 100 / TOTAL_ENTRIES);
+	return 0;
+}
+
+static int
+test_hash_readwrite_lf(uint8_t extra_flag)
+{
+	struct rte_hash_parameters hash_params = {
+		.name = "test_hash_rwlf",
+		.entries = TOTAL_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+				extra_flag,
+	};
+	struct rte_hash *handle;
+	uint64_t lookups, misses;
+	uint32_t i;
+	int ret;
+
+	handle = rte_hash_create(&hash_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	tbl_rwlf_test_params.h = handle;
+
+	for (i = 0; i < TOTAL_ENTRIES; i++)
+		tbl_rwlf_test_params.keys[i] = i + 1;
+
+	for (i = 0; i < NB_STABLE_KEYS; i++) {
+		ret = rte_hash_add_key_data(handle,
+				&tbl_rwlf_test_params.keys[i],
+				(void *)(uintptr_t)tbl_rwlf_test_params.keys[i]);
+		RETURN_IF_ERROR(ret != 0, "failed to add stable key %u", i);
+	}
+
+	tbl_rwlf_test_params.writer_done = 0;
+	rte_atomic64_init(&tbl_rwlf_test_params.lookups);
+	rte_atomic64_init(&tbl_rwlf_test_params.misses);
+
+	rte_eal_mp_remote_launch(test_rwlf_reader, NULL, SKIP_MASTER);
+	ret = test_rwlf_writer();
+	tbl_rwlf_test_params.writer_done = 1;
+	rte_eal_mp_wait_lcore();
+	RETURN_IF_ERROR(ret != 0, "writer failed");
+
+	lookups = rte_atomic64_read(&tbl_rwlf_test_params.lookups);
+	misses = rte_atomic64_read(&tbl_rwlf_test_params.misses);
+	printf("%"PRIu64" lookups of present keys, %"PRIu64" missed\n",
+		lookups, misses);
+	RETURN_IF_ERROR(misses != 0, "readers missed present keys");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * With lock-free readers, the key slot of a deleted entry must not be
+ * reused until it is explicitly freed.
+ */
+static int
+test_hash_readwrite_lf_free_pos(void)
+{
+	struct rte_hash_parameters hash_params = {
+		.name = "test_hash_rwlf_pos",
+		.entries = 8,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	struct rte_hash *handle;
+	uint32_t keys[9];
+	int32_t pos;
+	uint32_t i;
+
+	handle = rte_hash_create(&hash_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RTE_DIM(keys); i++)
+		keys[i] = i;
+
+	/* Single bucket table: fill it until no key slot is left */
+	for (i = 0; i < RTE_DIM(keys) - 1; i++)
+		if (rte_hash_add_key(handle, &keys[i]) < 0)
+			break;
+	RETURN_IF_ERROR(i == 0, "failed to add keys");
+
+	pos = rte_hash_del_key(handle, &keys[0]);
+	RETURN_IF_ERROR(pos < 0, "failed to delete key");
+	RETURN_IF_ERROR(rte_hash_lookup(handle, &keys[0]) != -ENOENT,
+			"deleted key still found");
+	RETURN_IF_ERROR(rte_hash_add_key(handle, &keys[8]) != -ENOSPC,
+			"key slot reused before being freed");
+
+	RETURN_IF_ERROR(rte_hash_free_key_with_position(handle, 8) != -EINVAL,
+			"out of range position freed");
+	RETURN_IF_ERROR(rte_hash_free_key_with_position(handle, pos) != 0,
+			"failed to free position %d", pos);
+	RETURN_IF_ERROR(rte_hash_add_key(handle, &keys[8]) != pos,
+			"freed key slot not reused");
+
+	rte_hash_free(handle);
+
+	/* Lock-free readers only support a single writer */
+	hash_params.name = "test_hash_rwlf_mw";
+	hash_params.extra_flag |= RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD;
+	handle = rte_hash_create(&hash_params);
+	if (handle != NULL)
+		rte_hash_free(handle);
+	RETURN_IF_ERROR(handle != NULL || rte_errno != EINVAL,
+			"lock-free readers with multiple writers accepted");
+
+	return 0;
+}
+
+static int
+test_hash_readwrite_lf_main(void)
+{
+	if (test_hash_readwrite_lf_free_pos() < 0)
+		return -1;
+
+	if (rte_lcore_count() == 1) {
+		printf("More than one lcore is required "
+			"to do read-write lock-free test\n");
+		return 0;
+	}
+
+	printf("Test lock-free readers\n");
+	if (test_hash_readwrite_lf(0) < 0)
+		return -1;
+
+	printf("Test lock-free readers with extendable buckets\n");
+	return test_hash_readwrite_lf(RTE_HASH_EXTRA_FLAGS_EXT_TABLE);
+}
+
+REGISTER_TEST_COMMAND(hash_readwrite_lf_autotest, test_hash_readwrite_lf_main);
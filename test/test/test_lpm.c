@@ -37,6 +37,7 @@
 
 #include <rte_ip.h>
 #include <rte_lpm.h>
+#include <rte_random.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -69,6 +70,8 @@ static int32_t test15(void);
 static int32_t test16(void);
 static int32_t test17(void);
 static int32_t test18(void);
+static int32_t test19(void);
+static int32_t test20(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -90,7 +93,9 @@ rte_lpm_test tests[] = {
 	test15,
 	test16,
 	test17,
-	test18
+	test18,
+	test19,
+	test20
 };
 
 #define NUM_LPM_TESTS (sizeof(tests)/sizeof(tests[0]))
@@ -1295,6 +1300,146 @@ test18(void)
 	return PASS;
 }
 
+/*
+ * With RTE_LPM_DEFER_TBL8_FREE, a tbl8 group freed by a delete must not
+ * be reused before every registered reader has reported a quiescent state.
+ *  - step 1: add a rule with depth=28, which takes the only tbl8 group
+ *  - step 2: delete it, the group is held back for the reader
+ *  - step 3: adding a rule with depth=28 in another /24 fails
+ *  - step 4: once the reader is quiescent the same rule can be added
+ *  - step 5: an unregistered reader does not hold groups back
+ */
+int32_t
+test19(void)
+{
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	uint32_t ip1 = IPv4(192, 168, 100, 100);
+	uint32_t ip2 = IPv4(192, 168, 200, 100);
+	uint32_t next_hop_return = 0;
+	uint8_t depth = 28;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 1;
+	config.flags = RTE_LPM_DEFER_TBL8_FREE;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm_reader_register(lpm,
+			RTE_LPM_MAX_READERS) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_reader_register(lpm, 0) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm_add(lpm, ip1, depth, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_delete(lpm, ip1, depth) == 0);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, ip1, &next_hop_return) == -ENOENT);
+
+	TEST_LPM_ASSERT(rte_lpm_add(lpm, ip2, depth, 2) == -ENOSPC);
+
+	rte_lpm_quiescent(lpm, 0);
+
+	TEST_LPM_ASSERT(rte_lpm_add(lpm, ip2, depth, 2) == 0);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, ip2, &next_hop_return) == 0);
+	TEST_LPM_ASSERT(next_hop_return == 2);
+
+	TEST_LPM_ASSERT(rte_lpm_delete(lpm, ip2, depth) == 0);
+	TEST_LPM_ASSERT(rte_lpm_add(lpm, ip1, depth, 1) == -ENOSPC);
+
+	TEST_LPM_ASSERT(rte_lpm_reader_unregister(lpm, 0) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm_add(lpm, ip1, depth, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, ip1, &next_hop_return) == 0);
+	TEST_LPM_ASSERT(next_hop_return == 1);
+
+	rte_lpm_free(lpm);
+
+	/* Readers can only be registered when frees are deferred. */
+	config.flags = 0;
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	TEST_LPM_ASSERT(rte_lpm_reader_register(lpm, 0) == -EINVAL);
+	rte_lpm_quiescent(lpm, 0);
+	rte_lpm_free(lpm);
+
+	return PASS;
+}
+
+/*
+ * Vector lookups must return the same results as rte_lpm_lookup().
+ *  - step 1: add random rules, half of them deeper than 24
+ *  - step 2: look up addresses within the rules and random addresses with
+ *    rte_lpm_lookupx8(), rte_lpm_lookupx16() and rte_lpm_lookup_bulk()
+ *  - step 3: check them, including lookup misses and partial last block
+ */
+int32_t
+test20(void)
+{
+#define TEST20_NUM_IPS 1024
+#define TEST20_NUM_RULES 512
+#define TEST20_DEFV 0xdeadbe
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	uint32_t ips[TEST20_NUM_IPS];
+	uint32_t hops[TEST20_NUM_IPS];
+	uint32_t ip, next_hop_return;
+	uint8_t depth;
+	unsigned int i, j;
+	int ret;
+
+	config.max_rules = TEST20_NUM_RULES;
+	config.number_tbl8s = TEST20_NUM_RULES;
+	config.flags = 0;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < TEST20_NUM_RULES; i++) {
+		ip = (uint32_t)rte_rand();
+		depth = (i & 1) ? 25 + rte_rand() % 8 : 8 + rte_rand() % 17;
+		TEST_LPM_ASSERT(rte_lpm_add(lpm, ip, depth, i + 1) == 0);
+		ips[i] = ip;
+	}
+	for (; i < TEST20_NUM_IPS; i++)
+		ips[i] = (uint32_t)rte_rand();
+
+	for (i = 0; i < TEST20_NUM_IPS; i += 8) {
+		rte_lpm_lookupx8(lpm, &ips[i], &hops[i], TEST20_DEFV);
+		for (j = i; j < i + 8; j++) {
+			ret = rte_lpm_lookup(lpm, ips[j], &next_hop_return);
+			TEST_LPM_ASSERT(hops[j] == (ret == 0 ?
+					next_hop_return : TEST20_DEFV));
+		}
+	}
+
+	for (i = 0; i < TEST20_NUM_IPS; i += 16) {
+		rte_lpm_lookupx16(lpm, &ips[i], &hops[i], TEST20_DEFV);
+		for (j = i; j < i + 16; j++) {
+			ret = rte_lpm_lookup(lpm, ips[j], &next_hop_return);
+			TEST_LPM_ASSERT(hops[j] == (ret == 0 ?
+					next_hop_return : TEST20_DEFV));
+		}
+	}
+
+	/* Not a multiple of the vector width. */
+	TEST_LPM_ASSERT(rte_lpm_lookup_bulk(lpm, ips, hops,
+			TEST20_NUM_IPS - 5) == 0);
+	for (i = 0; i < TEST20_NUM_IPS - 5; i++) {
+		ret = rte_lpm_lookup(lpm, ips[i], &next_hop_return);
+		if (ret == 0) {
+			TEST_LPM_ASSERT(hops[i] & RTE_LPM_LOOKUP_SUCCESS);
+			TEST_LPM_ASSERT((hops[i] & 0x00FFFFFF) ==
+					next_hop_return);
+		} else
+			TEST_LPM_ASSERT(!(hops[i] & RTE_LPM_LOOKUP_SUCCESS));
+	}
+
+	rte_lpm_free(lpm);
+#undef TEST20_NUM_IPS
+#undef TEST20_NUM_RULES
+#undef TEST20_DEFV
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -80,6 +80,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -112,6 +113,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define NUM_LPM6_TESTS                (sizeof(tests6)/sizeof(tests6[0]))
@@ -1800,6 +1802,73 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Add nested rules on the same prefix, delete them in a mixed order and
+ * check that lookups fall back to the longest remaining rule. Once all of
+ * them are gone the tbl8s must be recycled, so a table with only 16 tbl8s
+ * can take another /128 rule.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t ip_out[] = {0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t ip_other[] = {0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint32_t next_hop_return = 0;
+	int32_t status = 0;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 16;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm6_add(lpm, ip, 16, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_add(lpm, ip, 32, 2) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_add(lpm, ip, 48, 3) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_add(lpm, ip, 128, 4) == 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 4));
+	status = rte_lpm6_lookup(lpm, ip_out, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 2));
+
+	TEST_LPM_ASSERT(rte_lpm6_delete(lpm, ip, 128) == 0);
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 3));
+
+	TEST_LPM_ASSERT(rte_lpm6_delete(lpm, ip, 32) == 0);
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 3));
+	status = rte_lpm6_lookup(lpm, ip_out, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 1));
+
+	TEST_LPM_ASSERT(rte_lpm6_delete(lpm, ip, 48) == 0);
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 1));
+
+	TEST_LPM_ASSERT(rte_lpm6_delete(lpm, ip, 16) == 0);
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm6_delete(lpm, ip, 16) == -ENOENT);
+
+	TEST_LPM_ASSERT(rte_lpm6_add(lpm, ip_other, 128, 5) == 0);
+	status = rte_lpm6_lookup(lpm, ip_other, &next_hop_return);
+	TEST_LPM_ASSERT((status == 0) && (next_hop_return == 5));
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == -ENOENT);
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
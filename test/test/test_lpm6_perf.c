@@ -84,7 +84,7 @@ test_lpm6_perf(void)
 {
 	struct rte_lpm6 *lpm = NULL;
 	struct rte_lpm6_config config;
-	uint64_t begin, total_time;
+	uint64_t begin, total_time, add_time, del_time;
 	unsigned i, j;
 	uint32_t next_hop_add = 0xAA, next_hop_return = 0;
 	int status = 0;
@@ -178,11 +178,39 @@ test_lpm6_perf(void)
 				large_route_table[i].depth);
 	}
 
-	total_time += rte_rdtsc() - begin;
+	total_time = rte_rdtsc() - begin;
 
 	printf("Average LPM Delete: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
 
+	/*
+	 * Measure add and delete rates on a populated table, withdrawing
+	 * and announcing each route again in turn.
+	 */
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++)
+		rte_lpm6_add(lpm, large_route_table[i].ip,
+				large_route_table[i].depth, next_hop_add);
+
+	del_time = 0;
+	add_time = 0;
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++) {
+		begin = rte_rdtsc();
+		rte_lpm6_delete(lpm, large_route_table[i].ip,
+				large_route_table[i].depth);
+		del_time += rte_rdtsc() - begin;
+
+		begin = rte_rdtsc();
+		rte_lpm6_add(lpm, large_route_table[i].ip,
+				large_route_table[i].depth, next_hop_add);
+		add_time += rte_rdtsc() - begin;
+	}
+
+	printf("LPM Delete rate (populated table): %.0f routes/s\n",
+			(double)NUM_ROUTE_ENTRIES * rte_get_tsc_hz() / del_time);
+	printf("LPM Add rate (populated table): %.0f routes/s\n",
+			(double)NUM_ROUTE_ENTRIES * rte_get_tsc_hz() / add_time);
+
 	rte_lpm6_delete_all(lpm);
 	rte_lpm6_free(lpm);
 
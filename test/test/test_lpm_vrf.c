@@ -0,0 +1,464 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <rte_memory.h>
+#include <rte_random.h>
+#include <rte_errno.h>
+#include <rte_ip.h>
+#include <rte_lpm_vrf.h>
+
+#include "test.h"
+
+#define TEST_LPM_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+typedef int32_t (*rte_lpm_vrf_test)(void);
+
+static int32_t test0(void);
+static int32_t test1(void);
+static int32_t test2(void);
+static int32_t test3(void);
+static int32_t test4(void);
+
+static rte_lpm_vrf_test tests_vrf[] = {
+/* Test Cases */
+	test0,
+	test1,
+	test2,
+	test3,
+	test4
+};
+
+#define NUM_LPM_VRF_TESTS (sizeof(tests_vrf)/sizeof(tests_vrf[0]))
+#define MAX_VRFS 16
+#define MAX_RULES 1024
+#define NUMBER_TBL8S 256
+#define PASS 0
+
+static void
+vrf_conf_init(struct rte_lpm_vrf_config *config)
+{
+	config->max_vrfs = MAX_VRFS;
+	config->max_rules = MAX_RULES;
+	config->number_tbl8s = NUMBER_TBL8S;
+	config->flags = 0;
+}
+
+/*
+ * Check that rte_lpm_vrf_create fails gracefully for incorrect user input
+ * arguments, and that a table can be found by name.
+ */
+int32_t
+test0(void)
+{
+	struct rte_lpm_vrf *lpm = NULL, *lpm2;
+	struct rte_lpm_vrf_config config;
+
+	vrf_conf_init(&config);
+
+	/* rte_lpm_vrf_create: lpm name == NULL */
+	lpm = rte_lpm_vrf_create(NULL, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	/* rte_lpm_vrf_create: config == NULL */
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, NULL);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	/* rte_lpm_vrf_create: socket_id < -1 */
+	lpm = rte_lpm_vrf_create(__func__, -2, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	/* rte_lpm_vrf_create: max_vrfs = 0 and too many VRFs */
+	config.max_vrfs = 0;
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+	config.max_vrfs = RTE_LPM_VRF_MAX_VRFS + 1;
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+	config.max_vrfs = MAX_VRFS;
+
+	/* rte_lpm_vrf_create: max_rules = 0 */
+	config.max_rules = 0;
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+	config.max_rules = MAX_RULES;
+
+	/* rte_lpm_vrf_create: too many tbl8s */
+	config.number_tbl8s = RTE_LPM_VRF_MAX_TBL8_NUM_GROUPS + 1;
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+	config.number_tbl8s = NUMBER_TBL8S;
+
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* rte_lpm_vrf_create: name already in use */
+	lpm2 = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm2 == NULL && rte_errno == EEXIST);
+
+	lpm2 = rte_lpm_vrf_find_existing(__func__);
+	TEST_LPM_ASSERT(lpm2 == lpm);
+
+	rte_lpm_vrf_free(lpm);
+
+	lpm2 = rte_lpm_vrf_find_existing(__func__);
+	TEST_LPM_ASSERT(lpm2 == NULL && rte_errno == ENOENT);
+
+	/* Freeing NULL is a no-op. */
+	rte_lpm_vrf_free(NULL);
+
+	return PASS;
+}
+
+/*
+ * Check that add, delete and rule lookups fail gracefully for incorrect
+ * user input arguments.
+ */
+int32_t
+test1(void)
+{
+	struct rte_lpm_vrf *lpm = NULL;
+	struct rte_lpm_vrf_config config;
+	uint32_t ip = IPv4(10, 0, 0, 0), next_hop;
+
+	vrf_conf_init(&config);
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(NULL, 0, ip, 8, 1) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, MAX_VRFS, ip, 8, 1) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 0, ip, 0, 1) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 0, ip,
+			RTE_LPM_MAX_DEPTH + 1, 1) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 0, ip, 8, 1 << 24) == -EINVAL);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, MAX_VRFS - 1, ip, 8,
+			(1 << 24) - 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, MAX_VRFS - 1, ip,
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == (1 << 24) - 1);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_is_rule_present(NULL, 0, ip, 8,
+			&next_hop) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_is_rule_present(lpm, 0, ip, 8,
+			NULL) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_is_rule_present(lpm, MAX_VRFS, ip, 8,
+			&next_hop) == -EINVAL);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(NULL, 0, ip, 8) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, MAX_VRFS, ip, 8) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, 0, ip, 0) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, 0, ip, 8) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, MAX_VRFS - 1, ip, 8) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete_all(NULL, 0) == -EINVAL);
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete_all(lpm, MAX_VRFS) == -EINVAL);
+
+	rte_lpm_vrf_free(lpm);
+
+	return PASS;
+}
+
+/*
+ * Add nested routes ending in the tbl16 and in both tbl8 levels, and the
+ * same prefixes with other next hops in another VRF. Check that each VRF
+ * only sees its own routes, and that deleted routes fall back to the
+ * covering route of their VRF.
+ */
+int32_t
+test2(void)
+{
+	struct rte_lpm_vrf *lpm = NULL;
+	struct rte_lpm_vrf_config config;
+	static const uint8_t depths[] = {8, 16, 20, 24, 28, 32};
+	const uint32_t ip = IPv4(192, 168, 100, 200);
+	uint32_t ips[RTE_DIM(depths)], vrf_ids[RTE_DIM(depths)];
+	uint32_t next_hops[RTE_DIM(depths)], next_hop;
+	unsigned int i, j, vrf, n = RTE_DIM(depths);
+
+	vrf_conf_init(&config);
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* ips[i] is covered by the routes of depth up to depths[i] only. */
+	for (i = 0; i < n; i++)
+		ips[i] = (i + 1 < n) ? ip ^ (1U << (32 - depths[i + 1])) : ip;
+
+	for (i = 0; i < n; i++) {
+		TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 3, ip, depths[i],
+				100 + i) == 0);
+		TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 5, ip, depths[i],
+				200 + i) == 0);
+	}
+
+	/* VRF 4 has no route. */
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 4, ip, &next_hop) == -ENOENT);
+
+	for (vrf = 3; vrf <= 5; vrf += 2) {
+		for (i = 0; i < n; i++) {
+			TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, vrf, ips[i],
+					&next_hop) == 0);
+			TEST_LPM_ASSERT(next_hop == (vrf == 3 ? 100 : 200) + i);
+		}
+	}
+
+	/* Delete the routes of VRF 3 from the longest, one at a time. */
+	for (i = n - 1; i > 0; i--) {
+		TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, 3, ip,
+				depths[i]) == 0);
+		for (j = 0; j < n; j++) {
+			TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 3, ips[j],
+					&next_hop) == 0);
+			TEST_LPM_ASSERT(next_hop == 100 + RTE_MIN(j, i - 1));
+		}
+	}
+
+	/* A mixed burst sees the routes of the VRF of each address. */
+	for (i = 0; i < n; i++)
+		vrf_ids[i] = (i % 2) ? 5 : 3;
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup_bulk(lpm, vrf_ids, ips, next_hops,
+			n) == 0);
+	for (i = 0; i < n; i++) {
+		TEST_LPM_ASSERT(next_hops[i] & RTE_LPM_LOOKUP_SUCCESS);
+		TEST_LPM_ASSERT((next_hops[i] & 0x00FFFFFF) ==
+				((i % 2) ? 200 + i : 100));
+	}
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, 3, ip, depths[0]) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 3, ip, &next_hop) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 5, ip, &next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == 200 + n - 1);
+
+	rte_lpm_vrf_free(lpm);
+
+	return PASS;
+}
+
+/*
+ * Check that the VRFs share the tbl8 pool: groups used by one VRF are not
+ * available to the others until its routes are deleted.
+ */
+int32_t
+test3(void)
+{
+	struct rte_lpm_vrf *lpm = NULL;
+	struct rte_lpm_vrf_config config;
+	uint32_t next_hop;
+
+	/* A /32 needs two tbl8 groups. */
+	vrf_conf_init(&config);
+	config.number_tbl8s = 2;
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 1, IPv4(10, 1, 1, 1), 32,
+			1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 1, IPv4(10, 1, 1, 0), 24,
+			2) == 0);
+
+	/* No group left for another VRF, nothing must change. */
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 2, IPv4(10, 1, 1, 0), 24,
+			3) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm_vrf_is_rule_present(lpm, 2, IPv4(10, 1, 1, 0),
+			24, &next_hop) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 2, IPv4(10, 1, 1, 1),
+			&next_hop) == -ENOENT);
+
+	/* Routes up to /16 only use the tbl16 of their VRF. */
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 2, IPv4(10, 1, 0, 0), 16,
+			4) == 0);
+
+	/* Once the /32 is gone, the /24 fits in a single group. */
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm, 1, IPv4(10, 1, 1, 1),
+			32) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 1, IPv4(10, 1, 1, 1),
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == 2);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 2, IPv4(10, 1, 1, 0), 24,
+			3) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 2, IPv4(10, 1, 1, 1), 32,
+			5) == -ENOSPC);
+
+	/* Emptying VRF 1 gives its group back. */
+	TEST_LPM_ASSERT(rte_lpm_vrf_delete_all(lpm, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_is_rule_present(lpm, 1, IPv4(10, 1, 1, 0),
+			24, &next_hop) == 0);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 1, IPv4(10, 1, 1, 1),
+			&next_hop) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm_vrf_add(lpm, 2, IPv4(10, 1, 1, 1), 32,
+			5) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 2, IPv4(10, 1, 1, 1),
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == 5);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 2, IPv4(10, 1, 1, 2),
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == 3);
+	TEST_LPM_ASSERT(rte_lpm_vrf_lookup(lpm, 2, IPv4(10, 1, 2, 2),
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == 4);
+
+	rte_lpm_vrf_free(lpm);
+
+	return PASS;
+}
+
+/*
+ * Add and delete random routes in random VRFs, checking mixed-VRF bulk
+ * lookups of random addresses against a linear search of the routes.
+ */
+#define RND_VRFS 4
+#define RND_ROUTES 512
+#define RND_IPS 256
+
+int32_t
+test4(void)
+{
+	struct rte_lpm_vrf *lpm = NULL;
+	struct rte_lpm_vrf_config config;
+	struct {
+		uint32_t vrf_id;
+		uint32_t ip;
+		uint8_t depth;
+		uint32_t next_hop;
+	} routes[RND_ROUTES];
+	uint32_t vrf_ids[RND_IPS], ips[RND_IPS], next_hops[RND_IPS];
+	uint32_t expected, next_hop;
+	unsigned int j, k, n, step;
+	int best, ret;
+
+	vrf_conf_init(&config);
+	lpm = rte_lpm_vrf_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	n = 0;
+	for (step = 0; step < 4 * RND_ROUTES; step++) {
+		if (n == RND_ROUTES || (n > 0 && (rte_rand() % 3) == 0)) {
+			/* Delete a random route. */
+			j = rte_rand() % n;
+			TEST_LPM_ASSERT(rte_lpm_vrf_delete(lpm,
+					routes[j].vrf_id, routes[j].ip,
+					routes[j].depth) == 0);
+			routes[j] = routes[--n];
+		} else {
+			/* Routes within 10.0.0.0/12, so that they nest. */
+			routes[n].vrf_id = rte_rand() % RND_VRFS;
+			routes[n].depth = 12 + rte_rand() % 21;
+			routes[n].ip = (IPv4(10, 0, 0, 0) |
+					((uint32_t)rte_rand() & 0x000FFFFF)) &
+					(uint32_t)(UINT64_MAX <<
+					(32 - routes[n].depth));
+			routes[n].next_hop = rte_rand() % 1000;
+			for (j = 0; j < n; j++)
+				if (routes[j].vrf_id == routes[n].vrf_id &&
+						routes[j].ip == routes[n].ip &&
+						routes[j].depth ==
+						routes[n].depth)
+					break;
+			ret = rte_lpm_vrf_add(lpm, routes[n].vrf_id,
+					routes[n].ip, routes[n].depth,
+					routes[n].next_hop);
+			if (ret == -ENOSPC)
+				continue;
+			TEST_LPM_ASSERT(ret == 0);
+			if (j < n)
+				routes[j].next_hop = routes[n].next_hop;
+			else
+				n++;
+		}
+
+		for (k = 0; k < RND_IPS; k++) {
+			vrf_ids[k] = rte_rand() % RND_VRFS;
+			ips[k] = IPv4(10, 0, 0, 0) |
+					((uint32_t)rte_rand() & 0x000FFFFF);
+		}
+		TEST_LPM_ASSERT(rte_lpm_vrf_lookup_bulk(lpm, vrf_ids, ips,
+				next_hops, RND_IPS) == 0);
+
+		for (k = 0; k < RND_IPS; k++) {
+			best = -1;
+			for (j = 0; j < n; j++) {
+				if (routes[j].vrf_id == vrf_ids[k] &&
+						((ips[k] ^ routes[j].ip) >>
+						(32 - routes[j].depth)) == 0 &&
+						(best < 0 || routes[j].depth >
+						routes[best].depth))
+					best = j;
+			}
+			expected = (best < 0) ? 0 : (routes[best].next_hop |
+					RTE_LPM_LOOKUP_SUCCESS);
+			TEST_LPM_ASSERT(next_hops[k] == expected);
+			ret = rte_lpm_vrf_lookup(lpm, vrf_ids[k], ips[k],
+					&next_hop);
+			TEST_LPM_ASSERT(best < 0 ? ret == -ENOENT :
+					(ret == 0 &&
+					next_hop == routes[best].next_hop));
+		}
+	}
+
+	rte_lpm_vrf_free(lpm);
+
+	return PASS;
+}
+
+/*
+ * Do all unit tests.
+ */
+
+static int
+test_lpm_vrf(void)
+{
+	unsigned i;
+	int status, global_status = 0;
+
+	for (i = 0; i < NUM_LPM_VRF_TESTS; i++) {
+		status = tests_vrf[i]();
+		if (status < 0) {
+			printf("ERROR: LPM VRF Test %u: FAIL\n", i);
+			global_status = status;
+		}
+	}
+
+	return global_status;
+}
+
+REGISTER_TEST_COMMAND(lpm_vrf_autotest, test_lpm_vrf);
@@ -63,6 +63,7 @@
 
 #define MBUF_DATA_SIZE          2048
 #define NB_MBUF                 128
+#define NB_MBUF_PARALLEL        8192
 #define MBUF_TEST_DATA_LEN      1464
 #define MBUF_TEST_DATA_LEN2     50
 #define MBUF_TEST_HDR1_LEN      20
@@ -579,6 +580,50 @@ test_pktmbuf_pool(void)
 	return ret;
 }
 
+/* count the mbufs that rte_pktmbuf_init() did not initialize properly */
+static void
+check_pktmbuf_init(struct rte_mempool *mp, void *opaque, void *obj,
+	__attribute__((unused)) unsigned i)
+{
+	struct rte_mbuf *m = obj;
+	unsigned *n_bad = opaque;
+
+	if (m->pool != mp || m->priv_size != MBUF2_PRIV_SIZE ||
+			m->buf_len != MBUF_DATA_SIZE ||
+			m->buf_addr != (char *)m + sizeof(*m) + MBUF2_PRIV_SIZE ||
+			rte_mbuf_refcnt_read(m) != 1)
+		(*n_bad)++;
+}
+
+/*
+ * test that a pool created with rte_pktmbuf_pool_create_parallel() has all
+ * its mbufs initialized, the pool being big enough to split the work
+ */
+static int
+test_pktmbuf_pool_parallel(void)
+{
+	struct rte_mempool *mp;
+	unsigned n_bad = 0;
+
+	mp = rte_pktmbuf_pool_create_parallel("test_pktmbuf_pool_par",
+		NB_MBUF_PARALLEL, 32, MBUF2_PRIV_SIZE, MBUF_DATA_SIZE,
+		SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("cannot allocate mbuf pool\n");
+		return -1;
+	}
+
+	if (rte_mempool_obj_iter(mp, check_pktmbuf_init, &n_bad) !=
+			NB_MBUF_PARALLEL || n_bad != 0) {
+		printf("%u mbufs not initialized\n", n_bad);
+		rte_mempool_free(mp);
+		return -1;
+	}
+
+	rte_mempool_free(mp);
+	return 0;
+}
+
 /*
  * test that the pointer to the data on a packet mbuf is set properly
  */
@@ -1089,6 +1134,12 @@ test_mbuf(void)
 		return -1;
 	}
 
+	/* test a pool whose mbufs are initialized on several lcores */
+	if (test_pktmbuf_pool_parallel() < 0) {
+		printf("test_pktmbuf_pool_parallel() failed\n");
+		return -1;
+	}
+
 	/* test that the pointer to the data on a packet mbuf is set properly */
 	if (test_pktmbuf_pool_ptr() < 0) {
 		printf("test_pktmbuf_pool_ptr() failed\n");
@@ -0,0 +1,601 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* This test is for membership library's simple feature test */
+
+#include <string.h>
+
+#include <rte_memcpy.h>
+#include <rte_malloc.h>
+#include <rte_member.h>
+#include <rte_byteorder.h>
+#include <rte_random.h>
+#include <rte_debug.h>
+#include <rte_ip.h>
+
+#include "test.h"
+
+static struct rte_member_setsum *setsum_ht;
+static struct rte_member_setsum *setsum_cache;
+static struct rte_member_setsum *setsum_vbf;
+
+/* 5-tuple key type */
+struct flow_key {
+	uint32_t ip_src;
+	uint32_t ip_dst;
+	uint16_t port_src;
+	uint16_t port_dst;
+	uint8_t proto;
+} __attribute__((packed));
+
+/* Set ids of the keys, counted from 1 */
+static member_set_t test_set[5] = {1, 2, 3, 4, 5};
+
+/* Keys used by unit test functions */
+static struct flow_key keys[5] = {
+	{
+		.ip_src = IPv4(0x03, 0x02, 0x01, 0x00),
+		.ip_dst = IPv4(0x07, 0x06, 0x05, 0x04),
+		.port_src = 0x0908,
+		.port_dst = 0x0b0a,
+		.proto = 0x0c,
+	},
+	{
+		.ip_src = IPv4(0x13, 0x12, 0x11, 0x10),
+		.ip_dst = IPv4(0x17, 0x16, 0x15, 0x14),
+		.port_src = 0x1918,
+		.port_dst = 0x1b1a,
+		.proto = 0x1c,
+	},
+	{
+		.ip_src = IPv4(0x23, 0x22, 0x21, 0x20),
+		.ip_dst = IPv4(0x27, 0x26, 0x25, 0x24),
+		.port_src = 0x2928,
+		.port_dst = 0x2b2a,
+		.proto = 0x2c,
+	},
+	{
+		.ip_src = IPv4(0x33, 0x32, 0x31, 0x30),
+		.ip_dst = IPv4(0x37, 0x36, 0x35, 0x34),
+		.port_src = 0x3938,
+		.port_dst = 0x3b3a,
+		.proto = 0x3c,
+	},
+	{
+		.ip_src = IPv4(0x43, 0x42, 0x41, 0x40),
+		.ip_dst = IPv4(0x47, 0x46, 0x45, 0x44),
+		.port_src = 0x4948,
+		.port_dst = 0x4b4a,
+		.proto = 0x4c,
+	}
+};
+
+#define NUM_SAMPLES 100000
+#define MAX_ENTRIES (1 << 16)
+#define NUM_SETS 16
+#define FALSE_POSITIVE_RATE 0.03
+#define MAX_MATCH 32
+
+/* Random keys for the utilization and false positive tests */
+static uint8_t generated_keys[NUM_SAMPLES][sizeof(struct flow_key)];
+
+static struct rte_member_parameters params = {
+		.num_keys = MAX_ENTRIES,	/* Total hash table entries. */
+		.key_len = sizeof(struct flow_key),	/* Length of hash key. */
+		/* num_set and false_positive_rate only relevant to vBF */
+		.num_set = NUM_SETS,
+		.false_positive_rate = FALSE_POSITIVE_RATE,
+		.prim_hash_seed = 1,
+		.sec_hash_seed = 11,
+		.socket_id = 0			/* NUMA Socket ID for memory. */
+};
+
+/* Create the three types of set summary used by the tests */
+static int
+test_member_create(void)
+{
+	params.name = "test_member_ht";
+	params.type = RTE_MEMBER_TYPE_HT;
+	params.is_cache = 0;
+	setsum_ht = rte_member_create(&params);
+
+	params.name = "test_member_cache";
+	params.is_cache = 1;
+	setsum_cache = rte_member_create(&params);
+
+	params.name = "test_member_vbf";
+	params.type = RTE_MEMBER_TYPE_VBF;
+	params.is_cache = 0;
+	setsum_vbf = rte_member_create(&params);
+
+	if (setsum_ht == NULL || setsum_cache == NULL || setsum_vbf == NULL) {
+		printf("Creation of set summaries failed\n");
+		return -1;
+	}
+	printf("Creation of set summaries success\n");
+	return 0;
+}
+
+static void
+test_member_free(void)
+{
+	rte_member_free(setsum_ht);
+	rte_member_free(setsum_cache);
+	rte_member_free(setsum_vbf);
+	setsum_ht = NULL;
+	setsum_cache = NULL;
+	setsum_vbf = NULL;
+}
+
+static int
+test_member_create_bad_param(void)
+{
+	struct rte_member_setsum *setsum;
+	struct rte_member_parameters bad_params;
+
+	printf("Expected error section begin...\n");
+
+	bad_params = params;
+	bad_params.name = "bad_param1";
+	bad_params.type = RTE_MEMBER_TYPE_HT;
+	bad_params.num_keys = 0;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation with zero keys should have failed");
+
+	bad_params = params;
+	bad_params.name = "bad_param2";
+	bad_params.type = RTE_MEMBER_TYPE_HT;
+	bad_params.key_len = 0;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation with zero key length should have failed");
+
+	bad_params = params;
+	bad_params.name = "bad_param3";
+	bad_params.type = RTE_MEMBER_TYPE_VBF;
+	bad_params.num_set = RTE_MEMBER_MAX_BF + 1;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation of vBF with too many sets should have failed");
+
+	bad_params = params;
+	bad_params.name = "bad_param4";
+	bad_params.type = RTE_MEMBER_TYPE_VBF;
+	bad_params.false_positive_rate = 0;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation of vBF with a zero false positive rate should "
+		"have failed");
+
+	bad_params = params;
+	bad_params.name = "bad_param5";
+	bad_params.type = RTE_MEMBER_NUM_TYPE;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation with an invalid type should have failed");
+
+	/* Creation with the name of an existing set summary */
+	bad_params = params;
+	bad_params.name = "test_member_ht";
+	bad_params.type = RTE_MEMBER_TYPE_HT;
+	setsum = rte_member_create(&bad_params);
+	TEST_ASSERT(setsum == NULL,
+		"Creation with an existing name should have failed");
+
+	printf("Expected error section end...\n");
+	return 0;
+}
+
+static int
+test_member_find_existing(void)
+{
+	struct rte_member_setsum *setsum;
+
+	setsum = rte_member_find_existing("test_member_ht");
+	TEST_ASSERT(setsum == setsum_ht, "Could not find the hash table");
+
+	setsum = rte_member_find_existing("test_member_vbf");
+	TEST_ASSERT(setsum == setsum_vbf, "Could not find the vBF");
+
+	setsum = rte_member_find_existing("test_member_none");
+	TEST_ASSERT(setsum == NULL, "Found a set summary never created");
+
+	printf("Test find existing success\n");
+	return 0;
+}
+
+/* Check that each of the five keys is found in its own set */
+static int
+check_five_keys(struct rte_member_setsum *setsum)
+{
+	unsigned int i;
+	int ret;
+	member_set_t set_id;
+	member_set_t set_ids[RTE_DIM(keys)];
+	const void *key_array[RTE_DIM(keys)];
+
+	for (i = 0; i < RTE_DIM(keys); i++) {
+		ret = rte_member_lookup(setsum, &keys[i], &set_id);
+		TEST_ASSERT(ret == 1 && set_id == test_set[i],
+			"%s: key %u found in set %u instead of %u",
+			setsum->name, i, set_id, test_set[i]);
+		key_array[i] = &keys[i];
+	}
+
+	ret = rte_member_lookup_bulk(setsum, key_array, RTE_DIM(keys),
+			set_ids);
+	TEST_ASSERT(ret == (int)RTE_DIM(keys),
+		"%s: bulk lookup found %d keys", setsum->name, ret);
+	for (i = 0; i < RTE_DIM(keys); i++)
+		TEST_ASSERT(set_ids[i] == test_set[i],
+			"%s: bulk lookup found key %u in set %u instead of %u",
+			setsum->name, i, set_ids[i], test_set[i]);
+
+	return 0;
+}
+
+/* Check that none of the five keys is found */
+static int
+check_no_keys(struct rte_member_setsum *setsum)
+{
+	unsigned int i;
+	int ret;
+	member_set_t set_id;
+	member_set_t set_ids[RTE_DIM(keys)];
+	const void *key_array[RTE_DIM(keys)];
+
+	for (i = 0; i < RTE_DIM(keys); i++) {
+		ret = rte_member_lookup(setsum, &keys[i], &set_id);
+		TEST_ASSERT(ret == 0 && set_id == RTE_MEMBER_NO_MATCH,
+			"%s: key %u still found in set %u",
+			setsum->name, i, set_id);
+		key_array[i] = &keys[i];
+	}
+
+	ret = rte_member_lookup_bulk(setsum, key_array, RTE_DIM(keys),
+			set_ids);
+	TEST_ASSERT(ret == 0, "%s: bulk lookup still found %d keys",
+		setsum->name, ret);
+
+	return 0;
+}
+
+static int
+test_member_insert_lookup(void)
+{
+	unsigned int i;
+	int ret_ht, ret_cache, ret_vbf;
+
+	for (i = 0; i < RTE_DIM(keys); i++) {
+		ret_ht = rte_member_add(setsum_ht, &keys[i], test_set[i]);
+		ret_cache = rte_member_add(setsum_cache, &keys[i],
+				test_set[i]);
+		ret_vbf = rte_member_add(setsum_vbf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret_ht == 0 && ret_cache == 0 && ret_vbf == 0,
+			"Insert of key %u failed", i);
+	}
+
+	if (check_five_keys(setsum_ht) < 0 ||
+			check_five_keys(setsum_cache) < 0 ||
+			check_five_keys(setsum_vbf) < 0)
+		return -1;
+
+	/* Set id 0 means no match and cannot be added to */
+	TEST_ASSERT(rte_member_add(setsum_ht, &keys[0],
+			RTE_MEMBER_NO_MATCH) < 0,
+		"Insert into set 0 should have failed");
+	TEST_ASSERT(rte_member_add(setsum_vbf, &keys[0], NUM_SETS + 1) < 0,
+		"Insert into a set above num_set should have failed");
+
+	printf("Test insert and lookup success\n");
+	return 0;
+}
+
+static int
+test_member_multi(void)
+{
+	unsigned int i, j;
+	int ret;
+	member_set_t set_ids[MAX_MATCH];
+	member_set_t multi_ids[RTE_DIM(keys) * MAX_MATCH];
+	uint32_t match_count[RTE_DIM(keys)];
+	const void *key_array[RTE_DIM(keys)];
+	struct rte_member_setsum *multi_setsums[] = {setsum_ht, setsum_vbf};
+
+	/*
+	 * Add the first key to all the sets: the non-cache hash table and
+	 * the vBF keep track of all of them.
+	 */
+	for (i = 0; i < RTE_DIM(multi_setsums); i++) {
+		for (j = 1; j <= NUM_SETS; j++) {
+			if (j == test_set[0])
+				continue;
+			ret = rte_member_add(multi_setsums[i], &keys[0], j);
+			TEST_ASSERT(ret == 0, "%s: insert of key 0 in set %u "
+				"failed", multi_setsums[i]->name, j);
+		}
+
+		ret = rte_member_lookup_multi(multi_setsums[i], &keys[0],
+				MAX_MATCH, set_ids);
+		TEST_ASSERT(ret == NUM_SETS, "%s: key 0 found in %d sets",
+			multi_setsums[i]->name, ret);
+
+		/* Only as many sets as asked for are returned */
+		ret = rte_member_lookup_multi(multi_setsums[i], &keys[0], 2,
+				set_ids);
+		TEST_ASSERT(ret == 2, "%s: %d sets returned instead of 2",
+			multi_setsums[i]->name, ret);
+
+		for (j = 0; j < RTE_DIM(keys); j++)
+			key_array[j] = &keys[j];
+		ret = rte_member_lookup_multi_bulk(multi_setsums[i],
+				key_array, RTE_DIM(keys), MAX_MATCH,
+				match_count, multi_ids);
+		TEST_ASSERT(ret == (int)RTE_DIM(keys),
+			"%s: multi bulk lookup matched %d keys",
+			multi_setsums[i]->name, ret);
+		TEST_ASSERT(match_count[0] == NUM_SETS,
+			"%s: multi bulk lookup found key 0 in %u sets",
+			multi_setsums[i]->name, match_count[0]);
+		for (j = 1; j < RTE_DIM(keys); j++)
+			TEST_ASSERT(match_count[j] >= 1 &&
+				multi_ids[j * MAX_MATCH] == test_set[j],
+				"%s: multi bulk lookup of key %u failed",
+				multi_setsums[i]->name, j);
+	}
+
+	/* The cache mode keeps the last set a key was added to */
+	ret = rte_member_add(setsum_cache, &keys[0], NUM_SETS);
+	TEST_ASSERT(ret == 0, "Update of key 0 in cache mode failed");
+	ret = rte_member_lookup_multi(setsum_cache, &keys[0], MAX_MATCH,
+			set_ids);
+	TEST_ASSERT(ret == 1 && set_ids[0] == NUM_SETS,
+		"Cache mode found key 0 in %d sets", ret);
+
+	printf("Test multi-set lookup success\n");
+	return 0;
+}
+
+static int
+test_member_delete_reset(void)
+{
+	unsigned int i;
+	int ret;
+	member_set_t set_id;
+
+	/* Remove the extra sets of key 0 added by the multi-set test */
+	for (i = 1; i <= NUM_SETS; i++) {
+		if (i == test_set[0])
+			continue;
+		ret = rte_member_delete(setsum_ht, &keys[0], i);
+		TEST_ASSERT(ret == 0, "Delete of key 0 from set %u failed", i);
+	}
+	ret = rte_member_add(setsum_cache, &keys[0], test_set[0]);
+	TEST_ASSERT(ret == 0, "Update of key 0 in cache mode failed");
+
+	if (check_five_keys(setsum_ht) < 0 ||
+			check_five_keys(setsum_cache) < 0)
+		return -1;
+
+	for (i = 0; i < RTE_DIM(keys); i++) {
+		ret = rte_member_delete(setsum_ht, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == 0, "Delete of key %u failed", i);
+		ret = rte_member_delete(setsum_cache, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == 0, "Delete of key %u in cache mode failed",
+			i);
+		ret = rte_member_delete(setsum_vbf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == -ENOTSUP, "Delete from a vBF should not be "
+			"supported");
+	}
+
+	/* Deleting again, or from the wrong set, fails */
+	ret = rte_member_delete(setsum_ht, &keys[0], test_set[0]);
+	TEST_ASSERT(ret == -ENOENT, "Delete of a deleted key should fail");
+
+	if (check_no_keys(setsum_ht) < 0 || check_no_keys(setsum_cache) < 0)
+		return -1;
+
+	/* Reset empties all types */
+	for (i = 0; i < RTE_DIM(keys); i++) {
+		rte_member_add(setsum_ht, &keys[i], test_set[i]);
+		rte_member_add(setsum_cache, &keys[i], test_set[i]);
+	}
+	rte_member_reset(setsum_ht);
+	rte_member_reset(setsum_cache);
+	rte_member_reset(setsum_vbf);
+
+	if (check_no_keys(setsum_ht) < 0 ||
+			check_no_keys(setsum_cache) < 0 ||
+			check_no_keys(setsum_vbf) < 0)
+		return -1;
+
+	ret = rte_member_lookup(setsum_vbf, &keys[0], &set_id);
+	TEST_ASSERT(ret == 0, "vBF still matches after reset");
+
+	printf("Test delete and reset success\n");
+	return 0;
+}
+
+static void
+setup_keys(void)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < NUM_SAMPLES; i++)
+		for (j = 0; j < sizeof(struct flow_key); j++)
+			generated_keys[i][j] = rte_rand() & 0xFF;
+}
+
+/*
+ * Fill the non-cache hash table until it is full: the cuckoo pushes
+ * should let it reach a high load. The cache mode should never fail
+ * and keep finding the most recent keys.
+ */
+static int
+test_member_loadfactor(void)
+{
+	unsigned int i, added, found;
+	int ret;
+	member_set_t set_id;
+
+	rte_member_reset(setsum_ht);
+	rte_member_reset(setsum_cache);
+
+	for (added = 0; added < MAX_ENTRIES; added++) {
+		ret = rte_member_add(setsum_ht, generated_keys[added],
+				added % NUM_SETS + 1);
+		if (ret < 0)
+			break;
+	}
+	printf("Hash table utilization: %u%% (%u keys)\n",
+		added * 100 / MAX_ENTRIES, added);
+	TEST_ASSERT(added >= MAX_ENTRIES * 9 / 10,
+		"Hash table full at %u keys", added);
+
+	/* All the keys added so far are found, in their set */
+	for (i = 0; i < added; i++) {
+		ret = rte_member_lookup(setsum_ht, generated_keys[i], &set_id);
+		TEST_ASSERT(ret == 1, "Key %u lost by the hash table", i);
+	}
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_add(setsum_cache, generated_keys[i],
+				i % NUM_SETS + 1);
+		TEST_ASSERT(ret == 0 || ret == 1,
+			"Add to the cache failed with %d", ret);
+	}
+
+	/* Most of the last keys, a quarter of the table, are still there */
+	found = 0;
+	for (i = NUM_SAMPLES - MAX_ENTRIES / 4; i < NUM_SAMPLES; i++) {
+		ret = rte_member_lookup(setsum_cache, generated_keys[i],
+				&set_id);
+		if (ret == 1 && set_id == i % NUM_SETS + 1)
+			found++;
+	}
+	printf("Cache mode found %u%% of the recent keys\n",
+		found * 100 / (MAX_ENTRIES / 4));
+	TEST_ASSERT(found >= MAX_ENTRIES / 4 * 3 / 4,
+		"Cache mode lost too many recent keys");
+
+	rte_member_reset(setsum_ht);
+	rte_member_reset(setsum_cache);
+
+	printf("Test load factor success\n");
+	return 0;
+}
+
+/*
+ * Add half of the generated keys and look up the other half: the
+ * vBF should meet the false positive rate it was created with, and
+ * must not have any false negative.
+ */
+static int
+test_member_false_positive(void)
+{
+	unsigned int i, num_fp;
+	uint32_t num_keys = NUM_SAMPLES / 2;
+	int ret;
+	member_set_t set_id;
+	struct rte_member_setsum *vbf;
+	struct rte_member_parameters fp_params = params;
+
+	fp_params.name = "test_member_fp";
+	fp_params.type = RTE_MEMBER_TYPE_VBF;
+	fp_params.num_keys = num_keys;
+	vbf = rte_member_create(&fp_params);
+	TEST_ASSERT(vbf != NULL, "Creation of vBF failed");
+
+	for (i = 0; i < num_keys; i++) {
+		ret = rte_member_add(vbf, generated_keys[i],
+				i % NUM_SETS + 1);
+		TEST_ASSERT(ret == 0, "Insert into vBF failed");
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		ret = rte_member_lookup_multi(vbf, generated_keys[i],
+				1, &set_id);
+		if (ret == 0) {
+			rte_member_free(vbf);
+			printf("vBF lost key %u\n", i);
+			return -1;
+		}
+	}
+
+	num_fp = 0;
+	for (i = num_keys; i < NUM_SAMPLES; i++) {
+		if (rte_member_lookup(vbf, generated_keys[i], &set_id) == 1)
+			num_fp++;
+	}
+	rte_member_free(vbf);
+
+	printf("vBF false positive rate %.4f, expected %.4f\n",
+		(double)num_fp / (NUM_SAMPLES - num_keys),
+		FALSE_POSITIVE_RATE);
+	TEST_ASSERT((double)num_fp / (NUM_SAMPLES - num_keys) <=
+			FALSE_POSITIVE_RATE * 1.2,
+		"vBF false positive rate too high");
+
+	printf("Test false positive rate success\n");
+	return 0;
+}
+
+static int
+test_member(void)
+{
+	if (test_member_create() < 0) {
+		test_member_free();
+		return -1;
+	}
+	if (test_member_create_bad_param() < 0 ||
+			test_member_find_existing() < 0 ||
+			test_member_insert_lookup() < 0 ||
+			test_member_multi() < 0 ||
+			test_member_delete_reset() < 0) {
+		test_member_free();
+		return -1;
+	}
+
+	setup_keys();
+	if (test_member_loadfactor() < 0 ||
+			test_member_false_positive() < 0) {
+		test_member_free();
+		return -1;
+	}
+
+	test_member_free();
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(member_autotest, test_member);
@@ -0,0 +1,571 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2017 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_lcore.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_memcpy.h>
+#include <rte_member.h>
+
+#include "test.h"
+
+#define NUM_KEYSIZES 10
+#define NUM_SHUFFLES 10
+#define MAX_KEYSIZE 64
+#define MAX_ENTRIES (1 << 19)
+#define KEYS_TO_ADD (MAX_ENTRIES * 3 / 4) /* 75% table utilization */
+#define NUM_LOOKUPS (KEYS_TO_ADD * 5) /* Loop among keys added, several times */
+#define NUM_SETS 32
+#define MAX_MATCH 32
+#define BURST_SIZE RTE_MEMBER_LOOKUP_BULK_MAX
+#define FALSE_POSITIVE_RATE 0.03
+
+static unsigned int test_socket_id;
+
+enum sstype {
+	HT = 0,
+	CACHE,
+	VBF,
+	NUM_TYPE
+};
+
+enum operations {
+	ADD = 0,
+	LOOKUP,
+	LOOKUP_BULK,
+	LOOKUP_MULTI,
+	LOOKUP_MULTI_BULK,
+	DELETE,
+	LOOKUP_MISS,
+	NUM_OPERATIONS
+};
+
+struct member_perf_params {
+	struct rte_member_setsum *setsum[NUM_TYPE];
+	uint32_t key_size;
+	unsigned int cycle;
+};
+
+static const char * const type_names[NUM_TYPE] = {
+	"hash table", "hash table, cache mode", "vector of Bloom filters"
+};
+
+static uint32_t hashtest_key_lens[] = {
+	/* standard key sizes */
+	4, 8, 16, 32, 48, 64,
+	/* IPv4 SRC + DST + protocol, unpadded */
+	9,
+	/* IPv4 5-tuple, unpadded */
+	13,
+	/* IPv6 5-tuple, unpadded */
+	37,
+	/* IPv6 5-tuple, padded to 8-byte boundary */
+	40
+};
+
+/* Array to store number of cycles per operation */
+uint64_t cycles[NUM_TYPE][NUM_KEYSIZES][NUM_OPERATIONS];
+
+/* Array to store false positive rates, in 1/10000 */
+uint64_t false_data[NUM_TYPE][NUM_KEYSIZES];
+
+/* Array to store the set ids */
+member_set_t data[KEYS_TO_ADD];
+
+/* Array to store all input keys */
+uint8_t keys[KEYS_TO_ADD][MAX_KEYSIZE];
+
+/* Array of keys never added, for the false positive lookups */
+uint8_t false_keys[KEYS_TO_ADD][MAX_KEYSIZE];
+
+/* Shuffle the keys that have been added, so lookups will be totally random */
+static void
+shuffle_input_keys(struct member_perf_params *params)
+{
+	member_set_t temp_data;
+	unsigned int i;
+	uint32_t swap_idx;
+	uint8_t temp_key[MAX_KEYSIZE];
+
+	for (i = KEYS_TO_ADD - 1; i > 0; i--) {
+		swap_idx = rte_rand() % i;
+
+		memcpy(temp_key, keys[i], hashtest_key_lens[params->cycle]);
+		temp_data = data[i];
+
+		memcpy(keys[i], keys[swap_idx], hashtest_key_lens[params->cycle]);
+		data[i] = data[swap_idx];
+
+		memcpy(keys[swap_idx], temp_key, hashtest_key_lens[params->cycle]);
+		data[swap_idx] = temp_data;
+	}
+}
+
+static int key_compare(const void *key1, const void *key2)
+{
+	return memcmp(key1, key2, MAX_KEYSIZE);
+}
+
+/*
+ * Generate the keys to add, without duplicates, and as many keys
+ * which are not added. These may collide with the added ones for the
+ * smallest key size, which only slightly raises the measured false
+ * positive rate.
+ */
+static int
+setup_keys_and_data(struct member_perf_params *params, unsigned int cycle)
+{
+	unsigned int i, j;
+	int num_duplicates;
+
+	params->key_size = hashtest_key_lens[cycle];
+	params->cycle = cycle;
+
+	/* Reset all arrays */
+	memset(keys, 0, sizeof(keys));
+	memset(false_keys, 0, sizeof(false_keys));
+
+	/* Generate a list of keys, some of which may be duplicates */
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		for (j = 0; j < params->key_size; j++) {
+			keys[i][j] = rte_rand() & 0xFF;
+			false_keys[i][j] = rte_rand() & 0xFF;
+		}
+	}
+
+	/* Remove duplicates from the keys array */
+	do {
+		num_duplicates = 0;
+
+		/* Sort the list of keys to make it easier to find duplicates */
+		qsort(keys, KEYS_TO_ADD, MAX_KEYSIZE, key_compare);
+
+		/* Sift through the list of keys and look for duplicates */
+		for (i = 0; i < KEYS_TO_ADD - 1; i++) {
+			if (memcmp(keys[i], keys[i + 1], params->key_size) == 0) {
+				/* This key already exists, try again */
+				num_duplicates++;
+				for (j = 0; j < params->key_size; j++)
+					keys[i][j] = rte_rand() & 0xFF;
+			}
+		}
+	} while (num_duplicates != 0);
+
+	/* Assign the keys to the sets, then shuffle them */
+	for (i = 0; i < KEYS_TO_ADD; i++)
+		data[i] = rte_rand() % NUM_SETS + 1;
+
+	shuffle_input_keys(params);
+
+	return 0;
+}
+
+static int
+create_setsums(struct member_perf_params *params)
+{
+	struct rte_member_parameters member_params = {
+		.num_keys = KEYS_TO_ADD,
+		.key_len = params->key_size,
+		.num_set = NUM_SETS,
+		.false_positive_rate = FALSE_POSITIVE_RATE,
+		.prim_hash_seed = rte_rand(),
+		.sec_hash_seed = rte_rand(),
+		.socket_id = test_socket_id,
+	};
+
+	member_params.name = "test_member_ht";
+	member_params.type = RTE_MEMBER_TYPE_HT;
+	member_params.is_cache = 0;
+	params->setsum[HT] = rte_member_create(&member_params);
+
+	member_params.name = "test_member_cache";
+	member_params.is_cache = 1;
+	params->setsum[CACHE] = rte_member_create(&member_params);
+
+	member_params.name = "test_member_vbf";
+	member_params.type = RTE_MEMBER_TYPE_VBF;
+	member_params.is_cache = 0;
+	params->setsum[VBF] = rte_member_create(&member_params);
+
+	if (params->setsum[HT] == NULL || params->setsum[CACHE] == NULL ||
+			params->setsum[VBF] == NULL) {
+		printf("Error creating the set summaries\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+timed_adds(struct member_perf_params *params, int type)
+{
+	const uint64_t start_tsc = rte_rdtsc();
+	unsigned int i, a;
+	int32_t ret;
+
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		ret = rte_member_add(params->setsum[type], keys[i], data[i]);
+		if (ret < 0) {
+			printf("Error %d in rte_member_add - key=0x", ret);
+			for (a = 0; a < params->key_size; a++)
+				printf("%02x", keys[i][a]);
+			printf(" value=%d, type: %d\n", data[i], type);
+
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][ADD] = time_taken / KEYS_TO_ADD;
+	return 0;
+}
+
+static int
+timed_lookups(struct member_perf_params *params, int type)
+{
+	unsigned int i, j;
+	const uint64_t start_tsc = rte_rdtsc();
+	member_set_t result;
+	int ret;
+
+	for (i = 0; i < NUM_LOOKUPS / KEYS_TO_ADD; i++) {
+		for (j = 0; j < KEYS_TO_ADD; j++) {
+			ret = rte_member_lookup(params->setsum[type], keys[j],
+					&result);
+			if (ret < 0) {
+				printf("Failure in rte_member_lookup: %d\n",
+					ret);
+				return -1;
+			}
+			/* The non-cache hash table has no false negatives */
+			if (type == HT && ret == 0) {
+				printf("Key #%u not found\n", j);
+				return -1;
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][LOOKUP] = time_taken / NUM_LOOKUPS;
+
+	return 0;
+}
+
+static int
+timed_lookups_bulk(struct member_perf_params *params, int type)
+{
+	unsigned int i, j, k;
+	member_set_t result[BURST_SIZE] = {0};
+	const void *keys_burst[BURST_SIZE];
+	int ret;
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < NUM_LOOKUPS / KEYS_TO_ADD; i++) {
+		for (j = 0; j < KEYS_TO_ADD / BURST_SIZE; j++) {
+			for (k = 0; k < BURST_SIZE; k++)
+				keys_burst[k] = keys[j * BURST_SIZE + k];
+
+			ret = rte_member_lookup_bulk(params->setsum[type],
+					keys_burst, BURST_SIZE, result);
+			if (ret < 0) {
+				printf("Failure in rte_member_lookup_bulk: "
+					"%d\n", ret);
+				return -1;
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][LOOKUP_BULK] = time_taken / NUM_LOOKUPS;
+
+	return 0;
+}
+
+static int
+timed_lookups_multimatch(struct member_perf_params *params, int type)
+{
+	unsigned int i, j;
+	member_set_t result[MAX_MATCH] = {0};
+	int ret;
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < NUM_LOOKUPS / KEYS_TO_ADD; i++) {
+		for (j = 0; j < KEYS_TO_ADD; j++) {
+			ret = rte_member_lookup_multi(params->setsum[type],
+					keys[j], MAX_MATCH, result);
+			if (ret < 0) {
+				printf("Failure in rte_member_lookup_multi: "
+					"%d\n", ret);
+				return -1;
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][LOOKUP_MULTI] = time_taken / NUM_LOOKUPS;
+
+	return 0;
+}
+
+static int
+timed_lookups_multimatch_bulk(struct member_perf_params *params, int type)
+{
+	unsigned int i, j, k;
+	member_set_t result[BURST_SIZE][MAX_MATCH] = {{0} };
+	const void *keys_burst[BURST_SIZE];
+	uint32_t match_count[BURST_SIZE];
+	int ret;
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < NUM_LOOKUPS / KEYS_TO_ADD; i++) {
+		for (j = 0; j < KEYS_TO_ADD / BURST_SIZE; j++) {
+			for (k = 0; k < BURST_SIZE; k++)
+				keys_burst[k] = keys[j * BURST_SIZE + k];
+
+			ret = rte_member_lookup_multi_bulk(
+					params->setsum[type],
+					keys_burst, BURST_SIZE, MAX_MATCH,
+					match_count, (member_set_t *)result);
+			if (ret < 0) {
+				printf("Failure in "
+					"rte_member_lookup_multi_bulk: %d\n",
+					ret);
+				return -1;
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][LOOKUP_MULTI_BULK] =
+			time_taken / NUM_LOOKUPS;
+
+	return 0;
+}
+
+static int
+timed_deletes(struct member_perf_params *params, int type)
+{
+	unsigned int i;
+	int32_t ret;
+
+	if (type == VBF)
+		return 0;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		ret = rte_member_delete(params->setsum[type], keys[i],
+				data[i]);
+		/* The cache mode may have evicted some keys */
+		if (ret < 0 && !(type == CACHE && ret == -ENOENT)) {
+			printf("Error %d in rte_member_delete\n", ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][DELETE] = time_taken / KEYS_TO_ADD;
+
+	return 0;
+}
+
+/* Look up keys never added, measuring the cost and the false positives */
+static int
+timed_lookups_miss(struct member_perf_params *params, int type)
+{
+	unsigned int i, num_fp = 0;
+	member_set_t result;
+	int ret;
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		ret = rte_member_lookup(params->setsum[type], false_keys[i],
+				&result);
+		if (ret < 0) {
+			printf("Failure in rte_member_lookup: %d\n", ret);
+			return -1;
+		}
+		num_fp += ret;
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[type][params->cycle][LOOKUP_MISS] = time_taken / KEYS_TO_ADD;
+	false_data[type][params->cycle] =
+			(uint64_t)num_fp * 10000 / KEYS_TO_ADD;
+
+	return 0;
+}
+
+static void
+perform_frees(struct member_perf_params *params)
+{
+	int i;
+
+	for (i = 0; i < NUM_TYPE; i++) {
+		if (params->setsum[i] != NULL) {
+			rte_member_free(params->setsum[i]);
+			params->setsum[i] = NULL;
+		}
+	}
+}
+
+static int
+exit_with_fail(const char *testname, struct member_perf_params *params,
+		unsigned int i, unsigned int j)
+{
+	printf("<<<<<Test %s failed at keysize %d iteration %d type %d>>>>>\n",
+			testname, hashtest_key_lens[params->cycle], i, j);
+	perform_frees(params);
+	return -1;
+}
+
+static int
+run_all_tbl_perf_tests(void)
+{
+	unsigned int i, j, k;
+	struct member_perf_params params;
+
+	memset(&params, 0, sizeof(params));
+
+	printf("Measuring performance, please wait\n");
+	fflush(stdout);
+
+	test_socket_id = rte_socket_id();
+
+	for (i = 0; i < NUM_KEYSIZES; i++) {
+		if (setup_keys_and_data(&params, i) < 0) {
+			printf("Could not create keys/data/table\n");
+			return -1;
+		}
+		if (create_setsums(&params) < 0) {
+			perform_frees(&params);
+			return -1;
+		}
+
+		for (j = 0; j < NUM_TYPE; j++) {
+			if (timed_adds(&params, j) < 0)
+				return exit_with_fail("timed_adds", &params,
+						i, j);
+
+			for (k = 0; k < NUM_SHUFFLES; k++)
+				shuffle_input_keys(&params);
+
+			if (timed_lookups(&params, j) < 0)
+				return exit_with_fail("timed_lookups",
+						&params, i, j);
+
+			if (timed_lookups_bulk(&params, j) < 0)
+				return exit_with_fail("timed_lookups_bulk",
+						&params, i, j);
+
+			if (timed_lookups_multimatch(&params, j) < 0)
+				return exit_with_fail("timed_lookups_multi",
+						&params, i, j);
+
+			if (timed_lookups_multimatch_bulk(&params, j) < 0)
+				return exit_with_fail(
+						"timed_lookups_multi_bulk",
+						&params, i, j);
+
+			if (timed_lookups_miss(&params, j) < 0)
+				return exit_with_fail("timed_lookups_miss",
+						&params, i, j);
+
+			if (timed_deletes(&params, j) < 0)
+				return exit_with_fail("timed_deletes",
+						&params, i, j);
+		}
+
+		/* Print a dot to show progress on operations */
+		printf(".");
+		fflush(stdout);
+
+		perform_frees(&params);
+	}
+
+	printf("\nResults (in CPU cycles/operation)\n");
+	printf("-----------------------------------\n");
+	for (i = 0; i < NUM_TYPE; i++) {
+		printf("\n%s, %u sets\n", type_names[i], NUM_SETS);
+		printf("%-10s%-10s%-10s%-10s%-10s%-12s%-10s%-10s%-10s\n",
+			"Keysize", "Add", "Lookup", "Lookup", "Multi",
+			"Multi", "Delete", "Lookup", "False");
+		printf("%-10s%-10s%-10s%-10s%-10s%-12s%-10s%-10s%-10s\n",
+			"", "", "", "bulk", "lookup", "lookup_bulk", "",
+			"miss", "positive");
+		for (j = 0; j < NUM_KEYSIZES; j++) {
+			printf("%-10d", hashtest_key_lens[j]);
+			for (k = 0; k < NUM_OPERATIONS; k++) {
+				if (k == DELETE && i == VBF)
+					printf("%-10s", "-");
+				else if (k == LOOKUP_MULTI_BULK)
+					printf("%-12"PRIu64, cycles[i][j][k]);
+				else
+					printf("%-10"PRIu64, cycles[i][j][k]);
+			}
+			printf("%"PRIu64".%02"PRIu64"%%\n",
+				false_data[i][j] / 100,
+				false_data[i][j] % 100);
+		}
+	}
+	return 0;
+}
+
+static int
+test_member_perf(void)
+{
+
+	if (run_all_tbl_perf_tests() < 0)
+		return -1;
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(member_perf_autotest, test_member_perf);
@@ -443,6 +443,129 @@ test_mempool_basic_ex(struct rte_mempool *mp)
 	return ret;
 }
 
+/*
+ * get contiguous blocks of objects, check that the objects of a block are
+ * neighbours in memory, and put them back one by one
+ */
+static int
+test_mempool_contig_blocks(struct rte_mempool *mp)
+{
+	struct rte_mempool_info info;
+	void **first_obj_table = NULL;
+	size_t total_elt_sz;
+	unsigned int avail, n_blocks, i, j;
+	void *obj;
+	int ret = -1;
+
+	if (rte_mempool_ops_get_info(mp, &info) < 0 ||
+			info.contig_block_size == 0) {
+		printf("mempool %s does not provide contiguous blocks\n",
+			mp->name);
+		return -1;
+	}
+
+	total_elt_sz = mp->header_size + mp->elt_size + mp->trailer_size;
+	avail = rte_mempool_avail_count(mp);
+	n_blocks = avail / info.contig_block_size;
+	if (n_blocks < 2)
+		RET_ERR();
+
+	first_obj_table = rte_calloc("test_mempool_contig_blocks", n_blocks,
+		sizeof(void *), 0);
+	if (first_obj_table == NULL)
+		RET_ERR();
+
+	/* a request bigger than the pool must fail without taking blocks */
+	if (rte_mempool_get_contig_blocks(mp, first_obj_table,
+			n_blocks + 1) == 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != avail)
+		GOTO_ERR(ret, out);
+
+	/* take half of the blocks */
+	n_blocks /= 2;
+	if (rte_mempool_get_contig_blocks(mp, first_obj_table, n_blocks) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) !=
+			avail - n_blocks * info.contig_block_size)
+		GOTO_ERR(ret, out);
+
+	for (i = 0; i < n_blocks; i++) {
+		for (j = 0; j < info.contig_block_size; j++) {
+			obj = RTE_PTR_ADD(first_obj_table[i],
+				j * total_elt_sz);
+			if (rte_mempool_from_obj(obj) != mp)
+				GOTO_ERR(ret, out);
+		}
+	}
+
+	/* free the objects individually */
+	for (i = 0; i < n_blocks; i++) {
+		for (j = 0; j < info.contig_block_size; j++) {
+			obj = RTE_PTR_ADD(first_obj_table[i],
+				j * total_elt_sz);
+			rte_mempool_put(mp, obj);
+		}
+	}
+	if (rte_mempool_avail_count(mp) != avail)
+		GOTO_ERR(ret, out);
+
+	/* the blocks are available again */
+	if (rte_mempool_get_contig_blocks(mp, first_obj_table, n_blocks) < 0)
+		GOTO_ERR(ret, out);
+	for (i = 0; i < n_blocks; i++) {
+		for (j = 0; j < info.contig_block_size; j++) {
+			obj = RTE_PTR_ADD(first_obj_table[i],
+				j * total_elt_sz);
+			rte_mempool_put(mp, obj);
+		}
+	}
+
+	ret = 0;
+
+out:
+	rte_free(first_obj_table);
+	return ret;
+}
+
+/*
+ * a bucket mempool must refuse a memory chunk that cannot hold an aligned
+ * bucket, like a single small page
+ */
+static int
+test_mempool_bucket_small_chunk(void)
+{
+	size_t bucket_sz = rte_align64pow2(
+		RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024);
+	size_t pg_sz = 4096;
+	struct rte_mempool *mp;
+	char *buf;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("test_bucket_small", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 0, 0, SOCKET_ID_ANY, 0);
+	buf = rte_malloc("test_bucket_small", 2 * bucket_sz, bucket_sz);
+	if (mp == NULL || buf == NULL)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_set_ops_byname(mp, "bucket", NULL) < 0)
+		GOTO_ERR(ret, out);
+
+	/* the page after a bucket boundary cannot start a bucket */
+	if (rte_mempool_populate_phys(mp, buf + pg_sz,
+			rte_malloc_virt2phy(buf) + pg_sz, pg_sz,
+			NULL, NULL) != -EINVAL)
+		GOTO_ERR(ret, out);
+	if (mp->populated_size != 0 || mp->nb_mem_chunks != 0)
+		GOTO_ERR(ret, out);
+
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	rte_free(buf);
+	return ret;
+}
+
 static int
 test_mempool_same_name_twice_creation(void)
 {
@@ -513,7 +636,10 @@ test_mempool(void)
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_lf_stack = NULL;
+	struct rte_mempool *mp_bucket = NULL;
 	struct rte_mempool *default_pool = NULL;
+	void *obj;
 
 	rte_atomic32_init(&synchro);
 
@@ -563,6 +689,54 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+#ifdef RTE_ARCH_X86_64
+	/* create a mempool with the lock-free stack handler */
+	mp_lf_stack = rte_mempool_create_empty("test_lf_stack",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_lf_stack == NULL) {
+		printf("cannot allocate mp_lf_stack mempool\n");
+		goto err;
+	}
+	if (rte_mempool_set_ops_byname(mp_lf_stack, "lf_stack", NULL) < 0) {
+		printf("cannot set lf_stack handler\n");
+		goto err;
+	}
+	if (rte_mempool_populate_default(mp_lf_stack) < 0) {
+		printf("cannot populate mp_lf_stack mempool\n");
+		goto err;
+	}
+	rte_mempool_obj_iter(mp_lf_stack, my_obj_init, NULL);
+#endif
+
+	/*
+	 * create a mempool with the bucket handler (without cache), its
+	 * buckets do not fit in small pages without hugepages
+	 */
+	mp_bucket = rte_mempool_create_empty("test_bucket",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		0, 0,
+		SOCKET_ID_ANY,
+		rte_eal_has_hugepages() ? 0 : MEMPOOL_F_NO_PHYS_CONTIG);
+
+	if (mp_bucket == NULL) {
+		printf("cannot allocate mp_bucket mempool\n");
+		goto err;
+	}
+	if (rte_mempool_set_ops_byname(mp_bucket, "bucket", NULL) < 0) {
+		printf("cannot set bucket handler\n");
+		goto err;
+	}
+	if (rte_mempool_populate_default(mp_bucket) < 0) {
+		printf("cannot populate mp_bucket mempool\n");
+		goto err;
+	}
+	rte_mempool_obj_iter(mp_bucket, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n",
 	       RTE_MBUF_DEFAULT_MEMPOOL_OPS);
@@ -633,6 +807,35 @@ test_mempool(void)
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		goto err;
 
+#ifdef RTE_ARCH_X86_64
+	/* test the lock-free stack handler, with and without cache */
+	if (test_mempool_basic(mp_lf_stack, 0) < 0)
+		goto err;
+
+	if (test_mempool_basic(mp_lf_stack, 1) < 0)
+		goto err;
+#endif
+
+	/* test the bucket handler */
+	if (test_mempool_basic(mp_bucket, 0) < 0)
+		goto err;
+
+	if (test_mempool_basic(mp_bucket, 1) < 0)
+		goto err;
+
+	if (test_mempool_basic_ex(mp_bucket) < 0)
+		goto err;
+
+	if (test_mempool_contig_blocks(mp_bucket) < 0)
+		goto err;
+
+	if (test_mempool_bucket_small_chunk() < 0)
+		goto err;
+
+	/* contiguous blocks are not supported by the ring handler */
+	if (rte_mempool_get_contig_blocks(mp_nocache, &obj, 1) != -ENOTSUP)
+		goto err;
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		goto err;
 
@@ -644,6 +847,8 @@ test_mempool(void)
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_lf_stack);
+	rte_mempool_free(mp_bucket);
 	rte_mempool_free(default_pool);
 
 	return ret;
@@ -90,6 +90,13 @@
  *
  *      - 32
  *      - 128
+ *
+ * Startup performance
+ * ===================
+ *
+ *    Measure the time needed to populate a mempool of STARTUP_POOL_SIZE
+ *    objects, then to initialize its objects with rte_mempool_obj_iter()
+ *    and with rte_mempool_obj_iter_parallel() (using the idle lcores).
  */
 
 #define N 65536
@@ -97,6 +104,7 @@
 #define MEMPOOL_ELT_SIZE 2048
 #define MAX_KEEP 128
 #define MEMPOOL_SIZE ((rte_lcore_count()*(MAX_KEEP+RTE_MEMPOOL_CACHE_MAX_SIZE))-1)
+#define STARTUP_POOL_SIZE ((1 << 16) - 1)
 
 #define LOG_ERR() printf("test failed at %s():%d\n", __func__, __LINE__)
 #define RET_ERR() do {							\
@@ -279,6 +287,119 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* create a mempool without cache using the given handler */
+static struct rte_mempool *
+create_ops_mempool(const char *name, const char *ops_name)
+{
+	struct rte_mempool *mp;
+
+	mp = rte_mempool_create_empty(name, MEMPOOL_SIZE, MEMPOOL_ELT_SIZE,
+				      0, 0, SOCKET_ID_ANY, 0);
+	if (mp == NULL) {
+		printf("cannot allocate %s mempool\n", ops_name);
+		return NULL;
+	}
+
+	if (rte_mempool_set_ops_byname(mp, ops_name, NULL) < 0) {
+		printf("cannot set %s handler\n", ops_name);
+		goto err;
+	}
+
+	if (rte_mempool_populate_default(mp) < 0) {
+		printf("cannot populate %s mempool\n", ops_name);
+		goto err;
+	}
+
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+	return mp;
+
+err:
+	rte_mempool_free(mp);
+	return NULL;
+}
+
+/* set the object number to an invalid value */
+static void
+my_obj_clear(__rte_unused struct rte_mempool *mp, __rte_unused void *arg,
+	     void *obj, __rte_unused unsigned i)
+{
+	uint32_t *objnum = obj;
+
+	*objnum = UINT32_MAX;
+}
+
+/* check the object number stored by my_obj_init() */
+static void
+my_obj_check(__rte_unused struct rte_mempool *mp, void *arg,
+	     void *obj, unsigned i)
+{
+	unsigned *errors = arg;
+	uint32_t *objnum = obj;
+
+	if (*objnum != i)
+		(*errors)++;
+}
+
+static double
+cycles_to_ms(uint64_t cycles)
+{
+	return (double)cycles * 1000 / rte_get_timer_hz();
+}
+
+/* measure the time to populate and initialize a big mempool */
+static int
+test_mempool_startup_perf(void)
+{
+	struct rte_mempool *mp;
+	uint64_t start, populate, init, init_parallel;
+	unsigned errors = 0;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("perf_test_startup", STARTUP_POOL_SIZE,
+				      MEMPOOL_ELT_SIZE, 0, 0,
+				      SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+
+	if (rte_mempool_set_ops_byname(mp, RTE_MBUF_DEFAULT_MEMPOOL_OPS,
+				       NULL) < 0)
+		GOTO_ERR(ret, out);
+
+	start = rte_get_timer_cycles();
+	if (rte_mempool_populate_default(mp) < 0)
+		GOTO_ERR(ret, out);
+	populate = rte_get_timer_cycles() - start;
+
+	start = rte_get_timer_cycles();
+	if (rte_mempool_obj_iter(mp, my_obj_init, NULL) != STARTUP_POOL_SIZE)
+		GOTO_ERR(ret, out);
+	init = rte_get_timer_cycles() - start;
+
+	/* clear the objects, so that the check below is meaningful */
+	rte_mempool_obj_iter(mp, my_obj_clear, NULL);
+
+	start = rte_get_timer_cycles();
+	if (rte_mempool_obj_iter_parallel(mp, my_obj_init, NULL) !=
+			STARTUP_POOL_SIZE)
+		GOTO_ERR(ret, out);
+	init_parallel = rte_get_timer_cycles() - start;
+
+	rte_mempool_obj_iter(mp, my_obj_check, &errors);
+	if (errors != 0)
+		GOTO_ERR(ret, out);
+
+	printf("startup of a %u objects mempool: populate %.2f ms, "
+	       "init %.2f ms, parallel init on %u lcores %.2f ms\n",
+	       STARTUP_POOL_SIZE, cycles_to_ms(populate), cycles_to_ms(init),
+	       rte_lcore_count(), cycles_to_ms(init_parallel));
+
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 /* for a given number of core, launch all test cases */
 static int
 do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
@@ -314,10 +435,15 @@ test_mempool_perf(void)
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
+	struct rte_mempool *stack_pool = NULL;
+	struct rte_mempool *lf_stack_pool = NULL;
 	int ret = -1;
 
 	rte_atomic32_init(&synchro);
 
+	if (test_mempool_startup_perf() < 0)
+		goto err;
+
 	/* create a mempool (without cache) */
 	mp_nocache = rte_mempool_create("perf_test_nocache", MEMPOOL_SIZE,
 					MEMPOOL_ELT_SIZE, 0, 0,
@@ -390,6 +516,39 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(default_pool, rte_lcore_count()) < 0)
 		goto err;
 
+	/* compare the stack handlers with the default ring based one */
+	stack_pool = create_ops_mempool("perf_test_stack", "stack");
+	if (stack_pool == NULL)
+		goto err;
+
+	printf("start performance test for stack (without cache)\n");
+
+	if (do_one_mempool_test(stack_pool, 1) < 0)
+		goto err;
+
+	if (do_one_mempool_test(stack_pool, 2) < 0)
+		goto err;
+
+	if (do_one_mempool_test(stack_pool, rte_lcore_count()) < 0)
+		goto err;
+
+#ifdef RTE_ARCH_X86_64
+	lf_stack_pool = create_ops_mempool("perf_test_lf_stack", "lf_stack");
+	if (lf_stack_pool == NULL)
+		goto err;
+
+	printf("start performance test for lf_stack (without cache)\n");
+
+	if (do_one_mempool_test(lf_stack_pool, 1) < 0)
+		goto err;
+
+	if (do_one_mempool_test(lf_stack_pool, 2) < 0)
+		goto err;
+
+	if (do_one_mempool_test(lf_stack_pool, rte_lcore_count()) < 0)
+		goto err;
+#endif
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (with cache)\n");
 
@@ -423,6 +582,8 @@ test_mempool_perf(void)
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
+	rte_mempool_free(stack_pool);
+	rte_mempool_free(lf_stack_pool);
 	return ret;
 }
 
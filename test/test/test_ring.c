@@ -53,6 +53,8 @@
 #include <rte_branch_prediction.h>
 #include <rte_malloc.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
+#include <rte_ring_peek.h>
 #include <rte_random.h>
 #include <rte_common.h>
 #include <rte_errno.h>
@@ -78,6 +80,23 @@
  *      - Dequeue one object, two objects, MAX_BULK objects
  *      - Check that dequeued pointers are correct
  *
+ *    - Using rings with inline elements of various sizes:
+ *
+ *      - Enqueue/dequeue bulks and bursts across the ring wrap point
+ *      - Check that dequeued elements are correct
+ *
+ *    - Using rings in RTS and HTS sync modes:
+ *
+ *      - Enqueue/dequeue bulks and bursts with the default functions
+ *      - Check that dequeued pointers are correct
+ *      - Check that invalid sync mode flags are rejected
+ *
+ *    - Using the peek and zero-copy functions on a SP/SC ring:
+ *
+ *      - Write objects in place, publish part of them
+ *      - Peek objects, release part of them
+ *      - Check that dequeued pointers are correct
+ *
  * #. Performance tests.
  *
  * Tests done in test_ring_perf.c
@@ -769,6 +788,304 @@ test_ring_basic_ex(void)
 	return ret;
 }
 
+/*
+ * test rings storing elements inline, for each supported element size
+ */
+#define TEST_RING_ELEM_SIZE 64
+#define TEST_RING_ELEM_MAX_SIZE 32
+
+static int
+test_ring_elem_size(unsigned int esize)
+{
+	uint8_t src[MAX_BULK * TEST_RING_ELEM_MAX_SIZE];
+	uint8_t dst[MAX_BULK * TEST_RING_ELEM_MAX_SIZE];
+	struct rte_ring *rp;
+	unsigned int i, j, n;
+	int ret = -1;
+
+	rp = rte_ring_create_elem("test_ring_elem", esize, TEST_RING_ELEM_SIZE,
+			SOCKET_ID_ANY, 0);
+	if (rp == NULL) {
+		printf("%s: cannot create ring with %u bytes elements\n",
+			__func__, esize);
+		return -1;
+	}
+
+	for (i = 0; i < sizeof(src); i++)
+		src[i] = (uint8_t)(i * 7 + esize);
+
+	/* move the head around the ring several times to cover wrapping */
+	for (i = 0; i < 4 * TEST_RING_ELEM_SIZE / MAX_BULK; i++) {
+		n = (i & 1) ? MAX_BULK : MAX_BULK / 2 + 3;
+		memset(dst, 0, sizeof(dst));
+
+		if (rte_ring_sp_enqueue_bulk_elem(rp, src, esize, n,
+				NULL) != n)
+			goto end;
+		if (rte_ring_count(rp) != n)
+			goto end;
+		if (rte_ring_sc_dequeue_bulk_elem(rp, dst, esize, n,
+				NULL) != n)
+			goto end;
+		if (memcmp(src, dst, n * esize) != 0)
+			goto end;
+
+		if (rte_ring_mp_enqueue_burst_elem(rp, src, esize, n,
+				NULL) != n)
+			goto end;
+		for (j = 0; j < n; j++)
+			if (rte_ring_mc_dequeue_elem(rp, &dst[j * esize],
+					esize) != 0)
+				goto end;
+		if (memcmp(src, dst, n * esize) != 0)
+			goto end;
+	}
+
+	/* fill the ring then check that one more element does not fit */
+	for (i = 0; i < TEST_RING_ELEM_SIZE - 1; i++)
+		if (rte_ring_enqueue_elem(rp, &src[(i % MAX_BULK) * esize],
+				esize) != 0)
+			goto end;
+	if (rte_ring_enqueue_elem(rp, src, esize) != -ENOBUFS)
+		goto end;
+	if (rte_ring_full(rp) != 1)
+		goto end;
+	n = rte_ring_dequeue_burst_elem(rp, dst, esize, MAX_BULK, NULL);
+	if (n != MAX_BULK || memcmp(src, dst, n * esize) != 0)
+		goto end;
+
+	ret = 0;
+end:
+	if (ret != 0)
+		printf("%s: failed for %u bytes elements\n", __func__, esize);
+	rte_ring_free(rp);
+	return ret;
+}
+
+static int
+test_ring_elem(void)
+{
+	static const unsigned int esizes[] = { 4, 8, 12, 16, 20, 32 };
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(esizes); i++)
+		if (test_ring_elem_size(esizes[i]) < 0)
+			return -1;
+
+	/* element size must be a multiple of 4 bytes */
+	if (rte_ring_create_elem("test_ring_elem", 6, TEST_RING_ELEM_SIZE,
+			SOCKET_ID_ANY, 0) != NULL)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * test rings using the RTS and HTS producer/consumer sync modes
+ */
+#define TEST_RING_SYNC_SIZE 64
+
+static int
+test_ring_sync_mode(unsigned int flags)
+{
+	void *src[MAX_BULK], *dst[MAX_BULK];
+	struct rte_ring *rp;
+	unsigned int i, n, free_space, avail;
+	int ret = -1;
+
+	rp = rte_ring_create("test_ring_sync", TEST_RING_SYNC_SIZE,
+			SOCKET_ID_ANY, flags);
+	if (rp == NULL) {
+		printf("%s: cannot create ring with flags 0x%x\n", __func__,
+			flags);
+		return -1;
+	}
+
+	for (i = 0; i < MAX_BULK; i++)
+		src[i] = (void *)(uintptr_t)(i + 1);
+
+	/* move the head around the ring several times to cover wrapping */
+	for (i = 0; i < 4 * TEST_RING_SYNC_SIZE / MAX_BULK; i++) {
+		n = (i & 1) ? MAX_BULK : MAX_BULK / 2 + 3;
+		memset(dst, 0, sizeof(dst));
+
+		if (rte_ring_enqueue_bulk(rp, src, n, &free_space) != n)
+			goto end;
+		if (free_space != TEST_RING_SYNC_SIZE - 1 - n)
+			goto end;
+		if (rte_ring_count(rp) != n)
+			goto end;
+		if (rte_ring_dequeue_bulk(rp, dst, n, &avail) != n ||
+				avail != 0)
+			goto end;
+		if (memcmp(src, dst, n * sizeof(void *)) != 0)
+			goto end;
+		if (rte_ring_empty(rp) != 1)
+			goto end;
+	}
+
+	/* fill the ring, the last burst is only partially enqueued */
+	for (i = 0; i < TEST_RING_SYNC_SIZE / MAX_BULK - 1; i++)
+		if (rte_ring_enqueue_burst(rp, src, MAX_BULK, NULL) != MAX_BULK)
+			goto end;
+	if (rte_ring_enqueue_burst(rp, src, MAX_BULK, NULL) != MAX_BULK - 1)
+		goto end;
+	if (rte_ring_full(rp) != 1 || rte_ring_enqueue(rp, src[0]) != -ENOBUFS)
+		goto end;
+	if (rte_ring_enqueue_bulk(rp, src, 1, NULL) != 0)
+		goto end;
+
+	/* empty it, the last burst is only partially dequeued */
+	for (i = 0; i < TEST_RING_SYNC_SIZE / MAX_BULK - 1; i++)
+		if (rte_ring_dequeue_burst(rp, dst, MAX_BULK, NULL) !=
+				MAX_BULK)
+			goto end;
+	if (rte_ring_dequeue_bulk(rp, dst, MAX_BULK, NULL) != 0)
+		goto end;
+	if (rte_ring_dequeue_burst(rp, dst, MAX_BULK, NULL) != MAX_BULK - 1)
+		goto end;
+	if (memcmp(src, dst, (MAX_BULK - 1) * sizeof(void *)) != 0)
+		goto end;
+	if (rte_ring_dequeue(rp, &dst[0]) != -ENOENT)
+		goto end;
+
+	/* the head/tail distance can only be set in RTS mode */
+	if ((rte_ring_set_prod_htd_max(rp, MAX_BULK) == 0) !=
+			!!(flags & RING_F_MP_RTS_ENQ))
+		goto end;
+	if ((rte_ring_set_cons_htd_max(rp, MAX_BULK) == 0) !=
+			!!(flags & RING_F_MC_RTS_DEQ))
+		goto end;
+
+	ret = 0;
+end:
+	if (ret != 0) {
+		printf("%s: failed for flags 0x%x\n", __func__, flags);
+		rte_ring_dump(stdout, rp);
+	}
+	rte_ring_free(rp);
+	return ret;
+}
+
+static int
+test_ring_sync_modes(void)
+{
+	static const unsigned int flags[] = {
+		RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+		RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+		RING_F_MP_RTS_ENQ | RING_F_MC_HTS_DEQ,
+		RING_F_MP_HTS_ENQ | RING_F_SC_DEQ,
+		RING_F_SP_ENQ | RING_F_MC_RTS_DEQ,
+	};
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(flags); i++)
+		if (test_ring_sync_mode(flags[i]) < 0)
+			return -1;
+
+	/* sync mode flags are exclusive */
+	if (rte_ring_create("test_ring_sync", TEST_RING_SYNC_SIZE,
+			SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_MP_RTS_ENQ) !=
+			NULL || rte_errno != EINVAL)
+		return -1;
+	if (rte_ring_create("test_ring_sync", TEST_RING_SYNC_SIZE,
+			SOCKET_ID_ANY, RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ) !=
+			NULL || rte_errno != EINVAL)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * test the peek and zero-copy API, on a ring small enough to wrap quickly
+ */
+#define TEST_RING_PEEK_SIZE 16
+
+static int
+test_ring_peek_zc(void)
+{
+	void *src[TEST_RING_PEEK_SIZE], *dst[TEST_RING_PEEK_SIZE];
+	struct rte_ring_zc_data zcd;
+	struct rte_ring *rp;
+	unsigned int i, j, n, avail;
+	uintptr_t next_in = 1, next_out = 1;
+	void **slot;
+	int ret = -1;
+
+	rp = rte_ring_create("test_ring_peek", TEST_RING_PEEK_SIZE,
+			SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (rp == NULL) {
+		printf("%s: cannot create ring\n", __func__);
+		return -1;
+	}
+
+	for (i = 0; i < 8 * TEST_RING_PEEK_SIZE; i++) {
+		/* reserve 5 slots in place, publish only 3 of them */
+		n = rte_ring_enqueue_zc_burst_start(rp, 5, &zcd, NULL);
+		if (n != 5)
+			goto end;
+		for (j = 0; j < 3; j++) {
+			slot = (j < zcd.n1) ? (void **)zcd.ptr1 + j :
+				(void **)zcd.ptr2 + (j - zcd.n1);
+			*slot = (void *)next_in++;
+		}
+		rte_ring_enqueue_zc_finish(rp, 3);
+		if (rte_ring_count(rp) != 3)
+			goto end;
+
+		/* a reservation that does not fit fails as a whole */
+		if (rte_ring_enqueue_zc_bulk_start(rp, TEST_RING_PEEK_SIZE,
+				&zcd, NULL) != 0)
+			goto end;
+
+		/* peek all objects, only take the first one */
+		n = rte_ring_dequeue_burst_start(rp, dst, TEST_RING_PEEK_SIZE,
+				&avail);
+		if (n != 3 || avail != 0 || dst[0] != (void *)next_out)
+			goto end;
+		rte_ring_dequeue_finish(rp, 1);
+		next_out++;
+		if (rte_ring_count(rp) != 2)
+			goto end;
+
+		/* access the remaining ones in place, and take them all */
+		n = rte_ring_dequeue_zc_bulk_start(rp, 2, &zcd, NULL);
+		if (n != 2)
+			goto end;
+		for (j = 0; j < n; j++) {
+			slot = (j < zcd.n1) ? (void **)zcd.ptr1 + j :
+				(void **)zcd.ptr2 + (j - zcd.n1);
+			if (*slot != (void *)next_out++)
+				goto end;
+		}
+		rte_ring_dequeue_zc_finish(rp, n);
+		if (rte_ring_empty(rp) != 1)
+			goto end;
+	}
+
+	/* objects enqueued in place can be dequeued by the regular API */
+	for (i = 0; i < TEST_RING_PEEK_SIZE; i++)
+		src[i] = (void *)(uintptr_t)(i + 1);
+	n = rte_ring_enqueue_zc_bulk_start(rp, TEST_RING_PEEK_SIZE - 1, &zcd,
+			NULL);
+	if (n != TEST_RING_PEEK_SIZE - 1)
+		goto end;
+	memcpy(zcd.ptr1, src, zcd.n1 * sizeof(void *));
+	if (zcd.n1 != n)
+		memcpy(zcd.ptr2, src + zcd.n1, (n - zcd.n1) * sizeof(void *));
+	rte_ring_enqueue_zc_finish(rp, n);
+	if (rte_ring_dequeue_bulk(rp, dst, n, NULL) != n ||
+			memcmp(src, dst, n * sizeof(void *)) != 0)
+		goto end;
+
+	ret = 0;
+end:
+	if (ret != 0)
+		printf("%s: failed at iteration %u\n", __func__, i);
+	rte_ring_free(rp);
+	return ret;
+}
+
 static int
 test_ring(void)
 {
@@ -797,6 +1114,18 @@ test_ring(void)
 	if (test_ring_basic() < 0)
 		return -1;
 
+	/* rings storing elements inline */
+	if (test_ring_elem() < 0)
+		return -1;
+
+	/* RTS and HTS sync modes */
+	if (test_ring_sync_modes() < 0)
+		return -1;
+
+	/* peek and zero-copy operations */
+	if (test_ring_peek_zc() < 0)
+		return -1;
+
 	/* basic operations */
 	if ( test_create_count_odd() < 0){
 			printf ("Test failed to detect odd count\n");
@@ -33,8 +33,10 @@
 
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
 #include <rte_cycles.h>
 #include <rte_launch.h>
 
@@ -48,12 +50,21 @@
  *  * Empty ring dequeue
  *  * Enqueue/dequeue of bursts in 1 threads
  *  * Enqueue/dequeue of bursts in 2 threads
+ *  * The same for rings storing 16 bytes elements inline, side by side
+ *    with the pointer ring
+ *  * The same for MP/MC rings in RTS and HTS sync modes
  */
 
 #define RING_NAME "RING_PERF"
+#define RING_ELEM_NAME "RING_ELEM_PERF"
+#define RING_RTS_NAME "RING_RTS_PERF"
+#define RING_HTS_NAME "RING_HTS_PERF"
 #define RING_SIZE 4096
 #define MAX_BURST 32
 
+/* size of the elements stored in the element ring, e.g. a 16 bytes event */
+#define RING_ELEM_SIZE 16
+
 /*
  * the sizes to enqueue and dequeue in testing
  * (marked volatile so they won't be seen as compile-time constants)
@@ -63,6 +74,16 @@ static const volatile unsigned bulk_sizes[] = { 8, 32 };
 /* The ring structure used for tests */
 static struct rte_ring *r;
 
+/* The ring storing RING_ELEM_SIZE bytes elements used for tests */
+static struct rte_ring *elem_r;
+
+/* The MP/MC rings in RTS and HTS modes used for tests */
+static struct rte_ring *rts_r, *hts_r;
+
+struct ring_elem {
+	uint64_t u64[RING_ELEM_SIZE / sizeof(uint64_t)];
+};
+
 struct lcore_pair {
 	unsigned c1, c2;
 };
@@ -245,12 +266,164 @@ dequeue_bulk(void *p)
 	return 0;
 }
 
+/*
+ * Same as enqueue_bulk, using the element ring
+ */
+static int
+enqueue_bulk_elem(void *p)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	struct thread_params *params = p;
+	const unsigned size = params->size;
+	unsigned i;
+	struct ring_elem burst[MAX_BURST];
+
+	memset(burst, 0, sizeof(burst));
+
+	if ( __sync_add_and_fetch(&lcore_count, 1) != 2 )
+		while(lcore_count != 2)
+			rte_pause();
+
+	const uint64_t sp_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_sp_enqueue_bulk_elem(elem_r, burst,
+				RING_ELEM_SIZE, size, NULL) == 0)
+			rte_pause();
+	const uint64_t sp_end = rte_rdtsc();
+
+	const uint64_t mp_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_mp_enqueue_bulk_elem(elem_r, burst,
+				RING_ELEM_SIZE, size, NULL) == 0)
+			rte_pause();
+	const uint64_t mp_end = rte_rdtsc();
+
+	params->spsc = ((double)(sp_end - sp_start))/(iterations*size);
+	params->mpmc = ((double)(mp_end - mp_start))/(iterations*size);
+	return 0;
+}
+
+/*
+ * Same as dequeue_bulk, using the element ring
+ */
+static int
+dequeue_bulk_elem(void *p)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	struct thread_params *params = p;
+	const unsigned size = params->size;
+	unsigned i;
+	struct ring_elem burst[MAX_BURST];
+
+	if ( __sync_add_and_fetch(&lcore_count, 1) != 2 )
+		while(lcore_count != 2)
+			rte_pause();
+
+	const uint64_t sc_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_sc_dequeue_bulk_elem(elem_r, burst,
+				RING_ELEM_SIZE, size, NULL) == 0)
+			rte_pause();
+	const uint64_t sc_end = rte_rdtsc();
+
+	const uint64_t mc_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_mc_dequeue_bulk_elem(elem_r, burst,
+				RING_ELEM_SIZE, size, NULL) == 0)
+			rte_pause();
+	const uint64_t mc_end = rte_rdtsc();
+
+	params->spsc = ((double)(sc_end - sc_start))/(iterations*size);
+	params->mpmc = ((double)(mc_end - mc_start))/(iterations*size);
+	return 0;
+}
+
+/*
+ * Same as enqueue_bulk, using the RTS ring then the HTS ring. The results
+ * of the RTS ring are returned as spsc and the ones of the HTS ring as mpmc.
+ */
+static int
+enqueue_bulk_sync(void *p)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	struct thread_params *params = p;
+	const unsigned size = params->size;
+	unsigned i;
+	void *burst[MAX_BURST] = {0};
+
+	if ( __sync_add_and_fetch(&lcore_count, 1) != 2 )
+		while(lcore_count != 2)
+			rte_pause();
+
+	const uint64_t rts_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_enqueue_bulk(rts_r, burst, size, NULL) == 0)
+			rte_pause();
+	const uint64_t rts_end = rte_rdtsc();
+
+	const uint64_t hts_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_enqueue_bulk(hts_r, burst, size, NULL) == 0)
+			rte_pause();
+	const uint64_t hts_end = rte_rdtsc();
+
+	params->spsc = ((double)(rts_end - rts_start))/(iterations*size);
+	params->mpmc = ((double)(hts_end - hts_start))/(iterations*size);
+	return 0;
+}
+
+/*
+ * Same as dequeue_bulk, using the RTS ring then the HTS ring
+ */
+static int
+dequeue_bulk_sync(void *p)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	struct thread_params *params = p;
+	const unsigned size = params->size;
+	unsigned i;
+	void *burst[MAX_BURST] = {0};
+
+	if ( __sync_add_and_fetch(&lcore_count, 1) != 2 )
+		while(lcore_count != 2)
+			rte_pause();
+
+	const uint64_t rts_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_dequeue_bulk(rts_r, burst, size, NULL) == 0)
+			rte_pause();
+	const uint64_t rts_end = rte_rdtsc();
+
+	const uint64_t hts_start = rte_rdtsc();
+	for (i = 0; i < iterations; i++)
+		while (rte_ring_dequeue_bulk(hts_r, burst, size, NULL) == 0)
+			rte_pause();
+	const uint64_t hts_end = rte_rdtsc();
+
+	params->spsc = ((double)(rts_end - rts_start))/(iterations*size);
+	params->mpmc = ((double)(hts_end - hts_start))/(iterations*size);
+	return 0;
+}
+
+/* descriptions of the two results of each pair of thread functions */
+static const char * const ptr_desc[] = { "SP/SC", "MP/MC" };
+static const char * const elem_desc[] = {
+	"SP/SC elem" RTE_STR(RING_ELEM_SIZE),
+	"MP/MC elem" RTE_STR(RING_ELEM_SIZE),
+};
+static const char * const sync_desc[] = { "MP/MC RTS", "MP/MC HTS" };
+
 /*
  * Function that calls the enqueue and dequeue bulk functions on pairs of cores.
  * used to measure ring perf between hyperthreads, cores and sockets.
+ * The desc strings describe the two results returned by the functions.
  */
 static void
-run_on_core_pair(struct lcore_pair *cores,
+run_on_core_pair(struct lcore_pair *cores, const char * const desc[2],
 		lcore_function_t f1, lcore_function_t f2)
 {
 	struct thread_params param1 = {0}, param2 = {0};
@@ -268,10 +441,10 @@ run_on_core_pair(struct lcore_pair *cores,
 			rte_eal_wait_lcore(cores->c1);
 			rte_eal_wait_lcore(cores->c2);
 		}
-		printf("SP/SC bulk enq/dequeue (size: %u): %.2F\n", bulk_sizes[i],
-				param1.spsc + param2.spsc);
-		printf("MP/MC bulk enq/dequeue (size: %u): %.2F\n", bulk_sizes[i],
-				param1.mpmc + param2.mpmc);
+		printf("%s bulk enq/dequeue (size: %u): %.2F\n", desc[0],
+				bulk_sizes[i], param1.spsc + param2.spsc);
+		printf("%s bulk enq/dequeue (size: %u): %.2F\n", desc[1],
+				bulk_sizes[i], param1.mpmc + param2.mpmc);
 	}
 }
 
@@ -389,6 +562,91 @@ test_bulk_enqueue_dequeue(void)
 	}
 }
 
+/* Times enqueue and dequeue on a single lcore using the element ring */
+static void
+test_bulk_enqueue_dequeue_elem(void)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	unsigned sz, i = 0;
+	struct ring_elem burst[MAX_BURST];
+
+	memset(burst, 0, sizeof(burst));
+
+	for (sz = 0; sz < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); sz++) {
+		const uint64_t sc_start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_ring_sp_enqueue_bulk_elem(elem_r, burst,
+					RING_ELEM_SIZE, bulk_sizes[sz], NULL);
+			rte_ring_sc_dequeue_bulk_elem(elem_r, burst,
+					RING_ELEM_SIZE, bulk_sizes[sz], NULL);
+		}
+		const uint64_t sc_end = rte_rdtsc();
+
+		const uint64_t mc_start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_ring_mp_enqueue_bulk_elem(elem_r, burst,
+					RING_ELEM_SIZE, bulk_sizes[sz], NULL);
+			rte_ring_mc_dequeue_bulk_elem(elem_r, burst,
+					RING_ELEM_SIZE, bulk_sizes[sz], NULL);
+		}
+		const uint64_t mc_end = rte_rdtsc();
+
+		double sc_avg = ((double)(sc_end-sc_start) /
+				(iterations * bulk_sizes[sz]));
+		double mc_avg = ((double)(mc_end-mc_start) /
+				(iterations * bulk_sizes[sz]));
+
+		printf("SP/SC elem%u bulk enq/dequeue (size: %u): %.2F\n",
+				RING_ELEM_SIZE, bulk_sizes[sz], sc_avg);
+		printf("MP/MC elem%u bulk enq/dequeue (size: %u): %.2F\n",
+				RING_ELEM_SIZE, bulk_sizes[sz], mc_avg);
+	}
+}
+
+/*
+ * Times enqueue and dequeue on a single lcore using the default functions
+ * on the RTS and HTS rings
+ */
+static void
+test_bulk_enqueue_dequeue_sync(void)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	unsigned sz, i = 0;
+	void *burst[MAX_BURST] = {0};
+
+	for (sz = 0; sz < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); sz++) {
+		const uint64_t rts_start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_ring_enqueue_bulk(rts_r, burst,
+					bulk_sizes[sz], NULL);
+			rte_ring_dequeue_bulk(rts_r, burst,
+					bulk_sizes[sz], NULL);
+		}
+		const uint64_t rts_end = rte_rdtsc();
+
+		const uint64_t hts_start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_ring_enqueue_bulk(hts_r, burst,
+					bulk_sizes[sz], NULL);
+			rte_ring_dequeue_bulk(hts_r, burst,
+					bulk_sizes[sz], NULL);
+		}
+		const uint64_t hts_end = rte_rdtsc();
+
+		double rts_avg = ((double)(rts_end-rts_start) /
+				(iterations * bulk_sizes[sz]));
+		double hts_avg = ((double)(hts_end-hts_start) /
+				(iterations * bulk_sizes[sz]));
+
+		printf("MP/MC RTS bulk enq/dequeue (size: %u): %.2F\n",
+				bulk_sizes[sz], rts_avg);
+		printf("MP/MC HTS bulk enq/dequeue (size: %u): %.2F\n",
+				bulk_sizes[sz], hts_avg);
+	}
+}
+
 static int
 test_ring_perf(void)
 {
@@ -396,6 +654,19 @@ test_ring_perf(void)
 	r = rte_ring_create(RING_NAME, RING_SIZE, rte_socket_id(), 0);
 	if (r == NULL && (r = rte_ring_lookup(RING_NAME)) == NULL)
 		return -1;
+	elem_r = rte_ring_create_elem(RING_ELEM_NAME, RING_ELEM_SIZE,
+			RING_SIZE, rte_socket_id(), 0);
+	if (elem_r == NULL &&
+			(elem_r = rte_ring_lookup(RING_ELEM_NAME)) == NULL)
+		return -1;
+	rts_r = rte_ring_create(RING_RTS_NAME, RING_SIZE, rte_socket_id(),
+			RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ);
+	if (rts_r == NULL && (rts_r = rte_ring_lookup(RING_RTS_NAME)) == NULL)
+		return -1;
+	hts_r = rte_ring_create(RING_HTS_NAME, RING_SIZE, rte_socket_id(),
+			RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ);
+	if (hts_r == NULL && (hts_r = rte_ring_lookup(RING_HTS_NAME)) == NULL)
+		return -1;
 
 	printf("### Testing single element and burst enq/deq ###\n");
 	test_single_enqueue_dequeue();
@@ -406,18 +677,32 @@ test_ring_perf(void)
 
 	printf("\n### Testing using a single lcore ###\n");
 	test_bulk_enqueue_dequeue();
+	test_bulk_enqueue_dequeue_elem();
+	test_bulk_enqueue_dequeue_sync();
 
 	if (get_two_hyperthreads(&cores) == 0) {
 		printf("\n### Testing using two hyperthreads ###\n");
-		run_on_core_pair(&cores, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, ptr_desc, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, elem_desc, enqueue_bulk_elem,
+				dequeue_bulk_elem);
+		run_on_core_pair(&cores, sync_desc, enqueue_bulk_sync,
+				dequeue_bulk_sync);
 	}
 	if (get_two_cores(&cores) == 0) {
 		printf("\n### Testing using two physical cores ###\n");
-		run_on_core_pair(&cores, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, ptr_desc, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, elem_desc, enqueue_bulk_elem,
+				dequeue_bulk_elem);
+		run_on_core_pair(&cores, sync_desc, enqueue_bulk_sync,
+				dequeue_bulk_sync);
 	}
 	if (get_two_sockets(&cores) == 0) {
 		printf("\n### Testing using two NUMA nodes ###\n");
-		run_on_core_pair(&cores, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, ptr_desc, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, elem_desc, enqueue_bulk_elem,
+				dequeue_bulk_elem);
+		run_on_core_pair(&cores, sync_desc, enqueue_bulk_sync,
+				dequeue_bulk_sync);
 	}
 	return 0;
 }
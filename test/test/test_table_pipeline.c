@@ -32,10 +32,13 @@
  */
 
 #include <string.h>
+#include <stdlib.h>
 #include <rte_pipeline.h>
 #include <rte_log.h>
 #include <inttypes.h>
 #include <rte_hexdump.h>
+#include <rte_cycles.h>
+#include <rte_random.h>
 #include "test_table.h"
 #include "test_table_pipeline.h"
 
@@ -527,6 +530,420 @@ test_pipeline_single_filter(int test_type, int expected_count)
 
 }
 
+#ifdef RTE_LIBRTE_ACL
+
+/*
+ * Chain benchmark: ACL -> hash -> LPM, as in a virtual router, where the ACL
+ * filters on the 5-tuple in the packet data, the hash table is the flow table
+ * keyed by the 5-tuple in the packet meta-data and the LPM table does the
+ * route lookup on the destination IP address.
+ */
+#define CHAIN_N_FLOWS			(1 << 18)
+#define CHAIN_N_ROUTES			1024
+#define CHAIN_N_BURSTS			64
+#define CHAIN_N_ITER			20000
+#define CHAIN_N_REPEAT			5
+#define CHAIN_BURST_SIZE		RTE_PORT_IN_BURST_SIZE_MAX
+#define CHAIN_RING_SIZE			256
+
+#define CHAIN_SIG_OFFSET		APP_METADATA_OFFSET(0)
+#define CHAIN_KEY_OFFSET		APP_METADATA_OFFSET(32)
+#define CHAIN_IP_DST_OFFSET		APP_METADATA_OFFSET(64)
+
+struct chain_5tuple {
+	uint8_t  proto;
+	uint32_t ip_src;
+	uint32_t ip_dst;
+	uint16_t port_src;
+	uint16_t port_dst;
+} __attribute__((__packed__));
+
+struct chain_flow_key {
+	uint32_t ip_src;
+	uint32_t ip_dst;
+	uint16_t port_src;
+	uint16_t port_dst;
+	uint8_t proto;
+	uint8_t pad[3];
+};
+
+enum {
+	CHAIN_PROTO_FIELD,
+	CHAIN_SRC_FIELD,
+	CHAIN_DST_FIELD,
+	CHAIN_SRCP_FIELD,
+	CHAIN_DSTP_FIELD,
+	CHAIN_NUM_FIELDS
+};
+
+static struct rte_acl_field_def chain_acl_defs[CHAIN_NUM_FIELDS] = {
+	{
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint8_t),
+		.field_index = CHAIN_PROTO_FIELD,
+		.input_index = CHAIN_PROTO_FIELD,
+		.offset = offsetof(struct chain_5tuple, proto),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = CHAIN_SRC_FIELD,
+		.input_index = CHAIN_SRC_FIELD,
+		.offset = offsetof(struct chain_5tuple, ip_src),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = CHAIN_DST_FIELD,
+		.input_index = CHAIN_DST_FIELD,
+		.offset = offsetof(struct chain_5tuple, ip_dst),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = CHAIN_SRCP_FIELD,
+		.input_index = CHAIN_SRCP_FIELD,
+		.offset = offsetof(struct chain_5tuple, port_src),
+	},
+	{
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = CHAIN_DSTP_FIELD,
+		.input_index = CHAIN_SRCP_FIELD,
+		.offset = offsetof(struct chain_5tuple, port_dst),
+	},
+};
+
+static struct rte_pipeline *
+chain_pipeline_create(struct rte_ring *ring_rx, struct rte_ring *ring_tx,
+	struct chain_flow_key *flows)
+{
+	struct rte_pipeline *pc;
+	uint32_t port_in, port_out, table_acl, table_hash, table_lpm;
+	struct rte_pipeline_table_entry *entry_ptr;
+	int key_found;
+	uint32_t i;
+
+	struct rte_pipeline_params pipeline_params = {
+		.name = "PIPELINE_CHAIN",
+		.socket_id = 0,
+	};
+	struct rte_port_ring_reader_params port_in_ring_params = {
+		.ring = ring_rx,
+	};
+	struct rte_pipeline_port_in_params port_in_params = {
+		.ops = &rte_port_ring_reader_ops,
+		.arg_create = &port_in_ring_params,
+		.f_action = NULL,
+		.burst_size = CHAIN_BURST_SIZE,
+	};
+	struct rte_port_ring_writer_params port_out_ring_params = {
+		.ring = ring_tx,
+		.tx_burst_sz = CHAIN_BURST_SIZE,
+	};
+	struct rte_pipeline_port_out_params port_out_params = {
+		.ops = &rte_port_ring_writer_ops,
+		.arg_create = &port_out_ring_params,
+		.f_action = NULL,
+		.arg_ah = NULL,
+	};
+	struct rte_table_acl_params acl_params = {
+		.name = "CHAIN_ACL",
+		.n_rules = 64,
+		.n_rule_fields = CHAIN_NUM_FIELDS,
+	};
+	struct rte_table_hash_key16_ext_params hash_params = {
+		.n_entries = CHAIN_N_FLOWS * 2,
+		.n_entries_ext = CHAIN_N_FLOWS / 2,
+		.f_hash = pipeline_test_hash,
+		.seed = 0,
+		.signature_offset = CHAIN_SIG_OFFSET,
+		.key_offset = CHAIN_KEY_OFFSET,
+		.key_mask = NULL,
+	};
+	struct rte_table_lpm_params lpm_params = {
+		.name = "CHAIN_LPM",
+		.n_rules = CHAIN_N_ROUTES * 2,
+		.number_tbl8s = 1 << 8,
+		.flags = 0,
+		.entry_unique_size = sizeof(struct rte_pipeline_table_entry),
+		.offset = CHAIN_IP_DST_OFFSET,
+	};
+	struct rte_pipeline_table_params table_params = {
+		.f_action_hit = NULL,
+		.f_action_miss = NULL,
+		.arg_ah = NULL,
+		.action_data_size = 0,
+	};
+	struct rte_pipeline_table_entry default_entry = {
+		.action = RTE_PIPELINE_ACTION_DROP,
+	};
+	struct rte_pipeline_table_entry entry;
+
+	memcpy(acl_params.field_format, chain_acl_defs,
+		sizeof(chain_acl_defs));
+
+	pc = rte_pipeline_create(&pipeline_params);
+	if (pc == NULL)
+		return NULL;
+
+	if (rte_pipeline_port_in_create(pc, &port_in_params, &port_in) ||
+		rte_pipeline_port_out_create(pc, &port_out_params, &port_out))
+		goto fail;
+
+	table_params.ops = &rte_table_acl_ops;
+	table_params.arg_create = &acl_params;
+	if (rte_pipeline_table_create(pc, &table_params, &table_acl))
+		goto fail;
+
+	table_params.ops = &rte_table_hash_key16_ext_ops;
+	table_params.arg_create = &hash_params;
+	if (rte_pipeline_table_create(pc, &table_params, &table_hash))
+		goto fail;
+
+	table_params.ops = &rte_table_lpm_ops;
+	table_params.arg_create = &lpm_params;
+	if (rte_pipeline_table_create(pc, &table_params, &table_lpm))
+		goto fail;
+
+	if (rte_pipeline_port_in_connect_to_table(pc, port_in, table_acl))
+		goto fail;
+
+	/* ACL: a few destination port ranges plus a catch-all rule */
+	entry.action = RTE_PIPELINE_ACTION_TABLE;
+	entry.table_id = table_hash;
+	for (i = 0; i < 16; i++) {
+		struct rte_table_acl_rule_add_params rule;
+
+		memset(&rule, 0, sizeof(rule));
+		rule.priority = i + 1;
+		rule.field_value[CHAIN_SRCP_FIELD].mask_range.u16 = UINT16_MAX;
+		rule.field_value[CHAIN_DSTP_FIELD].value.u16 = i << 12;
+		rule.field_value[CHAIN_DSTP_FIELD].mask_range.u16 =
+			(i << 12) | 0xFFF;
+
+		if (rte_pipeline_table_entry_add(pc, table_acl, &rule, &entry,
+			&key_found, &entry_ptr))
+			goto fail;
+	}
+
+	{
+		struct rte_table_acl_rule_add_params rule;
+
+		memset(&rule, 0, sizeof(rule));
+		rule.priority = 100;
+		rule.field_value[CHAIN_SRCP_FIELD].mask_range.u16 = UINT16_MAX;
+		rule.field_value[CHAIN_DSTP_FIELD].mask_range.u16 = UINT16_MAX;
+
+		if (rte_pipeline_table_entry_add(pc, table_acl, &rule, &entry,
+			&key_found, &entry_ptr))
+			goto fail;
+	}
+
+	/* Hash: one entry per flow */
+	entry.table_id = table_lpm;
+	for (i = 0; i < CHAIN_N_FLOWS; i++)
+		if (rte_pipeline_table_entry_add(pc, table_hash, &flows[i],
+			&entry, &key_found, &entry_ptr))
+			goto fail;
+
+	/* LPM: random /20 routes */
+	entry.action = RTE_PIPELINE_ACTION_PORT;
+	entry.port_id = port_out;
+	for (i = 0; i < CHAIN_N_ROUTES; i++) {
+		struct rte_table_lpm_key route = {
+			.ip = (uint32_t) rte_rand(),
+			.depth = 20,
+		};
+
+		if (rte_pipeline_table_entry_add(pc, table_lpm, &route,
+			&entry, &key_found, &entry_ptr))
+			goto fail;
+	}
+
+	/* Default route, as the LPM table has no route of depth 0 */
+	if (rte_pipeline_table_default_entry_add(pc, table_lpm, &entry,
+			&entry_ptr))
+		goto fail;
+
+	if (rte_pipeline_table_default_entry_add(pc, table_acl,
+			&default_entry, &entry_ptr) ||
+		rte_pipeline_table_default_entry_add(pc, table_hash,
+			&default_entry, &entry_ptr))
+		goto fail;
+
+	if (rte_pipeline_port_in_enable(pc, port_in) ||
+		rte_pipeline_check(pc) < 0)
+		goto fail;
+
+	return pc;
+
+fail:
+	rte_pipeline_free(pc);
+	return NULL;
+}
+
+static void
+chain_packet_init(struct rte_mbuf *m, struct chain_flow_key *flow)
+{
+	struct chain_5tuple *hdr;
+
+	hdr = rte_pktmbuf_mtod(m, struct chain_5tuple *);
+	hdr->proto = flow->proto;
+	hdr->ip_src = flow->ip_src;
+	hdr->ip_dst = flow->ip_dst;
+	hdr->port_src = flow->port_src;
+	hdr->port_dst = flow->port_dst;
+	m->data_len = sizeof(*hdr);
+	m->pkt_len = sizeof(*hdr);
+
+	memcpy(RTE_MBUF_METADATA_UINT8_PTR(m, CHAIN_KEY_OFFSET), flow,
+		sizeof(*flow));
+	*RTE_MBUF_METADATA_UINT32_PTR(m, CHAIN_SIG_OFFSET) =
+		pipeline_test_hash(flow, sizeof(*flow), 0);
+	*RTE_MBUF_METADATA_UINT32_PTR(m, CHAIN_IP_DST_OFFSET) = flow->ip_dst;
+}
+
+static int
+chain_cycles_cmp(const void *a, const void *b)
+{
+	uint64_t ca = *(const uint64_t *) a, cb = *(const uint64_t *) b;
+
+	return (ca > cb) - (ca < cb);
+}
+
+/* Run the chain for all the bursts, return the number of packets out */
+static uint64_t
+chain_pipeline_run(struct rte_pipeline *pc, struct rte_ring *ring_rx,
+	struct rte_ring *ring_tx, struct rte_mbuf **pkts, uint64_t *cycles)
+{
+	void *objs[CHAIN_BURST_SIZE];
+	uint64_t n_pkts_out = 0, t;
+	uint32_t i, burst;
+
+	*cycles = 0;
+	for (i = 0; i < CHAIN_N_ITER; i++) {
+		burst = i % CHAIN_N_BURSTS;
+		rte_ring_sp_enqueue_bulk(ring_rx,
+			(void **) &pkts[burst * CHAIN_BURST_SIZE],
+			CHAIN_BURST_SIZE, NULL);
+
+		t = rte_rdtsc();
+		rte_pipeline_run(pc);
+		*cycles += rte_rdtsc() - t;
+
+		n_pkts_out += rte_ring_sc_dequeue_burst(ring_tx, objs,
+			CHAIN_BURST_SIZE, NULL);
+	}
+
+	rte_pipeline_flush(pc);
+	n_pkts_out += rte_ring_sc_dequeue_burst(ring_tx, objs,
+		CHAIN_BURST_SIZE, NULL);
+
+	return n_pkts_out;
+}
+
+static int
+test_pipeline_chain_perf(void)
+{
+	struct rte_ring *ring_rx, *ring_tx;
+	struct rte_pipeline *pc;
+	struct chain_flow_key *flows;
+	struct rte_mbuf **pkts;
+	uint64_t cycles[CHAIN_N_REPEAT];
+	uint32_t i, round, n_pkts = CHAIN_N_BURSTS * CHAIN_BURST_SIZE;
+	int status = -1;
+
+	printf("\nPipeline chain ACL -> hash -> LPM, %u flows, "
+		"%u bursts of %u packets, median of %u runs\n", CHAIN_N_FLOWS,
+		CHAIN_N_ITER, CHAIN_BURST_SIZE, CHAIN_N_REPEAT);
+
+	ring_rx = rte_ring_lookup("chain_ring_rx");
+	if (ring_rx == NULL)
+		ring_rx = rte_ring_create("chain_ring_rx", CHAIN_RING_SIZE, 0,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	ring_tx = rte_ring_lookup("chain_ring_tx");
+	if (ring_tx == NULL)
+		ring_tx = rte_ring_create("chain_ring_tx", CHAIN_RING_SIZE, 0,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if ((ring_rx == NULL) || (ring_tx == NULL)) {
+		printf("Cannot create rings\n");
+		return -1;
+	}
+
+	flows = rte_zmalloc(NULL, CHAIN_N_FLOWS * sizeof(*flows), 0);
+	pkts = rte_zmalloc(NULL, n_pkts * sizeof(*pkts), 0);
+	if ((flows == NULL) || (pkts == NULL)) {
+		printf("Cannot allocate memory\n");
+		goto free_mem;
+	}
+
+	/*
+	 * Flow keys in network byte order, with unique source IP addresses so
+	 * the keys are unique.
+	 */
+	for (i = 0; i < CHAIN_N_FLOWS; i++) {
+		flows[i].ip_src = rte_cpu_to_be_32((10 << 24) | i);
+		flows[i].ip_dst = (uint32_t) rte_rand();
+		flows[i].port_src = (uint16_t) rte_rand();
+		flows[i].port_dst = (uint16_t) rte_rand();
+		flows[i].proto = 17;
+	}
+
+	if (rte_pktmbuf_alloc_bulk(pool, pkts, n_pkts) < 0) {
+		printf("Cannot allocate mbufs\n");
+		goto free_mem;
+	}
+
+	for (i = 0; i < n_pkts; i++)
+		chain_packet_init(pkts[i],
+			&flows[rte_rand() % CHAIN_N_FLOWS]);
+
+	pc = chain_pipeline_create(ring_rx, ring_tx, flows);
+	if (pc == NULL) {
+		printf("Cannot create pipeline\n");
+		goto free_mbufs;
+	}
+
+	for (round = 0; round < CHAIN_N_REPEAT; round++) {
+		uint64_t warmup, n_pkts_out;
+
+		/* Warm up */
+		chain_pipeline_run(pc, ring_rx, ring_tx, pkts, &warmup);
+
+		n_pkts_out = chain_pipeline_run(pc, ring_rx, ring_tx, pkts,
+			&cycles[round]);
+		if (n_pkts_out != (uint64_t) CHAIN_N_ITER * CHAIN_BURST_SIZE) {
+			printf("%" PRIu64 " packets out instead of %u\n",
+				n_pkts_out, CHAIN_N_ITER * CHAIN_BURST_SIZE);
+			goto free_pipeline;
+		}
+	}
+
+	qsort(cycles, CHAIN_N_REPEAT, sizeof(cycles[0]), chain_cycles_cmp);
+	printf("%.1f cycles/packet (min %.1f, max %.1f)\n",
+		(double) cycles[CHAIN_N_REPEAT / 2] /
+		((double) CHAIN_N_ITER * CHAIN_BURST_SIZE),
+		(double) cycles[0] /
+		((double) CHAIN_N_ITER * CHAIN_BURST_SIZE),
+		(double) cycles[CHAIN_N_REPEAT - 1] /
+		((double) CHAIN_N_ITER * CHAIN_BURST_SIZE));
+
+	status = 0;
+
+free_pipeline:
+	rte_pipeline_free(pc);
+free_mbufs:
+	for (i = 0; i < n_pkts; i++)
+		rte_pktmbuf_free(pkts[i]);
+free_mem:
+	rte_free(pkts);
+	rte_free(flows);
+	return status;
+}
+
+#endif /* RTE_LIBRTE_ACL */
+
 int
 test_table_pipeline(void)
 {
@@ -596,5 +1013,13 @@ test_table_pipeline(void)
 		return -1;
 	}
 
+#ifdef RTE_LIBRTE_ACL
+	if (test_pipeline_chain_perf() < 0) {
+		RTE_LOG(INFO, PIPELINE, "%s: Pipeline chain benchmark "
+			"failed.\n", __func__);
+		return -1;
+	}
+#endif
+
 	return 0;
 }
@@ -37,6 +37,7 @@
 port_test port_tests[] = {
 	test_port_ring_reader,
 	test_port_ring_writer,
+	test_port_ring_multi_sync,
 };
 
 unsigned n_port_tests = RTE_DIM(port_tests);
@@ -218,3 +219,70 @@ test_port_ring_writer(void)
 
 	return 0;
 }
+
+int
+test_port_ring_multi_sync(void)
+{
+	static const unsigned int ring_flags[] = {
+		RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+		RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+	};
+	struct rte_port_ring_reader_params reader_params;
+	struct rte_port_ring_writer_params writer_params;
+	struct rte_mbuf *mbuf[RTE_PORT_IN_BURST_SIZE_MAX];
+	struct rte_mbuf *res_mbuf[RTE_PORT_IN_BURST_SIZE_MAX];
+	struct rte_ring *r;
+	void *reader, *writer;
+	int received_pkts;
+	unsigned int i, j;
+
+	for (i = 0; i < RTE_DIM(ring_flags); i++) {
+		r = rte_ring_create("port_ring_sync", RING_RX_SIZE, 0,
+			ring_flags[i]);
+		if (r == NULL)
+			return -1;
+
+		reader_params.ring = r;
+		writer_params.ring = r;
+		writer_params.tx_burst_sz = RTE_PORT_IN_BURST_SIZE_MAX;
+
+		/* RTS and HTS rings are not single producer/consumer rings */
+		reader = rte_port_ring_reader_ops.f_create(&reader_params, 0);
+		writer = rte_port_ring_writer_ops.f_create(&writer_params, 0);
+		if (reader != NULL || writer != NULL) {
+			rte_ring_free(r);
+			return -2;
+		}
+
+		reader = rte_port_ring_multi_reader_ops.f_create(
+			&reader_params, 0);
+		writer = rte_port_ring_multi_writer_ops.f_create(
+			&writer_params, 0);
+		if (reader == NULL || writer == NULL) {
+			rte_port_ring_multi_reader_ops.f_free(reader);
+			rte_port_ring_multi_writer_ops.f_free(writer);
+			rte_ring_free(r);
+			return -3;
+		}
+
+		for (j = 0; j < RTE_PORT_IN_BURST_SIZE_MAX; j++)
+			mbuf[j] = rte_pktmbuf_alloc(pool);
+		rte_port_ring_multi_writer_ops.f_tx_bulk(writer, mbuf,
+			(uint64_t)-1);
+		rte_port_ring_multi_writer_ops.f_flush(writer);
+
+		received_pkts = rte_port_ring_multi_reader_ops.f_rx(reader,
+			res_mbuf, RTE_PORT_IN_BURST_SIZE_MAX);
+		for (j = 0; j < (unsigned int) received_pkts; j++)
+			rte_pktmbuf_free(res_mbuf[j]);
+
+		rte_port_ring_multi_reader_ops.f_free(reader);
+		rte_port_ring_multi_writer_ops.f_free(writer);
+		rte_ring_free(r);
+
+		if (received_pkts != RTE_PORT_IN_BURST_SIZE_MAX)
+			return -4;
+	}
+
+	return 0;
+}
@@ -63,6 +63,21 @@ table_test table_tests[] = {
 	*signature = pipeline_test_hash(key, 0, 0);			\
 } while (0)
 
+#define PREPARE_PACKET_KEY64(mbuf, value, key_size, tail) do {		\
+	uint32_t *k32, *signature;					\
+	uint8_t *key;							\
+	mbuf = rte_pktmbuf_alloc(pool);					\
+	signature = RTE_MBUF_METADATA_UINT32_PTR(mbuf,			\
+			APP_METADATA_OFFSET(0));			\
+	key = RTE_MBUF_METADATA_UINT8_PTR(mbuf,			\
+			APP_METADATA_OFFSET(32));			\
+	memset(key, 0, 64);						\
+	k32 = (uint32_t *) key;						\
+	k32[0] = (value);						\
+	key[(key_size) - 1] = (tail);					\
+	*signature = pipeline_test_hash(key, 0, 0);			\
+} while (0)
+
 unsigned n_table_tests = RTE_DIM(table_tests);
 
 /* Function prototypes */
@@ -70,6 +85,8 @@ static int
 test_table_hash_lru_generic(struct rte_table_ops *ops);
 static int
 test_table_hash_ext_generic(struct rte_table_ops *ops);
+static int
+test_table_hash_key64_generic(struct rte_table_ops *ops, int ext);
 
 struct rte_bucket_4_8 {
 	/* Cache line 0 */
@@ -890,6 +907,176 @@ test_table_hash_ext_generic(struct rte_table_ops *ops)
 	return 0;
 }
 
+static int
+test_table_hash_key64_generic(struct rte_table_ops *ops, int ext)
+{
+	static const uint32_t key_sizes[] = {8, 24, 40, 64};
+	int status, key_found;
+	uint32_t i, k;
+	uint64_t expected_mask, result_mask;
+	struct rte_mbuf *mbufs[RTE_PORT_IN_BURST_SIZE_MAX];
+	void *table, *params;
+	char *entries[RTE_PORT_IN_BURST_SIZE_MAX];
+	char entry;
+	void *entry_ptr;
+	uint8_t key[64], key_mask[64];
+	uint32_t *k32 = (uint32_t *) &key;
+
+	/* Initialize params and create tables */
+	struct rte_table_hash_key64_lru_params lru_params = {
+		.key_size = 64,
+		.n_entries = 1 << 10,
+		.f_hash = pipeline_test_hash,
+		.seed = 0,
+		.signature_offset = APP_METADATA_OFFSET(0),
+		.key_offset = APP_METADATA_OFFSET(32),
+		.key_mask = NULL,
+	};
+	struct rte_table_hash_key64_ext_params ext_params = {
+		.key_size = 64,
+		.n_entries = 1 << 10,
+		.n_entries_ext = 1 << 4,
+		.f_hash = pipeline_test_hash,
+		.seed = 0,
+		.signature_offset = APP_METADATA_OFFSET(0),
+		.key_offset = APP_METADATA_OFFSET(32),
+		.key_mask = NULL,
+	};
+
+	params = ext ? (void *) &ext_params : (void *) &lru_params;
+
+	/* Invalid key sizes */
+	lru_params.key_size = ext_params.key_size = 0;
+	table = ops->f_create(params, 0, 1);
+	if (table != NULL)
+		return -1;
+
+	lru_params.key_size = ext_params.key_size = 12;
+	table = ops->f_create(params, 0, 1);
+	if (table != NULL)
+		return -2;
+
+	lru_params.key_size = ext_params.key_size = 72;
+	table = ops->f_create(params, 0, 1);
+	if (table != NULL)
+		return -3;
+
+	for (k = 0; k < RTE_DIM(key_sizes); k++) {
+		uint32_t key_size = key_sizes[k];
+
+		lru_params.key_size = ext_params.key_size = key_size;
+		lru_params.key_mask = ext_params.key_mask = NULL;
+
+		table = ops->f_create(params, 0, 1);
+		if (table == NULL)
+			return -4;
+
+		/*
+		 * Two keys with the same signature, differing only in their
+		 * last byte, so the full key compare has to tell them apart.
+		 */
+		memset(key, 0, sizeof(key));
+		k32[0] = rte_be_to_cpu_32(0xadadadad);
+
+		entry = 'A';
+		status = ops->f_add(table, &key, &entry, &key_found,
+			&entry_ptr);
+		if ((status != 0) || key_found)
+			return -5;
+
+		key[key_size - 1] = 1;
+		entry = 'B';
+		status = ops->f_add(table, &key, &entry, &key_found,
+			&entry_ptr);
+		if ((status != 0) || key_found)
+			return -6;
+
+		expected_mask = 0;
+		for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++) {
+			PREPARE_PACKET_KEY64(mbufs[i], 0xadadadad, key_size,
+				i % 3);
+			if (i % 3 != 2)
+				expected_mask |= (uint64_t)1 << i;
+		}
+
+		/* Full burst, then a burst too small for the pipeline */
+		ops->f_lookup(table, mbufs, -1, &result_mask,
+			(void **)entries);
+		if (result_mask != expected_mask)
+			return -7;
+
+		for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+			if ((i % 3 != 2) && (*entries[i] != 'A' + (char)(i % 3)))
+				return -8;
+
+		ops->f_lookup(table, mbufs, 0x3F, &result_mask,
+			(void **)entries);
+		if (result_mask != (expected_mask & 0x3F))
+			return -9;
+
+		/* Delete */
+		status = ops->f_delete(table, &key, &key_found, NULL);
+		if ((status != 0) || !key_found)
+			return -10;
+
+		ops->f_lookup(table, mbufs, -1, &result_mask,
+			(void **)entries);
+		if (result_mask != (expected_mask & 0x9249249249249249LLU))
+			return -11;
+
+		status = ops->f_free(table);
+		if (status < 0)
+			return -12;
+
+		/* Key mask ignoring the last byte of the key */
+		memset(key_mask, 0xFF, sizeof(key_mask));
+		key_mask[key_size - 1] = 0;
+		lru_params.key_mask = ext_params.key_mask = key_mask;
+
+		table = ops->f_create(params, 0, 1);
+		if (table == NULL)
+			return -13;
+
+		/* Key added with bits outside of the mask set */
+		key[key_size - 1] = 1;
+		entry = 'A';
+		status = ops->f_add(table, &key, &entry, &key_found,
+			&entry_ptr);
+		if (status != 0)
+			return -14;
+
+		ops->f_lookup(table, mbufs, -1, &result_mask,
+			(void **)entries);
+		if (result_mask != UINT64_MAX)
+			return -15;
+
+		key[key_size - 1] = 2;
+		status = ops->f_add(table, &key, &entry, &key_found,
+			&entry_ptr);
+		if ((status != 0) || !key_found)
+			return -16;
+
+		key[key_size - 1] = 3;
+		status = ops->f_delete(table, &key, &key_found, NULL);
+		if ((status != 0) || !key_found)
+			return -17;
+
+		ops->f_lookup(table, mbufs, -1, &result_mask,
+			(void **)entries);
+		if (result_mask != 0)
+			return -18;
+
+		status = ops->f_free(table);
+		if (status < 0)
+			return -19;
+
+		for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+			rte_pktmbuf_free(mbufs[i]);
+	}
+
+	return 0;
+}
+
 int
 test_table_hash_lru(void)
 {
@@ -912,6 +1099,16 @@ test_table_hash_lru(void)
 	if (status < 0)
 		return status;
 
+	status = test_table_hash_key64_generic(&rte_table_hash_key64_lru_ops,
+		0);
+	if (status < 0)
+		return status;
+
+	status = test_table_hash_key64_generic(
+		&rte_table_hash_key64_lru_dosig_ops, 0);
+	if (status < 0)
+		return status;
+
 	status = test_lru_update();
 	if (status < 0)
 		return status;
@@ -941,6 +1138,16 @@ test_table_hash_ext(void)
 	if (status < 0)
 		return status;
 
+	status = test_table_hash_key64_generic(&rte_table_hash_key64_ext_ops,
+		1);
+	if (status < 0)
+		return status;
+
+	status = test_table_hash_key64_generic(
+		&rte_table_hash_key64_ext_dosig_ops, 1);
+	if (status < 0)
+		return status;
+
 	return 0;
 }
 